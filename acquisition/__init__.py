@@ -0,0 +1 @@
+"""Acquisition pipeline - background sampling and the sample bus."""
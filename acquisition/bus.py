@@ -0,0 +1,131 @@
+"""Sample bus - fans acquired samples and hardware events out to consumers.
+
+The acquisition thread publishes into the bus and must never wait on a
+consumer. Every subscriber therefore gets its own bounded queue: when a
+consumer falls behind, its oldest items are dropped (and counted) instead
+of the producer blocking.
+"""
+
+import threading
+from collections import deque
+from typing import List, NamedTuple, Sequence, Tuple, Union
+
+
+class SampleBlock(NamedTuple):
+    """A run of samples from one channel.
+
+    Attributes:
+        channel: Channel name (e.g. "adc0")
+        timestamps: Sample times in seconds (time.monotonic() timebase)
+        values: Sample values, same length as timestamps
+        board: Board ID the samples came from (0 for the local shield)
+    """
+    channel: str
+    timestamps: Sequence[float]
+    values: Sequence[float]
+    board: int = 0
+
+
+class Event(NamedTuple):
+    """A discrete hardware event.
+
+    Attributes:
+        kind: Event kind ("gpio", "i2c", "rule" or "alert")
+        timestamp: Event time in seconds (time.monotonic() timebase)
+        source: BCM pin for "gpio", device address for "i2c" and "alert", rule index for "rule"
+        value: 1 = pressed / 0 = released for "gpio", 1 = appeared / 0 = vanished for "i2c",
+            1 = fired / 0 = cleared for "rule", window state for "alert" (1 = above,
+            2 = critical, -1 = below, 0 = back inside)
+        board: Board ID the event came from (0 for the local shield)
+    """
+    kind: str
+    timestamp: float
+    source: int
+    value: int
+    board: int = 0
+
+
+BusItem = Union[SampleBlock, Event]
+
+
+class Subscription:
+    """Bounded per-consumer queue attached to a SampleBus."""
+    
+    def __init__(self, bus: "SampleBus", maxlen: int, samples: bool, events: bool):
+        self._bus = bus
+        self._queue = deque(maxlen=maxlen)
+        self._ready = threading.Event()
+        self.samples = samples
+        self.events = events
+        self.dropped = 0  # Items discarded because the consumer fell behind
+    
+    def put(self, item: BusItem):
+        """Queue an item (called from the producer thread, never blocks)."""
+        if len(self._queue) == self._queue.maxlen:
+            self.dropped += 1
+        self._queue.append(item)
+        self._ready.set()
+    
+    def drain(self) -> List[BusItem]:
+        """Take everything currently queued."""
+        self._ready.clear()
+        items = []
+        queue = self._queue
+        while queue:
+            try:
+                items.append(queue.popleft())
+            except IndexError:
+                break
+        return items
+    
+    def wait(self, timeout: float = None) -> bool:
+        """Wait until at least one item is queued.
+
+        Returns:
+            True if items are available, False on timeout
+        """
+        return self._ready.wait(timeout)
+    
+    def close(self):
+        """Detach from the bus."""
+        self._bus.unsubscribe(self)
+
+
+class SampleBus:
+    """Publish/subscribe fan-out for SampleBlock and Event items."""
+    
+    def __init__(self):
+        self._lock = threading.Lock()
+        # Copy-on-write so publish() can iterate without taking the lock
+        self._subscribers: Tuple[Subscription, ...] = ()
+        self.published = 0
+    
+    def subscribe(self, maxlen: int = 256, samples: bool = True, events: bool = True) -> Subscription:
+        """Attach a new consumer.
+
+        Args:
+            maxlen: Queue depth; older items are dropped beyond this
+            samples: Receive SampleBlock items
+            events: Receive Event items
+        """
+        sub = Subscription(self, maxlen, samples, events)
+        with self._lock:
+            self._subscribers = self._subscribers + (sub,)
+        return sub
+    
+    def unsubscribe(self, sub: Subscription):
+        """Detach a consumer (no-op if already detached)."""
+        with self._lock:
+            self._subscribers = tuple(s for s in self._subscribers if s is not sub)
+    
+    @property
+    def subscriber_count(self) -> int:
+        return len(self._subscribers)
+    
+    def publish(self, item: BusItem):
+        """Deliver an item to every interested subscriber."""
+        self.published += 1
+        is_event = isinstance(item, Event)
+        for sub in self._subscribers:
+            if (sub.events if is_event else sub.samples):
+                sub.put(item)
@@ -0,0 +1,158 @@
+"""Capture files - record the sample bus to disk and read it back.
+
+Layout (little-endian):
+
+    "SCAP" | version u8 | header_len u32 | header JSON
+    records...
+        0x01 channel  channel_id u16 | name_len u8 | name utf-8
+        0x02 block    channel_id u16 | board u8 | count u32
+                      | timestamps f64[count] | values f32[count]
+        0x03 event    kind_len u8 | kind utf-8 | board u8 | source u16
+                      | timestamp f64 | value i32
+
+Timestamps are stored exactly as published (time.monotonic() seconds); the
+header carries "unix_offset" so they can be converted to wall-clock time.
+While a DS3231 discipline is locked (acquisition/clock.py) the offset comes
+from the RTC and "clock" is "rtc"; its clock_offset channel then records
+how the offset moves during the capture.
+"""
+
+import json
+import socket
+import struct
+import sys
+import time
+from array import array
+from typing import Iterator, Optional
+
+from .bus import BusItem, Event, SampleBlock
+from .timing import clock_source, unix_offset
+
+MAGIC = b"SCAP"
+VERSION = 1
+
+REC_CHANNEL = 0x01
+REC_BLOCK = 0x02
+REC_EVENT = 0x03
+
+_FILE_HEADER = struct.Struct("<4sBI")
+_CHANNEL = struct.Struct("<BHB")
+_BLOCK = struct.Struct("<BHBI")
+_EVENT_TAIL = struct.Struct("<BHdi")
+
+_SWAP = sys.byteorder != "little"
+
+
+def _packed(typecode: str, values) -> bytes:
+    if hasattr(values, 'astype'):  # NumPy array
+        return values.astype('<f8' if typecode == 'd' else '<f4').tobytes()
+    packed = array(typecode, values)
+    if _SWAP:
+        packed.byteswap()
+    return packed.tobytes()
+
+
+class CaptureWriter:
+    """Appends bus items to a capture file."""
+    
+    def __init__(self, path: str, metadata: Optional[dict] = None):
+        """Create a capture file.
+
+        Args:
+            path: Output file path
+            metadata: Extra header fields (e.g. rate_hz, source)
+        """
+        header = {
+            "created": time.time(),
+            "host": socket.gethostname(),
+            "time_base": "monotonic",
+            "unix_offset": unix_offset(),
+            "clock": clock_source(),
+        }
+        header.update(metadata or {})
+        header_bytes = json.dumps(header).encode("utf-8")
+        self._file = open(path, "wb")
+        self._file.write(_FILE_HEADER.pack(MAGIC, VERSION, len(header_bytes)) + header_bytes)
+        self._channels = {}
+        self.blocks = 0
+        self.samples = 0
+        self.events = 0
+    
+    def write(self, item: BusItem):
+        """Write one SampleBlock or Event."""
+        if isinstance(item, Event):
+            kind = item.kind.encode("utf-8")
+            self._file.write(bytes([REC_EVENT, len(kind)]) + kind + _EVENT_TAIL.pack(
+                item.board, item.source & 0xFFFF, item.timestamp, item.value))
+            self.events += 1
+            return
+        
+        channel_id = self._channels.get(item.channel)
+        if channel_id is None:
+            channel_id = self._channels[item.channel] = len(self._channels)
+            name = item.channel.encode("utf-8")
+            self._file.write(_CHANNEL.pack(REC_CHANNEL, channel_id, len(name)) + name)
+        count = len(item.timestamps)
+        self._file.write(_BLOCK.pack(REC_BLOCK, channel_id, item.board, count))
+        self._file.write(_packed('d', item.timestamps))
+        self._file.write(_packed('f', item.values))
+        self.blocks += 1
+        self.samples += count
+    
+    def close(self):
+        self._file.close()
+    
+    def __enter__(self):
+        return self
+    
+    def __exit__(self, *exc):
+        self.close()
+
+
+class CaptureReader:
+    """Reads a capture file back as SampleBlock/Event items."""
+    
+    def __init__(self, path: str):
+        self.path = path
+        with open(path, "rb") as f:
+            magic, version, header_len = _FILE_HEADER.unpack(f.read(_FILE_HEADER.size))
+            if magic != MAGIC:
+                raise ValueError(f"{path} is not a capture file")
+            if version > VERSION:
+                raise ValueError(f"Capture version {version} not supported")
+            self.header = json.loads(f.read(header_len).decode("utf-8"))
+            self._data_start = f.tell()
+    
+    def __iter__(self) -> Iterator[BusItem]:
+        channels = {}
+        with open(self.path, "rb") as f:
+            f.seek(self._data_start)
+            while True:
+                kind = f.read(1)
+                if not kind:
+                    return
+                kind = kind[0]
+                if kind == REC_CHANNEL:
+                    channel_id, name_len = struct.unpack("<HB", f.read(3))
+                    channels[channel_id] = f.read(name_len).decode("utf-8")
+                elif kind == REC_BLOCK:
+                    channel_id, board, count = struct.unpack("<HBI", f.read(7))
+                    timestamps = array('d')
+                    values = array('f')
+                    timestamps.frombytes(f.read(8 * count))
+                    values.frombytes(f.read(4 * count))
+                    if len(values) != count:
+                        return  # Truncated tail (capture interrupted)
+                    if _SWAP:
+                        timestamps.byteswap()
+                        values.byteswap()
+                    yield SampleBlock(channels[channel_id], timestamps, values, board)
+                elif kind == REC_EVENT:
+                    name = f.read(f.read(1)[0]).decode("utf-8")
+                    tail = f.read(_EVENT_TAIL.size)
+                    if len(tail) < _EVENT_TAIL.size:
+                        return
+                    board, source, timestamp, value = _EVENT_TAIL.unpack(tail)
+                    yield Event(name, timestamp, source, value, board)
+                else:
+                    raise ValueError(f"Corrupt capture record type 0x{kind:02X}")
@@ -0,0 +1,251 @@
+"""DS3231 clock discipline: wall-clock time for the acquisition timestamps from the RTC.
+
+Everything on the bus is stamped with time.monotonic(); captures and the
+MQTT/text sinks turn that into Unix time with timing.unix_offset(). Without
+network time the system clock behind that offset is only as good as the
+Pi's crystal (tens of ppm, seconds per day), and it starts wherever the
+last shutdown left it.
+
+The DS3231's TCXO holds about 2 ppm. RTCDiscipline sets its INT/SQW pin to
+the 1 Hz square wave, wired to a J11 GPIO, and timestamps the falling edges
+(one per RTC second) in the kernel (EdgeInput). The RTC time is read once,
+in one burst right after an edge, to learn which Unix second that edge
+started; from then on edges are counted, not read. A DriftEstimator fits
+edge times against the count, so
+
+    unix(t) = second + (t - fitted edge time) / period
+
+maps any monotonic time to RTC time with the edge jitter averaged out, and
+period says how fast the host clock runs against the RTC (drift_ppm). Once
+locked the discipline becomes the timing clock reference: unix_offset()
+and captures use it, and a clock_offset channel (Unix minus monotonic
+seconds) is published every publish_s so a long capture records how the
+mapping moved. The system clock itself is never stepped; get_stats()
+reports how far it is from the RTC (offset_s).
+
+The RTC time is re-read every CHECK_S, right after an edge; if it isn't the
+counted second (RTC set meanwhile, edges lost in a burst) the count is
+re-anchored and the fit restarted.
+"""
+
+import sys
+import threading
+import time
+from datetime import datetime, timezone
+from typing import Optional
+
+from config.acquisition_config import (RTC_ADDRESS, RTC_BUS, RTC_PUBLISH_S, RTC_SQW_PIN,
+                                       RTC_TAU_S)
+from . import timing
+from .bus import SampleBlock, SampleBus
+from .timing import DriftEstimator
+
+# Edges fitted before the mapping is used (DriftEstimator fits the period from 16 on)
+LOCK_EDGES = 16
+
+# Interval of the RTC time check (s)
+CHECK_S = 60.0
+
+# Wakeup interval of the edge thread when no edge comes (s)
+EDGE_WAIT_S = 2.0
+
+# Latest read after an edge that still belongs to that edge's second (s)
+ANCHOR_WINDOW_S = 0.5
+
+
+class RTCDiscipline:
+    """Counts DS3231 SQW edges and maps time.monotonic() to the RTC's Unix time."""
+    
+    def __init__(self, rtc, sqw=None, sqw_pin: Optional[int] = RTC_SQW_PIN,
+                 bus: Optional[SampleBus] = None, tau_s: float = RTC_TAU_S,
+                 publish_s: float = RTC_PUBLISH_S, board: int = 0):
+        """Initialize discipline (the square wave is enabled in start()).
+
+        Args:
+            rtc: hardware.ds3231.DS3231
+            sqw: EdgeInput-like object for INT/SQW (default: EdgeInput on sqw_pin)
+            sqw_pin: BCM pin INT/SQW is wired to
+            bus: Bus that receives the clock_offset channel (None = don't publish)
+            tau_s: Drift estimator time constant
+            publish_s: Interval of the clock_offset samples
+            board: Board ID stamped on the blocks
+        """
+        self.rtc = rtc
+        self.sqw = sqw
+        self.sqw_pin = sqw_pin
+        self.bus = bus
+        self.publish_s = publish_s
+        self.board = board
+        self.estimator = DriftEstimator(1.0, tau_s)
+        self._lock = threading.Lock()
+        self._second: Optional[int] = None  # Unix second the last counted edge started
+        self._fitted = 0.0  # Fitted monotonic time of that edge
+        self._last_edge: Optional[float] = None
+        self._opened = False
+        self._stop = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+        self.stats = {"edges": 0, "missed": 0, "glitches": 0, "checks": 0, "reanchors": 0,
+                      "timeouts": 0, "published": 0}
+    
+    @classmethod
+    def from_config(cls, bus: Optional[SampleBus] = None, **kwargs) -> "RTCDiscipline":
+        """Discipline for the RTC_* settings.
+
+        Raises:
+            ValueError: RTC_SQW_PIN not set
+            RTCError: No DS3231 at RTC_ADDRESS (e.g. an IMU)
+            ImportError: smbus2 not installed
+            OSError: Bus not accessible or nothing at the address
+        """
+        from hardware.ds3231 import DS3231
+        
+        if RTC_SQW_PIN is None:
+            raise ValueError("RTC_SQW_PIN is not set")
+        return cls(DS3231(RTC_BUS, RTC_ADDRESS), sqw_pin=RTC_SQW_PIN, bus=bus, **kwargs)
+    
+    @property
+    def running(self) -> bool:
+        return self._thread is not None
+    
+    @property
+    def locked(self) -> bool:
+        return self._second is not None and self.estimator.observations >= LOCK_EDGES
+    
+    def start(self):
+        """Enable the 1 Hz square wave and start counting edges.
+
+        Raises:
+            ImportError: python3-libgpiod missing
+            OSError: SQW pin busy, RTC not answering
+        """
+        if self._thread is not None:
+            return
+        if self.rtc.oscillator_stopped:
+            print("RTC: oscillator stopped flag set, the RTC time is not valid "
+                  "(set it with 'device_cli.py rtc set')", file=sys.stderr)
+        self.rtc.enable_sqw(1)
+        if self.sqw is None:
+            from hardware.gpio_bank import EdgeInput
+            self.sqw = EdgeInput(self.sqw_pin)
+            self._opened = True
+        self._stop.clear()
+        self._thread = threading.Thread(target=self._run, name="rtc-discipline", daemon=True)
+        self._thread.start()
+        timing.set_clock_reference(self)
+    
+    def stop(self, timeout: float = 3.0):
+        """Stop counting and hand wall-clock conversions back to the system clock."""
+        timing.set_clock_reference(None)
+        self._stop.set()
+        if self._thread is not None:
+            self._thread.join(timeout)
+            self._thread = None
+        if self._opened:
+            self.sqw.close()
+            self.sqw = None
+            self._opened = False
+    
+    # Mapping -------------------------------------------------------------------
+    
+    def to_unix(self, t: float) -> Optional[float]:
+        """RTC time (Unix seconds) at monotonic time t; None until locked."""
+        with self._lock:
+            if not self.locked:
+                return None
+            return self._second + (t - self._fitted) / self.estimator.period
+    
+    def unix_offset(self) -> Optional[float]:
+        """Unix minus monotonic seconds now (timing clock reference); None until locked."""
+        now = time.monotonic()
+        unix = self.to_unix(now)
+        return None if unix is None else unix - now
+    
+    def get_stats(self) -> dict:
+        stats = dict(self.stats)
+        unix = self.to_unix(time.monotonic())
+        system = time.time()
+        stats.update({
+            "locked": self.locked,
+            "sqw_pin": self.sqw_pin,
+            # Host clock vs RTC; positive = the host's monotonic clock runs fast
+            "drift_ppm": (self.estimator.period - 1.0) * 1e6,
+            "residual_us": self.estimator.residual_us,
+            "rtc_time": None if unix is None else
+            datetime.fromtimestamp(unix, tz=timezone.utc).isoformat(timespec="milliseconds"),
+            # System clock minus RTC; what an NTP-less system clock has gained
+            "offset_s": None if unix is None else system - unix,
+        })
+        return stats
+    
+    # Edge thread ---------------------------------------------------------------
+    
+    def _run(self):
+        next_check = next_publish = 0.0
+        while not self._stop.is_set():
+            try:
+                edges = self.sqw.read(EDGE_WAIT_S)
+            except OSError as e:
+                print(f"RTC: SQW line failed: {e}", file=sys.stderr)
+                return
+            if not edges:
+                self.stats["timeouts"] += 1
+                continue
+            for t in edges:
+                self._edge(t)
+            now = time.monotonic()
+            if now - edges[-1] > ANCHOR_WINDOW_S:
+                continue  # Too late to tell which second the RTC is in
+            if self._second is None or now >= next_check:
+                try:
+                    self._check(edges[-1])
+                except OSError as e:
+                    print(f"RTC: time read failed: {e}", file=sys.stderr)
+                next_check = now + CHECK_S
+            if self.bus is not None and self.locked and now >= next_publish:
+                self._publish(now)
+                next_publish = now + self.publish_s
+    
+    def _edge(self, t: float):
+        """Count one falling edge (start of an RTC second)."""
+        estimator = self.estimator
+        if self._last_edge is None:
+            steps = 1
+        else:
+            steps = round((t - self._last_edge) / estimator.period)
+            if steps < 1:
+                self.stats["glitches"] += 1  # Ringing or a second edge within the second
+                return
+        self._last_edge = t
+        self.stats["edges"] += 1
+        self.stats["missed"] += steps - 1
+        if self._second is None:
+            return
+        fitted = estimator.add(t, steps)
+        with self._lock:
+            self._second += steps
+            self._fitted = fitted
+    
+    def _check(self, edge: float):
+        """Read the RTC time (one burst) and anchor the count to it if it disagrees."""
+        second = int(self.rtc.read_time().timestamp())
+        self.stats["checks"] += 1
+        if second == self._second:
+            return
+        if self._second is not None:
+            self.stats["reanchors"] += 1
+            print(f"RTC: time jumped by {second - self._second} s, re-anchoring",
+                  file=sys.stderr)
+        with self._lock:
+            self.estimator.reset()
+            self._second = second
+            self._fitted = self.estimator.add(edge)
+    
+    def _publish(self, now: float):
+        import numpy as np
+        
+        offset = self.unix_offset()
+        if offset is None:
+            return
+        self.bus.publish(SampleBlock("clock_offset", np.array([now]), np.array([offset]),
+                                     self.board))
+        self.stats["published"] += 1
@@ -0,0 +1,471 @@
+"""Closed-loop control - PID loops at a fixed rate on dedicated threads.
+
+Each ControlLoop reads its input from the acquisition pipeline (the engine's
+latest ADC value or a derived channel), runs one PID step and writes a PWM
+duty or an on/off level to the J11 GPIO bank. Ticks are scheduled against
+absolute deadlines (start + k * period): the thread sleeps until the
+deadline, optionally spinning for the last CONTROL_SPIN_US, so timing errors
+never accumulate. A tick that starts more than a whole period late is an
+overrun; the ticks it missed are skipped instead of run back to back.
+
+PID (parallel form, e = setpoint - input, sign flipped with reverse=True):
+    u = ff + kp*e + I - kd * d(input)/dt
+    ff = ff_gain * setpoint + ff_offset
+The derivative acts on the input, not the error, so setpoint steps cause no
+kick, and is low-pass filtered with time constant d_filter_s. Anti-windup:
+the integral is frozen while the output is saturated and the error pushes
+further into saturation (conditional integration).
+
+Inputs carry the time they were measured. One older than the loop's
+max_age_s (the ADC failed, or the engine or replay stopped) counts as
+missing: the output goes to out_min, also in manual mode, and the PID
+restarts from a clean state once fresh values arrive.
+
+Per loop: period jitter, wake-up latency (mean/max/p99), overruns,
+execution time, and a trace ring of (t, setpoint, input, output, p, i, d, ff)
+kept as one flat array('d') - 64 bytes a point instead of a tuple of floats.
+Setpoint, input and output are also published on the bus as <name>.sp,
+<name>.pv and <name>.out so they are recorded and plotted like channels.
+"""
+
+import re
+import sys
+import threading
+import time
+from array import array
+from typing import Callable, Dict, Hashable, List, Optional, Tuple
+
+from config.acquisition_config import (BLOCK_MS, CONTROL_INPUT_MAX_AGE, CONTROL_PWM_HZ,
+                                       CONTROL_SPIN_US, CONTROL_TRACE_LEN)
+from config.pins import GPIO_BANK
+from . import realtime
+from .bus import SampleBlock, SampleBus
+from .stats import P2Quantile, Welford
+
+_PHYSICAL = re.compile(r"(?:adc|ch)(\d+)$")
+_OUTPUT = re.compile(r"^(pwm|gpio):(\d+)$")
+
+TRACE_FIELDS = ("t", "setpoint", "input", "output", "p", "i", "d", "ff")
+
+
+class ControlError(ValueError):
+    """Control loop definition is invalid."""
+
+
+def latest_reader(values: dict, times: dict,
+                  key: Hashable) -> Callable[[], Optional[Tuple[float, float]]]:
+    """ControlLoop input over a latest / latest_t pair of dicts (engine, replay, derived)."""
+    def read():
+        value = values.get(key)
+        return None if value is None else (value, times.get(key, 0.0))
+    return read
+
+
+class PID:
+    """PID controller with feed-forward, derivative filter and anti-windup."""
+    
+    def __init__(self, kp: float, ki: float = 0.0, kd: float = 0.0, setpoint: float = 0.0,
+                 out_min: float = 0.0, out_max: float = 1.0, ff_gain: float = 0.0,
+                 ff_offset: float = 0.0, d_filter_s: float = 0.0, reverse: bool = False):
+        """Initialize PID.
+
+        Args:
+            kp, ki, kd: Gains (ki per second, kd in seconds)
+            setpoint: Target input value
+            out_min, out_max: Output limits
+            ff_gain, ff_offset: Feed-forward ff_gain * setpoint + ff_offset
+            d_filter_s: Derivative low-pass time constant (0 = unfiltered)
+            reverse: Output must rise when the input is above setpoint (cooling)
+        """
+        if out_min >= out_max:
+            raise ControlError("out_min must be below out_max")
+        self.kp = kp
+        self.ki = ki
+        self.kd = kd
+        self.setpoint = setpoint
+        self.out_min = out_min
+        self.out_max = out_max
+        self.ff_gain = ff_gain
+        self.ff_offset = ff_offset
+        self.d_filter_s = d_filter_s
+        self.sign = -1.0 if reverse else 1.0
+        self.integral = 0.0
+        self.terms = (0.0, 0.0, 0.0, 0.0)  # p, i, d, ff of the last update
+        self._derivative = 0.0
+        self._last_input: Optional[float] = None
+    
+    def reset(self, output: Optional[float] = None, measurement: Optional[float] = None):
+        """Clear state; with output given, preload the integral for a bumpless start."""
+        self._derivative = 0.0
+        self._last_input = measurement
+        self.integral = 0.0
+        if output is not None:
+            error = self.sign * (self.setpoint - measurement) if measurement is not None else 0.0
+            ff = self.ff_gain * self.setpoint + self.ff_offset
+            self.integral = output - ff - self.kp * error
+    
+    def update(self, measurement: float, dt: float) -> float:
+        """Run one step and return the clamped output."""
+        error = self.sign * (self.setpoint - measurement)
+        ff = self.ff_gain * self.setpoint + self.ff_offset
+        p = self.kp * error
+        
+        if self._last_input is not None and dt > 0:
+            rate = -self.sign * (measurement - self._last_input) / dt
+            if self.d_filter_s > 0:
+                self._derivative += dt / (self.d_filter_s + dt) * (rate - self._derivative)
+            else:
+                self._derivative = rate
+        self._last_input = measurement
+        d = self.kd * self._derivative
+        
+        integral = self.integral + self.ki * error * dt
+        output = ff + p + integral + d
+        # Conditional integration: don't wind further into saturation
+        if not ((output > self.out_max and error > 0) or (output < self.out_min and error < 0)):
+            self.integral = integral
+        output = ff + p + self.integral + d
+        self.terms = (p, self.integral, d, ff)
+        return min(self.out_max, max(self.out_min, output))
+
+
+class ControlLoop:
+    """Runs a PID at a fixed rate against absolute deadlines."""
+    
+    def __init__(self, name: str, pid: PID,
+                 read_input: Callable[[], Optional[Tuple[float, float]]],
+                 write_output: Callable[[float], None], rate_hz: float,
+                 bus: Optional[SampleBus] = None, board: int = 0,
+                 trace_len: int = CONTROL_TRACE_LEN, spin_us: float = CONTROL_SPIN_US,
+                 realtime: bool = False, max_age_s: Optional[float] = None):
+        """Initialize control loop.
+
+        Args:
+            name: Loop name (prefix of the published channels)
+            pid: Controller
+            read_input: Returns (latest input value, time.monotonic() it was measured),
+                or None while there is none yet
+            write_output: Applies an output value
+            rate_hz: Loop rate
+            bus: Optional bus for <name>.sp/.pv/.out channels
+            board: Board ID for published channels
+            trace_len: Trace points kept in memory
+            spin_us: Busy-wait this long before each deadline (0 = sleep only)
+            realtime: Run the loop thread SCHED_FIFO/pinned (see acquisition/realtime.py)
+            max_age_s: An older input counts as missing (None = never stale)
+        """
+        self.name = name
+        self.pid = pid
+        self.read_input = read_input
+        self.write_output = write_output
+        self.rate_hz = rate_hz
+        self.period = 1.0 / rate_hz
+        self.bus = bus
+        self.board = board
+        self.spin_s = spin_us / 1e6
+        self.realtime = realtime
+        self.max_age_s = max_age_s
+        self.trace_len = trace_len
+        self._trace = array('d', bytes(8 * len(TRACE_FIELDS) * trace_len))
+        self._trace_written = 0  # Points written so far (the ring slot is this % trace_len)
+        self.manual: Optional[float] = None  # Fixed output while not in automatic mode
+        self.output = pid.out_min
+        self._input_lost = False  # Output held at out_min for a missing/stale input
+        
+        self._stop = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+        self._buffers = {key: array('d') for key in ("t", "sp", "pv", "out")}
+        
+        self._wake = Welford()
+        self._wake_p99 = P2Quantile(0.99)
+        self._jitter = Welford()
+        self._pending_wake = array('d')
+        self._pending_jitter = array('d')
+        self.stats = {
+            "ticks": 0,
+            "overruns": 0,
+            "input_missing": 0,
+            "output_errors": 0,
+            "wake_ms_max": 0.0,
+            "jitter_ms_max": 0.0,
+            "exec_ms_max": 0.0,
+        }
+    
+    @property
+    def running(self) -> bool:
+        return self._thread is not None and self._thread.is_alive()
+    
+    def start(self):
+        if self.running:
+            return
+        self._stop.clear()
+        self._thread = threading.Thread(target=self._run, name=f"control-{self.name}",
+                                        daemon=True)
+        self._thread.start()
+    
+    def stop(self, timeout: float = 2.0):
+        """Stop the loop and drive the output to out_min."""
+        self._stop.set()
+        if self._thread is not None:
+            self._thread.join(timeout)
+            self._thread = None
+        self._flush()
+        try:
+            self.write_output(self.pid.out_min)
+        except Exception:
+            pass
+    
+    def set_setpoint(self, value: float):
+        self.pid.setpoint = value
+    
+    def set_manual(self, output: Optional[float]):
+        """Hold a fixed output (None returns to automatic, bumplessly)."""
+        if output is None and self.manual is not None:
+            reading = self.read_input()
+            self.pid.reset(self.manual, reading[0] if reading is not None else None)
+        self.manual = output
+    
+    def get_stats(self) -> dict:
+        stats = dict(self.stats)
+        stats.update({
+            "rate_hz": self.rate_hz,
+            "max_age_s": self.max_age_s,
+            "input_lost": self._input_lost,
+            "setpoint": self.pid.setpoint,
+            "output": self.output,
+            "manual": self.manual,
+            "wake_ms_mean": self._wake.mean,
+            "wake_ms_p99": self._wake_p99.value,
+            "jitter_ms_std": self._jitter.variance ** 0.5,
+        })
+        return stats
+    
+    def get_trace(self, count: Optional[int] = None) -> Dict[str, list]:
+        """Recent trace as columns (t is time.monotonic() of the tick deadline)."""
+        # Lock-free against the loop thread: each point is written with one slice
+        # assignment, so only points overwritten during the copy are dropped
+        end = self._trace_written
+        data = self._trace[:]
+        start = max(0, self._trace_written - self.trace_len)
+        if count is not None:
+            start = max(start, end - count)
+        width = len(TRACE_FIELDS)
+        rows = [(n % self.trace_len) * width for n in range(start, end)]
+        return {field: [data[row + i] for row in rows] for i, field in enumerate(TRACE_FIELDS)}
+    
+    def _sleep_until(self, deadline: float):
+        remaining = deadline - time.monotonic() - self.spin_s
+        if remaining > 0.05:
+            # Long waits stay interruptible by stop()
+            self._stop.wait(remaining - 0.02)
+            remaining = deadline - time.monotonic() - self.spin_s
+        if remaining > 0:
+            time.sleep(remaining)
+        while time.monotonic() < deadline:
+            pass
+    
+    def _run(self):
+        if self.realtime:
+            realtime.configure_thread("control", f"control:{self.name}")
+        period = self.period
+        deadline = time.monotonic() + period
+        next_flush = deadline + BLOCK_MS / 1000.0
+        last_wake = None
+        skipped = 0
+        
+        while not self._stop.is_set():
+            self._sleep_until(deadline)
+            if self._stop.is_set():
+                break
+            wake = time.monotonic()
+            
+            reading = self.read_input()
+            if reading is not None and self.max_age_s is not None and \
+                    wake - reading[1] > self.max_age_s:
+                reading = None
+            if reading is None:
+                self.stats["input_missing"] += 1
+                if not self._input_lost:
+                    self._input_lost = True
+                    self.pid.reset()
+                    self._write(self.pid.out_min)
+            else:
+                measurement = reading[0]
+                self._input_lost = False
+                dt = period * (1 + skipped)
+                if self.manual is None:
+                    output = self.pid.update(measurement, dt)
+                else:
+                    output = self.manual
+                self._write(output)
+                self._record(deadline, measurement, output)
+            done = time.monotonic()
+            
+            # Timing statistics
+            wake_ms = (wake - deadline) * 1000.0
+            self._pending_wake.append(wake_ms)
+            self._wake_p99.add(wake_ms)
+            if wake_ms > self.stats["wake_ms_max"]:
+                self.stats["wake_ms_max"] = wake_ms
+            if last_wake is not None:
+                jitter_ms = (wake - last_wake - period * (1 + skipped)) * 1000.0
+                self._pending_jitter.append(jitter_ms)
+                if abs(jitter_ms) > self.stats["jitter_ms_max"]:
+                    self.stats["jitter_ms_max"] = abs(jitter_ms)
+            last_wake = wake
+            exec_ms = (done - wake) * 1000.0
+            if exec_ms > self.stats["exec_ms_max"]:
+                self.stats["exec_ms_max"] = exec_ms
+            self.stats["ticks"] += 1
+            
+            if done >= next_flush:
+                self._flush()
+                next_flush = done + BLOCK_MS / 1000.0
+            
+            # Next absolute deadline; skip whole periods that are already gone
+            deadline += period
+            skipped = 0
+            late = time.monotonic() - deadline
+            if late >= period:
+                skipped = int(late // period)
+                deadline += skipped * period
+                self.stats["overruns"] += skipped
+    
+    def _write(self, output: float):
+        try:
+            self.write_output(output)
+        except Exception as e:
+            self.stats["output_errors"] += 1
+            if self.stats["output_errors"] == 1:
+                print(f"Control {self.name}: output failed: {e}", file=sys.stderr)
+        self.output = output
+    
+    def _record(self, t: float, measurement: float, output: float):
+        p, i, d, ff = self.pid.terms
+        slot = (self._trace_written % self.trace_len) * len(TRACE_FIELDS)
+        self._trace[slot:slot + len(TRACE_FIELDS)] = array(
+            'd', (t, self.pid.setpoint, measurement, output, p, i, d, ff))
+        self._trace_written += 1
+        buffers = self._buffers
+        buffers["t"].append(t)
+        buffers["sp"].append(self.pid.setpoint)
+        buffers["pv"].append(measurement)
+        buffers["out"].append(output)
+    
+    def _flush(self):
+        """Fold timing samples into the statistics and publish buffered traces."""
+        if self._pending_wake:
+            self._wake.update_block(self._pending_wake)
+            self._pending_wake = array('d')
+        if self._pending_jitter:
+            self._jitter.update_block(self._pending_jitter)
+            self._pending_jitter = array('d')
+        buffers = self._buffers
+        if not buffers["t"]:
+            return
+        self._buffers = {key: array('d') for key in buffers}
+        if self.bus is not None:
+            for key in ("sp", "pv", "out"):
+                self.bus.publish(SampleBlock(f"{self.name}.{key}", buffers["t"], buffers[key],
+                                             self.board))
+
+
+def make_output(spec: str, frequency: float = CONTROL_PWM_HZ, out_min: float = 0.0,
+                out_max: float = 1.0):
+    """Build (writer, device) for "pwm:<bcm>" or "gpio:<bcm>" on the J11 bank.
+
+    PWM maps out_min..out_max to 0..100 % duty; GPIO switches on above the
+    middle of the output range.
+    """
+    from hardware.gpio_bank import DigitalOutput, PWMOutput
+    match = _OUTPUT.match(spec.strip())
+    if not match:
+        raise ControlError(f"Output must be 'pwm:<bcm>' or 'gpio:<bcm>', got {spec!r}")
+    kind, pin = match.group(1), int(match.group(2))
+    if pin not in GPIO_BANK.values():
+        raise ControlError(f"BCM{pin} is not on the J11 GPIO bank "
+                           f"({', '.join(f'BCM{p}' for p in GPIO_BANK.values())})")
+    span = out_max - out_min
+    if kind == "pwm":
+        device = PWMOutput(pin, frequency)
+        return (lambda u: device.set_duty((u - out_min) / span)), device
+    device = DigitalOutput(pin)
+    middle = out_min + span / 2
+    return (lambda u: device.set_state(u > middle)), device
+
+
+class ControlSystem:
+    """Builds and runs the configured control loops."""
+    
+    def __init__(self, specs: List[dict], bus: Optional[SampleBus] = None, engine=None,
+                 derived=None, replay=None, realtime: bool = False):
+        """Create loops from CONTROL_LOOPS-style definitions.
+
+        Args:
+            specs: Loop definitions (name, input, output, rate_hz, setpoint, kp, ki, kd, ...)
+            bus: Bus for published traces
+            engine: AcquisitionEngine providing ADC inputs (latest values)
+            derived: DerivedChannels providing derived inputs
+            replay: CaptureReplayer providing ADC inputs when replaying
+            realtime: Run the loop threads SCHED_FIFO/pinned
+
+        Raises:
+            ControlError: A definition is invalid
+        """
+        self.engine = engine
+        self.derived = derived
+        self.replay = replay
+        self.loops: Dict[str, ControlLoop] = {}
+        self._devices = []
+        for spec in specs:
+            name = spec.get("name")
+            if not name or name in self.loops:
+                raise ControlError(f"Control loop needs a unique name: {spec!r}")
+            pid = PID(spec.get("kp", 0.0), spec.get("ki", 0.0), spec.get("kd", 0.0),
+                      spec.get("setpoint", 0.0), spec.get("out_min", 0.0),
+                      spec.get("out_max", 1.0), spec.get("ff_gain", 0.0),
+                      spec.get("ff_offset", 0.0), spec.get("d_filter_s", 0.0),
+                      spec.get("reverse", False))
+            writer, device = make_output(spec.get("output", ""), spec.get("pwm_hz", CONTROL_PWM_HZ),
+                                         pid.out_min, pid.out_max)
+            self._devices.append(device)
+            read_input, input_period = self._input(spec.get("input", ""))
+            max_age_s = spec.get("max_age_s", CONTROL_INPUT_MAX_AGE * input_period)
+            self.loops[name] = ControlLoop(name, pid, read_input, writer,
+                                           spec.get("rate_hz", 10.0), bus, realtime=realtime,
+                                           max_age_s=max_age_s)
+    
+    def _input(self, name: str) -> Tuple[Callable[[], Optional[Tuple[float, float]]], float]:
+        """(reader, seconds between updates) for an input channel."""
+        match = _PHYSICAL.match(name)
+        block_s = BLOCK_MS / 1000.0
+        if match and self.engine is not None:
+            return (latest_reader(self.engine.latest, self.engine.latest_t, int(match.group(1))),
+                    1.0 / self.engine.rate_hz)
+        if match and self.replay is not None:
+            return (latest_reader(self.replay.latest, self.replay.latest_t,
+                                  f"adc{match.group(1)}"), block_s)
+        if self.derived is not None and name in self.derived.units:
+            # Derived values follow the engine's blocks
+            if self.engine is not None:
+                block_s = max(block_s, 1.0 / self.engine.rate_hz)
+            return latest_reader(self.derived.latest, self.derived.latest_t, (0, name)), block_s
+        raise ControlError(f"Unknown control input {name!r} (adcN or a derived channel)")
+    
+    def start(self):
+        for loop in self.loops.values():
+            loop.start()
+    
+    def stop(self):
+        for loop in self.loops.values():
+            loop.stop()
+        for device in self._devices:
+            device.close()
+    
+    def get_stats(self) -> dict:
+        return {name: loop.get_stats() for name, loop in self.loops.items()}
+    
+    def snapshot(self, trace: Optional[int] = None) -> dict:
+        """Stats plus the last trace points of every loop (JSON-friendly)."""
+        return {name: {"stats": loop.get_stats(), "trace": loop.get_trace(trace)}
+                for name, loop in self.loops.items()}
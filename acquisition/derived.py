@@ -0,0 +1,495 @@
+"""Derived channels - user expressions over physical channels, evaluated block-wise.
+
+An expression such as "(adc0 - adc1) * 2.5" or "ntc(adc2)" is parsed once
+(Python ast, restricted grammar) and compiled into a flat plan of NumPy
+ufunc calls writing into preallocated scratch registers. Constant
+sub-expressions are folded at compile time, so evaluating a block costs
+one vectorized pass per operator and no Python work per sample. Nonlinear
+curves (thermistors, calibration tables) become lookup tables evaluated
+with np.interp.
+
+DerivedChannels lines up the input blocks of each board and publishes the
+results back onto the sample bus as ordinary SampleBlocks, so derived
+channels are displayed, recorded, streamed and usable in rules exactly
+like physical ones.
+
+Grammar:
+    numbers, pi, e
+    adc0..adcN (ch0..chN are aliases), and derived channels defined earlier
+    + - * / % **, unary -, comparisons < <= > >= == != (give 1.0 / 0.0)
+    abs sqrt exp log log10 sin cos tan floor ceil
+    min(a, b)  max(a, b)  clip(x, lo, hi)
+    poly(x, c0, c1, ...)    c0 + c1*x + c2*x**2 + ... (Horner)
+    table(x, "name")        piecewise-linear curve from DERIVED_TABLES
+    ntc(v, beta=3950, r25=10000, r_series=10000, vref=3.3)
+                            NTC thermistor in degC; NTC to GND, r_series to vref,
+                            v measured across the NTC
+"""
+
+import ast
+import math
+import re
+import sys
+import threading
+import time
+from array import array
+from collections import deque
+from typing import Dict, List, Optional, Sequence, Tuple
+
+import numpy as np
+
+from config.acquisition_config import DERIVED_CHANNELS, DERIVED_TABLES
+from .bus import SampleBlock, SampleBus
+
+_PHYSICAL = re.compile(r"(?:adc|ch)(\d+)$")
+
+_BINOPS = {
+    ast.Add: np.add,
+    ast.Sub: np.subtract,
+    ast.Mult: np.multiply,
+    ast.Div: np.divide,
+    ast.Mod: np.mod,
+    ast.Pow: np.power,
+}
+
+_COMPARE = {
+    ast.Lt: np.less,
+    ast.LtE: np.less_equal,
+    ast.Gt: np.greater,
+    ast.GtE: np.greater_equal,
+    ast.Eq: np.equal,
+    ast.NotEq: np.not_equal,
+}
+
+_FUNCTIONS = {
+    "abs": (np.abs, 1),
+    "sqrt": (np.sqrt, 1),
+    "exp": (np.exp, 1),
+    "log": (np.log, 1),
+    "log10": (np.log10, 1),
+    "sin": (np.sin, 1),
+    "cos": (np.cos, 1),
+    "tan": (np.tan, 1),
+    "floor": (np.floor, 1),
+    "ceil": (np.ceil, 1),
+    "min": (np.minimum, 2),
+    "max": (np.maximum, 2),
+    "clip": (np.clip, 3),
+}
+
+_CONSTANTS = {"pi": math.pi, "e": math.e}
+
+# ntc() parameters in positional order, with defaults
+_NTC_PARAMS = (("beta", 3950.0), ("r25", 10000.0), ("r_series", 10000.0), ("vref", 3.3))
+
+# Grid points of generated lookup tables
+LUT_POINTS = 1024
+
+
+class ExpressionError(ValueError):
+    """Expression could not be parsed or uses something unsupported."""
+
+
+class Lookup:
+    """Piecewise-linear curve, callable like a ufunc (x, out=...)."""
+    
+    def __init__(self, xp: Sequence[float], fp: Sequence[float]):
+        self.xp = np.asarray(xp, dtype=np.float64)
+        self.fp = np.asarray(fp, dtype=np.float64)
+        if self.xp.ndim != 1 or len(self.xp) < 2 or len(self.xp) != len(self.fp):
+            raise ExpressionError("Lookup table needs at least two (x, y) points")
+        if np.any(np.diff(self.xp) <= 0):
+            raise ExpressionError("Lookup table x values must be strictly increasing")
+    
+    def __call__(self, x, out=None):
+        result = np.interp(x, self.xp, self.fp)
+        if out is None:
+            return result
+        out[...] = result
+        return out
+
+
+def ntc_lookup(beta: float = 3950.0, r25: float = 10000.0, r_series: float = 10000.0,
+               vref: float = 3.3) -> Lookup:
+    """Lookup table from divider voltage to NTC temperature (beta model, degC)."""
+    volts = np.linspace(vref * 0.001, vref * 0.999, LUT_POINTS)
+    resistance = r_series * volts / (vref - volts)
+    kelvin = 1.0 / (1.0 / 298.15 + np.log(resistance / r25) / beta)
+    return Lookup(volts, kelvin - 273.15)
+
+
+def _as_float_array(values) -> np.ndarray:
+    """View a block's values as a float64 array (no copy where possible)."""
+    if hasattr(values, 'astype'):  # NumPy array
+        return values.astype(np.float64, copy=False)
+    if isinstance(values, array) and values.typecode == 'd':
+        return np.frombuffer(values, dtype=np.float64)
+    return np.asarray(values, dtype=np.float64)
+
+
+class Expression:
+    """A compiled expression: inputs, constants and a list of ufunc steps."""
+    
+    def __init__(self, source: str, derived: Sequence[str] = (),
+                 tables: Optional[Dict[str, Sequence[Tuple[float, float]]]] = None):
+        """Parse and compile an expression.
+
+        Args:
+            source: Expression text
+            derived: Names of derived channels that may be referenced
+            tables: Named curves for table(x, "name")
+
+        Raises:
+            ExpressionError: Syntax error, unknown name or unsupported construct
+        """
+        self.source = source
+        self._derived = set(derived)
+        self._tables = tables if tables is not None else DERIVED_TABLES
+        self.inputs: List[str] = []
+        self._constants: List[float] = []
+        self._registers = 0
+        self._free: List[int] = []
+        # (function, operand slots, output slot)
+        self.steps: List[Tuple[object, Tuple[int, ...], int]] = []
+        
+        try:
+            tree = ast.parse(source.strip(), mode="eval")
+        except SyntaxError as e:
+            raise ExpressionError(f"{source!r}: {e.msg} at column {e.offset}") from None
+        kind, value = self._compile(tree.body)
+        self._result_kind = kind
+        self._result = value
+        
+        # Slot layout: inputs, then constants, then scratch registers
+        self._const_base = len(self.inputs)
+        self._reg_base = self._const_base + len(self._constants)
+        self.steps = [(func, tuple(self._slot(op) for op in operands), self._slot(("reg", out)))
+                      for func, operands, out in self.steps]
+        self._scratch = [np.empty(0) for _ in range(self._registers)]
+    
+    def __repr__(self) -> str:
+        return f"Expression({self.source!r}, steps={len(self.steps)})"
+    
+    def evaluate(self, inputs: Sequence) -> np.ndarray:
+        """Evaluate over one block.
+
+        Args:
+            inputs: One array per name in self.inputs, all the same length
+
+        Returns:
+            New float64 array with the result
+        """
+        n = len(inputs[0]) if inputs else 1
+        if self._result_kind == "const":
+            return np.full(n, self._result)
+        if self._result_kind == "input":
+            return np.array(inputs[self._result], dtype=np.float64)
+        
+        if len(self._scratch) and len(self._scratch[0]) < n:
+            self._scratch = [np.empty(n) for _ in range(self._registers)]
+        registers = [buf[:n] for buf in self._scratch]
+        # The result register gets a fresh array so the published block owns it
+        registers[self._result] = np.empty(n)
+        slots = list(inputs) + self._constants + registers
+        with np.errstate(all="ignore"):
+            for func, operands, out in self.steps:
+                func(*[slots[i] for i in operands], out=slots[out])
+        return registers[self._result]
+    
+    def _slot(self, operand) -> int:
+        kind, value = operand
+        if kind == "input":
+            return value
+        if kind == "reg":
+            return self._reg_base + value
+        return self._const_base + value  # Index into self._constants
+    
+    def _error(self, node: ast.AST, message: str):
+        column = getattr(node, 'col_offset', 0) + 1
+        raise ExpressionError(f"{self.source!r}: {message} at column {column}")
+    
+    def _emit(self, func, operands: List[tuple], keep: Optional[tuple] = None) -> tuple:
+        """Add one step, or fold it if every operand is constant.
+
+        Operand registers are released for reuse (the output may overwrite
+        one of them in place) unless they are the keep operand.
+        """
+        if all(kind == "const" for kind, _ in operands):
+            with np.errstate(all="ignore"):
+                return ("const", float(func(*[value for _, value in operands])))
+        for operand in operands:
+            if operand[0] == "reg" and operand != keep and operand[1] not in self._free:
+                self._free.append(operand[1])
+        stored = []
+        for kind, value in operands:
+            if kind == "const":
+                self._constants.append(value)
+                kind, value = "constant", len(self._constants) - 1
+            stored.append((kind, value))
+        if self._free:
+            out = self._free.pop()
+        else:
+            out = self._registers
+            self._registers += 1
+        self.steps.append((func, stored, out))
+        return ("reg", out)
+    
+    def _compile(self, node: ast.AST) -> tuple:
+        if isinstance(node, ast.Constant):
+            if isinstance(node.value, bool) or not isinstance(node.value, (int, float)):
+                self._error(node, f"unsupported constant {node.value!r}")
+            return ("const", float(node.value))
+        
+        if isinstance(node, ast.Name):
+            return self._name(node)
+        
+        if isinstance(node, ast.BinOp):
+            func = _BINOPS.get(type(node.op))
+            if func is None:
+                self._error(node, f"unsupported operator {type(node.op).__name__}")
+            return self._emit(func, [self._compile(node.left), self._compile(node.right)])
+        
+        if isinstance(node, ast.UnaryOp):
+            operand = self._compile(node.operand)
+            if isinstance(node.op, ast.UAdd):
+                return operand
+            if isinstance(node.op, ast.USub):
+                return self._emit(np.negative, [operand])
+            self._error(node, f"unsupported operator {type(node.op).__name__}")
+        
+        if isinstance(node, ast.Compare):
+            if len(node.ops) != 1:
+                self._error(node, "chained comparisons are not supported")
+            func = _COMPARE[type(node.ops[0])] if type(node.ops[0]) in _COMPARE else None
+            if func is None:
+                self._error(node, f"unsupported comparison {type(node.ops[0]).__name__}")
+            return self._emit(func, [self._compile(node.left), self._compile(node.comparators[0])])
+        
+        if isinstance(node, ast.Call):
+            return self._call(node)
+        
+        self._error(node, f"unsupported syntax {type(node).__name__}")
+    
+    def _name(self, node: ast.Name) -> tuple:
+        name = node.id
+        if name in _CONSTANTS:
+            return ("const", _CONSTANTS[name])
+        match = _PHYSICAL.match(name)
+        if match:
+            name = f"adc{match.group(1)}"
+        elif name not in self._derived:
+            self._error(node, f"unknown channel {node.id!r}")
+        if name not in self.inputs:
+            self.inputs.append(name)
+        return ("input", self.inputs.index(name))
+    
+    def _call(self, node: ast.Call) -> tuple:
+        if not isinstance(node.func, ast.Name):
+            self._error(node, "only plain function calls are supported")
+        name = node.func.id
+        
+        if name == "table":
+            if len(node.args) != 2 or node.keywords:
+                self._error(node, 'table() takes (x, "name")')
+            key = node.args[1]
+            if not isinstance(key, ast.Constant) or not isinstance(key.value, str):
+                self._error(key, "table name must be a string")
+            if key.value not in self._tables:
+                self._error(key, f"unknown table {key.value!r}")
+            xp, fp = zip(*self._tables[key.value])
+            return self._emit(Lookup(xp, fp), [self._compile(node.args[0])])
+        
+        if name == "ntc":
+            if not node.args or len(node.args) > 1 + len(_NTC_PARAMS):
+                self._error(node, "ntc() takes (v, beta, r25, r_series, vref)")
+            params = dict(_NTC_PARAMS)
+            for (param, _), arg in zip(_NTC_PARAMS, node.args[1:]):
+                params[param] = self._constant(arg)
+            for keyword in node.keywords:
+                if keyword.arg not in params:
+                    self._error(node, f"ntc() has no parameter {keyword.arg!r}")
+                params[keyword.arg] = self._constant(keyword.value)
+            return self._emit(ntc_lookup(**params), [self._compile(node.args[0])])
+        
+        if name == "poly":
+            if len(node.args) < 2 or node.keywords:
+                self._error(node, "poly() takes (x, c0, c1, ...)")
+            x = self._compile(node.args[0])
+            coeffs = [self._constant(arg) for arg in node.args[1:]]
+            acc = ("const", coeffs[-1])
+            for coeff in reversed(coeffs[:-1]):
+                # x is read by every step, so its register stays allocated
+                acc = self._emit(np.multiply, [acc, x], keep=x)
+                acc = self._emit(np.add, [acc, ("const", coeff)])
+            if x[0] == "reg" and x != acc:
+                self._free.append(x[1])
+            return acc
+        
+        if name not in _FUNCTIONS:
+            self._error(node, f"unknown function {name!r}")
+        func, arity = _FUNCTIONS[name]
+        if len(node.args) != arity or node.keywords:
+            self._error(node, f"{name}() takes {arity} argument{'s' if arity > 1 else ''}")
+        return self._emit(func, [self._compile(arg) for arg in node.args])
+    
+    def _constant(self, node: ast.AST) -> float:
+        kind, value = self._compile(node)
+        if kind != "const":
+            self._error(node, "parameter must be a constant")
+        return value
+
+
+def parse_definitions(definitions: Dict[str, object]) -> List[Tuple[str, str, str]]:
+    """Normalize DERIVED_CHANNELS entries to (name, expression, unit)."""
+    parsed = []
+    for name, spec in definitions.items():
+        expression, unit = (spec, "") if isinstance(spec, str) else spec
+        if not name.isidentifier() or _PHYSICAL.match(name) or name in _CONSTANTS:
+            raise ExpressionError(f"Invalid derived channel name {name!r}")
+        parsed.append((name, expression, unit))
+    return parsed
+
+
+class DerivedChannels:
+    """Evaluates derived channels for every board and publishes them on the bus."""
+    
+    def __init__(self, bus: SampleBus, definitions: Optional[Dict[str, object]] = None,
+                 tables: Optional[Dict[str, Sequence[Tuple[float, float]]]] = None,
+                 max_pending: int = 16):
+        """Compile all definitions.
+
+        Args:
+            bus: Bus to read physical channels from and publish results to
+            definitions: name -> expression or (expression, unit); default DERIVED_CHANNELS
+            tables: Named curves for table(); default DERIVED_TABLES
+            max_pending: Blocks buffered per input while waiting for the other inputs
+
+        Raises:
+            ExpressionError: A definition does not compile
+        """
+        self.bus = bus
+        self.max_pending = max_pending
+        self.channels: List[Tuple[str, Expression]] = []
+        self.units: Dict[str, str] = {}
+        for name, source, unit in parse_definitions(
+                DERIVED_CHANNELS if definitions is None else definitions):
+            expression = Expression(source, [n for n, _ in self.channels], tables)
+            self.channels.append((name, expression))
+            self.units[name] = unit
+        # Physical channels needed to evaluate one cycle
+        self.inputs = sorted({name for _, expr in self.channels for name in expr.inputs
+                              if name not in self.units})
+        
+        # board -> input channel -> blocks waiting for the other inputs
+        self._pending: Dict[int, Dict[str, deque]] = {}
+        self._warned = False
+        # Most recent value per (board, derived channel) and the monotonic time it
+        # was computed
+        self.latest: Dict[Tuple[int, str], float] = {}
+        self.latest_t: Dict[Tuple[int, str], float] = {}
+        self._sub = None
+        self._stop = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+        
+        self.stats = {
+            "cycles": 0,
+            "samples": 0,
+            "misaligned": 0,
+            "dropped": 0,
+            "errors": 0,
+            "eval_ms_max": 0.0,
+        }
+    
+    @property
+    def names(self) -> List[str]:
+        return [name for name, _ in self.channels]
+    
+    def start(self):
+        if self._thread is not None or not self.channels:
+            return
+        self._stop.clear()
+        self._sub = self.bus.subscribe(maxlen=1024, events=False)
+        self._thread = threading.Thread(target=self._run, name="derived-channels", daemon=True)
+        self._thread.start()
+    
+    def stop(self, timeout: float = 2.0):
+        """Stop, evaluating whatever input is still queued."""
+        self._stop.set()
+        if self._thread is not None:
+            self._thread.join(timeout)
+            self._thread = None
+        if self._sub is not None:
+            self.update(self._sub.drain())
+            self._sub.close()
+            self._sub = None
+    
+    def get_stats(self) -> dict:
+        stats = dict(self.stats)
+        stats["channels"] = {name: expr.source for name, expr in self.channels}
+        stats["bus_dropped"] = self._sub.dropped if self._sub else 0
+        return stats
+    
+    def update(self, blocks: Sequence[SampleBlock]):
+        """Queue input blocks and evaluate every complete cycle (usable without the thread)."""
+        boards = set()
+        for block in blocks:
+            if not isinstance(block, SampleBlock) or block.channel not in self.inputs:
+                continue
+            queues = self._pending.get(block.board)
+            if queues is None:
+                queues = self._pending[block.board] = {name: deque() for name in self.inputs}
+            queue = queues[block.channel]
+            queue.append(block)
+            if len(queue) > self.max_pending:
+                # Another input never arrives (not sampled on this board?) - don't grow
+                queue.popleft()
+                self.stats["dropped"] += 1
+                if not self._warned:
+                    self._warned = True
+                    missing = [name for name, q in queues.items() if not q]
+                    print(f"Derived channels: board {block.board} is not delivering "
+                          f"{', '.join(missing)}", file=sys.stderr)
+            boards.add(block.board)
+        for board in boards:
+            self._evaluate(board)
+    
+    def _evaluate(self, board: int):
+        queues = self._pending[board]
+        while all(queues.values()):
+            blocks = [queues[name].popleft() for name in self.inputs]
+            n = min(len(block.values) for block in blocks)
+            if any(len(block.values) != n for block in blocks):
+                # A read error cost one channel a sample this cycle
+                self.stats["misaligned"] += 1
+            if not n:
+                continue
+            timestamps = blocks[0].timestamps[:n]
+            env = {block.channel: _as_float_array(block.values)[:n] for block in blocks}
+            
+            t0 = time.perf_counter()
+            results = []
+            for name, expr in self.channels:
+                try:
+                    values = expr.evaluate([env[i] for i in expr.inputs])
+                except Exception as e:
+                    self.stats["errors"] += 1
+                    if self.stats["errors"] == 1:
+                        print(f"Derived channels: {name} failed: {e}", file=sys.stderr)
+                    break
+                env[name] = values
+                results.append((name, values))
+            elapsed_ms = (time.perf_counter() - t0) * 1000.0
+            if elapsed_ms > self.stats["eval_ms_max"]:
+                self.stats["eval_ms_max"] = elapsed_ms
+            
+            for name, values in results:
+                self.bus.publish(SampleBlock(name, timestamps, values, board))
+                self.latest[(board, name)] = float(values[-1])
+                self.latest_t[(board, name)] = time.monotonic()
+                self.stats["samples"] += n
+            self.stats["cycles"] += 1
+    
+    def _run(self):
+        while not self._stop.is_set():
+            self._sub.wait(0.2)
+            self.update(self._sub.drain())
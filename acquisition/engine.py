@@ -0,0 +1,362 @@
+"""Acquisition engine - samples the hardware managers on a background thread.
+
+The engine owns the timing: it reads the ADC at a fixed rate against
+absolute deadlines, watches the buttons for edges and publishes blocks of
+samples and events on the SampleBus. Slow housekeeping (I2C presence scans,
+plugin polling) runs on a separate task thread so it never delays sampling.
+"""
+
+import sys
+import threading
+import time
+from array import array
+from typing import Callable, Dict, List, Optional
+
+from config.acquisition_config import (ADC_CHANNELS, ADC_SAMPLE_RATE_HZ, BLOCK_MS,
+                                       I2C_PRESENCE_PERIOD_S)
+from config.pins import BTN1, BTN2
+from . import realtime
+from .bus import Event, SampleBlock, SampleBus
+
+# Shortest loop period with a block source: each read returns everything due,
+# so waking faster than this only costs CPU
+BLOCK_SOURCE_MIN_PERIOD_S = 0.001
+
+
+def _join(parts: list):
+    """Concatenate array('d') or NumPy runs (one run is returned as is)."""
+    if len(parts) == 1:
+        return parts[0]
+    if isinstance(parts[0], array):
+        joined = array('d')
+        for part in parts:
+            joined.extend(part)
+        return joined
+    import numpy as np
+    return np.concatenate(parts)
+
+
+class _Task:
+    """Periodic housekeeping task."""
+    
+    def __init__(self, name: str, period: float, func: Callable[[], None]):
+        self.name = name
+        self.period = period
+        self.func = func
+        self.next_due = time.monotonic()
+        self.runs = 0
+        self.errors = 0
+
+
+class AcquisitionEngine:
+    """Background sampler that feeds a SampleBus."""
+    
+    def __init__(self, hardware, bus: SampleBus, rate_hz: float = ADC_SAMPLE_RATE_HZ,
+                 block_ms: float = BLOCK_MS, channels: Optional[List[int]] = None,
+                 board: int = 0, rules=None, realtime: bool = False):
+        """Initialize acquisition engine.
+
+        Args:
+            hardware: Hardware container (needs .adc, optionally .gpio and .i2c)
+            bus: Bus that receives sample blocks and events
+            rate_hz: Sample rate per ADC channel
+            block_ms: Publish interval for sample blocks
+            channels: ADC channels to sample (default: ADC_CHANNELS)
+            board: Board ID stamped on everything this engine publishes
+            rules: Optional RuleEngine fed with every sample right after the read
+            realtime: Run the sampling thread SCHED_FIFO/pinned (see acquisition/realtime.py)
+        """
+        self.hardware = hardware
+        self.bus = bus
+        self.rate_hz = rate_hz
+        self.block_ms = block_ms
+        self.channels = list(ADC_CHANNELS if channels is None else channels)
+        self.board = board
+        self.rules = rules
+        self.realtime = realtime
+        
+        self._stop = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+        self._task_thread: Optional[threading.Thread] = None
+        self._tasks: List[_Task] = []
+        self._task_lock = threading.Lock()
+        
+        self._timestamps: Dict[int, array] = {}
+        self._values: Dict[int, array] = {}
+        # (timestamps, values) read from a block source since the last publish
+        self._chunks: List[tuple] = []
+        self._reset_buffers()
+        
+        # Button pin -> button id, and last seen state for edge detection
+        self._buttons = {BTN1: 1, BTN2: 2}
+        self._button_states: Dict[int, bool] = {}
+        self._i2c_present: Optional[set] = None
+        
+        # Most recent value per channel (cheap access for UI polling) and the
+        # monotonic time it was read (control loops check its age)
+        self.latest: Dict[int, float] = {}
+        self.latest_t: Dict[int, float] = {}
+        
+        # (deadline, wake) pairs of every loop iteration when set to an array('d');
+        # consumers take complete pairs with del tick_log[:n] (benchmarks/loop_latency.py)
+        self.tick_log: Optional[array] = None
+        
+        self.stats = {
+            "loops": 0,
+            "samples": 0,
+            "blocks": 0,
+            "events": 0,
+            "overruns": 0,
+            "read_errors": 0,
+            "max_late_ms": 0.0,
+        }
+        
+        if I2C_PRESENCE_PERIOD_S and getattr(hardware, 'i2c', None) is not None:
+            self.add_task("i2c_presence", I2C_PRESENCE_PERIOD_S, self._scan_presence)
+    
+    def add_task(self, name: str, period: float, func: Callable[[], None]):
+        """Run func every period seconds on the housekeeping thread."""
+        with self._task_lock:
+            self._tasks.append(_Task(name, period, func))
+    
+    def remove_task(self, name: str):
+        """Remove a housekeeping task by name."""
+        with self._task_lock:
+            self._tasks = [t for t in self._tasks if t.name != name]
+    
+    @property
+    def running(self) -> bool:
+        return self._thread is not None and self._thread.is_alive()
+    
+    def start(self):
+        """Start the sampling and housekeeping threads."""
+        if self.running:
+            return
+        self._stop.clear()
+        self._thread = threading.Thread(target=self._run, name="acquisition", daemon=True)
+        self._task_thread = threading.Thread(target=self._run_tasks, name="acquisition-tasks",
+                                             daemon=True)
+        self._thread.start()
+        self._task_thread.start()
+    
+    def stop(self, timeout: float = 2.0):
+        """Stop both threads and publish whatever is still buffered."""
+        self._stop.set()
+        for thread in (self._thread, self._task_thread):
+            if thread is not None:
+                thread.join(timeout)
+        self._thread = None
+        self._task_thread = None
+        self._flush()
+    
+    def get_stats(self) -> dict:
+        """Snapshot of engine counters."""
+        stats = dict(self.stats)
+        stats["rate_hz"] = self.rate_hz
+        stats["block_ms"] = self.block_ms
+        stats["channels"] = list(self.channels)
+        stats["tasks"] = {t.name: {"runs": t.runs, "errors": t.errors} for t in self._tasks}
+        if self.rules is not None:
+            stats["rules"] = self.rules.get_stats()
+        if self.realtime:
+            stats["realtime"] = realtime.report()
+        adc_stats = getattr(self.hardware.adc, 'get_stats', None)
+        if adc_stats is not None:
+            stats["adc_timing"] = adc_stats()
+        i2c_stats = getattr(getattr(self.hardware, 'i2c', None), 'get_stats', None)
+        if i2c_stats is not None:
+            stats["i2c"] = i2c_stats()
+        return stats
+    
+    def _reset_buffers(self):
+        self._timestamps = {ch: array('d') for ch in self.channels}
+        self._values = {ch: array('d') for ch in self.channels}
+    
+    def _run(self):
+        """Sampling loop with absolute deadlines (no cumulative drift)."""
+        if self.realtime:
+            realtime.configure_thread("acquisition")
+        block_s = self.block_ms / 1000.0
+        # Block sources (e.g. SyntheticADC, TimedADC) deliver every sample due
+        # per call, but the loop still wakes at the sample rate - and within the
+        # rules' latency budget - so buttons and rules keep a per-sample cadence;
+        # the samples are published once per block either way
+        read_block = getattr(self.hardware.adc, 'read_block', None)
+        period = 1.0 / self.rate_hz
+        if read_block:
+            period = min(period, block_s)
+            if self.rules is not None:
+                period = min(period, self.rules.latency_budget_ms / 2000.0)
+            period = max(period, BLOCK_SOURCE_MIN_PERIOD_S)
+        next_tick = time.monotonic()
+        next_flush = next_tick + block_s
+        
+        while not self._stop.is_set():
+            delay = next_tick - time.monotonic()
+            if delay > 0 and self._stop.wait(delay):
+                break
+            
+            now = time.monotonic()
+            if self.tick_log is not None:
+                self.tick_log.extend((next_tick, now))
+            late_ms = (now - next_tick) * 1000.0
+            if late_ms > self.stats["max_late_ms"]:
+                self.stats["max_late_ms"] = late_ms
+            
+            if read_block:
+                self._sample_block(read_block, now)
+            else:
+                self._sample()
+            self._poll_gpio(now)
+            
+            if now >= next_flush:
+                self._flush()
+                next_flush += block_s
+                if next_flush <= now:
+                    next_flush = now + block_s
+            
+            self.stats["loops"] += 1
+            next_tick += period
+            if next_tick <= time.monotonic():
+                # Missed at least one deadline - skip ahead instead of bursting
+                self.stats["overruns"] += 1
+                next_tick = time.monotonic() + period
+    
+    def _sample(self):
+        """Read every channel once, stamping each read at its midpoint."""
+        adc = self.hardware.adc
+        rules = self.rules
+        for ch in self.channels:
+            t_start = time.monotonic()
+            try:
+                value = adc.read_channel(ch)
+            except Exception as e:
+                self.stats["read_errors"] += 1
+                if self.stats["read_errors"] == 1:
+                    print(f"Acquisition: ADC read error (channel {ch}): {e}", file=sys.stderr)
+                continue
+            if value is None:
+                continue
+            t = (t_start + time.monotonic()) * 0.5
+            self._timestamps[ch].append(t)
+            self._values[ch].append(value)
+            self.latest[ch] = value
+            self.latest_t[ch] = t
+            self.stats["samples"] += 1
+            if rules is not None:
+                rules.feed_sample(ch, t, value)
+    
+    def _sample_block(self, read_block, now: float):
+        """Take every sample a block source has due; rules see them right away."""
+        try:
+            timestamps, values = read_block(now)
+        except Exception as e:
+            self.stats["read_errors"] += 1
+            if self.stats["read_errors"] == 1:
+                print(f"Acquisition: ADC block read error: {e}", file=sys.stderr)
+            return
+        # One timestamp array shared by all channels, or one per channel (TimedADC)
+        per_channel = isinstance(timestamps, dict)
+        if not per_channel and not len(timestamps):
+            return
+        added = False
+        for ch in self.channels:
+            data = values.get(ch)
+            stamps = timestamps.get(ch) if per_channel else timestamps
+            if data is None or not len(data):
+                continue
+            added = True
+            self.latest[ch] = float(data[-1])
+            self.latest_t[ch] = now
+            self.stats["samples"] += len(data)
+            if self.rules is not None:
+                self.rules.feed_block(ch, stamps, data)
+        if added:
+            self._chunks.append((timestamps, values))
+    
+    def _publish_chunks(self):
+        """Publish the block-source reads since the last flush, one block per channel."""
+        chunks, self._chunks = self._chunks, []
+        per_channel = isinstance(chunks[0][0], dict)
+        shared = None if per_channel else _join([timestamps for timestamps, _ in chunks])
+        for ch in self.channels:
+            parts = [(timestamps.get(ch) if per_channel else timestamps, values.get(ch))
+                     for timestamps, values in chunks]
+            parts = [(stamps, data) for stamps, data in parts if data is not None and len(data)]
+            if not parts:
+                continue
+            if per_channel or len(parts) < len(chunks):
+                stamps = _join([stamps for stamps, _ in parts])
+            else:
+                stamps = shared
+            data = _join([data for _, data in parts])
+            self.bus.publish(SampleBlock(f"adc{ch}", stamps, data, self.board))
+            self.stats["blocks"] += 1
+    
+    def _poll_gpio(self, now: float):
+        """Publish an event whenever a button changes state."""
+        gpio = getattr(self.hardware, 'gpio', None)
+        if gpio is None:
+            return
+        if hasattr(gpio, 'read_edges'):
+            # Edge source with exact edge times (e.g. SyntheticGPIO)
+            pins = {button_id: pin for pin, button_id in self._buttons.items()}
+            for t, button_id, pressed in gpio.read_edges(now):
+                if button_id in pins:
+                    self._publish_event(Event("gpio", t, pins[button_id], int(pressed),
+                                              self.board))
+            return
+        for pin, button_id in self._buttons.items():
+            try:
+                pressed = bool(gpio.get_button(button_id))
+            except Exception:
+                continue
+            previous = self._button_states.get(pin)
+            self._button_states[pin] = pressed
+            if previous is not None and previous != pressed:
+                self._publish_event(Event("gpio", now, pin, int(pressed), self.board))
+    
+    def _flush(self):
+        """Publish buffered samples as one block per channel."""
+        if self._chunks:
+            self._publish_chunks()
+        timestamps, values = self._timestamps, self._values
+        self._reset_buffers()
+        for ch in self.channels:
+            if timestamps[ch]:
+                self.bus.publish(SampleBlock(f"adc{ch}", timestamps[ch], values[ch], self.board))
+                self.stats["blocks"] += 1
+    
+    def _publish_event(self, event: Event):
+        self.bus.publish(event)
+        self.stats["events"] += 1
+    
+    def _run_tasks(self):
+        """Housekeeping loop - runs due tasks, sleeps until the next one."""
+        while not self._stop.is_set():
+            with self._task_lock:
+                tasks = list(self._tasks)
+            now = time.monotonic()
+            next_due = now + 0.5
+            for task in tasks:
+                if task.next_due <= now:
+                    try:
+                        task.func()
+                    except Exception as e:
+                        task.errors += 1
+                        print(f"Acquisition: task {task.name} failed: {e}", file=sys.stderr)
+                    task.runs += 1
+                    task.next_due = max(task.next_due + task.period, time.monotonic())
+                next_due = min(next_due, task.next_due)
+            self._stop.wait(max(0.0, next_due - time.monotonic()))
+    
+    def _scan_presence(self):
+        """Scan the I2C bus and publish devices that appeared or vanished."""
+        found = set(self.hardware.i2c.scan())
+        now = time.monotonic()
+        if self._i2c_present is not None:
+            for addr in sorted(found - self._i2c_present):
+                self._publish_event(Event("i2c", now, addr, 1, self.board))
+            for addr in sorted(self._i2c_present - found):
+                self._publish_event(Event("i2c", now, addr, 0, self.board))
+        self._i2c_present = found
@@ -0,0 +1,269 @@
+"""IMU streaming - drains MPU6050/MPU6500 FIFOs on a thread and publishes blocks.
+
+Each IMUStream owns one sensor (hardware/imu.py) and a reader thread that
+empties the FIFO every IMU_BATCH_MS, decodes each drain with one vectorized
+pass and publishes one SampleBlock per axis every BLOCK_MS, like the engine.
+
+Sample stamps come from the sensor's own sample grid, not from when a drain
+happened to run:
+
+    INT pin     DATA_RDY pulses INT for every sample; the edges are
+                timestamped by the kernel (EdgeInput) and fitted by a
+                DriftEstimator, and packets take the fitted edge times in
+                FIFO order. The reader sleeps on the edges and drains once a
+                batch worth has arrived, so no polling.
+    no pin      drains run on a timer; the newest packet in a drain was
+                sampled during the last sample period before FIFO_COUNT was
+                read, and the packet count since the previous drain is exact,
+                so the estimator fits those times against the counted packets
+                and earlier packets are spaced by the fitted period.
+
+Either way the sensor's clock error (about +-1 % on the internal
+oscillator) is measured and reported in ppm instead of distorting the
+timeline. An overflow (the reader fell behind by a whole FIFO) is counted,
+the FIFO is reset and stamping restarts from the next edge or drain.
+"""
+
+import sys
+import threading
+import time
+from collections import deque
+from typing import Dict, List, Optional
+
+from config.acquisition_config import (ADC_DRIFT_TAU_S, BLOCK_MS, IMU_ACCEL_RANGE_G,
+                                       IMU_BATCH_MS, IMU_DLPF_HZ, IMU_GYRO_RANGE_DPS,
+                                       IMU_RATE_HZ)
+from .bus import SampleBlock, SampleBus
+from .timing import DriftEstimator, raw_clock, raw_to_monotonic
+
+
+class IMUStream:
+    """FIFO-streamed MPU6050/MPU6500 publishing <name>_ax ... <name>_gz on a SampleBus."""
+    
+    def __init__(self, bus: SampleBus, imu, name: str = "imu", rate_hz: float = IMU_RATE_HZ,
+                 accel_range_g: int = IMU_ACCEL_RANGE_G,
+                 gyro_range_dps: int = IMU_GYRO_RANGE_DPS, dlpf_hz: Optional[float] = IMU_DLPF_HZ,
+                 temperature: bool = False, ready=None, int_pin: Optional[int] = None,
+                 batch_ms: float = IMU_BATCH_MS, block_ms: float = BLOCK_MS, board: int = 0):
+        """Initialize stream (the sensor is configured in start()).
+
+        Args:
+            bus: Bus that receives the sample blocks
+            imu: hardware.imu.MPU6050 (real or on a virtual device)
+            name: Channel prefix
+            rate_hz: Output data rate (rounded to what SMPLRT_DIV can do)
+            accel_range_g: Accelerometer full scale
+            gyro_range_dps: Gyro full scale
+            dlpf_hz: Low-pass bandwidth; None = widest below rate / 2
+            temperature: Also stream <name>_temp
+            ready: EdgeInput-like object for INT (read(timeout) -> edge times)
+            int_pin: BCM pin wired to INT for an EdgeInput when ready isn't given
+            batch_ms: FIFO drain interval
+            block_ms: Publish interval
+            board: Board ID stamped on the blocks
+        """
+        self.bus = bus
+        self.imu = imu
+        self.name = name
+        self.rate_hz = rate_hz
+        self.accel_range_g = accel_range_g
+        self.gyro_range_dps = gyro_range_dps
+        self.dlpf_hz = dlpf_hz
+        self.temperature = temperature
+        if ready is None and int_pin is not None:
+            from hardware.gpio_bank import EdgeInput
+            ready = EdgeInput(int_pin)
+        self.ready = ready
+        self.batch_s = batch_ms / 1000.0
+        self.block_s = block_ms / 1000.0
+        self.board = board
+        self.settings: dict = {}
+        self.estimator: Optional[DriftEstimator] = None
+        self.latest: Dict[str, float] = {}
+        self.stats = {"packets": 0, "drains": 0, "overflows": 0, "read_errors": 0,
+                      "timeouts": 0, "bytes": 0, "read_s": 0.0, "max_read_ms": 0.0,
+                      "max_fill": 0.0, "blocks": 0}
+        
+        self._timestamps: List = []
+        self._values: List = []
+        self._edges = deque()  # Fitted edge times not matched to a packet yet (raw clock)
+        self._discard_before = 0.0
+        self._last_stamp: Optional[float] = None
+        self._started = 0.0
+        self._stop = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+    
+    @classmethod
+    def from_spec(cls, spec: dict, bus: SampleBus, index: int = 0) -> "IMUStream":
+        """Stream for one IMU_STREAMS entry (opens the sensor on the spec's I2C bus)."""
+        from hardware.imu import MPU6050
+        options = dict(spec)
+        imu = MPU6050(options.pop("bus"), options.pop("address", 0x68))
+        options.setdefault("name", "imu" if index == 0 else f"imu{index}")
+        return cls(bus, imu, **options)
+    
+    @property
+    def channels(self) -> List[str]:
+        return [f"{self.name}_{column}" for column in self.imu.columns]
+    
+    @property
+    def running(self) -> bool:
+        return self._thread is not None and self._thread.is_alive()
+    
+    def start(self) -> dict:
+        """Configure the sensor and start draining; returns the applied settings."""
+        if self._thread is not None:
+            return self.settings
+        self.settings = self.imu.configure(self.rate_hz, self.accel_range_g,
+                                           self.gyro_range_dps, self.dlpf_hz,
+                                           temperature=self.temperature,
+                                           data_ready=self.ready is not None)
+        # Edges of samples taken before the FIFO (re)started have no packet
+        self._discard_before = raw_clock()
+        period = 1.0 / self.imu.rate_hz
+        # At most half the FIFO per drain, so a late wakeup doesn't overflow it
+        capacity = self.imu.fifo_size // self.imu.packet
+        self._batch = max(1, min(capacity // 2, round(self.batch_s / period)))
+        if self.ready is not None:
+            self.estimator = DriftEstimator(period)
+        else:
+            # One observation per drain instead of per sample: keep the same time
+            # constant, and accept the scheduling jitter of the drain itself
+            self.estimator = DriftEstimator(period, tau_s=ADC_DRIFT_TAU_S / self._batch,
+                                            gate=max(20.0, 4.0 * self._batch))
+        self._started = time.monotonic()
+        self._stop.clear()
+        self._thread = threading.Thread(target=self._run, name=f"imu-{self.name}",
+                                        daemon=True)
+        self._thread.start()
+        return self.settings
+    
+    def stop(self, timeout: float = 2.0):
+        self._stop.set()
+        if self._thread is not None:
+            self._thread.join(timeout)
+            self._thread = None
+        self._publish()
+        if self.ready is not None:
+            self.ready.close()
+    
+    def get_stats(self) -> dict:
+        stats = dict(self.stats)
+        elapsed = time.monotonic() - self._started if self._started else 0.0
+        drains = stats["drains"]
+        stats.update(self.settings)
+        stats.update({
+            "name": self.name, "address": f"0x{self.imu.address:02X}",
+            "int_pin": self.ready is not None,
+            "achieved_hz": stats["packets"] / elapsed if elapsed > 0 else 0.0,
+            "mean_read_ms": 1000.0 * stats["read_s"] / drains if drains else 0.0,
+            "bytes_per_s": stats["bytes"] / elapsed if elapsed > 0 else 0.0,
+        })
+        if self.estimator is not None:
+            stats["clock_ppm"] = self.estimator.ppm
+            stats["residual_us"] = self.estimator.residual_us
+        return stats
+    
+    # Reader thread -------------------------------------------------------------
+    
+    def _run(self):
+        period = 1.0 / self.imu.rate_hz
+        batch_s = self._batch * period
+        next_drain = raw_clock() + batch_s
+        next_publish = time.monotonic() + self.block_s
+        while not self._stop.is_set():
+            if self.ready is not None:
+                edges = self.ready.read(batch_s * 2)
+                if edges:
+                    offset = raw_to_monotonic()
+                    # Edges older than the last stamp belong to packets already
+                    # stamped by extending the grid
+                    newer = max(self._discard_before, (self._last_stamp or 0.0) + period * 0.5)
+                    for edge in edges:
+                        fitted = self.estimator.add(edge - offset)
+                        if fitted > newer:
+                            self._edges.append(fitted)
+                else:
+                    self.stats["timeouts"] += 1
+                if edges and len(self._edges) < self._batch:
+                    continue
+            else:
+                delay = next_drain - raw_clock()
+                if delay > 0 and self._stop.wait(delay):
+                    break
+                next_drain += batch_s
+                if next_drain <= raw_clock():
+                    next_drain = raw_clock() + batch_s
+            self._drain(period)
+            if time.monotonic() >= next_publish:
+                self._publish()
+                next_publish = time.monotonic() + self.block_s
+    
+    def _drain(self, period: float):
+        import numpy as np
+        
+        start = raw_clock()
+        try:
+            data, count, overflow = self.imu.drain()
+        except OSError as e:
+            self.stats["read_errors"] += 1
+            if self.stats["read_errors"] == 1:
+                print(f"IMU {self.name}: read error: {e}", file=sys.stderr)
+            return
+        elapsed = raw_clock() - start
+        stats = self.stats
+        stats["drains"] += 1
+        stats["read_s"] += elapsed
+        stats["max_read_ms"] = max(stats["max_read_ms"], elapsed * 1000.0)
+        stats["max_fill"] = max(stats["max_fill"], count / self.imu.fifo_size)
+        if overflow:
+            stats["overflows"] += 1
+            if stats["overflows"] == 1:
+                print(f"IMU {self.name}: FIFO overflow, reset", file=sys.stderr)
+            # Everything up to the reset is gone; stamping restarts with the next packet
+            self._edges.clear()
+            self._discard_before = raw_clock()
+            self._last_stamp = None
+            if self.ready is None:
+                self.estimator.reset()
+            return
+        if not data:
+            return
+        values = self.imu.decode(data)
+        n = len(values)
+        
+        edges = self._edges
+        if self.ready is not None and (edges or self._last_stamp is not None):
+            # Packets take the edge times in FIFO order; edges not seen yet
+            # (read before they were queued) continue the grid
+            stamps = np.empty(n)
+            last = self._last_stamp
+            for i in range(n):
+                last = edges.popleft() if edges else last + self.estimator.period
+                stamps[i] = last
+        elif self.ready is not None:
+            # No edge yet (INT not wired?): the packets end just before the count read
+            stamps = start - period * (np.arange(n - 1, -1, -1) + 0.5)
+        else:
+            # The newest packet was sampled within the period before the count read
+            newest = self.estimator.add(start - period * 0.5, steps=n)
+            stamps = newest - self.estimator.period * np.arange(n - 1, -1, -1)
+        self._last_stamp = float(stamps[-1])
+        self._timestamps.append(stamps)
+        self._values.append(values)
+        stats["packets"] += n
+        stats["bytes"] += len(data)
+    
+    def _publish(self):
+        import numpy as np
+        
+        if not self._timestamps:
+            return
+        timestamps = np.concatenate(self._timestamps) + raw_to_monotonic()
+        values = np.concatenate(self._values)
+        self._timestamps, self._values = [], []
+        for column, channel in enumerate(self.channels):
+            data = np.ascontiguousarray(values[:, column])
+            self.bus.publish(SampleBlock(channel, timestamps, data, self.board))
+            self.latest[channel] = float(data[-1])
+            self.stats["blocks"] += 1
@@ -0,0 +1,220 @@
+"""Multi-board acquisition - one worker per extra shield, merged onto one bus.
+
+Lab hosts drive several shields through additional I2C adapters (USB-I2C
+bridges appear as more /dev/i2c-N). Each extra board gets a BoardContext
+(its own ADC and I2C scanner on that adapter) and its own AcquisitionEngine
+running in a worker process, so boards sample in parallel on separate cores
+and never share the GIL. Workers batch their bus output once per block and
+send it to the parent, which republishes it on the main bus. Every block and
+event already carries the board ID stamped by the worker's engine.
+
+Board specs are strings:
+    "20"            ADS1115 at the default address on /dev/i2c-20
+    "20:0x49"       explicit address
+    "mock"          per-sample MockADC (Python read cost, no hardware)
+    "synthetic"     block-rate SignalGenerator (needs NumPy)
+
+Buttons and LEDs stay on the host's own header (board 0).
+"""
+
+import multiprocessing
+import queue
+import sys
+import threading
+import time
+from typing import Dict, List, Optional, Tuple
+
+from config.acquisition_config import ADC_CHANNELS, ADC_SAMPLE_RATE_HZ, BLOCK_MS
+from config.pins import ADC_ADDRESS
+from .bus import SampleBus
+
+STATS_PERIOD_S = 1.0
+
+
+def parse_board(spec: str) -> Tuple[Optional[int], int]:
+    """Parse a board spec into (bus, address); bus is None for mock/synthetic."""
+    if spec in ("mock", "synthetic"):
+        return None, ADC_ADDRESS
+    bus, _, address = spec.partition(":")
+    return int(bus), int(address, 0) if address else ADC_ADDRESS
+
+
+class BoardContext:
+    """Hardware container for one extra board (what AcquisitionEngine needs)."""
+    
+    def __init__(self, spec: str, board_id: int, rate_hz: float):
+        bus, address = parse_board(spec)
+        self.spec = spec
+        self.board_id = board_id
+        if spec == "synthetic":
+            from mock.signal_generator import SignalGenerator, SyntheticADC
+            self.adc = SyntheticADC(SignalGenerator(rate_hz, seed=board_id))
+            self.i2c = None
+        elif spec == "mock":
+            from mock.mock_hardware import MockADC
+            self.adc = MockADC()
+            self.i2c = None
+        else:
+            from hardware.adc_manager import ADCManager
+            from hardware.i2c_scanner import I2CScanner
+            self.adc = ADCManager(bus=bus, address=address)
+            self.i2c = I2CScanner(bus=bus)
+
+
+def _board_worker(spec: str, board_id: int, rate_hz: float, block_ms: float,
+                  channels: List[int], out, stop):
+    """Run one board's engine and forward its bus output in batches.
+
+    Runs in a child process (or a thread in thread mode); out is a queue,
+    stop an event.
+    """
+    from acquisition.engine import AcquisitionEngine
+    
+    try:
+        context = BoardContext(spec, board_id, rate_hz)
+    except Exception as e:
+        out.put(("error", board_id, f"{spec}: {e}"))
+        return
+    bus = SampleBus()
+    sub = bus.subscribe(maxlen=8192)
+    engine = AcquisitionEngine(context, bus, rate_hz=rate_hz, block_ms=block_ms,
+                               channels=channels, board=board_id)
+    engine.start()
+    next_stats = time.monotonic() + STATS_PERIOD_S
+    try:
+        while not stop.is_set():
+            sub.wait(block_ms / 1000.0)
+            items = sub.drain()
+            if items:
+                out.put(("data", board_id, items))
+            if time.monotonic() >= next_stats:
+                next_stats += STATS_PERIOD_S
+                out.put(("stats", board_id, dict(engine.get_stats(), dropped=sub.dropped,
+                                                 cpu_s=time.process_time())))
+    except KeyboardInterrupt:
+        pass
+    finally:
+        engine.stop()
+        items = sub.drain()
+        if items:
+            out.put(("data", board_id, items))
+        out.put(("stats", board_id, dict(engine.get_stats(), dropped=sub.dropped,
+                                         cpu_s=time.process_time())))
+        out.put(("done", board_id, None))
+
+
+class MultiBoardAcquisition:
+    """Runs extra boards in workers and merges them onto a SampleBus."""
+    
+    def __init__(self, specs: List[str], bus: SampleBus, rate_hz: float = ADC_SAMPLE_RATE_HZ,
+                 block_ms: float = BLOCK_MS, channels: Optional[List[int]] = None,
+                 first_board_id: int = 1, mode: str = "process"):
+        """Initialize multi-board acquisition.
+
+        Args:
+            specs: Board specs (see module docstring), one per extra board
+            bus: Main bus that receives every board's blocks and events
+            rate_hz: Sample rate per channel on each board
+            block_ms: Publish interval for sample blocks
+            channels: ADC channels to sample (default: ADC_CHANNELS)
+            first_board_id: Board ID of specs[0]; the host's own board is 0
+            mode: "process" (one process per board) or "thread" (in-process)
+        """
+        self.specs = list(specs)
+        self.bus = bus
+        self.rate_hz = rate_hz
+        self.block_ms = block_ms
+        self.channels = list(ADC_CHANNELS if channels is None else channels)
+        self.board_ids = [first_board_id + i for i in range(len(self.specs))]
+        self.mode = mode
+        
+        self.board_stats: Dict[int, dict] = {}
+        self.errors: Dict[int, str] = {}
+        self.merged = {"batches": 0, "blocks": 0, "samples": 0, "events": 0,
+                       "max_merge_ms": 0.0}
+        self._workers = []
+        self._queue = None
+        self._stop = None
+        self._receiver: Optional[threading.Thread] = None
+        self._running = False
+    
+    def start(self):
+        """Start one worker per board plus the merge thread."""
+        if self._running:
+            return
+        if self.mode == "process":
+            # forkserver: safe to start from a process that already runs threads (Qt, engine)
+            methods = multiprocessing.get_all_start_methods()
+            ctx = multiprocessing.get_context("forkserver" if "forkserver" in methods else "spawn")
+            self._queue, self._stop = ctx.Queue(), ctx.Event()
+            make = ctx.Process
+        else:
+            self._queue, self._stop = queue.Queue(), threading.Event()
+            make = threading.Thread
+        for spec, board_id in zip(self.specs, self.board_ids):
+            worker = make(target=_board_worker, name=f"board-{board_id}", daemon=True,
+                          args=(spec, board_id, self.rate_hz, self.block_ms, self.channels,
+                                self._queue, self._stop))
+            worker.start()
+            self._workers.append(worker)
+        self._running = True
+        self._receiver = threading.Thread(target=self._merge, name="board-merge", daemon=True)
+        self._receiver.start()
+    
+    def stop(self, timeout: float = 3.0):
+        """Stop all workers; their final output is still merged."""
+        if not self._running:
+            return
+        self._stop.set()
+        for worker in self._workers:
+            worker.join(timeout)
+        if self._receiver is not None:
+            self._receiver.join(timeout)
+        for worker in self._workers:
+            if self.mode == "process" and worker.is_alive():
+                worker.terminate()
+        self._workers = []
+        self._running = False
+    
+    def get_stats(self) -> dict:
+        return {
+            "boards": {board_id: {"spec": spec, **self.board_stats.get(board_id, {}),
+                                  **({"error": self.errors[board_id]}
+                                     if board_id in self.errors else {})}
+                       for spec, board_id in zip(self.specs, self.board_ids)},
+            "merged": dict(self.merged),
+            "mode": self.mode,
+        }
+    
+    def _merge(self):
+        """Republish worker batches on the main bus until every worker is done."""
+        pending = set(self.board_ids)
+        while pending:
+            try:
+                kind, board_id, payload = self._queue.get(timeout=0.2)
+            except queue.Empty:
+                if self._stop.is_set() and not any(w.is_alive() for w in self._workers):
+                    break
+                continue
+            if kind == "data":
+                now = time.monotonic()
+                for item in payload:
+                    self.bus.publish(item)
+                    if hasattr(item, "values"):
+                        self.merged["blocks"] += 1
+                        self.merged["samples"] += len(item.values)
+                        if len(item.timestamps):
+                            merge_ms = float(now - item.timestamps[-1]) * 1000.0
+                            if merge_ms > self.merged["max_merge_ms"]:
+                                self.merged["max_merge_ms"] = merge_ms
+                    else:
+                        self.merged["events"] += 1
+                self.merged["batches"] += 1
+            elif kind == "stats":
+                self.board_stats[board_id] = payload
+            elif kind == "error":
+                self.errors[board_id] = payload
+                print(f"Multi-board: board {board_id} failed: {payload}", file=sys.stderr)
+                pending.discard(board_id)
+            elif kind == "done":
+                pending.discard(board_id)
@@ -0,0 +1,190 @@
+"""Pressure sensor polling - any number of BMP280/BME280s on the engine's task thread.
+
+One poll reads every sensor with a single burst (hardware/bme280.py) and
+compensates all of them in one vectorized pass, with the calibrations
+stacked into arrays, so a dozen sensors across both buses cost about a
+dozen 8-byte transfers per poll and no per-sensor Python arithmetic.
+
+Forced mode is pipelined: each poll reads the measurement the previous poll
+triggered (finished long ago, as choose_settings() keeps it well inside the
+period) and triggers the next one, so the poll never waits on a
+conversion. Samples are stamped at the middle of their measurement. In
+normal mode the sensors free-run and a poll reads the newest result,
+stamped at the read.
+
+Polls run as an AcquisitionEngine task rather than on a thread of their own;
+samples are buffered and published as one SampleBlock per channel every
+block_ms: <name>_p (hPa), <name>_t (degC) and, on a BME280, <name>_rh (%).
+"""
+
+import time
+from typing import Dict, List, Tuple
+
+from config.acquisition_config import (BLOCK_MS, PRESSURE_IIR, PRESSURE_MODE,
+                                       PRESSURE_RATE_HZ)
+from .bus import SampleBlock, SampleBus
+
+
+class PressurePoller:
+    """Polls BMP280/BME280 sensors and publishes their readings on a SampleBus."""
+    
+    def __init__(self, bus: SampleBus, sensors: List[Tuple[str, object]],
+                 rate_hz: float = PRESSURE_RATE_HZ, mode: str = PRESSURE_MODE,
+                 iir: int = PRESSURE_IIR, block_ms: float = BLOCK_MS, board: int = 0):
+        """Initialize poller (sensors are configured in start()).
+
+        Args:
+            bus: Bus that receives the sample blocks
+            sensors: (name, hardware.bme280.BME280) pairs; names prefix the channels
+            rate_hz: Poll rate
+            mode: "forced" or "normal"
+            iir: IIR filter coefficient (0 = off)
+            block_ms: Publish interval
+            board: Board ID stamped on the blocks
+        """
+        self.bus = bus
+        self.sensors = sensors
+        self.rate_hz = rate_hz
+        self.mode = mode
+        self.iir = iir
+        self.block_s = block_ms / 1000.0
+        self.board = board
+        self.engine = None
+        self._started = False
+        self.latest: Dict[str, float] = {}
+        self._calibration = None
+        self._triggered = 0.0
+        self._measurement_s = 0.0
+        self._buffer: List[tuple] = []
+        self._next_publish = 0.0
+        self.stats = {"polls": 0, "samples": 0, "read_errors": 0, "blocks": 0,
+                      "poll_s": 0.0, "max_poll_ms": 0.0}
+    
+    @classmethod
+    def from_specs(cls, specs: List[dict], bus: SampleBus, **kwargs) -> "PressurePoller":
+        """Poller for PRESSURE_SENSORS entries; sensors that don't answer are skipped."""
+        from hardware.bme280 import open_all
+        sensors = []
+        for index, (spec, sensor) in enumerate(open_all(specs)):
+            sensors.append((spec.get("name", "baro" if index == 0 else f"baro{index}"), sensor))
+        return cls(bus, sensors, **kwargs)
+    
+    @property
+    def channels(self) -> List[str]:
+        channels = []
+        for name, sensor in self.sensors:
+            channels += [f"{name}_p", f"{name}_t"] + ([f"{name}_rh"] if sensor.humidity else [])
+        return channels
+    
+    @property
+    def running(self) -> bool:
+        return self._started
+    
+    def start(self, engine=None) -> List[dict]:
+        """Configure every sensor and add the poll task; returns the applied settings.
+
+        Without an engine the caller runs poll() at rate_hz itself.
+        """
+        from hardware.bme280 import choose_settings, stack
+        
+        if self._started:
+            return self.get_stats()["sensors"]
+        for _, sensor in self.sensors:
+            sensor.configure(choose_settings(sensor.model, self.rate_hz, self.mode, self.iir))
+        self._calibration = stack([sensor.calibration for _, sensor in self.sensors])
+        self._measurement_s = max((sensor.settings.measurement_ms for _, sensor in self.sensors),
+                                  default=0.0) / 1000.0
+        self._trigger()
+        self._next_publish = time.monotonic() + self.block_s
+        self._started = True
+        self.engine = engine
+        if engine is not None:
+            engine.add_task("pressure", 1.0 / self.rate_hz, self.poll)
+        return self.get_stats()["sensors"]
+    
+    def stop(self):
+        """Remove the poll task and publish what is buffered."""
+        if self.engine is not None:
+            self.engine.remove_task("pressure")
+            self.engine = None
+        self._started = False
+        self._publish()
+    
+    def get_stats(self) -> dict:
+        stats = dict(self.stats)
+        polls = max(1, stats["polls"])
+        stats["mean_poll_ms"] = stats.pop("poll_s") / polls * 1000.0
+        stats["rate_hz"] = self.rate_hz
+        stats["mode"] = self.mode
+        stats["sensors"] = [dict(name=name, model=sensor.model, address=sensor.address,
+                                 **(sensor.settings._asdict() if sensor.settings else {}))
+                            for name, sensor in self.sensors]
+        return stats
+    
+    def _trigger(self):
+        if self.mode != "forced":
+            return
+        for _, sensor in self.sensors:
+            try:
+                sensor.trigger()
+            except OSError:
+                self.stats["read_errors"] += 1
+        self._triggered = time.monotonic()
+    
+    def poll(self):
+        """Read every sensor once and compensate them together (engine task)."""
+        import numpy as np
+        from hardware.bme280 import Calibration, compensate, decode
+        
+        start = time.monotonic()
+        if self.mode == "forced" and start - self._triggered < self._measurement_s:
+            return  # First poll right after start(): nothing measured yet
+        ok, raws = [], []
+        for index, (_, sensor) in enumerate(self.sensors):
+            try:
+                raw = sensor.read_raw()
+            except OSError:
+                self.stats["read_errors"] += 1
+                continue
+            ok.append(index)
+            # BMP280 bursts are two bytes shorter; 0x8000 marks humidity as skipped
+            raws.append(raw + b"\x80\x00" * (len(raw) == 6))
+        if self.mode == "forced":
+            stamp = self._triggered + self._measurement_s / 2
+            self._trigger()
+        else:
+            stamp = start
+        if ok:
+            cal = Calibration(*(field[ok] for field in self._calibration))
+            temperature, pressure, humidity = compensate(cal, *decode(np.frombuffer(
+                b"".join(raws), dtype=np.uint8).reshape(len(raws), 8)))
+            self._buffer.append((stamp, ok, pressure, temperature, humidity))
+            self.stats["samples"] += len(ok)
+        elapsed = time.monotonic() - start
+        self.stats["polls"] += 1
+        self.stats["poll_s"] += elapsed
+        self.stats["max_poll_ms"] = max(self.stats["max_poll_ms"], elapsed * 1000.0)
+        if time.monotonic() >= self._next_publish:
+            self._publish()
+            self._next_publish = time.monotonic() + self.block_s
+    
+    def _publish(self):
+        import numpy as np
+        
+        buffer, self._buffer = self._buffer, []
+        series: Dict[str, Tuple[list, list]] = {}
+        for stamp, ok, pressure, temperature, humidity in buffer:
+            for row, index in enumerate(ok):
+                name, sensor = self.sensors[index]
+                values = [("p", pressure), ("t", temperature)]
+                if sensor.humidity:
+                    values.append(("rh", humidity))
+                for suffix, column in values:
+                    stamps, data = series.setdefault(f"{name}_{suffix}", ([], []))
+                    stamps.append(stamp)
+                    data.append(column[row])
+        for channel, (stamps, data) in series.items():
+            values = np.array(data)
+            self.bus.publish(SampleBlock(channel, np.array(stamps), values, self.board))
+            self.latest[channel] = float(values[-1])
+            self.stats["blocks"] += 1
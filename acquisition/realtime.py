@@ -0,0 +1,239 @@
+"""Real-time settings for the acquisition and control threads (Linux).
+
+Process-wide, once at startup (setup_process):
+    mallopt      never trim the heap or serve allocations by mmap, so freed
+                 memory is reused instead of returned and faulted in again
+    prefault     touch RT_PREFAULT_MB of heap so the first blocks don't fault
+    mlockall     lock current and future pages in RAM (MCL_CURRENT|MCL_FUTURE)
+    GC           "freeze" moves startup objects out of the collector's reach;
+                 "defer" also disables automatic collection, and a housekeeping
+                 task collects young generations every RT_GC_PERIOD_S instead
+                 and everything every RT_GC_FULL_PERIOD_S (cycles that reach
+                 the oldest generation would leak otherwise); "off" never
+                 collects
+    GIL          a shorter switch interval, so an RT thread that becomes
+                 runnable gets the interpreter back sooner
+
+Per thread, from inside the thread (configure_thread):
+    SCHED_FIFO at RT_PRIORITIES[role], pinned to RT_CPUS ("isolated" = the
+    cores from the isolcpus= boot parameter)
+
+Every step records what was requested and what actually took effect, read
+back from the kernel. report() collects the results, and format_report()
+turns them into the startup check printed by the panel and by
+`device_cli.py rtcheck`.
+"""
+
+import ctypes
+import gc
+import os
+import platform
+import resource
+import sys
+import threading
+from typing import Dict, List, Optional, Tuple
+
+from config.acquisition_config import (RT_CPUS, RT_GC, RT_GC_FULL_PERIOD_S, RT_GC_PERIOD_S,
+                                       RT_MLOCKALL, RT_PREFAULT_MB, RT_PRIORITIES,
+                                       RT_SWITCH_INTERVAL_S)
+
+MCL_CURRENT = 1
+MCL_FUTURE = 2
+M_TRIM_THRESHOLD = -1
+M_MMAP_MAX = -4
+
+# label -> result dict of configure_thread()
+_threads: Dict[str, dict] = {}
+_process: Dict[str, object] = {}
+_lock = threading.Lock()
+_configured = threading.Condition(_lock)
+
+
+def _libc():
+    return ctypes.CDLL(None, use_errno=True)
+
+
+def isolated_cpus() -> List[int]:
+    """Cores reserved with isolcpus= (empty if none)."""
+    try:
+        with open("/sys/devices/system/cpu/isolated") as f:
+            text = f.read().strip()
+    except OSError:
+        return []
+    cpus = []
+    for part in filter(None, text.split(",")):
+        lo, _, hi = part.partition("-")
+        cpus.extend(range(int(lo), int(hi or lo) + 1))
+    return cpus
+
+
+def resolve_cpus(spec=RT_CPUS) -> Optional[List[int]]:
+    """CPU list for RT threads: explicit list, "isolated" or None (no pinning)."""
+    if spec == "isolated":
+        return isolated_cpus() or None
+    return list(spec) if spec else None
+
+
+def _kernel_preempt() -> str:
+    version = platform.uname().version
+    if "PREEMPT_RT" in version:
+        return "PREEMPT_RT"
+    if "PREEMPT" in version:
+        return "PREEMPT"
+    return "none"
+
+
+def setup_process(mlock: bool = RT_MLOCKALL, prefault_mb: float = RT_PREFAULT_MB,
+                  gc_mode: str = RT_GC, switch_interval: float = RT_SWITCH_INTERVAL_S) -> dict:
+    """Apply process-wide settings (call once, before starting RT threads)."""
+    result: Dict[str, object] = {"kernel_preempt": _kernel_preempt(),
+                                 "isolated_cpus": isolated_cpus()}
+    libc = None
+    if sys.platform.startswith("linux"):
+        try:
+            libc = _libc()
+        except OSError:
+            pass
+    
+    if libc is not None and hasattr(libc, "mallopt"):
+        result["mallopt"] = bool(libc.mallopt(M_TRIM_THRESHOLD, -1)
+                                 and libc.mallopt(M_MMAP_MAX, 0))
+    
+    if prefault_mb > 0:
+        # Freed chunks stay in the heap (no trim), so later allocations reuse these pages
+        reserve = bytearray(int(prefault_mb * 1024 * 1024))
+        for offset in range(0, len(reserve), 4096):
+            reserve[offset] = 1
+        del reserve
+        result["prefault_mb"] = prefault_mb
+    
+    if mlock:
+        if libc is None:
+            result["mlockall"] = "unsupported"
+        elif libc.mlockall(MCL_CURRENT | MCL_FUTURE) == 0:
+            result["mlockall"] = "ok"
+        else:
+            errno = ctypes.get_errno()
+            soft, _ = resource.getrlimit(resource.RLIMIT_MEMLOCK)
+            limit = "unlimited" if soft == resource.RLIM_INFINITY else f"{soft // 1024} kB"
+            result["mlockall"] = f"failed: {os.strerror(errno)} (RLIMIT_MEMLOCK {limit})"
+    
+    if gc_mode in ("freeze", "defer", "off"):
+        gc.collect()
+        gc.freeze()
+        if gc_mode in ("defer", "off"):
+            gc.disable()
+    result["gc"] = gc_mode
+    result["gc_enabled"] = gc.isenabled()
+    result["gc_frozen"] = gc.get_freeze_count()
+    
+    if switch_interval:
+        sys.setswitchinterval(switch_interval)
+    result["switch_interval_ms"] = sys.getswitchinterval() * 1000.0
+    
+    with _lock:
+        _process.clear()
+        _process.update(result)
+    return result
+
+
+def collect_young():
+    """Deferred GC: collect generations 0 and 1 (for a periodic housekeeping task)."""
+    gc.collect(1)
+
+
+def collect_full():
+    """Deferred GC: collect every generation (startup objects stay frozen)."""
+    gc.collect()
+
+
+def install_gc_task(engine, gc_mode: str = RT_GC, period: float = RT_GC_PERIOD_S,
+                    full_period: float = RT_GC_FULL_PERIOD_S):
+    """With GC deferred, collect from the engine's housekeeping thread."""
+    if gc_mode == "defer" and engine is not None:
+        engine.add_task("gc_collect", period, collect_young)
+        engine.add_task("gc_collect_full", full_period, collect_full)
+
+
+def configure_thread(role: str, label: Optional[str] = None) -> dict:
+    """Make the calling thread SCHED_FIFO and pin it; record what took effect.
+
+    Args:
+        role: Key into RT_PRIORITIES ("acquisition", "control")
+        label: Name in the report (default: role), e.g. "control:heater"
+
+    Returns:
+        Requested and applied policy, priority and CPUs, plus any errors
+    """
+    priority = RT_PRIORITIES.get(role, 0)
+    cpus = resolve_cpus()
+    result = {"thread": threading.current_thread().name, "requested_priority": priority,
+              "requested_cpus": cpus, "errors": []}
+    
+    if priority and hasattr(os, "sched_setscheduler"):
+        try:
+            # pid 0 = the calling thread on Linux
+            os.sched_setscheduler(0, os.SCHED_FIFO, os.sched_param(priority))
+        except OSError as e:
+            soft, _ = resource.getrlimit(resource.RLIMIT_RTPRIO)
+            result["errors"].append(f"SCHED_FIFO {priority}: {e.strerror} "
+                                    f"(RLIMIT_RTPRIO {soft}, needs CAP_SYS_NICE or rtprio "
+                                    f"in /etc/security/limits.conf)")
+    if cpus and hasattr(os, "sched_setaffinity"):
+        try:
+            os.sched_setaffinity(0, cpus)
+        except OSError as e:
+            result["errors"].append(f"affinity {cpus}: {e.strerror}")
+    
+    # Read back what the kernel actually applied
+    if hasattr(os, "sched_getscheduler"):
+        policy = os.sched_getscheduler(0)
+        result["policy"] = {os.SCHED_FIFO: "SCHED_FIFO", os.SCHED_RR: "SCHED_RR"}.get(
+            policy, "SCHED_OTHER")
+        result["priority"] = os.sched_getparam(0).sched_priority
+    if hasattr(os, "sched_getaffinity"):
+        result["cpus"] = sorted(os.sched_getaffinity(0))
+    result["ok"] = (not priority or result.get("priority") == priority) and \
+                   (not cpus or result.get("cpus") == sorted(cpus))
+    
+    with _configured:
+        _threads[label or role] = result
+        _configured.notify_all()
+    return result
+
+
+def wait_for(labels: List[str], timeout: float = 1.0) -> bool:
+    """Wait until the given threads have run configure_thread()."""
+    with _configured:
+        return _configured.wait_for(lambda: all(k in _threads for k in labels), timeout)
+
+
+def report() -> dict:
+    """Everything recorded so far (JSON-friendly)."""
+    with _lock:
+        return {"process": dict(_process), "threads": {k: dict(v) for k, v in _threads.items()}}
+
+
+def format_report(data: Optional[dict] = None) -> Tuple[bool, str]:
+    """Startup check text; ok is False if any requested setting didn't take effect."""
+    data = data or report()
+    process = data["process"]
+    lines = [f"RT: kernel preemption {process.get('kernel_preempt') or _kernel_preempt()}, "
+             f"isolated CPUs {process.get('isolated_cpus') or isolated_cpus() or 'none'}"]
+    ok = True
+    mlock = process.get("mlockall")
+    if mlock is not None:
+        ok &= mlock == "ok"
+        lines.append(f"RT: mlockall {mlock}")
+    if "gc" in process:
+        lines.append(f"RT: GC {process['gc']} (enabled={process['gc_enabled']}, "
+                     f"{process['gc_frozen']} objects frozen), GIL switch interval "
+                     f"{process['switch_interval_ms']:.2f} ms")
+    for label, result in sorted(data["threads"].items()):
+        ok &= result["ok"]
+        mark = "ok" if result["ok"] else "NOT APPLIED"
+        lines.append(f"RT: {label} thread {result.get('policy', '?')} "
+                     f"prio {result.get('priority', '?')} on CPUs {result.get('cpus', '?')} - {mark}")
+        for error in result["errors"]:
+            lines.append(f"RT:   {error}")
+    return ok, "\n".join(lines)
@@ -0,0 +1,184 @@
+"""Capture replay - plays recorded capture files onto a sample bus.
+
+Recorded blocks and events are published exactly as the live engine would,
+so streaming, MQTT and any other bus consumer can be exercised with real
+signals. Playback runs at 1x, Nx or as fast as possible (speed <= 0).
+
+Timestamps are either preserved as recorded, or rebased: shifted by a
+constant onto the replay's monotonic clock (spacing is kept, so filters
+still see the recorded sample rate). When looping, each pass is
+shifted by the capture length so time keeps increasing - preserved
+timestamps too, from the second pass on.
+"""
+
+import sys
+import threading
+import time
+from array import array
+from typing import Dict, Optional
+
+from .bus import Event, SampleBlock, SampleBus
+from .capture import CaptureReader
+
+
+def _item_time(item) -> float:
+    """Time at which the live engine would have published this item."""
+    if isinstance(item, Event):
+        return item.timestamp
+    return item.timestamps[-1] if len(item.timestamps) else 0.0
+
+
+class CaptureReplayer:
+    """Publishes a capture file onto a bus from a background thread."""
+    
+    def __init__(self, path: str, bus: SampleBus, speed: float = 1.0, rebase: bool = True,
+                 loop: bool = False, board: Optional[int] = None):
+        """Initialize replayer.
+
+        Args:
+            path: Capture file written by acquisition.capture.CaptureWriter
+            bus: Bus that receives the replayed blocks and events
+            speed: Playback speed (1.0 = real time, <= 0 = as fast as possible)
+            rebase: Shift timestamps to the replay clock instead of keeping them
+            loop: Start over at the end of the file until stopped
+            board: Override the recorded board ID
+        """
+        self.reader = CaptureReader(path)
+        self.path = path
+        self.bus = bus
+        self.speed = speed
+        self.rebase = rebase
+        self.loop = loop
+        self.board = board
+        
+        # Most recent value per channel name (backs ReplayADC) and the monotonic
+        # time it was published
+        self.latest: Dict[str, float] = {}
+        self.latest_t: Dict[str, float] = {}
+        
+        self._stop = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+        self._started = 0.0
+        self._finished = 0.0
+        self.stats = {
+            "passes": 0,
+            "blocks": 0,
+            "samples": 0,
+            "events": 0,
+            "max_lag_ms": 0.0,
+        }
+    
+    @property
+    def running(self) -> bool:
+        return self._thread is not None and self._thread.is_alive()
+    
+    def start(self):
+        """Start playback."""
+        if self.running:
+            return
+        self._stop.clear()
+        self._thread = threading.Thread(target=self._run, name="capture-replay", daemon=True)
+        self._thread.start()
+    
+    def stop(self, timeout: float = 2.0):
+        self._stop.set()
+        if self._thread is not None:
+            self._thread.join(timeout)
+            self._thread = None
+    
+    def wait(self, timeout: Optional[float] = None) -> bool:
+        """Wait for playback to finish (never, when looping). Returns True if finished."""
+        if self._thread is not None:
+            self._thread.join(timeout)
+        return not self.running
+    
+    def get_stats(self) -> dict:
+        stats = dict(self.stats)
+        end = self._finished or time.monotonic()
+        elapsed = end - self._started if self._started else 0.0
+        stats.update({
+            "source": self.path,
+            "speed": self.speed,
+            "rebase": self.rebase,
+            "elapsed_s": elapsed,
+            "samples_per_s": stats["samples"] / elapsed if elapsed > 0 else 0.0,
+        })
+        return stats
+    
+    def _run(self):
+        self._started = time.monotonic()
+        self._finished = 0.0
+        shift = None
+        pass_start = 0.0
+        rate = self.reader.header.get("rate_hz")
+        gap = 1.0 / rate if rate else 0.0
+        try:
+            while not self._stop.is_set():
+                first = last = begin = None
+                for item in self.reader:
+                    if self._stop.is_set():
+                        return
+                    t = _item_time(item)
+                    if first is None:
+                        first = t
+                        begin = item.timestamps[0] if isinstance(item, SampleBlock) else t
+                        if shift is None:
+                            shift = self._started - t if self.rebase else 0.0
+                            pass_start = self._started
+                    last = t
+                    
+                    if self.speed > 0:
+                        due = pass_start + (t - first) / self.speed
+                        delay = due - time.monotonic()
+                        if delay > 0:
+                            if self._stop.wait(delay):
+                                return
+                        else:
+                            lag_ms = -delay * 1000.0
+                            if lag_ms > self.stats["max_lag_ms"]:
+                                self.stats["max_lag_ms"] = lag_ms
+                    self._publish(item, shift)
+                
+                self.stats["passes"] += 1
+                if not self.loop or first is None:
+                    return
+                # Next pass continues the timeline one sample period after this one
+                span = last - begin + gap
+                shift += span
+                if self.speed > 0:
+                    pass_start += span / self.speed
+        except Exception as e:
+            print(f"Replay: {self.path}: {e}", file=sys.stderr)
+        finally:
+            self._finished = time.monotonic()
+    
+    def _publish(self, item, shift: float):
+        board = item.board if self.board is None else self.board
+        if isinstance(item, Event):
+            self.bus.publish(Event(item.kind, item.timestamp + shift, item.source, item.value,
+                                   board))
+            self.stats["events"] += 1
+            return
+        timestamps = item.timestamps
+        if shift:
+            timestamps = array('d', [t + shift for t in timestamps])
+        self.bus.publish(SampleBlock(item.channel, timestamps, item.values, board))
+        if len(item.values):
+            self.latest[item.channel] = item.values[-1]
+            self.latest_t[item.channel] = time.monotonic()
+        self.stats["blocks"] += 1
+        self.stats["samples"] += len(item.values)
+
+
+class ReplayADC:
+    """ADC manager API over a replay: read_channel() returns the replayed value."""
+    
+    def __init__(self, replayer: CaptureReplayer):
+        self.replayer = replayer
+        self.is_pi = False
+    
+    def read_channel(self, channel: int) -> Optional[float]:
+        return self.replayer.latest.get(f"adc{channel}")
+    
+    def read_all_channels(self) -> Dict[int, Optional[float]]:
+        return {i: self.read_channel(i) for i in range(4)}
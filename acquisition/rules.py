@@ -0,0 +1,351 @@
+"""Rule engine - threshold rules that drive LEDs and sensor power locally.
+
+A rule watches one channel and fires when its condition has held for
+for_ms, then clears once the value has moved back past the threshold by
+hysteresis for clear_ms:
+
+    {"name": "overvoltage", "when": "adc2 > 3.1", "for_ms": 20, "hysteresis": 0.1,
+     "then": ["led3:blink", "power:off"], "clear": ["led3:off"]}
+
+Rules on ADC channels run inside the acquisition thread: the engine hands
+every sample (or block) to feed_sample()/feed_block() right after the read,
+so actions are not delayed by the bus or the GUI. Rules on derived channels
+are fed from a bus subscription instead.
+
+Conditions are compiled once: the comparison becomes a bound float method
+(e.g. 3.1.__lt__ for "> 3.1") for single samples and a NumPy comparison for
+blocks, where only the points at which a predicate changes are visited.
+
+Actions:
+    ledN:on|off|toggle|blink    GPIOManager.set_led (blinking at RULE_BLINK_HZ)
+    power:on|off                PowerManager.set_power
+Every fire/clear is also published as an Event(kind="rule", source=<rule index>).
+
+Input-to-action latency (sample timestamp to actions done, excluding the
+for_ms hold) is measured per rule and checked against RULE_LATENCY_BUDGET_MS.
+"""
+
+import re
+import sys
+import threading
+import time
+from typing import Dict, List, Optional, Sequence
+
+from config.acquisition_config import RULE_BLINK_HZ, RULE_LATENCY_BUDGET_MS
+from .bus import Event, SampleBlock, SampleBus
+
+_CONDITION = re.compile(r"^\s*([A-Za-z_]\w*)\s*(>=|<=|>|<)\s*([-+]?[\d.]+(?:[eE][-+]?\d+)?)\s*$")
+_PHYSICAL = re.compile(r"(?:adc|ch)(\d+)$")
+_ACTION = re.compile(r"^\s*(led([1-4])|power)\s*:\s*(on|off|toggle|blink)\s*$")
+
+
+class RuleError(ValueError):
+    """Rule definition is invalid."""
+
+
+class Rule:
+    """One compiled rule and its debounce/hysteresis state."""
+    
+    def __init__(self, index: int, spec: dict, engine: "RuleEngine"):
+        self.index = index
+        self.name = spec.get("name", f"rule{index}")
+        match = _CONDITION.match(spec.get("when", ""))
+        if not match:
+            raise RuleError(f"{self.name}: 'when' must look like 'adc2 > 3.1', "
+                            f"got {spec.get('when')!r}")
+        channel, op, threshold = match.groups()
+        physical = _PHYSICAL.match(channel)
+        self.channel = f"adc{physical.group(1)}" if physical else channel
+        self.adc_channel = int(physical.group(1)) if physical else None
+        self.when = f"{self.channel} {op} {threshold}"
+        
+        threshold = float(threshold)
+        hysteresis = float(spec.get("hysteresis", 0.0))
+        if hysteresis < 0:
+            raise RuleError(f"{self.name}: hysteresis must be >= 0")
+        self.hold_s = float(spec.get("for_ms", 0.0)) / 1000.0
+        self.clear_s = float(spec.get("clear_ms", spec.get("for_ms", 0.0))) / 1000.0
+        
+        # Trigger and release predicates as bound float comparisons, e.g.
+        # "v > 3.1" is 3.1.__lt__(v). They never overlap: release needs the
+        # value hysteresis past the threshold (or just off it when 0).
+        if op in (">", ">="):
+            release = threshold - hysteresis
+            self.trigger = threshold.__lt__ if op == ">" else threshold.__le__
+            if op == ">" and not hysteresis:
+                self.release, release_op = threshold.__ge__, "<="
+            else:
+                self.release, release_op = release.__gt__, "<"
+        else:
+            release = threshold + hysteresis
+            self.trigger = threshold.__gt__ if op == "<" else threshold.__ge__
+            if op == "<" and not hysteresis:
+                self.release, release_op = threshold.__le__, ">="
+            else:
+                self.release, release_op = release.__lt__, ">"
+        self._vector = (op, threshold, release_op, release)
+        
+        self.then = [engine.compile_action(a, self.name) for a in spec.get("then", [])]
+        self.on_clear = [engine.compile_action(a, self.name) for a in spec.get("clear", [])]
+        if not self.then and not self.on_clear:
+            raise RuleError(f"{self.name}: needs 'then' and/or 'clear' actions")
+        
+        self._engine = engine
+        self.active = False
+        # Time at which a pending fire/clear takes effect if the condition holds
+        self._fire_at: Optional[float] = None
+        self._clear_at: Optional[float] = None
+        self.fires = 0
+        self.clears = 0
+        self.last_latency_ms = 0.0
+        self.max_latency_ms = 0.0
+        self.budget_misses = 0
+    
+    def feed(self, t: float, value: float):
+        """Advance the state machine by one sample."""
+        if not self.active:
+            if self.trigger(value):
+                if self._fire_at is None:
+                    self._fire_at = t + self.hold_s
+                if t >= self._fire_at:
+                    self._fire(t)
+            else:
+                self._fire_at = None
+        else:
+            if self.release(value):
+                if self._clear_at is None:
+                    self._clear_at = t + self.clear_s
+                if t >= self._clear_at:
+                    self._clear(t)
+            else:
+                self._clear_at = None
+    
+    def feed_block(self, timestamps, values):
+        """Advance by a NumPy block, visiting only points where a predicate changes."""
+        import numpy as np
+        op, threshold, release_op, release = self._vector
+        trig = _compare(np, values, op, threshold)
+        rel = _compare(np, values, release_op, release)
+        n = len(values)
+        changes = np.flatnonzero((trig[1:] != trig[:-1]) | (rel[1:] != rel[:-1])) + 1
+        bounds = [0] + changes.tolist() + [n]
+        for start, end in zip(bounds[:-1], bounds[1:]):
+            if not self.active:
+                if not trig[start]:
+                    self._fire_at = None
+                    continue
+                if self._fire_at is None:
+                    self._fire_at = float(timestamps[start]) + self.hold_s
+                k = start + int(np.searchsorted(timestamps[start:end], self._fire_at))
+                if k < end:
+                    self._fire(float(timestamps[k]))
+                    # rel is False for the rest of this run (no overlap)
+            else:
+                if not rel[start]:
+                    self._clear_at = None
+                    continue
+                if self._clear_at is None:
+                    self._clear_at = float(timestamps[start]) + self.clear_s
+                k = start + int(np.searchsorted(timestamps[start:end], self._clear_at))
+                if k < end:
+                    self._clear(float(timestamps[k]))
+    
+    def _fire(self, t: float):
+        self.active = True
+        self._fire_at = None
+        self._clear_at = None
+        self.fires += 1
+        self._engine.run_actions(self, self.then, t, 1)
+    
+    def _clear(self, t: float):
+        self.active = False
+        self._fire_at = None
+        self._clear_at = None
+        self.clears += 1
+        self._engine.run_actions(self, self.on_clear, t, 0)
+    
+    def get_stats(self) -> dict:
+        return {
+            "when": self.when,
+            "active": self.active,
+            "fires": self.fires,
+            "clears": self.clears,
+            "last_latency_ms": self.last_latency_ms,
+            "max_latency_ms": self.max_latency_ms,
+            "budget_misses": self.budget_misses,
+        }
+
+
+def _compare(np, values, op: str, threshold: float):
+    if op == ">":
+        return np.greater(values, threshold)
+    if op == ">=":
+        return np.greater_equal(values, threshold)
+    if op == "<":
+        return np.less(values, threshold)
+    return np.less_equal(values, threshold)
+
+
+class RuleEngine:
+    """Holds the compiled rules and executes their actions."""
+    
+    def __init__(self, rules: Sequence[dict], gpio=None, power=None,
+                 bus: Optional[SampleBus] = None, board: int = 0,
+                 latency_budget_ms: float = RULE_LATENCY_BUDGET_MS,
+                 blink_hz: float = RULE_BLINK_HZ, via_bus: bool = False):
+        """Compile rules.
+
+        Args:
+            rules: Rule definitions (see module docstring)
+            gpio: GPIOManager for led actions
+            power: PowerManager for power actions
+            bus: Bus for rule events and for rules on derived channels
+            board: Board whose channels the rules watch
+            latency_budget_ms: Input-to-action latency considered acceptable
+            blink_hz: Blink frequency for ledN:blink
+            via_bus: Feed ADC rules from the bus too (no engine, e.g. replaying a capture)
+
+        Raises:
+            RuleError: A rule or action is invalid
+        """
+        self.gpio = gpio
+        self.power = power
+        self.bus = bus
+        self.board = board
+        self.latency_budget_ms = latency_budget_ms
+        self.blink_hz = blink_hz
+        self.rules = [Rule(i, spec, self) for i, spec in enumerate(rules)]
+        
+        # ADC channel -> rules, looked up once per sample in the acquisition thread
+        self._by_adc: Dict[int, List[Rule]] = {}
+        # Other (derived) channel name -> rules, fed from the bus
+        self._by_name: Dict[str, List[Rule]] = {}
+        for rule in self.rules:
+            if rule.adc_channel is not None and not via_bus:
+                self._by_adc.setdefault(rule.adc_channel, []).append(rule)
+            else:
+                self._by_name.setdefault(rule.channel, []).append(rule)
+        
+        self._blinking: Dict[int, bool] = {}
+        self._lock = threading.Lock()
+        self._warned = False
+        self._sub = None
+        self._stop = threading.Event()
+        self._threads: List[threading.Thread] = []
+    
+    def compile_action(self, action: str, rule_name: str):
+        """Turn 'led3:blink' / 'power:off' into a callable."""
+        match = _ACTION.match(action)
+        if not match:
+            raise RuleError(f"{rule_name}: unknown action {action!r} "
+                            f"(ledN:on|off|toggle|blink or power:on|off)")
+        target, led, verb = match.groups()
+        if target == "power":
+            if verb not in ("on", "off"):
+                raise RuleError(f"{rule_name}: power only supports on/off")
+            state = verb == "on"
+            return lambda: self.power.set_power(state)
+        led_id = int(led)
+        if verb == "blink":
+            return lambda: self._set_blink(led_id)
+        if verb == "toggle":
+            return lambda: self._set_led(led_id, not self.gpio.get_led(led_id))
+        state = verb == "on"
+        return lambda: self._set_led(led_id, state)
+    
+    def _set_led(self, led_id: int, state: bool):
+        with self._lock:
+            self._blinking.pop(led_id, None)
+        self.gpio.set_led(led_id, state)
+    
+    def _set_blink(self, led_id: int):
+        with self._lock:
+            self._blinking[led_id] = True
+        self.gpio.set_led(led_id, True)
+    
+    def run_actions(self, rule: Rule, actions: list, t: float, value: int):
+        """Execute actions for a fire (value 1) or clear (value 0) and record latency."""
+        t = float(t)
+        for action in actions:
+            try:
+                action()
+            except Exception as e:
+                print(f"Rules: {rule.name} action failed: {e}", file=sys.stderr)
+        latency_ms = (time.monotonic() - t) * 1000.0
+        rule.last_latency_ms = latency_ms
+        if latency_ms > rule.max_latency_ms:
+            rule.max_latency_ms = latency_ms
+        if latency_ms > self.latency_budget_ms:
+            rule.budget_misses += 1
+            if not self._warned:
+                self._warned = True
+                print(f"Rules: {rule.name} took {latency_ms:.1f} ms from sample to action "
+                      f"(budget {self.latency_budget_ms:.1f} ms)", file=sys.stderr)
+        if self.bus is not None:
+            self.bus.publish(Event("rule", t, rule.index, value, self.board))
+    
+    def feed_sample(self, ch: int, t: float, value: float):
+        """One ADC sample (called by the acquisition thread)."""
+        rules = self._by_adc.get(ch)
+        if rules:
+            for rule in rules:
+                rule.feed(t, value)
+    
+    def feed_block(self, ch: int, timestamps, values):
+        """A block of ADC samples (called by the acquisition thread)."""
+        rules = self._by_adc.get(ch)
+        if rules:
+            for rule in rules:
+                self._feed_rule_block(rule, timestamps, values)
+    
+    def _feed_rule_block(self, rule: Rule, timestamps, values):
+        if hasattr(values, 'astype'):  # NumPy array
+            rule.feed_block(timestamps, values)
+        else:
+            for t, value in zip(timestamps, values):
+                rule.feed(t, value)
+    
+    def start(self):
+        """Start the blink thread and, if needed, the derived-channel feed."""
+        if self._threads:
+            return
+        self._stop.clear()
+        self._threads.append(threading.Thread(target=self._run_blink, name="rules-blink",
+                                              daemon=True))
+        if self._by_name and self.bus is not None:
+            self._sub = self.bus.subscribe(maxlen=1024, events=False)
+            self._threads.append(threading.Thread(target=self._run_bus, name="rules-bus",
+                                                  daemon=True))
+        for thread in self._threads:
+            thread.start()
+    
+    def stop(self, timeout: float = 2.0):
+        self._stop.set()
+        for thread in self._threads:
+            thread.join(timeout)
+        self._threads = []
+        if self._sub is not None:
+            self._sub.close()
+            self._sub = None
+    
+    def get_stats(self) -> dict:
+        return {rule.name: rule.get_stats() for rule in self.rules}
+    
+    def _run_blink(self):
+        half_period = 0.5 / self.blink_hz
+        phase = True
+        while not self._stop.wait(half_period):
+            phase = not phase
+            with self._lock:
+                leds = list(self._blinking)
+            for led_id in leds:
+                self.gpio.set_led(led_id, phase)
+    
+    def _run_bus(self):
+        while not self._stop.is_set():
+            self._sub.wait(0.2)
+            for block in self._sub.drain():
+                if not isinstance(block, SampleBlock) or block.board != self.board:
+                    continue
+                for rule in self._by_name.get(block.channel, ()):
+                    self._feed_rule_block(rule, block.timestamps, block.values)
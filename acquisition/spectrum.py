@@ -0,0 +1,230 @@
+"""Spectral analysis stage - Welch-averaged windowed FFTs of one ADC channel.
+
+Samples of the selected channel are copied into a preallocated ring buffer.
+At a fixed update rate (independent of the sample rate) every complete
+segment of nfft samples, hopping by nfft * (1 - overlap), is detrended,
+windowed (Hann/Blackman) and transformed with a real-input FFT; the last
+`averages` periodograms are averaged (Welch). Each update also appends one
+row to a waterfall. Segment, window, index and spectrum buffers are
+allocated once per configuration, so steady-state updates don't allocate
+beyond NumPy's FFT internals.
+
+The power spectral density is in V^2/Hz (one-sided); snapshot() also gives
+it in dB re 1 V^2/Hz.
+"""
+
+import threading
+import time
+from typing import Optional
+
+import numpy as np
+
+from config.acquisition_config import (SPECTRUM_AVERAGES, SPECTRUM_NFFT, SPECTRUM_OVERLAP,
+                                       SPECTRUM_UPDATE_HZ, SPECTRUM_WATERFALL_ROWS,
+                                       SPECTRUM_WINDOW)
+from .bus import SampleBus
+
+WINDOWS = {"hann": np.hanning, "blackman": np.blackman}
+
+# numpy >= 2.0 can write rfft output into a preallocated array
+try:
+    np.fft.rfft(np.zeros(4), out=np.empty(3, dtype=complex))
+    _RFFT_OUT = True
+except TypeError:
+    _RFFT_OUT = False
+
+
+class SpectrumAnalyzer:
+    """Welch spectrum and waterfall of one channel, updated on its own thread."""
+    
+    def __init__(self, bus: SampleBus, channel: str = "adc0", board: int = 0,
+                 nfft: int = SPECTRUM_NFFT, overlap: float = SPECTRUM_OVERLAP,
+                 window: str = SPECTRUM_WINDOW, averages: int = SPECTRUM_AVERAGES,
+                 update_hz: float = SPECTRUM_UPDATE_HZ,
+                 waterfall_rows: int = SPECTRUM_WATERFALL_ROWS):
+        """Initialize analyzer.
+
+        Args:
+            bus: Bus carrying the channel's sample blocks
+            channel: Channel name to analyze
+            board: Board ID of the channel
+            nfft: Segment length (FFT size)
+            overlap: Segment overlap fraction (0.5 = 50%)
+            window: "hann" or "blackman"
+            averages: Number of periodograms averaged (Welch)
+            update_hz: Spectrum/waterfall update rate
+            waterfall_rows: Waterfall history length
+        """
+        if window not in WINDOWS:
+            raise ValueError(f"Unknown window '{window}' (use {', '.join(WINDOWS)})")
+        self.bus = bus
+        self.update_hz = update_hz
+        self.waterfall_rows = waterfall_rows
+        self._lock = threading.Lock()
+        self._stop = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+        self._sub = None
+        self.configure(channel, board, nfft, overlap, window, averages)
+    
+    def configure(self, channel: str, board: int = 0, nfft: Optional[int] = None,
+                  overlap: Optional[float] = None, window: Optional[str] = None,
+                  averages: Optional[int] = None):
+        """Select a channel and/or change FFT settings (resets history)."""
+        with self._lock:
+            self.channel = channel
+            self.board = board
+            self.nfft = nfft or getattr(self, "nfft", SPECTRUM_NFFT)
+            self.overlap = overlap if overlap is not None else getattr(self, "overlap",
+                                                                        SPECTRUM_OVERLAP)
+            self.window_name = window or getattr(self, "window_name", SPECTRUM_WINDOW)
+            self.averages = averages or getattr(self, "averages", SPECTRUM_AVERAGES)
+            self.hop = max(1, int(self.nfft * (1.0 - self.overlap)))
+            bins = self.nfft // 2 + 1
+            
+            self._window = WINDOWS[self.window_name](self.nfft)
+            self._window_power = float(np.sum(self._window ** 2))
+            self._arange = np.arange(self.nfft)
+            self._index = np.empty(self.nfft, dtype=np.intp)
+            self._segment = np.empty(self.nfft)
+            self._spectrum = np.empty(bins, dtype=complex)
+            self._power = np.empty(bins)
+            self._periodograms = np.zeros((self.averages, bins))
+            self._psd = np.zeros(bins)
+            self._psd_db = np.full(bins, -200.0)
+            self._waterfall = np.full((self.waterfall_rows, bins), -200.0)
+            self._ring = np.zeros(4 * self.nfft)
+            self._written = 0       # Total samples written to the ring
+            self._next_start = 0    # Absolute index of the next segment
+            self._filled = 0        # Periodograms collected (<= averages)
+            self._slot = 0
+            self._row = 0
+            self._rows_filled = 0
+            self.sample_rate = 0.0
+            self.stats = {"updates": 0, "segments": 0, "skipped": 0,
+                          "cpu_ms": 0.0, "cpu_ms_max": 0.0, "cpu_percent": 0.0}
+    
+    def start(self):
+        if self._thread is not None:
+            return
+        self._stop.clear()
+        self._sub = self.bus.subscribe(maxlen=1024, events=False)
+        self._thread = threading.Thread(target=self._run, name="spectrum", daemon=True)
+        self._thread.start()
+    
+    def stop(self, timeout: float = 2.0):
+        self._stop.set()
+        if self._thread is not None:
+            self._thread.join(timeout)
+            self._thread = None
+        if self._sub is not None:
+            self._sub.close()
+            self._sub = None
+    
+    def snapshot(self) -> Optional[dict]:
+        """Latest spectrum and waterfall (oldest row first), or None before the first segment."""
+        with self._lock:
+            if not self._filled or not self.sample_rate:
+                return None
+            order = (np.arange(self._rows_filled) + self._row - self._rows_filled) % self.waterfall_rows
+            return {
+                "channel": self.channel,
+                "board": self.board,
+                "sample_rate": self.sample_rate,
+                "freqs": np.fft.rfftfreq(self.nfft, 1.0 / self.sample_rate),
+                "psd": self._psd.copy(),
+                "psd_db": self._psd_db.copy(),
+                "waterfall": self._waterfall[order],
+                "averaged": self._filled,
+                "stats": dict(self.stats),
+            }
+    
+    def _run(self):
+        period = 1.0 / self.update_hz
+        next_t = time.monotonic()
+        while not self._stop.is_set():
+            next_t += period
+            delay = next_t - time.monotonic()
+            if delay < 0:
+                next_t = time.monotonic()  # Fell behind; don't try to catch up
+            elif self._stop.wait(delay):
+                break
+            self.update(self._sub.drain())
+    
+    def update(self, blocks):
+        """Feed blocks and compute (the background thread calls this at update_hz)."""
+        started = time.thread_time()
+        with self._lock:
+            for block in blocks:
+                if block.channel == self.channel and block.board == self.board:
+                    self._feed(block)
+            segments = self._compute()
+            if segments:
+                self._waterfall[self._row] = self._psd_db
+                self._row = (self._row + 1) % self.waterfall_rows
+                self._rows_filled = min(self._rows_filled + 1, self.waterfall_rows)
+            stats = self.stats
+            cpu_ms = (time.thread_time() - started) * 1000.0
+            stats["updates"] += 1
+            stats["segments"] += segments
+            stats["cpu_ms"] = cpu_ms
+            stats["cpu_ms_max"] = max(stats["cpu_ms_max"], cpu_ms)
+            stats["cpu_percent"] = cpu_ms * self.update_hz / 10.0
+    
+    def _feed(self, block):
+        values = block.values
+        count = len(values)
+        if count > 1:
+            dt = (block.timestamps[-1] - block.timestamps[0]) / (count - 1)
+            if dt > 0:
+                self.sample_rate = 1.0 / dt
+        # Grow the ring once if an update interval holds more than it can
+        needed = self.nfft + 2 * count
+        if needed > len(self._ring):
+            ring = np.zeros(2 * needed)
+            keep = np.arange(max(0, self._written - len(self._ring)), self._written)
+            ring[keep % len(ring)] = self._ring[keep % len(self._ring)]
+            self._ring = ring
+        cap = len(self._ring)
+        start = self._written % cap
+        first = min(count, cap - start)
+        self._ring[start:start + first] = values[:first]
+        if first < count:
+            self._ring[:count - first] = values[first:]
+        self._written += count
+    
+    def _compute(self) -> int:
+        """Process every complete segment; returns how many were processed."""
+        cap = len(self._ring)
+        if self._written - self._next_start > cap - self.hop:
+            # Compute fell behind the ring - jump to the newest full segment
+            skip_to = self._written - self.nfft
+            self.stats["skipped"] += max(0, (skip_to - self._next_start) // self.hop)
+            self._next_start = skip_to
+        segments = 0
+        while self._next_start + self.nfft <= self._written:
+            np.add(self._arange, self._next_start % cap, out=self._index)
+            np.take(self._ring, self._index, mode='wrap', out=self._segment)
+            self._segment -= self._segment.mean()
+            self._segment *= self._window
+            if _RFFT_OUT:
+                np.fft.rfft(self._segment, out=self._spectrum)
+            else:
+                self._spectrum[:] = np.fft.rfft(self._segment)
+            np.abs(self._spectrum, out=self._power)
+            np.square(self._power, out=self._power)
+            self._periodograms[self._slot] = self._power
+            self._slot = (self._slot + 1) % self.averages
+            self._filled = min(self._filled + 1, self.averages)
+            self._next_start += self.hop
+            segments += 1
+        if segments and self.sample_rate:
+            np.sum(self._periodograms[:self._filled], axis=0, out=self._psd)
+            # One-sided density: |X|^2 / (fs * sum(w^2)), doubled except DC/Nyquist
+            self._psd *= 2.0 / (self._filled * self.sample_rate * self._window_power)
+            self._psd[0] /= 2.0
+            if self.nfft % 2 == 0:
+                self._psd[-1] /= 2.0
+            np.maximum(self._psd, 1e-20, out=self._psd_db)
+            np.log10(self._psd_db, out=self._psd_db)
+            self._psd_db *= 10.0
+        return segments
@@ -0,0 +1,265 @@
+"""Streaming per-channel statistics with constant memory.
+
+Every channel on the bus gets a ChannelStats that is updated block-wise:
+    mean / std / RMS    Welford, merged per block (Chan et al.), since start
+    min / max           over a sliding time window (monotonic deques), and all-time
+    percentiles         P-squared estimators (Jain & Chlamtac), since start
+
+Memory per channel is fixed: five markers per percentile, and the window
+deques hold at most window_s * rate entries however long the run is.
+"""
+
+import math
+import threading
+from collections import deque
+from typing import Dict, List, Optional, Sequence, Tuple
+
+from config.acquisition_config import STATS_PERCENTILES, STATS_WINDOW_S
+from .bus import SampleBlock, SampleBus
+
+
+class Welford:
+    """Running count, mean and sum of squared deviations."""
+    
+    __slots__ = ("count", "mean", "m2")
+    
+    def __init__(self):
+        self.count = 0
+        self.mean = 0.0
+        self.m2 = 0.0
+    
+    def update_block(self, values: Sequence[float]):
+        """Merge a whole block (parallel-variance combination)."""
+        n_b = len(values)
+        if not n_b:
+            return
+        if hasattr(values, 'astype'):  # NumPy array
+            mean_b = float(values.mean())
+            m2_b = float(((values - mean_b) ** 2).sum())
+        else:
+            mean_b = math.fsum(values) / n_b
+            m2_b = math.fsum((v - mean_b) ** 2 for v in values)
+        n_a = self.count
+        total = n_a + n_b
+        delta = mean_b - self.mean
+        self.mean += delta * n_b / total
+        self.m2 += m2_b + delta * delta * n_a * n_b / total
+        self.count = total
+    
+    @property
+    def variance(self) -> float:
+        return self.m2 / (self.count - 1) if self.count > 1 else 0.0
+    
+    @property
+    def rms(self) -> float:
+        if not self.count:
+            return 0.0
+        return math.sqrt(self.mean * self.mean + self.m2 / self.count)
+
+
+class SlidingMinMax:
+    """Min and max over the last window_s seconds via monotonic deques."""
+    
+    __slots__ = ("window_s", "_min", "_max")
+    
+    def __init__(self, window_s: float):
+        self.window_s = window_s
+        self._min: deque = deque()  # (t, v), values increasing
+        self._max: deque = deque()  # (t, v), values decreasing
+    
+    def update_block(self, timestamps: Sequence[float], values: Sequence[float]):
+        lo, hi = self._min, self._max
+        for t, v in zip(timestamps, values):
+            while lo and lo[-1][1] >= v:
+                lo.pop()
+            lo.append((t, v))
+            while hi and hi[-1][1] <= v:
+                hi.pop()
+            hi.append((t, v))
+        if len(timestamps):
+            cutoff = timestamps[-1] - self.window_s
+            while lo[0][0] < cutoff:
+                lo.popleft()
+            while hi[0][0] < cutoff:
+                hi.popleft()
+    
+    @property
+    def min(self) -> Optional[float]:
+        return float(self._min[0][1]) if self._min else None
+    
+    @property
+    def max(self) -> Optional[float]:
+        return float(self._max[0][1]) if self._max else None
+
+
+class P2Quantile:
+    """P-squared streaming quantile estimator (five markers, no stored samples)."""
+    
+    __slots__ = ("p", "q", "n", "np", "dn", "_initial")
+    
+    def __init__(self, p: float):
+        """Args:
+            p: Quantile in (0, 1), e.g. 0.95
+        """
+        self.p = p
+        self.q: List[float] = []
+        self.n = [0, 1, 2, 3, 4]
+        self.np = [0.0, 2 * p, 4 * p, 2 + 2 * p, 4.0]
+        self.dn = [0.0, p / 2, p, (1 + p) / 2, 1.0]
+        self._initial: List[float] = []
+    
+    def add(self, x: float):
+        if len(self._initial) < 5:
+            self._initial.append(x)
+            if len(self._initial) == 5:
+                self.q = sorted(self._initial)
+            return
+        q, n = self.q, self.n
+        if x < q[0]:
+            q[0] = x
+            k = 0
+        elif x >= q[4]:
+            q[4] = x
+            k = 3
+        else:
+            k = 0
+            while x >= q[k + 1]:
+                k += 1
+        for i in range(k + 1, 5):
+            n[i] += 1
+        nps, dn = self.np, self.dn
+        for i in range(5):
+            nps[i] += dn[i]
+        for i in (1, 2, 3):
+            d = nps[i] - n[i]
+            if (d >= 1 and n[i + 1] - n[i] > 1) or (d <= -1 and n[i - 1] - n[i] < -1):
+                d = 1 if d > 0 else -1
+                # Piecewise-parabolic prediction, linear if it would break ordering
+                qp = q[i] + d / (n[i + 1] - n[i - 1]) * (
+                    (n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i])
+                    + (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]))
+                if not q[i - 1] < qp < q[i + 1]:
+                    qp = q[i] + d * (q[i + d] - q[i]) / (n[i + d] - n[i])
+                q[i] = qp
+                n[i] += d
+    
+    @property
+    def value(self) -> Optional[float]:
+        if self.q:
+            return self.q[2]
+        if not self._initial:
+            return None
+        ordered = sorted(self._initial)
+        return ordered[min(len(ordered) - 1, int(self.p * len(ordered)))]
+
+
+class ChannelStats:
+    """All statistics for one channel."""
+    
+    def __init__(self, window_s: float = STATS_WINDOW_S,
+                 percentiles: Sequence[float] = STATS_PERCENTILES):
+        self.moments = Welford()
+        self.window = SlidingMinMax(window_s)
+        self.quantiles = {pct: P2Quantile(pct / 100.0) for pct in percentiles}
+        self.min_all = math.inf
+        self.max_all = -math.inf
+        self.last: Optional[float] = None
+    
+    def update(self, timestamps: Sequence[float], values: Sequence[float]):
+        if not len(values):
+            return
+        self.moments.update_block(values)
+        if hasattr(values, 'astype'):
+            values = values.tolist()  # Plain floats are much faster per sample
+        if hasattr(timestamps, 'astype'):
+            timestamps = timestamps.tolist()
+        self.window.update_block(timestamps, values)
+        self.min_all = min(self.min_all, min(values))
+        self.max_all = max(self.max_all, max(values))
+        for estimator in self.quantiles.values():
+            add = estimator.add
+            for v in values:
+                add(v)
+        self.last = values[-1]
+    
+    def snapshot(self) -> dict:
+        m = self.moments
+        result = {
+            "count": m.count,
+            "last": self.last,
+            "mean": m.mean,
+            "std": math.sqrt(m.variance),
+            "rms": m.rms,
+            "min": self.window.min,
+            "max": self.window.max,
+            "min_all": self.min_all if m.count else None,
+            "max_all": self.max_all if m.count else None,
+        }
+        for pct, estimator in self.quantiles.items():
+            result[f"p{pct:g}"] = estimator.value
+        return result
+
+
+class StatsTracker:
+    """Keeps ChannelStats for every (board, channel) seen on a bus."""
+    
+    def __init__(self, bus: SampleBus, window_s: float = STATS_WINDOW_S,
+                 percentiles: Sequence[float] = STATS_PERCENTILES):
+        self.bus = bus
+        self.window_s = window_s
+        self.percentiles = list(percentiles)
+        self.channels: Dict[Tuple[int, str], ChannelStats] = {}
+        self._lock = threading.Lock()
+        self._sub = None
+        self._stop = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+    
+    def start(self):
+        if self._thread is not None:
+            return
+        self._stop.clear()
+        self._sub = self.bus.subscribe(maxlen=1024, events=False)
+        self._thread = threading.Thread(target=self._run, name="channel-stats", daemon=True)
+        self._thread.start()
+    
+    def stop(self, timeout: float = 2.0):
+        self._stop.set()
+        if self._thread is not None:
+            self._thread.join(timeout)
+            self._thread = None
+        if self._sub is not None:
+            self._sub.close()
+            self._sub = None
+    
+    def update(self, block: SampleBlock):
+        """Fold one block in (also usable without the background thread)."""
+        key = (block.board, block.channel)
+        with self._lock:
+            stats = self.channels.get(key)
+            if stats is None:
+                stats = self.channels[key] = ChannelStats(self.window_s, self.percentiles)
+            stats.update(block.timestamps, block.values)
+    
+    def reset(self):
+        with self._lock:
+            self.channels.clear()
+    
+    def get(self, channel: str, board: int = 0) -> Optional[dict]:
+        """Snapshot of one channel, or None if it hasn't been seen."""
+        with self._lock:
+            stats = self.channels.get((board, channel))
+            return stats.snapshot() if stats else None
+    
+    def snapshot(self) -> Dict[str, Dict[str, dict]]:
+        """All channels as {board: {channel: stats}} (JSON-friendly keys)."""
+        with self._lock:
+            result: Dict[str, Dict[str, dict]] = {}
+            for (board, channel), stats in sorted(self.channels.items()):
+                result.setdefault(str(board), {})[channel] = stats.snapshot()
+            return result
+    
+    def _run(self):
+        while not self._stop.is_set():
+            self._sub.wait(0.2)
+            for block in self._sub.drain():
+                self.update(block)
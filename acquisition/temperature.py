@@ -0,0 +1,253 @@
+"""MCP9808 temperature sensors - polled on the engine's task thread or woken by ALERT.
+
+Polled sensors are read once per period by an AcquisitionEngine task (one
+2-byte read each) at the finest resolution whose conversion fits the period,
+and published as one SampleBlock per channel every block_ms.
+
+Event-mode sensors get a window (lower/upper/critical) programmed into the
+chip and their ALERT output, in comparator mode, wired to a J11 GPIO. The
+chip compares every conversion by itself and the bus stays idle until
+ALERT changes: a thread per GPIO sleeps on the kernel-timestamped edges
+(EdgeInput, both directions) and only then reads T_A, whose flag bits say
+which limit was crossed. Each change is published as an "alert" Event
+(source = I2C address, value = 1 above upper, 2 at/above critical, -1 below
+lower, 0 back inside) plus a one-sample block at the edge time. Several
+sensors may share one ALERT line (open drain, wired-OR); an edge then reads
+each of them.
+
+ALERT asserts above T_UPPER and stays asserted through T_CRIT, so crossing
+T_CRIT (either way) gives no edge: while a sensor is outside its window the
+thread re-reads it every ALERT_WAIT_S to catch those transitions.
+"""
+
+import sys
+import threading
+import time
+from typing import Dict, List, Optional, Tuple
+
+from config.acquisition_config import BLOCK_MS, TEMPERATURE_HYSTERESIS, TEMPERATURE_RATE_HZ
+from .bus import Event, SampleBlock, SampleBus
+
+# Wakeup interval of the ALERT threads when no edge comes (s); sensors outside
+# their window are re-read at this interval
+ALERT_WAIT_S = 0.5
+
+
+class TemperatureMonitor:
+    """Polls MCP9808s, or waits on their ALERT lines, and publishes on a SampleBus."""
+    
+    def __init__(self, bus: SampleBus, sensors: List[Tuple[str, object, Optional[dict]]],
+                 rate_hz: float = TEMPERATURE_RATE_HZ,
+                 hysteresis: float = TEMPERATURE_HYSTERESIS, lines: Optional[dict] = None,
+                 block_ms: float = BLOCK_MS, board: int = 0):
+        """Initialize monitor (sensors are configured in start()).
+
+        Args:
+            bus: Bus that receives the sample blocks and alert events
+            sensors: (name, hardware.mcp9808.MCP9808, window) triples; window is None
+                to poll, or {"pin", "lower", "upper", "critical"} for event mode
+            rate_hz: Poll rate of the polled sensors
+            hysteresis: ALERT hysteresis (degC) of the event-mode sensors
+            lines: EdgeInput-like objects by pin (default: EdgeInput on that pin)
+            block_ms: Publish interval of the polled samples
+            board: Board ID stamped on blocks and events
+        """
+        self.bus = bus
+        self.sensors = sensors
+        self.rate_hz = rate_hz
+        self.hysteresis = hysteresis
+        self.lines = dict(lines or {})
+        self.block_s = block_ms / 1000.0
+        self.board = board
+        self.engine = None
+        self.latest: Dict[str, float] = {}
+        self.states: Dict[str, int] = {}
+        self._started = False
+        self._buffer: List[tuple] = []
+        self._next_publish = 0.0
+        self._stop = threading.Event()
+        self._threads: List[threading.Thread] = []
+        self._opened: List[int] = []  # Pins whose EdgeInput start() opened
+        self.stats = {"polls": 0, "samples": 0, "read_errors": 0, "blocks": 0, "alerts": 0,
+                      "alert_reads": 0, "poll_s": 0.0, "max_poll_ms": 0.0}
+    
+    @classmethod
+    def from_specs(cls, specs: List[dict], bus: SampleBus, **kwargs) -> "TemperatureMonitor":
+        """Monitor for TEMPERATURE_SENSORS entries; sensors that don't answer are skipped."""
+        from hardware.i2c_bus import I2CBus
+        from hardware.mcp9808 import MCP9808
+        
+        buses: Dict[int, I2CBus] = {}
+        sensors = []
+        for spec in specs:
+            address = spec.get("address", 0x18)
+            try:
+                if spec["bus"] not in buses:
+                    buses[spec["bus"]] = I2CBus(spec["bus"])
+                sensor = MCP9808(buses[spec["bus"]], address)
+            except (ImportError, OSError) as e:
+                print(f"Temperature sensor {spec['bus']}:0x{address:02X} disabled: {e}",
+                      file=sys.stderr)
+                continue
+            index = len(sensors)
+            name = spec.get("name", "temp" if index == 0 else f"temp{index}")
+            window = None
+            if spec.get("alert_pin") is not None:
+                window = {key: spec.get(key) for key in ("lower", "upper", "critical")}
+                window["pin"] = spec["alert_pin"]
+            sensors.append((name, sensor, window))
+        return cls(bus, sensors, **kwargs)
+    
+    @property
+    def channels(self) -> List[str]:
+        return [name for name, _, _ in self.sensors]
+    
+    @property
+    def running(self) -> bool:
+        return self._started
+    
+    def start(self, engine=None) -> List[dict]:
+        """Configure the sensors, add the poll task and start the ALERT threads.
+
+        Without an engine the caller runs poll() at rate_hz itself.
+
+        Raises:
+            ValueError: Bad window
+            ImportError: python3-libgpiod missing for an ALERT pin
+            OSError: ALERT pin busy
+        """
+        from hardware.mcp9808 import resolution_for
+        
+        if self._started:
+            return self.get_stats()["sensors"]
+        by_pin: Dict[int, list] = {}
+        for name, sensor, window in self.sensors:
+            if window is None:
+                sensor.set_resolution(resolution_for(self.rate_hz))
+                continue
+            # The chip converts continuously either way; event mode costs no bus time
+            sensor.set_resolution(3)
+            sensor.set_alert(window["lower"], window["upper"], window.get("critical"),
+                             self.hysteresis)
+            by_pin.setdefault(window["pin"], []).append((name, sensor))
+        for pin in by_pin:
+            if pin not in self.lines:
+                from hardware.gpio_bank import EdgeInput
+                self.lines[pin] = EdgeInput(pin, both=True)
+                self._opened.append(pin)
+        self._stop.clear()
+        for pin, members in by_pin.items():
+            thread = threading.Thread(target=self._watch, args=(self.lines[pin], members),
+                                      name=f"mcp9808-alert-{pin}", daemon=True)
+            thread.start()
+            self._threads.append(thread)
+        self._started = True
+        self._next_publish = time.monotonic() + self.block_s
+        self.engine = engine
+        if engine is not None and any(window is None for _, _, window in self.sensors):
+            engine.add_task("temperature", 1.0 / self.rate_hz, self.poll)
+        return self.get_stats()["sensors"]
+    
+    def stop(self, timeout: float = 2.0):
+        """Remove the poll task, stop the ALERT threads and publish what is buffered."""
+        if self.engine is not None:
+            self.engine.remove_task("temperature")
+            self.engine = None
+        self._stop.set()
+        for thread in self._threads:
+            thread.join(timeout)
+        self._threads = []
+        for pin in self._opened:
+            self.lines.pop(pin).close()
+        self._opened = []
+        self._started = False
+        self._publish()
+    
+    def get_stats(self) -> dict:
+        stats = dict(self.stats)
+        polls = max(1, stats["polls"])
+        stats["mean_poll_ms"] = stats.pop("poll_s") / polls * 1000.0
+        stats["rate_hz"] = self.rate_hz
+        stats["sensors"] = [dict(name=name, address=sensor.address, resolution=sensor.resolution,
+                                 mode="poll" if window is None else "alert",
+                                 state=self.states.get(name), **(window or {}))
+                            for name, sensor, window in self.sensors]
+        return stats
+    
+    def poll(self):
+        """Read every polled sensor once (engine task)."""
+        start = time.monotonic()
+        for index, (name, sensor, window) in enumerate(self.sensors):
+            if window is not None:
+                continue
+            try:
+                celsius = sensor.read()
+            except OSError:
+                self.stats["read_errors"] += 1
+                continue
+            self._buffer.append((index, start, celsius))
+            self.stats["samples"] += 1
+        elapsed = time.monotonic() - start
+        self.stats["polls"] += 1
+        self.stats["poll_s"] += elapsed
+        self.stats["max_poll_ms"] = max(self.stats["max_poll_ms"], elapsed * 1000.0)
+        if time.monotonic() >= self._next_publish:
+            self._publish()
+            self._next_publish = time.monotonic() + self.block_s
+    
+    def _publish(self):
+        import numpy as np
+        
+        buffer, self._buffer = self._buffer, []
+        series: Dict[int, Tuple[list, list]] = {}
+        for index, stamp, celsius in buffer:
+            stamps, values = series.setdefault(index, ([], []))
+            stamps.append(stamp)
+            values.append(celsius)
+        for index, (stamps, values) in series.items():
+            name = self.sensors[index][0]
+            self.bus.publish(SampleBlock(name, np.array(stamps), np.array(values), self.board))
+            self.latest[name] = values[-1]
+            self.stats["blocks"] += 1
+    
+    def _watch(self, line, members):
+        """Sleep on one ALERT line; read its sensors only when it changes."""
+        from hardware.mcp9808 import RESOLUTIONS
+        
+        # Publish where each sensor stands once a conversion has seen the new window;
+        # edges report changes from there on
+        if self._stop.wait(RESOLUTIONS[3][1] / 1000.0):
+            return
+        self._read_members(members, time.monotonic())
+        while not self._stop.is_set():
+            try:
+                edges = line.read(ALERT_WAIT_S)
+            except OSError as e:
+                print(f"Temperature: ALERT line failed: {e}", file=sys.stderr)
+                return
+            if edges:
+                self._read_members(members, edges[-1])
+            else:
+                # No edge while ALERT stays asserted: look for T_CRIT crossings
+                outside = [(name, sensor) for name, sensor in members if self.states.get(name)]
+                if outside:
+                    self._read_members(outside, time.monotonic())
+    
+    def _read_members(self, members, stamp: float):
+        import numpy as np
+        
+        for name, sensor in members:
+            try:
+                celsius, state = sensor.read_state()
+            except OSError:
+                self.stats["read_errors"] += 1
+                continue
+            self.stats["alert_reads"] += 1
+            self.bus.publish(SampleBlock(name, np.array([stamp]), np.array([celsius]),
+                                         self.board))
+            self.latest[name] = celsius
+            self.stats["blocks"] += 1
+            if self.states.get(name, 0) != state:
+                self.bus.publish(Event("alert", stamp, sensor.address, state, self.board))
+                self.stats["alerts"] += 1
+            self.states[name] = state
@@ -0,0 +1,432 @@
+"""Conversion-time sample stamps and ADC clock-drift correction.
+
+The engine's default stamps (midpoint of each read call) carry Python
+scheduling jitter and the sleep between starting a conversion and reading
+it. TimedADC stamps every sample from when its conversion actually happened:
+
+    ready pin   ALERT/RDY wired to a GPIO (ADC_RDY_PIN) and timestamped by
+                the kernel; the conversion ended at the edge
+    data rate   no ready pin: one channel runs in continuous mode and
+                conversions fall on a grid of the data rate; multi-channel
+                single-shot conversions end one period after the config write
+
+Each sample is stamped at the middle of its conversion, since the
+delta-sigma converter averages the input over the whole conversion period.
+
+The ADS1x15's internal oscillator is only accurate to about +-10 %, so the
+nominal data rate is not used as is. DriftEstimator fits conversion times
+against conversion count (exponentially weighted least squares), and the
+fitted period is what places samples on the grid. The drift relative to
+the host clock is reported in ppm. Single-shot conversions are not on a
+grid, so there is no fit and no drift figure: with a ready pin the longest
+recent write-to-edge time stands in for the conversion time (the write is
+stamped after the I2C transfer returns, so it is only ever late) and is
+reported as such; without one the nominal period is used.
+
+Fits run on CLOCK_MONOTONIC_RAW, which NTP never slews, so slewing can't
+leak into the measured period. Stamps are converted to the bus timebase
+(time.monotonic()) when they are published, so they line up with
+everything else on the bus, including other boards.
+"""
+
+import threading
+import time
+from array import array
+from collections import deque
+from typing import Dict, List, Optional, Tuple
+
+from config.acquisition_config import ADC_DATA_RATE, ADC_DRIFT_TAU_S, ADC_RDY_PIN
+
+RAW_CLOCK = getattr(time, "CLOCK_MONOTONIC_RAW", time.CLOCK_MONOTONIC)
+
+
+def raw_clock() -> float:
+    return time.clock_gettime(RAW_CLOCK)
+
+
+def raw_to_monotonic() -> float:
+    """Current offset from the raw clock to time.monotonic() (tightest of three reads)."""
+    best = None
+    for _ in range(3):
+        m0 = time.monotonic()
+        r = raw_clock()
+        m1 = time.monotonic()
+        if best is None or m1 - m0 < best[0]:
+            best = (m1 - m0, (m0 + m1) * 0.5 - r)
+    return best[1]
+
+
+# Disciplined time.monotonic() -> Unix mapping (acquisition/clock.py); None = system clock
+_clock_reference = None
+
+
+def set_clock_reference(reference):
+    """Take wall-clock conversions from reference.unix_offset() (None = the system clock)."""
+    global _clock_reference
+    _clock_reference = reference
+
+
+def unix_offset() -> float:
+    """Offset from time.monotonic() to Unix seconds.
+
+    From the clock reference (an RTC disciplining the timestamps) while it is
+    locked, else from the system clock.
+    """
+    reference = _clock_reference
+    if reference is not None:
+        offset = reference.unix_offset()
+        if offset is not None:
+            return offset
+    return time.time() - time.monotonic()
+
+
+def clock_source() -> str:
+    """Where unix_offset() currently comes from: "rtc" or "system"."""
+    reference = _clock_reference
+    return "rtc" if reference is not None and reference.unix_offset() is not None else "system"
+
+
+class DriftEstimator:
+    """Fits t = origin + offset + period * k to conversion times with exponential forgetting."""
+    
+    REBASE_EVERY = 100000  # Conversions; keeps the weighted sums well conditioned
+    
+    def __init__(self, nominal_period: float, tau_s: float = ADC_DRIFT_TAU_S,
+                 gate: float = 0.25):
+        """Initialize estimator.
+
+        Args:
+            nominal_period: Conversion period from the data sheet (s)
+            tau_s: Forgetting time constant (s); longer = smoother, slower to follow
+            gate: Reject observations further than gate * period from the fit
+        """
+        self.nominal = nominal_period
+        self.period = nominal_period
+        self.gate = gate
+        self._forget = 1.0 - min(0.5, nominal_period / tau_s)
+        self.observations = 0
+        self.rejected = 0
+        self.missed = 0
+        self.residual_us = 0.0  # RMS of accepted residuals (exponentially weighted)
+        self.reset()
+    
+    @property
+    def ppm(self) -> float:
+        """ADC clock error vs the host; positive = ADC runs fast."""
+        return (self.nominal / self.period - 1.0) * 1e6
+    
+    @property
+    def locked(self) -> bool:
+        """Enough conversions fitted for the grid to predict the next ones."""
+        return self._fitted >= 16
+    
+    def next_time(self) -> float:
+        """Fitted time of the conversion after the last one counted."""
+        return self._origin + self._offset + self.period * (self._k + 1)
+    
+    def advance(self, steps: int = 1) -> float:
+        """Count conversions that ended unobserved; returns the fitted time of the last one."""
+        self.missed += steps - 1
+        self._k += steps
+        return self._origin + self._offset + self.period * self._k
+    
+    def reset(self):
+        """Forget the fit (keeps the current period as the starting point)."""
+        self._origin: Optional[float] = None
+        self._k = 0
+        self._offset = 0.0
+        self._fitted = 0
+        self._rejected_run = 0
+        # Weighted sums for the fit of x = t - origin against k
+        self._sw = self._sk = self._sx = self._skk = self._skx = 0.0
+    
+    def add(self, t: float, steps: Optional[int] = None) -> float:
+        """Add a conversion-complete time; returns the fitted time of that conversion.
+
+        Args:
+            t: Conversion-complete time
+            steps: Conversions since the previous call when the source counts them
+                (e.g. packets drained from a FIFO); None = infer from t
+        """
+        if self._origin is None:
+            self._origin = t
+            self._update(0, 0.0)
+            self.observations += 1
+            return t
+        x = t - self._origin
+        counted = steps is not None
+        if not counted:
+            steps = max(1, round((x - self._offset) / self.period - self._k))
+            if steps > 4 and not self.locked:
+                # The period is only nominal (+-10 %) until the fit locks, too coarse
+                # to count conversions across a gap: start over from this one
+                self.reset()
+                return self.add(t)
+        k = self._k + steps
+        residual = x - (self._offset + self.period * k)
+        if self.locked and abs(residual) > self.gate * self.period:
+            self.rejected += 1
+            self._rejected_run += 1
+            if counted:
+                self._k = k  # The count is exact even when the time is not
+            if self._rejected_run >= 64:
+                # Everything is off the grid (stream restarted, clock stepped)
+                self.reset()
+            return self._origin + self._offset + self.period * k
+        self._rejected_run = 0
+        if not counted:
+            self.missed += steps - 1
+        self._k = k
+        self._update(k, x)
+        self.observations += 1
+        self.residual_us = (0.95 * self.residual_us ** 2 + 0.05 * (residual * 1e6) ** 2) ** 0.5
+        fitted = self._origin + self._offset + self.period * k
+        if k >= self.REBASE_EVERY:
+            self._rebase()
+        return fitted
+    
+    def _update(self, k: int, x: float):
+        f = self._forget
+        self._sw = self._sw * f + 1.0
+        self._sk = self._sk * f + k
+        self._sx = self._sx * f + x
+        self._skk = self._skk * f + k * k
+        self._skx = self._skx * f + k * x
+        self._fitted += 1
+        denominator = self._sw * self._skk - self._sk * self._sk
+        # A few conversions' span can't resolve the period better than the nominal value
+        if self._fitted >= 16 and denominator > 0:
+            period = (self._sw * self._skx - self._sk * self._sx) / denominator
+            if 0.5 * self.nominal < period < 2.0 * self.nominal:
+                self.period = period
+        self._offset = (self._sx - self.period * self._sk) / self._sw
+    
+    def _rebase(self):
+        """Move the origin to the current conversion (k = 0) without changing the fit."""
+        big_k, c = self._k, self._offset + self.period * self._k
+        sw, sk, sx = self._sw, self._sk, self._sx
+        self._skx = self._skx - big_k * sx - c * sk + big_k * c * sw
+        self._skk = self._skk - 2 * big_k * sk + big_k * big_k * sw
+        self._sk = sk - big_k * sw
+        self._sx = sx - c * sw
+        self._origin += c
+        self._offset -= c - self.period * big_k
+        self._k = 0
+    
+    def get_stats(self) -> dict:
+        return {"period_us": self.period * 1e6, "ppm": self.ppm,
+                "residual_us": self.residual_us, "observations": self.observations,
+                "rejected": self.rejected, "missed": self.missed}
+
+
+class TimedADC:
+    """Block source of conversion-time stamped samples (see module docstring).
+
+    Wraps a register-level ADC (ADCManager on an explicit bus, or
+    VirtualADS1x15) and reads it on its own thread; the engine collects the
+    stamped samples once per block through read_block().
+    """
+    
+    def __init__(self, adc, channels: List[int], data_rate: Optional[int] = ADC_DATA_RATE,
+                 ready=None, ready_pin: Optional[int] = ADC_RDY_PIN):
+        """Initialize timed reader.
+
+        Args:
+            adc: Register-level ADC (configure / read_raw / code_to_volts)
+            channels: Channels to convert (one = continuous mode)
+            data_rate: ADC data rate (samples/s, shared by all channels); None = the
+                fastest the chip supports (860 on an ADS1115, 3300 on an ADS1015)
+            ready: EdgeInput-like object for ALERT/RDY (read(timeout) -> edge times)
+            ready_pin: BCM pin for an EdgeInput when ready isn't given (None = no pin)
+        """
+        if not hasattr(adc, "configure"):
+            raise ValueError("Timed sampling needs a register-level ADC (ADCManager with "
+                             "an explicit bus, or a virtual ADS1x15)")
+        rates = getattr(adc, "data_rates", None)
+        if rates is not None and data_rate not in rates + (None,):
+            raise ValueError(f"{adc.model} data rate must be one of {rates}")
+        self.adc = adc
+        self.channels = list(channels)
+        self.data_rate = data_rate or (rates[-1] if rates else 860)
+        if ready is None and ready_pin is not None:
+            from hardware.gpio_bank import EdgeInput
+            ready = EdgeInput(ready_pin)
+        self.ready = ready
+        self.continuous = len(self.channels) == 1
+        self.estimator = DriftEstimator(1.0 / self.data_rate)
+        self.latest: Dict[int, float] = {}
+        self.stats = {"samples": 0, "timeouts": 0, "read_errors": 0}
+        
+        self._lock = threading.Lock()
+        self._timestamps = {ch: array('d') for ch in self.channels}
+        self._values = {ch: array('d') for ch in self.channels}
+        self._durations = deque(maxlen=64)  # Single-shot write-to-edge times
+        self._conversion_s = 1.0 / self.data_rate  # Single-shot conversion time in use
+        self._stop = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+    
+    @property
+    def mode(self) -> str:
+        return ("continuous" if self.continuous else "single-shot") + \
+               (" + ready pin" if self.ready is not None else "")
+    
+    def start(self):
+        if self._thread is not None:
+            return
+        self._stop.clear()
+        target = self._run_continuous if self.continuous else self._run_single_shot
+        self._thread = threading.Thread(target=target, name="adc-timed", daemon=True)
+        self._thread.start()
+    
+    def stop(self):
+        self._stop.set()
+        if self._thread is not None:
+            self._thread.join(2.0)
+            self._thread = None
+            # Don't leave the chip converting continuously: the next user (a
+            # direct read, model detection) expects single-shot
+            try:
+                self.adc.power_down()
+            except OSError:
+                pass
+        if self.ready is not None:
+            self.ready.close()
+    
+    # Engine interface ---------------------------------------------------------
+    
+    def read_block(self, now: Optional[float] = None) -> Tuple[Dict[int, array], Dict[int, array]]:
+        """Samples stamped since the last call (per-channel timestamps, bus timebase)."""
+        with self._lock:
+            timestamps, values = self._timestamps, self._values
+            self._timestamps = {ch: array('d') for ch in self.channels}
+            self._values = {ch: array('d') for ch in self.channels}
+        offset = raw_to_monotonic()
+        for stamps in timestamps.values():
+            for i in range(len(stamps)):
+                stamps[i] += offset
+        return timestamps, values
+    
+    def read_channel(self, channel: int) -> Optional[float]:
+        """Latest converted value (the thread owns the ADC)."""
+        return self.latest.get(channel)
+    
+    def read_all_channels(self) -> Dict[int, Optional[float]]:
+        return {ch: self.latest.get(ch) for ch in range(4)}
+    
+    def get_stats(self) -> dict:
+        """Counters plus the drift fit (continuous); single-shot has no fit, so ppm is None."""
+        stats = dict(self.stats)
+        stats.update({"mode": self.mode, "data_rate": self.data_rate})
+        if self.continuous:
+            stats.update(self.estimator.get_stats())
+        else:
+            source = "write-to-ready max" if self._durations else "nominal"
+            stats.update({"ppm": None, "residual_us": None, "missed": None,
+                          "conversion_us": self._conversion_s * 1e6,
+                          "conversion_source": source})
+        return stats
+    
+    # Reader threads -----------------------------------------------------------
+    
+    def _store(self, ch: int, t_raw: float, code: int):
+        value = self.adc.code_to_volts(code)
+        with self._lock:
+            self._timestamps[ch].append(t_raw)
+            self._values[ch].append(value)
+        self.latest[ch] = value
+        self.stats["samples"] += 1
+    
+    def _read(self) -> Optional[int]:
+        try:
+            return self.adc.read_raw()
+        except OSError:
+            self.stats["read_errors"] += 1
+            return None
+    
+    def _run_continuous(self):
+        ch = self.channels[0]
+        estimator = self.estimator
+        period, _ = self.adc.configure(ch, self.data_rate, continuous=True,
+                                       ready=self.ready is not None)
+        if self.ready is not None:
+            while not self._stop.is_set():
+                edges = self.ready.read(0.1)
+                if not edges:
+                    self.stats["timeouts"] += 1
+                    continue
+                code = self._read()
+                if code is None:
+                    continue
+                offset = raw_to_monotonic()
+                # Only the newest conversion is still in the register; older edges
+                # still refine the fit
+                for edge in edges:
+                    end = estimator.add(edge - offset)
+                self._store(ch, end - estimator.period * 0.5, code)
+            return
+        
+        # No ready pin: poll at four times the data rate. The register changes when
+        # a conversion ends, so the first poll showing a new value puts that end
+        # between it and the previous poll; the fit averages that out. At 3300 SPS
+        # (ADS1015) a read takes half a period or more at 400 kHz, so polls run back
+        # to back and the bound is the measured gap, not the nominal interval; stamps
+        # at that rate are only exact with a ready pin.
+        # A quiet input repeats codes (often, at 12 bits); once the grid is locked,
+        # a conversion the fit says ended before a read started is stored even
+        # when its code is unchanged.
+        poll = period * 0.25
+        estimator.gate = 0.4
+        guard = period * 0.25
+        previous = None
+        next_poll = last = raw_clock()
+        while not self._stop.is_set():
+            delay = next_poll - raw_clock()
+            if delay > 0:
+                time.sleep(delay)
+            before = raw_clock()
+            # A late poll (or a read slower than the interval) doesn't add a sleep
+            next_poll = max(next_poll, before) + poll
+            code = self._read()
+            seen = raw_clock()
+            since, last = last, seen
+            if code is None:
+                continue
+            if code == previous:
+                if estimator.locked:
+                    steps = int((before - guard - estimator.next_time()) // estimator.period) + 1
+                    if steps > 0:
+                        end = estimator.advance(steps)
+                        self._store(ch, end - estimator.period * 0.5, code)
+                continue
+            previous = code
+            end = estimator.add((since + seen) * 0.5)
+            self._store(ch, end - estimator.period * 0.5, code)
+    
+    def _run_single_shot(self):
+        nominal = 1.0 / self.data_rate
+        ready = self.ready
+        while not self._stop.is_set():
+            for ch in self.channels:
+                try:
+                    _, started = self.adc.configure(ch, self.data_rate, ready=ready is not None)
+                except OSError:
+                    self.stats["read_errors"] += 1
+                    self._stop.wait(nominal)
+                    continue
+                if ready is not None:
+                    edges = ready.read(nominal * 3)
+                    if not edges:
+                        self.stats["timeouts"] += 1
+                        continue
+                    end = edges[-1] - raw_to_monotonic()
+                    # The write stamp is only ever late, so the longest recent
+                    # write-to-edge time is closest to the conversion time
+                    self._durations.append(end - started)
+                    self._conversion_s = max(self._durations)
+                else:
+                    # ADCManager's direct read waits 1.3 periods for the same reason
+                    time.sleep(nominal * 1.3)
+                    end = started + nominal
+                code = self._read()
+                if code is not None:
+                    self._store(ch, end - self._conversion_s * 0.5, code)
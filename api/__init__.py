@@ -0,0 +1 @@
+"""External interfaces - local streaming API."""
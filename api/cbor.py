@@ -0,0 +1,163 @@
+"""Minimal CBOR (RFC 8949) encoder/decoder for publish payloads.
+
+Supports the subset the publishers need: ints, floats, strings, bytes,
+lists, dicts, bools and None. Float sample arrays are written as RFC 8746
+typed arrays (tag 85, float32 little-endian) so a batch of N samples costs
+4*N bytes plus a few bytes of framing.
+"""
+
+import struct
+import sys
+from array import array
+from typing import Any
+
+TAG_F32LE_ARRAY = 85
+
+_SWAP = sys.byteorder != "little"
+
+
+class Float32Array:
+    """Marker wrapper: encode a sequence of floats as a float32 typed array."""
+    
+    __slots__ = ("values",)
+    
+    def __init__(self, values):
+        self.values = values
+    
+    def tobytes(self) -> bytes:
+        values = self.values
+        if hasattr(values, 'astype'):  # NumPy array
+            return values.astype('<f4').tobytes()
+        packed = array('f', values)
+        if _SWAP:
+            packed.byteswap()
+        return packed.tobytes()
+
+
+def _head(major: int, value: int) -> bytes:
+    if value < 24:
+        return bytes([(major << 5) | value])
+    if value < 0x100:
+        return bytes([(major << 5) | 24, value])
+    if value < 0x10000:
+        return struct.pack(">BH", (major << 5) | 25, value)
+    if value < 0x100000000:
+        return struct.pack(">BI", (major << 5) | 26, value)
+    return struct.pack(">BQ", (major << 5) | 27, value)
+
+
+def _encode(obj: Any, out: list):
+    if obj is None:
+        out.append(b"\xf6")
+    elif obj is True:
+        out.append(b"\xf5")
+    elif obj is False:
+        out.append(b"\xf4")
+    elif isinstance(obj, int):
+        out.append(_head(0, obj) if obj >= 0 else _head(1, -1 - obj))
+    elif isinstance(obj, float):
+        out.append(struct.pack(">Bd", 0xFB, obj))
+    elif isinstance(obj, str):
+        data = obj.encode("utf-8")
+        out.append(_head(3, len(data)))
+        out.append(data)
+    elif isinstance(obj, (bytes, bytearray, memoryview)):
+        out.append(_head(2, len(obj)))
+        out.append(bytes(obj))
+    elif isinstance(obj, Float32Array):
+        data = obj.tobytes()
+        out.append(_head(6, TAG_F32LE_ARRAY))
+        out.append(_head(2, len(data)))
+        out.append(data)
+    elif isinstance(obj, dict):
+        out.append(_head(5, len(obj)))
+        for key, value in obj.items():
+            _encode(key, out)
+            _encode(value, out)
+    elif isinstance(obj, (list, tuple)):
+        out.append(_head(4, len(obj)))
+        for item in obj:
+            _encode(item, out)
+    else:
+        raise TypeError(f"Cannot CBOR-encode {type(obj).__name__}")
+
+
+def dumps(obj: Any) -> bytes:
+    """Encode obj as CBOR."""
+    out = []
+    _encode(obj, out)
+    return b"".join(out)
+
+
+def loads(data: bytes) -> Any:
+    """Decode CBOR produced by dumps() (float32 typed arrays become array('f'))."""
+    value, _ = _decode(memoryview(data), 0)
+    return value
+
+
+def _decode(data: memoryview, pos: int):
+    initial = data[pos]
+    major, info = initial >> 5, initial & 0x1F
+    pos += 1
+    if major == 7:
+        if info == 20:
+            return False, pos
+        if info == 21:
+            return True, pos
+        if info == 22:
+            return None, pos
+        if info == 25:
+            return struct.unpack_from(">e", data, pos)[0], pos + 2
+        if info == 26:
+            return struct.unpack_from(">f", data, pos)[0], pos + 4
+        if info == 27:
+            return struct.unpack_from(">d", data, pos)[0], pos + 8
+        raise ValueError(f"Unsupported simple value {info}")
+    
+    if info < 24:
+        value = info
+    elif info == 24:
+        value = data[pos]
+        pos += 1
+    elif info == 25:
+        value = struct.unpack_from(">H", data, pos)[0]
+        pos += 2
+    elif info == 26:
+        value = struct.unpack_from(">I", data, pos)[0]
+        pos += 4
+    elif info == 27:
+        value = struct.unpack_from(">Q", data, pos)[0]
+        pos += 8
+    else:
+        raise ValueError("Indefinite lengths not supported")
+    
+    if major == 0:
+        return value, pos
+    if major == 1:
+        return -1 - value, pos
+    if major == 2:
+        return bytes(data[pos:pos + value]), pos + value
+    if major == 3:
+        return str(data[pos:pos + value], "utf-8"), pos + value
+    if major == 4:
+        items = []
+        for _ in range(value):
+            item, pos = _decode(data, pos)
+            items.append(item)
+        return items, pos
+    if major == 5:
+        result = {}
+        for _ in range(value):
+            key, pos = _decode(data, pos)
+            result[key], pos = _decode(data, pos)
+        return result, pos
+    if major == 6:
+        inner, pos = _decode(data, pos)
+        if value == TAG_F32LE_ARRAY:
+            floats = array('f')
+            floats.frombytes(inner)
+            if _SWAP:
+                floats.byteswap()
+            return floats, pos
+        return inner, pos
+    raise ValueError(f"Unsupported major type {major}")
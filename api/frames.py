@@ -0,0 +1,153 @@
+"""Compact binary frame encoding for streamed samples and events.
+
+All fields are little-endian. One frame carries one batch:
+
+    Header   magic "SB" | version u8 | flags u8 | seq u32 | t_ref f64
+             | n_blocks u16 | n_events u16                      (20 bytes)
+    Block    channel_id u16 | board u8 | count u16 | t0 f64 | dt f32
+             | values f32[count]
+             | [time offsets from t0, f32[count], if FLAG_TIMESTAMPS]
+    Event    kind u8 | board u8 | source u16 | t f32 (relative to t_ref)
+             | value i32                                         (12 bytes)
+
+A block longer than MAX_BLOCK_SAMPLES (the u16 count) is sent as several
+consecutive blocks of the same channel, each with its own t0 and dt. Events
+have no such continuation: a batch of more than MAX_FRAME_EVENTS keeps the
+newest (a full bus queue drops the oldest too) and sets FLAG_EVENTS_DROPPED.
+
+Channel names are mapped to channel_id by the sender and announced
+separately (see ChannelTable).
+"""
+
+import struct
+import sys
+from array import array
+from typing import Dict, List, Sequence, Tuple
+
+from acquisition.bus import Event, SampleBlock
+
+MAGIC = b"SB"
+VERSION = 1
+
+# Frame flags
+FLAG_TIMESTAMPS = 0x01  # Blocks carry per-sample time offsets
+FLAG_EVENTS_DROPPED = 0x02  # The batch had more than MAX_FRAME_EVENTS events
+
+# Event kind codes
+EVENT_KINDS = {"gpio": 1, "i2c": 2, "rule": 3, "alert": 4}
+EVENT_NAMES = {code: name for name, code in EVENT_KINDS.items()}
+
+HEADER = struct.Struct("<2sBBIdHH")
+BLOCK = struct.Struct("<HBHdf")
+EVENT = struct.Struct("<BBHfi")
+
+# Largest count a Block can carry; longer sample blocks are split
+MAX_BLOCK_SAMPLES = 0xFFFF
+
+# Most events one frame can carry (the u16 n_events)
+MAX_FRAME_EVENTS = 0xFFFF
+
+_SWAP = sys.byteorder != "little"
+
+
+def _f32(values: Sequence[float]) -> bytes:
+    """Pack values as little-endian float32."""
+    if hasattr(values, 'astype'):  # NumPy array
+        return values.astype('<f4').tobytes()
+    packed = array('f', values)
+    if _SWAP:
+        packed.byteswap()
+    return packed.tobytes()
+
+
+class ChannelTable:
+    """Assigns stable numeric IDs to channel names."""
+    
+    def __init__(self):
+        self.ids: Dict[str, int] = {}
+    
+    def lookup(self, name: str) -> Tuple[int, bool]:
+        """Get the ID for a channel name.
+
+        Returns:
+            (channel_id, is_new) - is_new is True the first time a name is seen
+        """
+        channel_id = self.ids.get(name)
+        if channel_id is not None:
+            return channel_id, False
+        channel_id = len(self.ids)
+        self.ids[name] = channel_id
+        return channel_id, True
+
+
+def encode_frame(seq: int, t_ref: float, blocks: List[Tuple[int, SampleBlock]],
+                 events: List[Event], timestamps: bool = False,
+                 time_offset: float = 0.0) -> bytes:
+    """Encode one batch.
+
+    Args:
+        seq: Frame sequence number (wraps at 2^32)
+        t_ref: Reference time for event offsets (monotonic seconds)
+        blocks: (channel_id, block) pairs; a block of more than MAX_BLOCK_SAMPLES
+            samples is encoded as several frame blocks
+        events: Events in this batch (the newest MAX_FRAME_EVENTS are sent)
+        timestamps: Include per-sample time offsets instead of t0/dt only
+        time_offset: Added to t_ref and t0 (e.g. monotonic -> Unix time)
+    """
+    flags = FLAG_TIMESTAMPS if timestamps else 0
+    if len(events) > MAX_FRAME_EVENTS:
+        events = events[-MAX_FRAME_EVENTS:]
+        flags |= FLAG_EVENTS_DROPPED
+    parts = [b""]  # Header, packed once the number of frame blocks is known
+    n_blocks = 0
+    for channel_id, block in blocks:
+        for start in range(0, max(1, len(block.timestamps)), MAX_BLOCK_SAMPLES):
+            ts = block.timestamps[start:start + MAX_BLOCK_SAMPLES]
+            count = len(ts)
+            t0 = ts[0] if count else t_ref
+            dt = (ts[-1] - t0) / (count - 1) if count > 1 else 0.0
+            parts.append(BLOCK.pack(channel_id, block.board, count, t0 + time_offset, dt))
+            parts.append(_f32(block.values[start:start + MAX_BLOCK_SAMPLES]))
+            if timestamps:
+                parts.append(_f32(ts - t0 if hasattr(ts, 'astype') else [t - t0 for t in ts]))
+            n_blocks += 1
+    for event in events:
+        parts.append(EVENT.pack(EVENT_KINDS.get(event.kind, 0), event.board,
+                                event.source & 0xFFFF, event.timestamp - t_ref, event.value))
+    parts[0] = HEADER.pack(MAGIC, VERSION, flags, seq & 0xFFFFFFFF, t_ref + time_offset,
+                           n_blocks, len(events))
+    return b"".join(parts)
+
+
+def decode_frame(data: bytes) -> dict:
+    """Decode a frame produced by encode_frame (used by tools and tests)."""
+    magic, version, flags, seq, t_ref, n_blocks, n_events = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError("Not a sample frame")
+    offset = HEADER.size
+    blocks = []
+    for _ in range(n_blocks):
+        channel_id, board, count, t0, dt = BLOCK.unpack_from(data, offset)
+        offset += BLOCK.size
+        values = array('f')
+        values.frombytes(data[offset:offset + 4 * count])
+        offset += 4 * count
+        offsets = None
+        if flags & FLAG_TIMESTAMPS:
+            offsets = array('f')
+            offsets.frombytes(data[offset:offset + 4 * count])
+            offset += 4 * count
+        if _SWAP:
+            values.byteswap()
+            if offsets is not None:
+                offsets.byteswap()
+        blocks.append({"channel_id": channel_id, "board": board, "t0": t0, "dt": dt,
+                       "values": values, "offsets": offsets})
+    events = []
+    for _ in range(n_events):
+        kind, board, source, t, value = EVENT.unpack_from(data, offset)
+        offset += EVENT.size
+        events.append({"kind": EVENT_NAMES.get(kind, "unknown"), "board": board,
+                       "source": source, "timestamp": t_ref + t, "value": value})
+    return {"version": version, "seq": seq, "t_ref": t_ref, "blocks": blocks, "events": events,
+            "events_dropped": bool(flags & FLAG_EVENTS_DROPPED)}
@@ -0,0 +1,175 @@
+"""Minimal MQTT 3.1.1 publish-only client.
+
+Only what the publisher needs: CONNECT, PUBLISH (QoS 0/1), PUBACK handling,
+PINGREQ and DISCONNECT over a plain TCP socket. Keeping it in-tree avoids
+an extra dependency on the Pi image. Any socket error raises
+MQTTConnectionError; the caller decides whether to reconnect or spool.
+"""
+
+import select
+import socket
+import struct
+import time
+from typing import Dict, List, Optional, Tuple
+
+CONNECT = 0x10
+CONNACK = 0x20
+PUBLISH = 0x30
+PUBACK = 0x40
+PINGREQ = 0xC0
+PINGRESP = 0xD0
+DISCONNECT = 0xE0
+
+
+class MQTTConnectionError(Exception):
+    """Connection to the broker failed or was lost."""
+
+
+def _varint(value: int) -> bytes:
+    out = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+
+def _string(value: str) -> bytes:
+    data = value.encode("utf-8")
+    return struct.pack("!H", len(data)) + data
+
+
+def _packet(first_byte: int, body: bytes) -> bytes:
+    return bytes([first_byte]) + _varint(len(body)) + body
+
+
+class MQTTClient:
+    """Blocking MQTT client used from a single publisher thread."""
+    
+    def __init__(self, host: str, port: int = 1883, client_id: str = "device-panel",
+                 keepalive: int = 30, timeout: float = 5.0, max_inflight: int = 32):
+        self.host = host
+        self.port = port
+        self.client_id = client_id
+        self.keepalive = keepalive
+        self.timeout = timeout
+        self.max_inflight = max_inflight
+        self.sock: Optional[socket.socket] = None
+        # packet id -> (topic, payload) of QoS 1 messages awaiting PUBACK
+        self.inflight: Dict[int, Tuple[str, bytes]] = {}
+        self._next_id = 1
+        self._rx = bytearray()
+        self._last_tx = 0.0
+    
+    @property
+    def connected(self) -> bool:
+        return self.sock is not None
+    
+    def connect(self):
+        """Open the TCP connection and complete the MQTT handshake."""
+        try:
+            sock = socket.create_connection((self.host, self.port), timeout=self.timeout)
+            sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+            body = (_string("MQTT") + bytes([4, 0x02]) + struct.pack("!H", self.keepalive)
+                    + _string(self.client_id))
+            sock.sendall(_packet(CONNECT, body))
+            response = b""
+            while len(response) < 4:
+                chunk = sock.recv(4 - len(response))
+                if not chunk:
+                    raise MQTTConnectionError("Broker closed connection during CONNECT")
+                response += chunk
+        except OSError as e:
+            raise MQTTConnectionError(f"Connect to {self.host}:{self.port} failed: {e}")
+        if response[0] != CONNACK or response[3] != 0:
+            sock.close()
+            raise MQTTConnectionError(f"Broker refused connection (code {response[3]})")
+        self.sock = sock
+        self._rx.clear()
+        self._last_tx = time.monotonic()
+    
+    def close(self, graceful: bool = True):
+        """Close the connection (sends DISCONNECT when graceful)."""
+        if self.sock is None:
+            return
+        try:
+            if graceful:
+                self.sock.sendall(_packet(DISCONNECT, b""))
+            self.sock.close()
+        except OSError:
+            pass
+        self.sock = None
+    
+    def take_inflight(self) -> List[Tuple[str, bytes]]:
+        """Remove and return unacknowledged QoS 1 messages (for re-sending)."""
+        messages = [self.inflight[pid] for pid in sorted(self.inflight)]
+        self.inflight.clear()
+        return messages
+    
+    def publish(self, topic: str, payload: bytes, qos: int = 0, retain: bool = False):
+        """Send a PUBLISH; with QoS 1, blocks only while the inflight window is full."""
+        if self.sock is None:
+            raise MQTTConnectionError("Not connected")
+        body = _string(topic)
+        if qos:
+            while len(self.inflight) >= self.max_inflight:
+                self.poll(self.timeout)
+                if len(self.inflight) >= self.max_inflight:
+                    self._fail("PUBACK timeout")
+            packet_id = self._next_id
+            self._next_id = packet_id % 0xFFFF + 1
+            body += struct.pack("!H", packet_id)
+            self.inflight[packet_id] = (topic, payload)
+        self._send(_packet(PUBLISH | (qos << 1) | int(retain), body + payload))
+    
+    def poll(self, timeout: float = 0.0):
+        """Process incoming PUBACK/PINGRESP packets and send keepalive pings."""
+        if self.sock is None:
+            return
+        if time.monotonic() - self._last_tx > self.keepalive / 2:
+            self._send(_packet(PINGREQ, b""))
+        try:
+            readable, _, _ = select.select([self.sock], [], [], timeout)
+            if readable:
+                chunk = self.sock.recv(65536)
+                if not chunk:
+                    self._fail("Broker closed connection")
+                self._rx += chunk
+        except OSError as e:
+            self._fail(str(e))
+        self._parse()
+    
+    def _parse(self):
+        rx = self._rx
+        while len(rx) >= 2:
+            length, shift, pos = 0, 0, 1
+            while True:
+                if pos >= len(rx):
+                    return
+                byte = rx[pos]
+                length |= (byte & 0x7F) << shift
+                shift += 7
+                pos += 1
+                if not byte & 0x80:
+                    break
+            if len(rx) < pos + length:
+                return
+            kind = rx[0] & 0xF0
+            if kind == PUBACK and length >= 2:
+                packet_id = struct.unpack_from("!H", rx, pos)[0]
+                self.inflight.pop(packet_id, None)
+            del rx[:pos + length]
+    
+    def _send(self, data: bytes):
+        try:
+            self.sock.sendall(data)
+        except OSError as e:
+            self._fail(str(e))
+        self._last_tx = time.monotonic()
+    
+    def _fail(self, reason: str):
+        self.close(graceful=False)
+        raise MQTTConnectionError(reason)
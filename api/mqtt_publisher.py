@@ -0,0 +1,253 @@
+"""MQTT publisher stage - batches the sample bus into broker messages.
+
+Samples are coalesced per channel and emitted as one message per batch on
+<prefix>/samples (plus retained <prefix>/channels in binary mode). While the
+broker is unreachable, messages go to a bounded DiskSpool; after reconnect
+the backlog is replayed at MQTT_REPLAY_RATE messages/s ahead of new data,
+so ordering is kept and the broker isn't flooded.
+
+Payload formats:
+    cbor    {"v": 1, "host", "seq", "t": <unix>, "channels": [{"name", "board",
+            "t0": <unix>, "dt", "values": float32 typed array}], "events": [...]}
+    binary  api.frames layout with times converted to Unix seconds
+"""
+
+import json
+import socket
+import sys
+import threading
+import time
+from array import array
+from typing import Dict, List, Optional, Tuple
+
+from acquisition.bus import Event, SampleBlock, SampleBus
+from acquisition.timing import unix_offset
+from config.api_config import (MQTT_BATCH_MS, MQTT_CLIENT_ID, MQTT_FORMAT, MQTT_HOST,
+                               MQTT_MAX_PAYLOAD, MQTT_PORT, MQTT_QOS, MQTT_RECONNECT_S,
+                               MQTT_REPLAY_RATE, MQTT_SPOOL_DIR, MQTT_SPOOL_MAX_BYTES,
+                               MQTT_TOPIC_PREFIX)
+from . import cbor
+from .frames import ChannelTable, encode_frame
+from .mqtt import MQTTClient, MQTTConnectionError
+from .spool import DiskSpool
+
+
+def _concat(parts):
+    """Join sample sequences from several blocks of one channel."""
+    if len(parts) == 1:
+        return parts[0]
+    if hasattr(parts[0], 'astype'):  # NumPy arrays
+        import numpy as np
+        return np.concatenate(parts)
+    joined = array('d')
+    for part in parts:
+        joined.extend(part)
+    return joined
+
+
+class MqttPublisher:
+    """Publishes bus data to an MQTT broker with offline spooling."""
+    
+    def __init__(self, bus: SampleBus, host: str = MQTT_HOST, port: int = MQTT_PORT,
+                 topic_prefix: Optional[str] = MQTT_TOPIC_PREFIX, fmt: str = MQTT_FORMAT,
+                 qos: int = MQTT_QOS, batch_ms: float = MQTT_BATCH_MS,
+                 max_payload: int = MQTT_MAX_PAYLOAD, spool_dir: str = MQTT_SPOOL_DIR,
+                 spool_max_bytes: int = MQTT_SPOOL_MAX_BYTES,
+                 replay_rate: float = MQTT_REPLAY_RATE, client_id: Optional[str] = MQTT_CLIENT_ID):
+        hostname = socket.gethostname()
+        self.bus = bus
+        self.fmt = fmt
+        self.qos = qos
+        self.batch_s = batch_ms / 1000.0
+        self.max_payload = max_payload
+        self.replay_rate = replay_rate
+        self.hostname = hostname
+        self.prefix = topic_prefix or f"sensor-shield/{hostname}"
+        self.client = MQTTClient(host, port, client_id or f"device-panel-{hostname}")
+        self.spool = DiskSpool(spool_dir, spool_max_bytes)
+        self.channels = ChannelTable()
+        
+        self._pending: Dict[Tuple[int, str], List[SampleBlock]] = {}
+        self._pending_events: List[Event] = []
+        self._pending_bytes = 0
+        self._pending_since = 0.0
+        self._seq = 0
+        self._tokens = 0.0
+        self._last_service = time.monotonic()
+        self._next_connect = 0.0
+        self._sub = None
+        self._stop = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+        
+        self.stats = {
+            "published": 0,
+            "replayed": 0,
+            "spooled": 0,
+            "bytes": 0,
+            "reconnects": 0,
+            "last_error": None,
+        }
+    
+    def start(self):
+        """Subscribe to the bus and start the publisher thread."""
+        if self._thread is not None:
+            return
+        self._stop.clear()
+        self._sub = self.bus.subscribe(maxlen=4096)
+        self._thread = threading.Thread(target=self._run, name="mqtt-publisher", daemon=True)
+        self._thread.start()
+    
+    def stop(self, timeout: float = 5.0):
+        """Flush pending data (to broker or spool) and stop."""
+        self._stop.set()
+        if self._thread is not None:
+            self._thread.join(timeout)
+            self._thread = None
+        if self._sub is not None:
+            self._sub.close()
+            self._sub = None
+        self.client.close()
+        self.spool.close()
+    
+    def get_stats(self) -> dict:
+        stats = dict(self.stats)
+        stats.update({
+            "connected": self.client.connected,
+            "spool_messages": len(self.spool),
+            "spool_bytes": self.spool.size_bytes,
+            "spool_dropped": self.spool.dropped,
+            "bus_dropped": self._sub.dropped if self._sub else 0,
+        })
+        return stats
+    
+    def _run(self):
+        while not self._stop.is_set():
+            self._sub.wait(0.05)
+            self._collect(self._sub.drain())
+            now = time.monotonic()
+            if self._pending_bytes and (self._pending_bytes >= self.max_payload
+                                        or now - self._pending_since >= self.batch_s):
+                self._emit(self._pack())
+            self._service()
+        # Final flush: whatever is left goes to the broker or the spool
+        self._collect(self._sub.drain())
+        if self._pending_bytes:
+            self._emit(self._pack())
+    
+    def _collect(self, items):
+        for item in items:
+            if not self._pending_bytes:
+                self._pending_since = time.monotonic()
+            if isinstance(item, SampleBlock):
+                self._pending.setdefault((item.board, item.channel), []).append(item)
+                self._pending_bytes += 4 * len(item.values) + 24
+            else:
+                self._pending_events.append(item)
+                self._pending_bytes += 16
+    
+    def _pack(self) -> bytes:
+        """Encode everything pending as one payload."""
+        offset = unix_offset()  # monotonic -> Unix seconds
+        merged = []
+        for (board, channel), blocks in self._pending.items():
+            merged.append(SampleBlock(channel, _concat([b.timestamps for b in blocks]),
+                                      _concat([b.values for b in blocks]), board))
+        events = self._pending_events
+        self._pending = {}
+        self._pending_events = []
+        self._pending_bytes = 0
+        self._seq += 1
+        
+        if self.fmt == "binary":
+            ids = [self.channels.lookup(block.channel) for block in merged]
+            if any(is_new for _, is_new in ids) and self.client.connected:
+                self._publish_channels()
+            return encode_frame(self._seq, time.monotonic(),
+                                [(cid, block) for (cid, _), block in zip(ids, merged)],
+                                events, time_offset=offset)
+        
+        channels = []
+        for block in merged:
+            ts = block.timestamps
+            count = len(ts)
+            channels.append({
+                "name": block.channel,
+                "board": block.board,
+                "t0": ts[0] + offset,
+                "dt": (ts[-1] - ts[0]) / (count - 1) if count > 1 else 0.0,
+                "values": cbor.Float32Array(block.values),
+            })
+        return cbor.dumps({
+            "v": 1,
+            "host": self.hostname,
+            "seq": self._seq,
+            "t": time.time(),
+            "channels": channels,
+            "events": [{"kind": e.kind, "t": e.timestamp + offset, "source": e.source,
+                        "value": e.value, "board": e.board} for e in events],
+        })
+    
+    def _emit(self, payload: bytes):
+        topic = f"{self.prefix}/samples"
+        if self.client.connected and not len(self.spool):
+            try:
+                self.client.publish(topic, payload, self.qos)
+                self.stats["published"] += 1
+                self.stats["bytes"] += len(payload)
+                return
+            except MQTTConnectionError as e:
+                self._on_disconnect(e)
+        self.spool.append(topic, payload)
+        self.stats["spooled"] += 1
+    
+    def _publish_channels(self):
+        self.client.publish(f"{self.prefix}/channels", json.dumps(self.channels.ids).encode(),
+                            qos=1, retain=True)
+    
+    def _on_disconnect(self, error: Exception):
+        self.stats["last_error"] = str(error)
+        self.client.close(graceful=False)
+        # Unacknowledged QoS 1 messages go back into the spool
+        for topic, payload in self.client.take_inflight():
+            self.spool.append(topic, payload)
+            self.stats["spooled"] += 1
+        self._next_connect = time.monotonic() + MQTT_RECONNECT_S
+        print(f"MQTT: connection lost ({error}), spooling to {self.spool.directory}",
+              file=sys.stderr)
+    
+    def _service(self):
+        """Reconnect, handle acks and replay the spool at a limited rate."""
+        now = time.monotonic()
+        elapsed = now - self._last_service
+        self._last_service = now
+        try:
+            if not self.client.connected:
+                if now < self._next_connect:
+                    return
+                try:
+                    self.client.connect()
+                except MQTTConnectionError as e:
+                    self.stats["last_error"] = str(e)
+                    self._next_connect = now + MQTT_RECONNECT_S
+                    return
+                self.stats["reconnects"] += 1
+                self._tokens = 0.0
+                if self.fmt == "binary" and self.channels.ids:
+                    self._publish_channels()
+            
+            self.client.poll(0.0)
+            
+            # Token bucket: at most replay_rate messages/s, burst of one second
+            self._tokens = min(self.replay_rate, self._tokens + elapsed * self.replay_rate)
+            while self._tokens >= 1.0:
+                record = self.spool.peek()
+                if record is None:
+                    break
+                topic, payload = record
+                self.client.publish(topic, payload, self.qos)
+                self.spool.pop()
+                self._tokens -= 1.0
+                self.stats["replayed"] += 1
+                self.stats["bytes"] += len(payload)
+        except MQTTConnectionError as e:
+            self._on_disconnect(e)
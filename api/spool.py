@@ -0,0 +1,185 @@
+"""Bounded on-disk FIFO for messages that could not be delivered.
+
+Records are appended to segment files in a spool directory; the oldest
+segment is deleted once it has been consumed. When the spool exceeds its
+byte limit the oldest whole segment is discarded (and counted), so a long
+outage costs bounded disk space and the newest data is kept.
+
+The read position is persisted, so undelivered messages survive a restart.
+Delivery is at-least-once: after a crash a few messages may be sent twice.
+"""
+
+import os
+import struct
+from typing import List, Optional, Tuple
+
+RECORD = struct.Struct("<HI")  # topic length, payload length
+
+
+class DiskSpool:
+    """Append-only segmented message queue on disk."""
+    
+    def __init__(self, directory: str, max_bytes: int, segment_bytes: int = 1024 * 1024):
+        """Initialize spool.
+
+        Args:
+            directory: Spool directory (created if missing)
+            max_bytes: Total size limit across all segments
+            segment_bytes: Size at which a new segment file is started (at most a
+                quarter of max_bytes: the limit is enforced by dropping whole
+                segments, which needs more than one)
+        """
+        self.directory = os.path.expanduser(directory)
+        self.max_bytes = max_bytes
+        self.segment_bytes = min(segment_bytes, max(1, max_bytes // 4))
+        self.dropped = 0  # Messages discarded because the spool was full
+        os.makedirs(self.directory, exist_ok=True)
+        
+        self._segments: List[int] = sorted(
+            int(name[6:-4]) for name in os.listdir(self.directory)
+            if name.startswith("spool-") and name.endswith(".bin"))
+        self._counts = {seg: self._count_records(seg) for seg in self._segments}
+        self._writer = None
+        self._reader = None
+        self._read_offset = 0
+        self._pending_commits = 0
+        
+        # Resume where the previous run stopped reading
+        try:
+            with open(self._offset_path()) as f:
+                seg, offset = (int(x) for x in f.read().split())
+            if seg in self._segments:
+                self._skip_to(seg, offset)
+        except (OSError, ValueError):
+            pass
+    
+    def _path(self, seg: int) -> str:
+        return os.path.join(self.directory, f"spool-{seg:08d}.bin")
+    
+    def _offset_path(self) -> str:
+        return os.path.join(self.directory, "offset")
+    
+    def _count_records(self, seg: int, start: int = 0) -> int:
+        count = 0
+        try:
+            with open(self._path(seg), "rb") as f:
+                f.seek(start)
+                while True:
+                    header = f.read(RECORD.size)
+                    if len(header) < RECORD.size:
+                        break
+                    topic_len, payload_len = RECORD.unpack(header)
+                    f.seek(topic_len + payload_len, os.SEEK_CUR)
+                    count += 1
+        except OSError:
+            pass
+        return count
+    
+    def _skip_to(self, seg: int, offset: int):
+        for old in [s for s in self._segments if s < seg]:
+            self._delete(old)
+        self._read_offset = offset
+        self._counts[seg] = self._count_records(seg, offset)
+    
+    def __len__(self) -> int:
+        return sum(self._counts.values())
+    
+    @property
+    def size_bytes(self) -> int:
+        total = 0
+        for seg in self._segments:
+            try:
+                total += os.path.getsize(self._path(seg))
+            except OSError:
+                pass
+        return total - self._read_offset
+    
+    def append(self, topic: str, payload: bytes):
+        """Add a message at the tail."""
+        topic_bytes = topic.encode("utf-8")
+        if not self._segments or self._writer is None or self._writer.tell() >= self.segment_bytes:
+            self._rotate()
+        self._writer.write(RECORD.pack(len(topic_bytes), len(payload)) + topic_bytes + payload)
+        self._writer.flush()
+        self._counts[self._segments[-1]] += 1
+        while len(self._segments) > 1 and self.size_bytes > self.max_bytes:
+            self.dropped += self._counts.get(self._segments[0], 0)
+            self._delete(self._segments[0])
+    
+    def peek(self) -> Optional[Tuple[str, bytes]]:
+        """Return the oldest message without removing it."""
+        while self._segments:
+            seg = self._segments[0]
+            if self._counts.get(seg, 0) > 0:
+                if self._reader is None:
+                    if self._writer is not None and len(self._segments) == 1:
+                        self._writer.flush()
+                    self._reader = open(self._path(seg), "rb")
+                self._reader.seek(self._read_offset)
+                header = self._reader.read(RECORD.size)
+                if len(header) == RECORD.size:
+                    topic_len, payload_len = RECORD.unpack(header)
+                    topic = self._reader.read(topic_len).decode("utf-8")
+                    payload = self._reader.read(payload_len)
+                    if len(payload) == payload_len:
+                        return topic, payload
+                # Truncated tail (crash mid-write) - treat segment as done
+                self._counts[seg] = 0
+            if seg == self._segments[-1]:
+                return None
+            self._delete(seg)
+        return None
+    
+    def pop(self):
+        """Remove the oldest message (after it was delivered)."""
+        if self._reader is None or not self._segments:
+            return
+        seg = self._segments[0]
+        self._read_offset = self._reader.tell()
+        self._counts[seg] -= 1
+        if self._counts[seg] <= 0 and seg != self._segments[-1]:
+            self._delete(seg)
+        self._pending_commits += 1
+        if self._pending_commits >= 64 or not len(self):
+            self.commit()
+    
+    def commit(self):
+        """Persist the read position."""
+        self._pending_commits = 0
+        if not self._segments:
+            return
+        tmp = self._offset_path() + ".tmp"
+        with open(tmp, "w") as f:
+            f.write(f"{self._segments[0]} {self._read_offset}")
+        os.replace(tmp, self._offset_path())
+    
+    def close(self):
+        self.commit()
+        for f in (self._reader, self._writer):
+            if f is not None:
+                f.close()
+        self._reader = self._writer = None
+    
+    def _rotate(self):
+        if self._writer is not None:
+            self._writer.close()
+        seg = self._segments[-1] + 1 if self._segments else 0
+        self._segments.append(seg)
+        self._counts[seg] = 0
+        self._writer = open(self._path(seg), "ab")
+    
+    def _delete(self, seg: int):
+        if seg == self._segments[0]:
+            if self._reader is not None:
+                self._reader.close()
+                self._reader = None
+            self._read_offset = 0
+        if self._writer is not None and seg == self._segments[-1]:
+            self._writer.close()
+            self._writer = None
+        self._segments.remove(seg)
+        self._counts.pop(seg, None)
+        try:
+            os.remove(self._path(seg))
+        except OSError:
+            pass
@@ -0,0 +1,416 @@
+"""Embedded HTTP/WebSocket server streaming the sample bus to local clients.
+
+Endpoints:
+    GET /status     JSON with server, client and engine counters
+    GET /channels   JSON channel name -> channel_id table
+    GET /stats      JSON running statistics per board and channel
+    GET /control    JSON control loop stats and traces (?trace=N points, default 200)
+    GET /stream     WebSocket upgrade; binary frames (see api.frames)
+
+Stream options are passed as query parameters and can be changed later by
+sending a JSON text message with the same keys:
+    rate=<Hz>       Downsample each channel to at most this rate (0 = full rate)
+    channels=a,b    Only stream these channels (default: all)
+    events=0|1      Include GPIO/I2C events (default: 1)
+    ts=0|1          Include per-sample timestamps (default: 0)
+
+The server holds a single bus subscription. Every STREAM_BATCH_MS it drains
+it, encodes one frame per distinct set of client options and writes that
+frame to each client in the group. A client whose socket buffer is above
+STREAM_MAX_BUFFERED simply misses frames (counted in /status), so a slow
+client never delays other clients or acquisition. A client frame longer
+than STREAM_MAX_MESSAGE closes the connection with status 1009 before any
+of it is read.
+"""
+
+import asyncio
+import base64
+import hashlib
+import json
+import struct
+import sys
+import threading
+import time
+from typing import Dict, FrozenSet, NamedTuple, Optional, Set
+from urllib.parse import parse_qs, urlsplit
+
+from acquisition.bus import Event, SampleBlock, SampleBus
+from config.api_config import (STREAM_BATCH_MS, STREAM_HOST, STREAM_MAX_BUFFERED,
+                               STREAM_MAX_MESSAGE, STREAM_PORT, STREAM_QUEUE_LEN)
+from .frames import ChannelTable, encode_frame
+
+WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+# WebSocket opcodes
+OP_TEXT = 0x1
+OP_BINARY = 0x2
+OP_CLOSE = 0x8
+OP_PING = 0x9
+OP_PONG = 0xA
+
+# Close status codes (RFC 6455 7.4.1)
+CLOSE_TOO_BIG = 1009
+
+
+class MessageTooBig(ValueError):
+    """A client frame longer than the server accepts."""
+
+
+class StreamOptions(NamedTuple):
+    """Per-client stream options; clients with equal options share frames."""
+    rate: float = 0.0
+    channels: Optional[FrozenSet[str]] = None
+    events: bool = True
+    timestamps: bool = False
+    
+    @classmethod
+    def parse(cls, params: Dict[str, str]) -> "StreamOptions":
+        channels = params.get("channels")
+        return cls(
+            rate=max(0.0, float(params.get("rate", 0) or 0)),
+            channels=frozenset(c for c in str(channels).split(",") if c) if channels else None,
+            events=str(params.get("events", "1")) not in ("0", "false", "False"),
+            timestamps=str(params.get("ts", "0")) in ("1", "true", "True"),
+        )
+
+
+def ws_frame(opcode: int, payload: bytes) -> bytes:
+    """Build an unmasked server-to-client WebSocket frame."""
+    length = len(payload)
+    if length < 126:
+        header = struct.pack("!BB", 0x80 | opcode, length)
+    elif length < 65536:
+        header = struct.pack("!BBH", 0x80 | opcode, 126, length)
+    else:
+        header = struct.pack("!BBQ", 0x80 | opcode, 127, length)
+    return header + payload
+
+
+async def read_ws_frame(reader: asyncio.StreamReader, max_length: int = STREAM_MAX_MESSAGE):
+    """Read one WebSocket frame.
+
+    Returns:
+        (opcode, payload) tuple
+
+    Raises:
+        MessageTooBig: Declared payload length above max_length (nothing of it is read)
+    """
+    b0, b1 = await reader.readexactly(2)
+    length = b1 & 0x7F
+    if length == 126:
+        length = struct.unpack("!H", await reader.readexactly(2))[0]
+    elif length == 127:
+        length = struct.unpack("!Q", await reader.readexactly(8))[0]
+    if length > max_length:
+        raise MessageTooBig(f"{length}-byte frame, limit {max_length}")
+    mask = await reader.readexactly(4) if b1 & 0x80 else None
+    payload = await reader.readexactly(length)
+    if mask:
+        payload = bytes(b ^ mask[i & 3] for i, b in enumerate(payload))
+    return b0 & 0x0F, payload
+
+
+class _Client:
+    """One connected WebSocket client."""
+    
+    def __init__(self, writer: asyncio.StreamWriter, options: StreamOptions):
+        self.writer = writer
+        self.options = options
+        self.peer = writer.get_extra_info("peername")
+        self.connected_at = time.monotonic()
+        self.frames_sent = 0
+        self.frames_skipped = 0
+        self.bytes_sent = 0
+    
+    def send(self, opcode: int, payload: bytes, max_buffered: int) -> bool:
+        """Queue a frame unless the client is backed up."""
+        transport = self.writer.transport
+        if transport.is_closing() or transport.get_write_buffer_size() > max_buffered:
+            self.frames_skipped += 1
+            return False
+        data = ws_frame(opcode, payload)
+        self.writer.write(data)
+        self.frames_sent += 1
+        self.bytes_sent += len(data)
+        return True
+    
+    def info(self) -> dict:
+        return {
+            "peer": f"{self.peer[0]}:{self.peer[1]}" if self.peer else "?",
+            "options": {"rate": self.options.rate,
+                        "channels": sorted(self.options.channels) if self.options.channels else None,
+                        "events": self.options.events, "ts": self.options.timestamps},
+            "connected_s": round(time.monotonic() - self.connected_at, 1),
+            "frames_sent": self.frames_sent,
+            "frames_skipped": self.frames_skipped,
+            "bytes_sent": self.bytes_sent,
+            "buffered": self.writer.transport.get_write_buffer_size(),
+        }
+
+
+class _Group:
+    """Clients sharing one StreamOptions - one encode per batch for all of them."""
+    
+    def __init__(self, options: StreamOptions):
+        self.options = options
+        self.clients: Set[_Client] = set()
+        self.seq = 0
+        self._phase: Dict[tuple, int] = {}  # (board, channel) -> decimation phase
+    
+    def select(self, block: SampleBlock) -> Optional[SampleBlock]:
+        """Apply channel filter and downsampling to a block."""
+        opts = self.options
+        if opts.channels is not None and block.channel not in opts.channels:
+            return None
+        count = len(block.timestamps)
+        if not opts.rate or count < 2:
+            return block
+        dt = (block.timestamps[-1] - block.timestamps[0]) / (count - 1)
+        step = int(1.0 / (opts.rate * dt)) if dt > 0 else 1
+        if step <= 1:
+            return block
+        # Carry the phase across blocks so the output stays evenly spaced
+        key = (block.board, block.channel)
+        phase = self._phase.get(key, 0)
+        if phase >= count:
+            self._phase[key] = phase - count
+            return None
+        last = phase + ((count - 1 - phase) // step) * step
+        self._phase[key] = last + step - count
+        return SampleBlock(block.channel, block.timestamps[phase::step],
+                           block.values[phase::step], block.board)
+
+
+class StreamServer:
+    """Local HTTP/WebSocket server fed from a SampleBus."""
+    
+    def __init__(self, bus: SampleBus, host: str = STREAM_HOST, port: int = STREAM_PORT,
+                 batch_ms: float = STREAM_BATCH_MS, engine=None, stats=None, control=None):
+        """Initialize stream server.
+
+        Args:
+            bus: Bus to stream from
+            host: Listen address
+            port: Listen port (0 = pick a free port)
+            batch_ms: Batch interval
+            engine: Optional AcquisitionEngine whose stats are included in /status
+            stats: Optional StatsTracker served on /stats
+            control: Optional ControlSystem served on /control
+        """
+        self.bus = bus
+        self.host = host
+        self.port = port
+        self.batch_ms = batch_ms
+        self.engine = engine
+        self.stats = stats
+        self.control = control
+        self.channels = ChannelTable()
+        self.batches = 0
+        self.encode_ms = 0.0  # Time spent encoding/writing the last batch
+        
+        self._groups: Dict[StreamOptions, _Group] = {}
+        self._sub = None
+        self._loop: Optional[asyncio.AbstractEventLoop] = None
+        self._server = None
+        self._thread: Optional[threading.Thread] = None
+        self._ready = threading.Event()
+    
+    def start(self):
+        """Start serving on a background thread."""
+        if self._thread is not None:
+            return
+        self._thread = threading.Thread(target=self._run, name="stream-server", daemon=True)
+        self._thread.start()
+        self._ready.wait(5.0)
+    
+    def stop(self):
+        """Stop the server and disconnect all clients."""
+        if self._loop is not None:
+            self._loop.call_soon_threadsafe(self._loop.stop)
+        if self._thread is not None:
+            self._thread.join(2.0)
+        self._thread = None
+        if self._sub is not None:
+            self._sub.close()
+            self._sub = None
+    
+    def _run(self):
+        self._loop = asyncio.new_event_loop()
+        asyncio.set_event_loop(self._loop)
+        try:
+            self._server = self._loop.run_until_complete(
+                asyncio.start_server(self._handle, self.host, self.port))
+            self.port = self._server.sockets[0].getsockname()[1]
+            print(f"Stream server listening on ws://{self.host}:{self.port}/stream", file=sys.stderr)
+        except OSError as e:
+            print(f"Stream server failed to start: {e}", file=sys.stderr)
+            self._ready.set()
+            return
+        self._ready.set()
+        self._loop.create_task(self._batch_loop())
+        try:
+            self._loop.run_forever()
+        finally:
+            self._server.close()
+            tasks = asyncio.all_tasks(self._loop)
+            for task in tasks:
+                task.cancel()
+            self._loop.run_until_complete(asyncio.gather(*tasks, return_exceptions=True))
+            self._loop.close()
+    
+    @property
+    def clients(self):
+        return [c for g in self._groups.values() for c in g.clients]
+    
+    def get_status(self) -> dict:
+        status = {
+            "clients": [c.info() for c in self.clients],
+            "batches": self.batches,
+            "batch_ms": self.batch_ms,
+            "encode_ms": round(self.encode_ms, 3),
+            "bus_dropped": self._sub.dropped if self._sub else 0,
+        }
+        if self.engine is not None:
+            status["engine"] = self.engine.get_stats()
+        return status
+    
+    async def _batch_loop(self):
+        """Drain the bus every batch interval and fan frames out."""
+        interval = self.batch_ms / 1000.0
+        loop = asyncio.get_running_loop()
+        next_t = loop.time()
+        while True:
+            next_t += interval
+            delay = next_t - loop.time()
+            if delay < 0:
+                next_t = loop.time()  # Fell behind; don't try to catch up
+                delay = 0
+            await asyncio.sleep(delay)
+            if self._sub is None:
+                continue
+            
+            started = time.perf_counter()
+            items = self._sub.drain()
+            blocks = [i for i in items if isinstance(i, SampleBlock)]
+            events = [i for i in items if isinstance(i, Event)]
+            new_channels = [self.channels.lookup(b.channel)[1] for b in blocks]
+            if any(new_channels):
+                self._broadcast_channels()
+            
+            t_ref = time.monotonic()
+            for group in list(self._groups.values()):
+                selected = []
+                for block in blocks:
+                    block = group.select(block)
+                    if block is not None:
+                        selected.append((self.channels.ids[block.channel], block))
+                group_events = events if group.options.events else []
+                if not selected and not group_events:
+                    continue
+                frame = encode_frame(group.seq, t_ref, selected, group_events,
+                                     group.options.timestamps)
+                group.seq += 1
+                for client in group.clients:
+                    client.send(OP_BINARY, frame, STREAM_MAX_BUFFERED)
+            self.batches += 1
+            self.encode_ms = (time.perf_counter() - started) * 1000.0
+    
+    def _broadcast_channels(self):
+        message = json.dumps({"type": "channels", "channels": self.channels.ids}).encode()
+        for client in self.clients:
+            client.send(OP_TEXT, message, STREAM_MAX_BUFFERED)
+    
+    def _attach(self, client: _Client):
+        group = self._groups.get(client.options)
+        if group is None:
+            group = self._groups[client.options] = _Group(client.options)
+        group.clients.add(client)
+        if self._sub is None:
+            self._sub = self.bus.subscribe(maxlen=STREAM_QUEUE_LEN)
+    
+    def _detach(self, client: _Client):
+        group = self._groups.get(client.options)
+        if group is not None:
+            group.clients.discard(client)
+            if not group.clients:
+                del self._groups[client.options]
+        if not self._groups and self._sub is not None:
+            # Nobody listening - stop queueing bus items
+            self._sub.close()
+            self._sub = None
+    
+    async def _handle(self, reader: asyncio.StreamReader, writer: asyncio.StreamWriter):
+        """Handle one HTTP connection."""
+        try:
+            request = await asyncio.wait_for(reader.readuntil(b"\r\n\r\n"), 5.0)
+            lines = request.decode("latin-1").split("\r\n")
+            method, target, _ = lines[0].split(" ", 2)
+            headers = {}
+            for line in lines[1:]:
+                if ":" in line:
+                    key, value = line.split(":", 1)
+                    headers[key.strip().lower()] = value.strip()
+            url = urlsplit(target)
+            params = {k: v[-1] for k, v in parse_qs(url.query).items()}
+            
+            if url.path == "/stream" and headers.get("upgrade", "").lower() == "websocket":
+                await self._serve_websocket(reader, writer, headers, params)
+            elif method == "GET" and url.path in ("/", "/status"):
+                self._send_json(writer, self.get_status())
+            elif method == "GET" and url.path == "/channels":
+                self._send_json(writer, self.channels.ids)
+            elif method == "GET" and url.path == "/stats" and self.stats is not None:
+                self._send_json(writer, self.stats.snapshot())
+            elif method == "GET" and url.path == "/control" and self.control is not None:
+                self._send_json(writer, self.control.snapshot(int(params.get("trace", 200))))
+            else:
+                writer.write(b"HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n")
+        except (asyncio.IncompleteReadError, asyncio.TimeoutError, asyncio.LimitOverrunError,
+                ConnectionError, ValueError):
+            pass
+        finally:
+            try:
+                await writer.drain()
+                writer.close()
+            except Exception:
+                pass
+    
+    def _send_json(self, writer: asyncio.StreamWriter, data):
+        body = json.dumps(data).encode()
+        writer.write(b"HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+                     b"Content-Length: %d\r\nConnection: close\r\n\r\n" % len(body) + body)
+    
+    async def _serve_websocket(self, reader, writer, headers: dict, params: dict):
+        key = headers.get("sec-websocket-key", "")
+        accept = base64.b64encode(hashlib.sha1((key + WS_GUID).encode()).digest()).decode()
+        writer.write(("HTTP/1.1 101 Switching Protocols\r\n"
+                      "Upgrade: websocket\r\nConnection: Upgrade\r\n"
+                      f"Sec-WebSocket-Accept: {accept}\r\n\r\n").encode())
+        
+        client = _Client(writer, StreamOptions.parse(params))
+        self._attach(client)
+        client.send(OP_TEXT, json.dumps({"type": "channels", "channels": self.channels.ids}).encode(),
+                    STREAM_MAX_BUFFERED)
+        try:
+            while True:
+                opcode, payload = await read_ws_frame(reader)
+                if opcode == OP_CLOSE:
+                    writer.write(ws_frame(OP_CLOSE, payload[:2]))
+                    break
+                if opcode == OP_PING:
+                    writer.write(ws_frame(OP_PONG, payload))
+                elif opcode == OP_TEXT:
+                    # Option update - move the client to the matching group
+                    try:
+                        options = StreamOptions.parse(json.loads(payload.decode()))
+                    except (ValueError, TypeError, AttributeError):
+                        continue
+                    self._detach(client)
+                    client.options = options
+                    self._attach(client)
+        except MessageTooBig:
+            writer.write(ws_frame(OP_CLOSE, struct.pack("!H", CLOSE_TOO_BIG)))
+        except (asyncio.IncompleteReadError, ConnectionError):
+            pass
+        finally:
+            self._detach(client)
@@ -0,0 +1 @@
+"""Benchmarks and load generators (run with python3 -m benchmarks.<name>)."""
@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""ADS1115 vs ADS1015 acquisition throughput on the simulator.
+
+For each model, a VirtualADS1x15 on a VirtualI2CBus (byte-accurate bus
+timing, oscillator error --clock-ppm) is identified with the same
+conversion-time check ADCManager uses, then streamed through the
+acquisition engine for --duration seconds per workload:
+    read        engine reads one channel per tick (single-shot at the fastest
+                data rate, the direct ADCManager path); read-bound
+    ready       TimedADC, one channel continuous, ALERT/RDY edges
+    polled      TimedADC, one channel continuous, conversion register polled
+    scan        TimedADC, four channels single-shot
+Reported per workload: samples/s, the share of the data rate that reached
+the bus, and for the timed workloads the fitted oscillator error.
+
+Usage:
+    python3 -m benchmarks.adc_bench
+    python3 -m benchmarks.adc_bench --models ADS1015 --clock-ppm -30000 --json
+"""
+
+import argparse
+import json
+import os
+import sys
+import time
+from types import SimpleNamespace
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from acquisition.bus import SampleBus  # noqa: E402
+from acquisition.engine import AcquisitionEngine  # noqa: E402
+from acquisition.timing import TimedADC  # noqa: E402
+from hardware.adc_manager import MODELS, detect_model  # noqa: E402
+from mock.virtual_ads1x15 import VirtualHardware  # noqa: E402
+
+WORKLOADS = ("read", "ready", "polled", "scan")
+
+
+def run(adc, workload: str, duration: float) -> dict:
+    """Stream one workload through the engine; samples counted on the bus."""
+    timed = None
+    source = adc
+    channels = [0]
+    rate_hz = 4.0 * adc.data_rates[-1]  # Faster than the reads can go
+    if workload != "read":
+        if workload == "scan":
+            channels = [0, 1, 2, 3]
+        ready = adc.ready_line() if workload == "ready" else None
+        timed = source = TimedADC(adc, channels, ready=ready, ready_pin=None)
+        timed.start()
+        rate_hz = 100.0  # Blocks collected by the engine
+    bus = SampleBus()
+    sub = bus.subscribe(maxlen=65536, events=False)
+    engine = AcquisitionEngine(SimpleNamespace(adc=source), bus, rate_hz=rate_hz,
+                               channels=channels)
+    engine.start()
+    time.sleep(min(1.0, duration))  # Settle (and let a drift fit lock)
+    sub.drain()
+    start = time.monotonic()
+    samples = 0
+    while time.monotonic() - start < duration:
+        sub.wait(0.2)
+        samples += sum(len(block.values) for block in sub.drain())
+    elapsed = time.monotonic() - start
+    data_rate = adc.data_rate  # Before stop() powers the chip down
+    engine.stop()
+    if timed is not None:
+        timed.stop()
+    result = {"model": adc.model, "workload": workload, "data_rate": data_rate,
+              "samples_per_s": samples / elapsed,
+              "of_data_rate": samples / elapsed / data_rate}
+    if timed is not None:
+        result["ppm"] = timed.estimator.ppm if timed.continuous else None
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="ADS1115/ADS1015 throughput on the simulator")
+    parser.add_argument("--models", default=",".join(MODELS))
+    parser.add_argument("--workloads", default=",".join(WORKLOADS))
+    parser.add_argument("--duration", type=float, default=3.0, help="Seconds per workload")
+    parser.add_argument("--clock-khz", type=float, default=400.0, help="Virtual I2C clock")
+    parser.add_argument("--clock-ppm", type=float, default=5000.0,
+                        help="Virtual ADC oscillator error")
+    parser.add_argument("--json", action="store_true")
+    args = parser.parse_args()
+    models = [model.upper() for model in args.models.split(",")]
+    workloads = args.workloads.split(",")
+    if set(models) - set(MODELS) or set(workloads) - set(WORKLOADS):
+        parser.error(f"models are {', '.join(MODELS)}; workloads are {', '.join(WORKLOADS)}")
+    
+    results = []
+    for model in models:
+        resolution = MODELS[model][0]
+        for workload in workloads:
+            hw = VirtualHardware(args.clock_khz, resolution=resolution, clock_ppm=args.clock_ppm)
+            t0 = time.monotonic()
+            detected = detect_model(hw.adc.write_register, hw.adc.read_register)
+            detect_ms = (time.monotonic() - t0) * 1000.0
+            step = run(hw.adc, workload, args.duration)
+            step.update({"detected": detected, "detect_ms": detect_ms})
+            results.append(step)
+            if not args.json:
+                drift = "" if step.get("ppm") is None else f"  {step['ppm']:+8.0f} ppm"
+                print(f"{model}  {workload:7s} {step['samples_per_s']:7.0f} samples/s  "
+                      f"{step['of_data_rate'] * 100:5.1f} % of {step['data_rate']} SPS{drift}  "
+                      f"detected {detected} in {detect_ms:.0f} ms")
+    if args.json:
+        print(json.dumps({"clock_khz": args.clock_khz, "clock_ppm": args.clock_ppm,
+                          "results": results}, indent=2))
+    if any(step["detected"] != step["model"] for step in results):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""Per-controller throughput benchmark for the OLED display engine.
+
+For each controller backend (SSD1306, SSD1309, SH1106) runs these workloads
+for --duration seconds and reports updates per second, bytes and I2C
+transactions per update, the mean update time and the longest single write
+(which must stay within the bus's MAX_MESSAGE_BYTES):
+    full        whole frame every update (show(full=True)), the upper bound
+    text        one status line of changing digits (partial update, one page pair)
+    column      a one-pixel vertical cursor moving across the panel (all pages,
+                one column each: SSD1306/SSD1309 cover it with one window
+                write, the SH1106 needs one write per page)
+
+Sources:
+    virtual     VirtualOLED on a VirtualI2CBus (byte-accurate timing at each
+                of --clock-khz: the image's 100 kHz and fast-mode 400 kHz by
+                default); after every workload the emulated panel RAM is
+                compared with the framebuffer ("verified")
+    real        the display at --address on --bus; only the controller given
+                with --controller is run, since a panel has one controller
+
+Usage:
+    python3 -m benchmarks.display_bench
+    python3 -m benchmarks.display_bench --clock-khz 100,400,1000 --duration 3 --json
+    python3 -m benchmarks.display_bench --source real --controller sh1106
+"""
+
+import argparse
+import json
+import os
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from hardware.display import CONTROLLERS, controller_class  # noqa: E402
+from hardware.i2c_bus import MAX_MESSAGE_BYTES  # noqa: E402
+from mock.virtual_ads1x15 import VirtualI2CBus  # noqa: E402
+from mock.virtual_oled import VirtualOLED  # noqa: E402
+
+WORKLOADS = ("full", "text", "column")
+
+
+def _draw(display, workload: str, n: int) -> bool:
+    """Change the framebuffer for update n; returns whether show() should be full."""
+    framebuffer = display.framebuffer
+    if workload == "full":
+        framebuffer.fill(0)
+        framebuffer.fill_rect(n % display.width, 0, 16, display.height)
+        return True
+    if workload == "text":
+        framebuffer.text(0, 20, f"t = {n * 0.1:8.1f} s")
+        return False
+    framebuffer.fill_rect((n - 1) % display.width, 0, 1, display.height, 0)
+    framebuffer.fill_rect(n % display.width, 0, 1, display.height, 1)
+    return False
+
+
+def run(display, workload: str, duration: float, panel=None) -> dict:
+    """Update the display as fast as possible for duration seconds."""
+    display.fill(0)
+    display.show(full=True)
+    writes0 = panel.writes if panel is not None else 0
+    display.stats["max_write_bytes"] = 0
+    before = display.get_stats()
+    n = 0
+    start = time.monotonic()
+    while time.monotonic() - start < duration:
+        n += 1
+        display.show(full=_draw(display, workload, n))
+    elapsed = time.monotonic() - start
+    after = display.get_stats()
+    updates = after["updates"] - before["updates"]
+    result = {
+        "controller": display.name,
+        "workload": workload,
+        "updates_per_s": updates / elapsed,
+        "bytes_per_update": (after["bytes"] - before["bytes"]) / max(1, updates),
+        "writes_per_update": (after["regions"] - before["regions"]) / max(1, updates),
+        "mean_ms": elapsed / max(1, updates) * 1000.0,
+        "max_write_bytes": after["max_write_bytes"],
+    }
+    if panel is not None:
+        result["writes_per_update"] = (panel.writes - writes0) / max(1, updates)
+        result["verified"] = panel.visible() == bytes(display.buffer)
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="OLED display engine throughput per controller")
+    parser.add_argument("--source", choices=["virtual", "real"], default="virtual")
+    parser.add_argument("--controller", choices=sorted(CONTROLLERS), default=None,
+                        help="Only this controller (required with --source real)")
+    parser.add_argument("--workloads", default=",".join(WORKLOADS))
+    parser.add_argument("--duration", type=float, default=2.0, help="Seconds per workload")
+    parser.add_argument("--clock-khz", default="100,400",
+                        help="Virtual I2C clocks, comma separated")
+    parser.add_argument("--bus", type=int, default=1)
+    parser.add_argument("--address", default="0x3C")
+    parser.add_argument("--height", type=int, default=64)
+    parser.add_argument("--json", action="store_true")
+    args = parser.parse_args()
+    workloads = args.workloads.split(",")
+    unknown = set(workloads) - set(WORKLOADS)
+    if unknown:
+        parser.error(f"unknown workloads: {', '.join(sorted(unknown))}")
+    if args.source == "real" and args.controller is None:
+        parser.error("--source real needs --controller")
+    address = int(args.address, 0)
+    # A real panel runs at whatever the adapter is set to
+    clocks = [None]
+    if args.source == "virtual":
+        clocks = [float(khz) for khz in args.clock_khz.split(",")]
+    
+    results = []
+    for khz in clocks:
+        for name in [args.controller] if args.controller else list(CONTROLLERS):
+            cls = controller_class(name)
+            for workload in workloads:
+                panel = None
+                if args.source == "virtual":
+                    panel = VirtualOLED(VirtualI2CBus(khz), address, name, args.height)
+                    display = cls(128, args.height, address, None, device=panel)
+                else:
+                    display = cls(128, args.height, address, args.bus)
+                try:
+                    step = run(display, workload, args.duration, panel)
+                finally:
+                    display.close()
+                step["clock_khz"] = khz
+                results.append(step)
+                if not args.json:
+                    clock = "" if khz is None else f"{khz:5.0f} kHz  "
+                    print(f"{clock}{step['controller']:8s} {workload:7s} "
+                          f"{step['updates_per_s']:8.1f} updates/s  "
+                          f"{step['bytes_per_update']:7.1f} bytes  "
+                          f"{step['writes_per_update']:4.1f} writes  {step['mean_ms']:6.2f} ms  "
+                          f"max write {step['max_write_bytes']} B"
+                          + ("" if panel is None else
+                             f"  {'verified' if step['verified'] else 'MISMATCH'}"))
+    if args.json:
+        print(json.dumps({"source": args.source, "max_message_bytes": MAX_MESSAGE_BYTES,
+                          "results": results}, indent=2))
+    if any(step.get("verified") is False or step["max_write_bytes"] > MAX_MESSAGE_BYTES
+           for step in results):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
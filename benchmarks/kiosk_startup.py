@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""Boot-to-first-frame and memory of the panel: X11 desktop vs kiosk (eglfs/linuxfb).
+
+device_panel.py writes a startup report once its first frame is on screen
+(ui/kiosk.py StartupProbe): seconds from kernel boot and from process start
+to that frame, and memory at that point and again after STARTUP_SETTLE_S -
+the panel's RSS/PSS, the RSS of the X11/Wayland session processes (Xorg,
+lightdm, the window manager, panels...) and system-wide memory in use.
+
+Run this after a fresh boot of each setup. It waits for the settled report,
+adds the board/image identification and systemd's boot breakdown, and saves
+it; --compare then puts the saved reports side by side:
+
+Usage:
+    python3 -m benchmarks.kiosk_startup --label x11 --out x11.json
+    sudo pi-image-build/enable-kiosk.sh eglfs && sudo reboot
+    python3 -m benchmarks.kiosk_startup --label eglfs --out eglfs.json
+    python3 -m benchmarks.kiosk_startup --compare x11.json eglfs.json
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+from typing import List, Optional
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from benchmarks.loop_latency import system_info  # noqa: E402
+
+# Where the panel writes the report: kiosk service (RuntimeDirectory) and X11 autostart
+REPORT_PATHS = ("/run/device-panel/startup.json", "/tmp/device-panel-startup.json")
+
+
+def find_report(path: Optional[str], wait_s: float) -> dict:
+    """Newest startup report that has its settled snapshot (waits up to wait_s)."""
+    candidates = [path] if path else list(REPORT_PATHS)
+    deadline = time.monotonic() + wait_s
+    while True:
+        found = []
+        for candidate in candidates:
+            try:
+                with open(candidate) as f:
+                    report = json.load(f)
+                found.append((os.path.getmtime(candidate), candidate, report))
+            except (OSError, ValueError):
+                continue
+        if found:
+            _, source, report = max(found, key=lambda item: item[0])
+            if "settled" in report:
+                report["source"] = source
+                return report
+        if time.monotonic() > deadline:
+            raise SystemExit(f"No settled startup report in {', '.join(candidates)} - "
+                             f"is device_panel.py running?")
+        time.sleep(0.5)
+
+
+def boot_breakdown() -> dict:
+    """systemd's firmware/loader/kernel/userspace split and the default target."""
+    result = {}
+    for key, cmd in (("systemd_analyze", ["systemd-analyze", "time"]),
+                     ("default_target", ["systemctl", "get-default"])):
+        try:
+            out = subprocess.run(cmd, capture_output=True, text=True, timeout=10)
+            result[key] = out.stdout.strip().splitlines()[0] if out.stdout.strip() else None
+        except (OSError, subprocess.SubprocessError):
+            result[key] = None
+    return result
+
+
+def _mb(kb: Optional[int]) -> str:
+    return "-" if kb is None else f"{kb / 1024:.1f}"
+
+
+def print_table(reports: List[dict], names: List[str]):
+    """Side-by-side table of startup time and memory."""
+    settled = lambda r: r.get("settled") or r["first_frame"]  # noqa: E731
+    rows = [("model", lambda r: r["system"].get("model", r["system"]["machine"])),
+            ("image", lambda r: r["system"].get("image", "-")),
+            ("platform", lambda r: r["platform"]),
+            ("screen", lambda r: "x".join(str(v) for v in r["screen"])),
+            ("target", lambda r: r["boot"].get("default_target") or "-"),
+            ("boot->frame s", lambda r: f"{r['boot_to_first_frame_s']:.2f}"),
+            ("launch->frame s", lambda r: f"{r['launch_to_first_frame_s']:.2f}"
+             if r.get("launch_to_first_frame_s") is not None else "-"),
+            ("panel RSS MB", lambda r: _mb(settled(r)["panel"]["rss_kb"])),
+            ("panel PSS MB", lambda r: _mb(settled(r)["panel"].get("pss_kb"))),
+            ("panel peak MB", lambda r: _mb(settled(r)["panel"]["peak_rss_kb"])),
+            ("display RSS MB", lambda r: _mb(settled(r)["display_stack_kb"])),
+            ("panel+display MB", lambda r: _mb(settled(r)["panel"]["rss_kb"]
+                                               + settled(r)["display_stack_kb"])),
+            ("system used MB", lambda r: _mb(settled(r)["system"]["used_kb"]))]
+    width = max(18, *(len(name) for name in names))
+    print(f"{'':18s}" + "".join(f"{name[:width]:>{width + 2}s}" for name in names))
+    for name, get in rows:
+        print(f"{name:18s}" + "".join(f"{str(get(r))[:width]:>{width + 2}s}" for r in reports))
+    for report, name in zip(reports, names):
+        line = report["boot"].get("systemd_analyze")
+        if line:
+            print(f"{name}: {line}")
+
+
+def compare(paths: List[str]):
+    """Compare saved reports."""
+    reports = []
+    for path in paths:
+        with open(path) as f:
+            reports.append(json.load(f))
+    print_table(reports, [r.get("label") or os.path.basename(p) for r, p in zip(reports, paths)])
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Panel boot-to-first-frame and memory report")
+    parser.add_argument("--report", help="Startup report to read (default: kiosk, then X11 path)")
+    parser.add_argument("--wait", type=float, default=120.0,
+                        help="Seconds to wait for the settled report")
+    parser.add_argument("--label", default="", help="Name for this setup in comparisons")
+    parser.add_argument("--out", help="Write the JSON report here")
+    parser.add_argument("--json", action="store_true", help="Print the JSON report")
+    parser.add_argument("--compare", nargs="+", metavar="REPORT", help="Compare saved reports")
+    args = parser.parse_args()
+    
+    if args.compare:
+        compare(args.compare)
+        return
+    report = find_report(args.report, args.wait)
+    report["label"] = args.label
+    report["system"] = system_info()
+    report["boot"] = boot_breakdown()
+    if args.out:
+        with open(args.out, "w") as f:
+            json.dump(report, f, indent=2)
+    if args.json:
+        print(json.dumps(report, indent=2))
+    else:
+        print_table([report], [args.label or "this boot"])
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,407 @@
+#!/usr/bin/env python3
+"""cyclictest-style wake-up latency and period jitter of the acquisition loop.
+
+Runs the real AcquisitionEngine scheduler against a virtual or real ADS1115
+and records, for every loop iteration, how late the thread woke up after
+its absolute deadline (latency) and how far each period deviated from the
+nominal one (jitter). Both go into fixed-width histograms so long runs use
+constant memory.
+
+Sources:
+    virtual     VirtualADS1x15 on a VirtualI2CBus: I2C byte times and
+                conversion time modelled, no hardware needed
+    real        ADCManager (the board's ADS1115 on the default or --bus bus)
+    mock        MockADC (no read cost, scheduler only)
+
+Background loads (comma separated, all running in this process):
+    gui         the full MainWindow on the Qt event loop (needs a display or
+                QT_QPA_PLATFORM=offscreen)
+    oled        full 128x64 frames pushed at --oled-fps (same bus as the ADC)
+    i2c         back-to-back I2C presence scans (same bus as the ADC)
+    cpu         one busy process per core
+
+The report (--out FILE) records the Pi model, kernel, OS image and
+device-panel image stamp next to the results, so runs can be compared
+across boards and pi-image-build versions:
+
+Usage:
+    python3 -m benchmarks.loop_latency --duration 60 --out pi4-idle.json
+    python3 -m benchmarks.loop_latency --load gui,i2c --rt --out pi4-gui-rt.json
+    sudo python3 -m benchmarks.loop_latency --source real --rate 100 --load oled
+    python3 -m benchmarks.loop_latency --compare pi4-idle.json pi4-gui-rt.json
+"""
+
+import argparse
+import json
+import multiprocessing
+import os
+import platform
+import sys
+import threading
+import time
+from array import array
+from typing import Dict, List, Optional
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from acquisition.bus import SampleBus  # noqa: E402
+from acquisition.engine import AcquisitionEngine  # noqa: E402
+
+IMAGE_STAMP = "/opt/device-panel/IMAGE_INFO"
+OLED_FRAME_BYTES = 128 * 64 // 8
+
+
+class Histogram:
+    """Fixed-width histogram in microseconds with under/overflow and exact extremes."""
+    
+    def __init__(self, bin_us: float, low_us: float, high_us: float):
+        self.bin_us = bin_us
+        self.low_us = low_us
+        self.counts = [0] * int((high_us - low_us) / bin_us)
+        self.underflow = 0
+        self.overflow = 0
+        self.count = 0
+        self.total = 0.0
+        self.min = float("inf")
+        self.max = float("-inf")
+    
+    def add(self, value_us: float):
+        self.count += 1
+        self.total += value_us
+        if value_us < self.min:
+            self.min = value_us
+        if value_us > self.max:
+            self.max = value_us
+        index = int((value_us - self.low_us) // self.bin_us)
+        if index < 0:
+            self.underflow += 1
+        elif index >= len(self.counts):
+            self.overflow += 1
+        else:
+            self.counts[index] += 1
+    
+    def percentile(self, q: float) -> Optional[float]:
+        """Upper edge of the bin holding the q-quantile (bin resolution).
+
+        Clamped to the observed extremes, so p99 never reads above max (or a
+        quantile in the underflow below min) because of where a bin ends.
+        """
+        if not self.count:
+            return None
+        rank = q * self.count
+        seen = self.underflow
+        edge = self.max
+        if seen >= rank:
+            edge = self.low_us
+        else:
+            for index, n in enumerate(self.counts):
+                seen += n
+                if seen >= rank:
+                    edge = self.low_us + (index + 1) * self.bin_us
+                    break
+        return min(max(edge, self.min), self.max)
+    
+    def summary(self) -> dict:
+        if not self.count:
+            return {"count": 0}
+        used = [i for i, n in enumerate(self.counts) if n]
+        first, last = (used[0], used[-1] + 1) if used else (0, 0)
+        return {
+            "count": self.count,
+            "min": round(self.min, 1),
+            "mean": round(self.total / self.count, 1),
+            "p50": self.percentile(0.5),
+            "p99": self.percentile(0.99),
+            "p999": self.percentile(0.999),
+            "max": round(self.max, 1),
+            "histogram": {"bin_us": self.bin_us, "start_us": self.low_us + first * self.bin_us,
+                          "counts": self.counts[first:last], "underflow": self.underflow,
+                          "overflow": self.overflow},
+        }
+
+
+class TickCollector:
+    """Drains the engine's (deadline, wake) log into latency and jitter histograms."""
+    
+    def __init__(self, engine: AcquisitionEngine, period: float, bin_us: float, max_us: float):
+        self.engine = engine
+        self.period = period
+        self.bin_us = bin_us
+        self.max_us = max_us
+        self._last_wake: Optional[float] = None
+        self.reset()
+        engine.tick_log = array('d')
+    
+    def reset(self):
+        """Start new histograms (after the warm-up)."""
+        self.latency = Histogram(self.bin_us, 0.0, self.max_us)
+        self.jitter = Histogram(self.bin_us, -self.max_us, self.max_us)
+    
+    def drain(self):
+        log = self.engine.tick_log
+        n = len(log) & ~1
+        pairs = log[:n]
+        del log[:n]
+        period = self.period
+        last = self._last_wake
+        for i in range(0, n, 2):
+            deadline, wake = pairs[i], pairs[i + 1]
+            self.latency.add((wake - deadline) * 1e6)
+            if last is not None:
+                # Period error; a skipped deadline shows up as a whole-period outlier
+                self.jitter.add((wake - last - period) * 1e6)
+            last = wake
+        self._last_wake = last
+
+
+def system_info() -> dict:
+    """Board, kernel and image identification for comparing reports."""
+    info = {"host": platform.node(), "kernel": platform.release(),
+            "kernel_version": platform.uname().version, "machine": platform.machine(),
+            "python": platform.python_version(), "cpus": os.cpu_count()}
+    for key, path in (("model", "/proc/device-tree/model"), ("rpi_issue", "/etc/rpi-issue"),
+                      ("image", IMAGE_STAMP)):
+        try:
+            with open(path) as f:
+                text = f.read().strip("\x00\n ")
+            info[key] = text.splitlines()[0] if key == "rpi_issue" else text
+        except OSError:
+            pass
+    try:
+        with open("/etc/os-release") as f:
+            for line in f:
+                if line.startswith("PRETTY_NAME="):
+                    info["os"] = line.split("=", 1)[1].strip().strip('"')
+    except OSError:
+        pass
+    return info
+
+
+def make_source(args):
+    """Hardware namespace for the engine plus the bus other loads share."""
+    from types import SimpleNamespace
+    if args.source == "virtual":
+        from mock.virtual_ads1x15 import VirtualHardware
+        return VirtualHardware(clock_khz=args.i2c_khz)
+    if args.source == "real":
+        from hardware.adc_manager import ADCManager
+        from hardware.i2c_scanner import I2CScanner
+        from config.pins import I2C_BUS
+        bus = args.bus if args.bus is not None else I2C_BUS
+        return SimpleNamespace(adc=ADCManager(bus=args.bus), i2c=I2CScanner(bus=bus))
+    from mock.mock_hardware import MockADC, MockI2C
+    return SimpleNamespace(adc=MockADC(), i2c=MockI2C())
+
+
+def _spin():
+    while True:
+        pass
+
+
+def start_loads(args, hw, stop: threading.Event) -> list:
+    """Start the background loads other than gui; returns threads and processes."""
+    workers = []
+    loads = set(args.load)
+    if "i2c" in loads:
+        def scan():
+            while not stop.is_set():
+                hw.i2c.scan()
+        workers.append(threading.Thread(target=scan, name="load-i2c", daemon=True))
+    if "oled" in loads:
+        def push():
+            frame = bytearray(OLED_FRAME_BYTES)
+            display = None
+            if args.source == "real":
+                from hardware import oled
+                display = oled.open_display()
+            interval = 1.0 / args.oled_fps
+            n = 0
+            while not stop.wait(interval):
+                n += 1
+                frame[n % OLED_FRAME_BYTES] ^= 0xFF
+                if display is not None:
+                    display.buffer[:] = frame
+                    display.show(full=True)
+                elif hasattr(hw.i2c, "transfer"):
+                    # SSD1306 page writes: 8 pages of 128 bytes plus command bytes
+                    for _ in range(8):
+                        hw.i2c.transfer(4)
+                        hw.i2c.transfer(OLED_FRAME_BYTES // 8 + 2)
+        workers.append(threading.Thread(target=push, name="load-oled", daemon=True))
+    for worker in workers:
+        worker.start()
+    if "cpu" in loads:
+        for _ in range(os.cpu_count() or 1):
+            process = multiprocessing.Process(target=_spin, daemon=True)
+            process.start()
+            workers.append(process)
+    return workers
+
+
+def run(args) -> dict:
+    if args.rt:
+        from acquisition import realtime
+        realtime.setup_process()
+    hw = make_source(args)
+    bus = SampleBus()
+    engine = AcquisitionEngine(hw, bus, rate_hz=args.rate, block_ms=args.block_ms,
+                               channels=args.channels, realtime=args.rt)
+    # Samples are not consumed; a subscriber would only add load that isn't being measured
+    collector = TickCollector(engine, 1.0 / args.rate, args.bin_us, args.max_ms * 1000.0)
+    stop = threading.Event()
+    workers = start_loads(args, hw, stop)
+    engine.start()
+    
+    time.sleep(args.warmup)
+    collector.drain()
+    collector.reset()
+    baseline = dict(engine.stats)
+    started = time.monotonic()
+    
+    if "gui" in args.load:
+        run_gui(args, hw, engine, collector)
+    else:
+        while time.monotonic() - started < args.duration:
+            time.sleep(0.25)
+            collector.drain()
+            if not args.json and not args.quiet:
+                latency = collector.latency
+                print(f"\rT: acquisition I: {1e6 / args.rate:.0f} C: {latency.count:8d} "
+                      f"Min: {latency.min:7.0f} Avg: {latency.total / max(1, latency.count):7.0f} "
+                      f"Max: {latency.max:7.0f}", end="", file=sys.stderr)
+    elapsed = time.monotonic() - started
+    engine.stop()
+    stop.set()
+    for worker in workers:
+        if isinstance(worker, multiprocessing.Process):
+            worker.terminate()
+    collector.drain()
+    if not args.json and not args.quiet:
+        print(file=sys.stderr)
+    
+    stats = engine.get_stats()
+    report = {
+        "label": args.label,
+        "timestamp": time.strftime("%Y-%m-%dT%H:%M:%S%z"),
+        "system": system_info(),
+        "config": {"source": args.source, "rate_hz": args.rate, "channels": args.channels,
+                   "block_ms": args.block_ms, "load": args.load, "rt": args.rt,
+                   "duration_s": round(elapsed, 1), "i2c_khz": args.i2c_khz},
+        "latency_us": collector.latency.summary(),
+        "jitter_us": collector.jitter.summary(),
+        "overruns": stats["overruns"] - baseline["overruns"],
+        "samples": stats["samples"] - baseline["samples"],
+        "read_errors": stats["read_errors"] - baseline["read_errors"],
+    }
+    if args.rt:
+        report["realtime"] = realtime.report()
+    return report
+
+
+def run_gui(args, hw, engine, collector):
+    """Measure while the main window runs on the Qt event loop in this thread."""
+    from PySide6.QtCore import QTimer
+    from PySide6.QtWidgets import QApplication
+    from mock.mock_hardware import MockHardware
+    from ui.main_window import MainWindow
+    
+    app = QApplication.instance() or QApplication(sys.argv)
+    panel = MockHardware()
+    panel.adc = hw.adc
+    panel.i2c = hw.i2c
+    panel.engine = engine
+    window = MainWindow(mock_hardware=panel)
+    window.show()
+    drain = QTimer()
+    drain.timeout.connect(collector.drain)
+    drain.start(250)
+    QTimer.singleShot(int(args.duration * 1000), app.quit)
+    app.exec()
+    drain.stop()
+    window.close()
+
+
+def print_report(report: dict):
+    print(f"{report['system'].get('model', report['system']['machine'])} | "
+          f"{report['system']['kernel']} | {report['system'].get('image', 'no image stamp')}")
+    config = report["config"]
+    print(f"{config['source']} @ {config['rate_hz']:g} Hz x {len(config['channels'])} ch, "
+          f"load {','.join(config['load']) or 'none'}{', RT' if config['rt'] else ''}, "
+          f"{config['duration_s']:g}s")
+    for key in ("latency_us", "jitter_us"):
+        s = report[key]
+        if not s["count"]:
+            continue
+        print(f"  {key[:-3]:8s} min {s['min']:8.1f}  mean {s['mean']:8.1f}  p50 {s['p50']:8.1f}  "
+              f"p99 {s['p99']:8.1f}  p99.9 {s['p999']:8.1f}  max {s['max']:8.1f} us")
+    print(f"  {report['overruns']} overruns, {report['read_errors']} read errors, "
+          f"{report['samples']} samples")
+
+
+def compare(paths: List[str]):
+    """Side-by-side table of key metrics from several reports."""
+    reports = []
+    for path in paths:
+        with open(path) as f:
+            reports.append(json.load(f))
+    rows = [("model", lambda r: r["system"].get("model", r["system"]["machine"])),
+            ("kernel", lambda r: r["system"]["kernel"]),
+            ("image", lambda r: r["system"].get("image", "-")),
+            ("load", lambda r: ",".join(r["config"]["load"]) or "none"),
+            ("rt", lambda r: str(r["config"]["rt"])),
+            ("rate Hz", lambda r: f"{r['config']['rate_hz']:g}")]
+    for key in ("latency_us", "jitter_us"):
+        for stat in ("mean", "p99", "p999", "max"):
+            rows.append((f"{key[:-3]} {stat}",
+                         lambda r, k=key, s=stat: f"{r[k].get(s, float('nan')):.1f}"))
+    rows.append(("overruns", lambda r: str(r["overruns"])))
+    width = max(18, *(len(r.get("label") or os.path.basename(p)) for r, p in zip(reports, paths)))
+    print(f"{'':16s}" + "".join(f"{(r.get('label') or os.path.basename(p))[:width]:>{width + 2}s}"
+                                for r, p in zip(reports, paths)))
+    for name, get in rows:
+        print(f"{name:16s}" + "".join(f"{str(get(r))[:width]:>{width + 2}s}" for r in reports))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Acquisition loop latency/jitter benchmark")
+    parser.add_argument("--source", choices=["virtual", "real", "mock"], default="virtual")
+    parser.add_argument("--bus", type=int, default=None, help="I2C bus for --source real")
+    parser.add_argument("--rate", type=float, default=100.0, help="Loop rate (Hz)")
+    parser.add_argument("--channels", default="0,1,2,3")
+    parser.add_argument("--block-ms", type=float, default=100.0)
+    parser.add_argument("--duration", type=float, default=30.0, help="Seconds measured")
+    parser.add_argument("--warmup", type=float, default=1.0, help="Seconds discarded first")
+    parser.add_argument("--load", default="", help="gui,oled,i2c,cpu")
+    parser.add_argument("--oled-fps", type=float, default=10.0)
+    parser.add_argument("--i2c-khz", type=float, default=400.0, help="Virtual bus clock")
+    parser.add_argument("--rt", action="store_true", help="Apply RT_* settings (acquisition/realtime.py)")
+    parser.add_argument("--bin-us", type=float, default=10.0, help="Histogram bin width")
+    parser.add_argument("--max-ms", type=float, default=50.0, help="Histogram range")
+    parser.add_argument("--label", default="", help="Name for this run in comparisons")
+    parser.add_argument("--out", help="Write the JSON report here")
+    parser.add_argument("--json", action="store_true", help="Print the JSON report")
+    parser.add_argument("--quiet", action="store_true", help="No live progress line")
+    parser.add_argument("--compare", nargs="+", metavar="REPORT", help="Compare saved reports")
+    args = parser.parse_args()
+    
+    if args.compare:
+        compare(args.compare)
+        return
+    args.channels = [int(ch) for ch in args.channels.split(",")]
+    args.load = [name for name in args.load.split(",") if name]
+    unknown = set(args.load) - {"gui", "oled", "i2c", "cpu"}
+    if unknown:
+        parser.error(f"unknown load {', '.join(sorted(unknown))}")
+    
+    report = run(args)
+    if args.out:
+        with open(args.out, "w") as f:
+            json.dump(report, f, indent=2)
+    if args.json:
+        print(json.dumps(report, indent=2))
+    else:
+        print_report(report)
+
+
+if __name__ == "__main__":
+    main()
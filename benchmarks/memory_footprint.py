@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+"""Per-subsystem memory of the panel, normal vs low-memory mode.
+
+Starts the panel's subsystems one after another in a child process, in the
+order device_panel.py does, and records the process RSS/PSS after each -
+the difference is what that subsystem added. It ends with the main window,
+an opened device tab and a few seconds of running acquisition, so lazily
+loaded pieces and filling buffers show up too. Each step also lists which
+of the heavy libraries (Qt, NumPy, PIL, Blinka, Adafruit drivers, asyncio)
+are loaded by then.
+
+By default the child runs twice, with DEVICE_PANEL_LOW_MEMORY=0 and =1, and
+the two are printed side by side:
+
+Usage:
+    python3 -m benchmarks.memory_footprint
+    python3 -m benchmarks.memory_footprint --modes low --out low.json
+    python3 -m benchmarks.memory_footprint --compare normal.json low.json
+
+The GUI runs on Qt's offscreen platform unless QT_QPA_PLATFORM is set.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+from typing import Dict, List
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from benchmarks.loop_latency import system_info  # noqa: E402
+
+MODES = {"normal": "0", "low": "1"}
+
+# Module -> short name shown per step
+HEAVY_MODULES = (("PySide6.QtWidgets", "qt"), ("numpy", "numpy"), ("PIL.Image", "pil"),
+                 ("board", "blinka"), ("adafruit_ssd1306", "ssd1306"),
+                 ("adafruit_ads1x15", "ads1x15"), ("asyncio", "asyncio"))
+
+
+def memory_kb() -> Dict[str, int]:
+    """RSS and PSS of this process in kB (PSS 0 where smaps_rollup is missing)."""
+    memory = {"rss_kb": 0, "pss_kb": 0}
+    with open("/proc/self/status") as f:
+        for line in f:
+            if line.startswith("VmRSS:"):
+                memory["rss_kb"] = int(line.split()[1])
+    try:
+        with open("/proc/self/smaps_rollup") as f:
+            for line in f:
+                if line.startswith("Pss:"):
+                    memory["pss_kb"] = int(line.split()[1])
+    except OSError:
+        pass
+    return memory
+
+
+def run_child(out_path: str, settle_s: float):
+    """Start the subsystems step by step and write the per-step memory to out_path."""
+    steps: List[dict] = []
+    
+    def record(name: str):
+        entry = {"step": name, **memory_kb(),
+                 "loaded": [short for module, short in HEAVY_MODULES if module in sys.modules]}
+        entry["delta_kb"] = entry["rss_kb"] - (steps[-1]["rss_kb"] if steps else 0)
+        steps.append(entry)
+    
+    record("python")
+    os.environ.setdefault("QT_QPA_PLATFORM", "offscreen")
+    from PySide6.QtWidgets import QApplication
+    app = QApplication([])
+    record("qt")
+    
+    import device_panel
+    from config.memory_config import LOW_MEMORY
+    from config.acquisition_config import ENABLE_SPECTRUM, ENABLE_STATS
+    from config.api_config import ENABLE_STREAM_SERVER, ENABLE_MQTT
+    hardware = device_panel.Hardware()
+    record("hardware")
+    
+    hardware.engine = device_panel.AcquisitionEngine(hardware, hardware.bus)
+    hardware.engine.start()
+    record("acquisition")
+    
+    if ENABLE_STATS:
+        from acquisition.stats import StatsTracker
+        hardware.stats = StatsTracker(hardware.bus)
+        hardware.stats.start()
+        record("stats")
+    if ENABLE_SPECTRUM and not LOW_MEMORY:
+        hardware.start_spectrum()
+        record("spectrum")
+    
+    server = publisher = None
+    if ENABLE_STREAM_SERVER:
+        from api.websocket_server import StreamServer
+        # Port 0: never collides with a panel running on the same board
+        server = StreamServer(hardware.bus, port=0, engine=hardware.engine,
+                              stats=hardware.stats)
+        server.start()
+        record("stream_server")
+    if ENABLE_MQTT:
+        from api.mqtt_publisher import MqttPublisher
+        publisher = MqttPublisher(hardware.bus)
+        record("mqtt")
+    
+    from ui.main_window import MainWindow
+    window = MainWindow(mock_hardware=hardware)
+    window.show()
+    app.processEvents()
+    record("main_window")
+    
+    from ui.device_tabs import DeviceTab
+    tab = DeviceTab.for_device(getattr(hardware.i2c, 'bus', 1), 0x3C, hardware)
+    tab.show()
+    tab.tabs.setCurrentIndex(1)  # Builds the plugin's test UI
+    app.processEvents()
+    record("device_tab")
+    
+    deadline = time.monotonic() + settle_s
+    while time.monotonic() < deadline:
+        app.processEvents()
+        time.sleep(0.02)
+    record("settled")
+    
+    for part in (server, hardware.spectrum, hardware.stats, hardware.engine):
+        if part is not None:
+            part.stop()
+    with open(out_path, "w") as f:
+        json.dump({"low_memory": LOW_MEMORY, "publisher": publisher is not None,
+                   "steps": steps}, f)
+
+
+def measure(mode: str, settle_s: float) -> dict:
+    """Run the child with the mode's DEVICE_PANEL_LOW_MEMORY setting."""
+    env = dict(os.environ, DEVICE_PANEL_LOW_MEMORY=MODES[mode])
+    with tempfile.NamedTemporaryFile(suffix=".json", delete=False) as tmp:
+        path = tmp.name
+    try:
+        subprocess.run([sys.executable, os.path.abspath(__file__), "--child", path,
+                        "--settle", str(settle_s)], env=env, check=True,
+                       stdout=subprocess.DEVNULL)
+        with open(path) as f:
+            report = json.load(f)
+    finally:
+        os.unlink(path)
+    report["label"] = mode
+    return report
+
+
+def _mb(kb: int) -> str:
+    return f"{kb / 1024:.1f}"
+
+
+def print_table(reports: List[dict]):
+    """Per-step RSS delta and total for each report."""
+    names = [r["label"] for r in reports]
+    print(f"{'':14s}" + "".join(f"{name + ' +MB':>12s}{'RSS MB':>9s}" for name in names))
+    order = []
+    for report in reports:
+        for step in report["steps"]:
+            if step["step"] not in order:
+                order.append(step["step"])
+    for name in order:
+        line = f"{name:14s}"
+        for report in reports:
+            step = next((s for s in report["steps"] if s["step"] == name), None)
+            line += (f"{_mb(step['delta_kb']):>12s}{_mb(step['rss_kb']):>9s}" if step
+                     else f"{'-':>12s}{'-':>9s}")
+        print(line)
+    for report in reports:
+        last = report["steps"][-1]
+        print(f"{report['label']}: PSS {_mb(last['pss_kb'])} MB settled, "
+              f"loaded: {', '.join(last['loaded']) or 'none'}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Per-subsystem RSS, normal vs low-memory mode")
+    parser.add_argument("--modes", default="normal,low",
+                        help="Comma-separated modes to measure: normal, low")
+    parser.add_argument("--settle", type=float, default=5.0,
+                        help="Seconds of running acquisition before the last snapshot")
+    parser.add_argument("--out", help="Write the JSON report here")
+    parser.add_argument("--json", action="store_true", help="Print the JSON report")
+    parser.add_argument("--compare", nargs="+", metavar="REPORT", help="Compare saved reports")
+    parser.add_argument("--child", help=argparse.SUPPRESS)
+    args = parser.parse_args()
+    
+    if args.child:
+        run_child(args.child, args.settle)
+        return
+    if args.compare:
+        reports = []
+        for path in args.compare:
+            with open(path) as f:
+                reports.extend(json.load(f)["reports"])
+        print_table(reports)
+        return
+    reports = [measure(mode.strip(), args.settle) for mode in args.modes.split(",")]
+    result = {"system": system_info(), "reports": reports}
+    if args.out:
+        with open(args.out, "w") as f:
+            json.dump(result, f, indent=2)
+    if args.json:
+        print(json.dumps(result, indent=2))
+    else:
+        print_table(reports)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+"""Throughput/latency benchmark for the MQTT publisher, with outage replay.
+
+Runs mock acquisition -> sample bus -> MqttPublisher -> stand-in broker and
+reports message rate, payload size, end-to-end latency (newest sample in a
+message to broker arrival) and sample loss. With --outage the broker goes
+down mid-run so the spool and rate-limited replay are exercised.
+
+Usage:
+    python3 -m benchmarks.mqtt_bench --rate 500 --duration 20
+    python3 -m benchmarks.mqtt_bench --outage 5 --format binary
+    python3 -m benchmarks.mqtt_bench --broker localhost:1883   # real mosquitto
+"""
+
+import argparse
+import json
+import os
+import shutil
+import sys
+import tempfile
+import threading
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from acquisition.bus import SampleBus  # noqa: E402
+from acquisition.engine import AcquisitionEngine  # noqa: E402
+from api import cbor  # noqa: E402
+from api.frames import decode_frame  # noqa: E402
+from api.mqtt_publisher import MqttPublisher  # noqa: E402
+from mock.mock_hardware import MockHardware  # noqa: E402
+from benchmarks.mqtt_standin import StandInBroker  # noqa: E402
+
+
+class _Collector:
+    """Decodes received payloads and keeps latency/sample counts."""
+    
+    def __init__(self, fmt: str):
+        self.fmt = fmt
+        self.lock = threading.Lock()
+        self.messages = 0
+        self.samples = 0
+        self.bytes = 0
+        self.latencies = []
+    
+    def __call__(self, topic: str, payload: bytes, received_at: float):
+        if not topic.endswith("/samples"):
+            return
+        newest = None
+        count = 0
+        if self.fmt == "binary":
+            for block in decode_frame(payload)["blocks"]:
+                n = len(block["values"])
+                count += n
+                end = block["t0"] + block["dt"] * (n - 1)
+                newest = end if newest is None else max(newest, end)
+        else:
+            for channel in cbor.loads(payload)["channels"]:
+                n = len(channel["values"])
+                count += n
+                end = channel["t0"] + channel["dt"] * (n - 1)
+                newest = end if newest is None else max(newest, end)
+        with self.lock:
+            self.messages += 1
+            self.samples += count
+            self.bytes += len(payload)
+            if newest is not None:
+                self.latencies.append((received_at - newest) * 1000.0)
+
+
+def _percentile(values, pct):
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * pct / 100.0))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="MQTT publisher benchmark")
+    parser.add_argument("--rate", type=float, default=500.0, help="Samples/s per ADC channel")
+    parser.add_argument("--duration", type=float, default=10.0, help="Acquisition seconds")
+    parser.add_argument("--format", choices=["cbor", "binary"], default="cbor")
+    parser.add_argument("--batch-ms", type=float, default=250.0)
+    parser.add_argument("--qos", type=int, choices=[0, 1], default=1)
+    parser.add_argument("--outage", type=float, default=0.0,
+                        help="Take the broker down for this many seconds mid-run")
+    parser.add_argument("--replay-rate", type=float, default=50.0)
+    parser.add_argument("--broker", help="host:port of a real broker (skips latency/loss stats)")
+    parser.add_argument("--port", type=int, default=18830, help="Stand-in broker port")
+    parser.add_argument("--json", action="store_true")
+    args = parser.parse_args()
+    
+    collector = _Collector(args.format)
+    broker = None
+    if args.broker:
+        host, port = args.broker.rsplit(":", 1)
+        port = int(port)
+    else:
+        host, port = "127.0.0.1", args.port
+        broker = StandInBroker(host, port, on_message=collector).start()
+    
+    spool_dir = tempfile.mkdtemp(prefix="mqtt-spool-")
+    hardware = MockHardware()
+    bus = SampleBus()
+    generated = bus.subscribe(maxlen=100000, events=False)
+    engine = AcquisitionEngine(hardware, bus, rate_hz=args.rate)
+    publisher = MqttPublisher(bus, host=host, port=port, fmt=args.format, qos=args.qos,
+                              batch_ms=args.batch_ms, spool_dir=spool_dir,
+                              replay_rate=args.replay_rate)
+    publisher.start()
+    engine.start()
+    
+    generated_samples = 0
+    spool_peak = 0
+    started = time.monotonic()
+    outage_at = started + (args.duration - args.outage) / 2 if args.outage else None
+    outage_end = None
+    while time.monotonic() - started < args.duration:
+        time.sleep(0.1)
+        generated_samples += sum(len(b.values) for b in generated.drain())
+        spool_peak = max(spool_peak, len(publisher.spool))
+        now = time.monotonic()
+        if broker and outage_at and now >= outage_at and outage_end is None:
+            broker.down()
+            outage_end = now + args.outage
+        if broker and outage_end and now >= outage_end:
+            broker.up()
+            outage_end = float("inf")
+    engine.stop()
+    time.sleep(args.batch_ms / 1000.0 + 0.2)
+    generated_samples += sum(len(b.values) for b in generated.drain())
+    
+    # Let the replay drain the spool
+    drain_started = time.monotonic()
+    while len(publisher.spool) and time.monotonic() - drain_started < 120:
+        time.sleep(0.1)
+    drain_s = time.monotonic() - drain_started
+    publisher.stop()
+    time.sleep(0.3)
+    if broker:
+        broker.stop()
+    shutil.rmtree(spool_dir, ignore_errors=True)
+    
+    elapsed = args.duration
+    stats = publisher.get_stats()
+    result = {
+        "format": args.format,
+        "qos": args.qos,
+        "rate_per_channel": args.rate,
+        "messages": stats["published"] + stats["replayed"],
+        "msgs_per_s": round((stats["published"] + stats["replayed"]) / elapsed, 1),
+        "avg_payload_bytes": round(stats["bytes"] / max(1, stats["published"] + stats["replayed"])),
+        "kbyte_s": round(stats["bytes"] / elapsed / 1024, 1),
+        "spooled": stats["spooled"],
+        "spool_peak_messages": spool_peak,
+        "spool_dropped": stats["spool_dropped"],
+        "replay_drain_s": round(drain_s, 2),
+        "reconnects": stats["reconnects"],
+    }
+    if broker:
+        result.update({
+            "samples_generated": generated_samples,
+            "samples_delivered": collector.samples,
+            "samples_lost": generated_samples - collector.samples,
+            "latency_p50_ms": round(_percentile(collector.latencies, 50), 1),
+            "latency_p99_ms": round(_percentile(collector.latencies, 99), 1),
+            "latency_max_ms": round(max(collector.latencies, default=0.0), 1),
+        })
+    
+    if args.json:
+        print(json.dumps(result, indent=2))
+    else:
+        for key, value in result.items():
+            print(f"{key:22s} {value}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""Mosquitto stand-in: a tiny MQTT 3.1.1 sink broker for tests and benchmarks.
+
+Accepts CONNECT/PUBLISH/PINGREQ/DISCONNECT, acknowledges QoS 1 and records
+every received message with its arrival time. It can be taken down and
+brought back to simulate broker outages. Nothing is forwarded.
+
+Usage:
+    python3 -m benchmarks.mqtt_standin --port 1883
+"""
+
+import argparse
+import asyncio
+import struct
+import threading
+import time
+from typing import Callable, List, Optional
+
+
+class StandInBroker:
+    """In-process MQTT sink running on its own event loop thread."""
+    
+    def __init__(self, host: str = "127.0.0.1", port: int = 1883,
+                 on_message: Optional[Callable[[str, bytes, float], None]] = None):
+        self.host = host
+        self.port = port
+        self.on_message = on_message
+        self.received = 0
+        self.connections = 0
+        self._loop: Optional[asyncio.AbstractEventLoop] = None
+        self._server = None
+        self._writers: List[asyncio.StreamWriter] = []
+        self._thread: Optional[threading.Thread] = None
+    
+    def start(self):
+        ready = threading.Event()
+        
+        def run():
+            self._loop = asyncio.new_event_loop()
+            self._loop.run_until_complete(self._listen())
+            ready.set()
+            self._loop.run_forever()
+        
+        self._thread = threading.Thread(target=run, name="mqtt-standin", daemon=True)
+        self._thread.start()
+        ready.wait(5.0)
+        return self
+    
+    def stop(self):
+        self.down()
+        self._loop.call_soon_threadsafe(self._loop.stop)
+        self._thread.join(2.0)
+    
+    def down(self):
+        """Simulate an outage: drop all connections and stop listening."""
+        asyncio.run_coroutine_threadsafe(self._shutdown(), self._loop).result(5.0)
+    
+    def up(self):
+        """End a simulated outage."""
+        asyncio.run_coroutine_threadsafe(self._listen(), self._loop).result(5.0)
+    
+    async def _listen(self):
+        self._server = await asyncio.start_server(self._handle, self.host, self.port,
+                                                  reuse_address=True)
+    
+    async def _shutdown(self):
+        if self._server is not None:
+            self._server.close()
+            await self._server.wait_closed()
+            self._server = None
+        for writer in self._writers:
+            writer.transport.abort()
+        self._writers.clear()
+    
+    async def _handle(self, reader: asyncio.StreamReader, writer: asyncio.StreamWriter):
+        self._writers.append(writer)
+        self.connections += 1
+        try:
+            while True:
+                header = await reader.readexactly(1)
+                length, shift = 0, 0
+                while True:
+                    byte = (await reader.readexactly(1))[0]
+                    length |= (byte & 0x7F) << shift
+                    shift += 7
+                    if not byte & 0x80:
+                        break
+                body = await reader.readexactly(length)
+                kind = header[0] & 0xF0
+                if kind == 0x10:  # CONNECT
+                    writer.write(b"\x20\x02\x00\x00")
+                elif kind == 0x30:  # PUBLISH
+                    now = time.time()
+                    qos = (header[0] >> 1) & 0x03
+                    topic_len = struct.unpack_from("!H", body, 0)[0]
+                    topic = body[2:2 + topic_len].decode("utf-8")
+                    pos = 2 + topic_len
+                    if qos:
+                        writer.write(b"\x40\x02" + body[pos:pos + 2])
+                        pos += 2
+                    self.received += 1
+                    if self.on_message:
+                        self.on_message(topic, body[pos:], now)
+                elif kind == 0xC0:  # PINGREQ
+                    writer.write(b"\xd0\x00")
+                elif kind == 0xE0:  # DISCONNECT
+                    break
+        except (asyncio.IncompleteReadError, ConnectionError):
+            pass
+        finally:
+            if writer in self._writers:
+                self._writers.remove(writer)
+            writer.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="MQTT sink broker (mosquitto stand-in)")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=1883)
+    args = parser.parse_args()
+    
+    def show(topic, payload, t):
+        print(f"{t:.3f} {topic} {len(payload)} bytes")
+    
+    broker = StandInBroker(args.host, args.port, on_message=show).start()
+    print(f"MQTT stand-in listening on {args.host}:{args.port}")
+    try:
+        while True:
+            time.sleep(1)
+    except KeyboardInterrupt:
+        broker.stop()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""Scaling benchmark for multi-board acquisition (1..N boards on one host).
+
+For each board count, runs MultiBoardAcquisition for --duration seconds and
+reports per-board achieved rate, deadline overruns, merge latency (newest
+sample in a block to republish on the main bus) and host CPU use.
+
+Sources:
+    stub        ADS1115 reads against the kernel i2c-stub driver. i2c-stub
+                creates a single adapter, so boards are chips at 0x48, 0x49...
+                on it. Load it with --load-stub (root) or beforehand:
+                    sudo modprobe i2c-stub chip_addr=0x48,0x49,0x4a,0x4b
+    mock        per-sample MockADC reads (Python cost only)
+    synthetic   block-rate SignalGenerator (NumPy)
+
+Usage:
+    python3 -m benchmarks.multiboard_bench --source mock --rate 500 --max-boards 8
+    sudo python3 -m benchmarks.multiboard_bench --source stub --load-stub --max-boards 4
+    python3 -m benchmarks.multiboard_bench --mode thread    # compare against threads
+"""
+
+import argparse
+import glob
+import json
+import os
+import resource
+import subprocess
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from acquisition.bus import SampleBus  # noqa: E402
+from acquisition.multiboard import MultiBoardAcquisition  # noqa: E402
+
+STUB_FIRST_ADDRESS = 0x48
+
+
+def find_stub_bus():
+    """Bus number of the i2c-stub adapter, or None."""
+    for path in glob.glob("/sys/class/i2c-adapter/i2c-*/name"):
+        with open(path) as f:
+            if "stub" in f.read().lower():
+                return int(path.split("/")[-2][4:])
+    return None
+
+
+def load_stub(count: int):
+    addresses = ",".join(hex(STUB_FIRST_ADDRESS + i) for i in range(count))
+    subprocess.run(["modprobe", "-r", "i2c-stub"], check=False)
+    subprocess.run(["modprobe", "i2c-stub", f"chip_addr={addresses}"], check=True)
+
+
+def _cpu_seconds(boards: MultiBoardAcquisition) -> float:
+    """CPU time of this process plus (in process mode) what the workers report."""
+    own = resource.getrusage(resource.RUSAGE_SELF)
+    total = own.ru_utime + own.ru_stime
+    if boards.mode == "process":
+        total += sum(s.get("cpu_s", 0.0) for s in boards.board_stats.values())
+    return total
+
+
+def run_level(args, specs) -> dict:
+    bus = SampleBus()
+    sub = bus.subscribe(maxlen=1 << 16)
+    boards = MultiBoardAcquisition(specs, bus, rate_hz=args.rate, block_ms=args.block_ms,
+                                   channels=args.channels, mode=args.mode)
+    boards.start()
+    # Warm up until every board delivers (process start-up, imports, bus open)
+    seen = set()
+    deadline = time.monotonic() + 10.0
+    while seen != set(boards.board_ids) and time.monotonic() < deadline:
+        sub.wait(0.1)
+        seen.update(item.board for item in sub.drain())
+    boards.merged["max_merge_ms"] = 0.0
+    cpu_before = _cpu_seconds(boards)
+    started = time.monotonic()
+    samples = {}
+    while time.monotonic() - started < args.duration:
+        sub.wait(0.2)
+        for item in sub.drain():
+            if hasattr(item, "values"):
+                samples[item.board] = samples.get(item.board, 0) + len(item.values)
+    boards.stop()
+    elapsed = time.monotonic() - started
+    for item in sub.drain():
+        if hasattr(item, "values"):
+            samples[item.board] = samples.get(item.board, 0) + len(item.values)
+    cpu = _cpu_seconds(boards) - cpu_before
+    
+    stats = boards.get_stats()
+    per_board = [samples.get(b, 0) / elapsed / len(args.channels) for b in boards.board_ids]
+    overruns = sum(s.get("overruns", 0) for s in stats["boards"].values())
+    result = {
+        "boards": len(specs),
+        "requested_hz": args.rate,
+        "min_board_hz": round(min(per_board), 1),
+        "mean_board_hz": round(sum(per_board) / len(per_board), 1),
+        "total_samples_per_s": round(sum(samples.values()) / elapsed),
+        "overruns": overruns,
+        "max_late_ms": round(max((s.get("max_late_ms", 0.0) for s in stats["boards"].values()),
+                                 default=0.0), 2),
+        "max_merge_ms": round(stats["merged"]["max_merge_ms"], 2),
+        "read_errors": sum(s.get("read_errors", 0) for s in stats["boards"].values()),
+        "cpu_percent": round(100.0 * cpu / elapsed, 1),
+        "bus_dropped": sub.dropped,
+    }
+    result["ok"] = (result["min_board_hz"] >= 0.95 * args.rate and not result["bus_dropped"]
+                    and all("error" not in s for s in stats["boards"].values()))
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Multi-board acquisition scaling benchmark")
+    parser.add_argument("--source", choices=["stub", "mock", "synthetic"], default="mock")
+    parser.add_argument("--max-boards", type=int, default=os.cpu_count() or 1)
+    parser.add_argument("--rate", type=float, default=200.0, help="Sample rate per channel (Hz)")
+    parser.add_argument("--block-ms", type=float, default=100.0)
+    parser.add_argument("--channels", default="0,1,2,3")
+    parser.add_argument("--duration", type=float, default=5.0, help="Seconds per level")
+    parser.add_argument("--mode", choices=["process", "thread"], default="process")
+    parser.add_argument("--load-stub", action="store_true",
+                        help="(Re)load i2c-stub with one chip per board (needs root)")
+    parser.add_argument("--json", action="store_true")
+    args = parser.parse_args()
+    args.channels = [int(ch) for ch in args.channels.split(",")]
+    
+    stub_bus = None
+    if args.source == "stub":
+        if args.load_stub:
+            load_stub(args.max_boards)
+        stub_bus = find_stub_bus()
+        if stub_bus is None:
+            print("i2c-stub not loaded (use --load-stub as root)", file=sys.stderr)
+            sys.exit(1)
+    
+    results = []
+    for count in range(1, args.max_boards + 1):
+        if args.source == "stub":
+            specs = [f"{stub_bus}:{STUB_FIRST_ADDRESS + i:#x}" for i in range(count)]
+        else:
+            specs = [args.source] * count
+        step = run_level(args, specs)
+        results.append(step)
+        if not args.json:
+            print(f"{count:2d} boards: min {step['min_board_hz']:8.1f} Hz/board  "
+                  f"total {step['total_samples_per_s']:8d} samples/s  "
+                  f"overruns {step['overruns']:4d}  late {step['max_late_ms']:7.2f} ms  "
+                  f"merge {step['max_merge_ms']:7.2f} ms  cpu {step['cpu_percent']:6.1f}%  "
+                  f"{'OK' if step['ok'] else 'FAIL'}")
+    if args.json:
+        print(json.dumps({"source": args.source, "mode": args.mode, "levels": results}, indent=2))
+
+
+if __name__ == "__main__":
+    main()
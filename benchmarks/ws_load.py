@@ -0,0 +1,222 @@
+#!/usr/bin/env python3
+"""Load generator for the WebSocket streaming API.
+
+Opens an increasing number of concurrent clients against the stream server
+and measures what each of them actually receives. The result answers "how
+many clients can this Pi feed" for a given sample rate.
+
+Usage:
+    # Against a running device_panel.py on this machine
+    python3 -m benchmarks.ws_load --clients 1,5,10,25,50
+
+    # Self-contained: spawn a mock acquisition + server process first
+    python3 -m benchmarks.ws_load --spawn-mock --rate 1000 --clients 1,10,50,100
+
+    # Include stalled clients to check they don't hurt the others
+    python3 -m benchmarks.ws_load --spawn-mock --clients 10 --slow 3
+"""
+
+import argparse
+import asyncio
+import base64
+import json
+import os
+import statistics
+import subprocess
+import sys
+import time
+import urllib.request
+from concurrent.futures import ProcessPoolExecutor
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from api.frames import HEADER  # noqa: E402
+from api.websocket_server import OP_BINARY, OP_CLOSE, read_ws_frame  # noqa: E402
+
+
+async def _client(host: str, port: int, query: str, duration: float, slow: bool) -> dict:
+    """Run one streaming client and collect what it receives."""
+    result = {"frames": 0, "bytes": 0, "latencies": [], "slow": slow, "error": None}
+    try:
+        reader, writer = await asyncio.open_connection(host, port)
+        key = base64.b64encode(os.urandom(16)).decode()
+        writer.write((f"GET /stream?{query} HTTP/1.1\r\nHost: {host}\r\n"
+                      "Upgrade: websocket\r\nConnection: Upgrade\r\n"
+                      f"Sec-WebSocket-Key: {key}\r\nSec-WebSocket-Version: 13\r\n\r\n").encode())
+        response = await reader.readuntil(b"\r\n\r\n")
+        if b" 101 " not in response.split(b"\r\n", 1)[0]:
+            raise ConnectionError(response.split(b"\r\n", 1)[0].decode())
+        
+        deadline = time.monotonic() + duration
+        while True:
+            remaining = deadline - time.monotonic()
+            if remaining <= 0:
+                break
+            if slow:
+                # A stalled consumer: read a single frame every second
+                await asyncio.sleep(min(1.0, remaining))
+            try:
+                opcode, payload = await asyncio.wait_for(read_ws_frame(reader), remaining)
+            except asyncio.TimeoutError:
+                break
+            if opcode == OP_BINARY:
+                now = time.monotonic()
+                t_ref = HEADER.unpack_from(payload, 0)[4]
+                result["frames"] += 1
+                result["bytes"] += len(payload)
+                result["latencies"].append((now - t_ref) * 1000.0)
+        writer.write(bytes([0x80 | OP_CLOSE, 0x80]) + os.urandom(4))
+        writer.close()
+    except Exception as e:
+        result["error"] = str(e)
+    return result
+
+
+def _run_clients(host: str, port: int, query: str, duration: float, count: int, slow: int) -> list:
+    """Run a batch of clients in this process (one event loop)."""
+    async def run():
+        tasks = [_client(host, port, query, duration, i < slow) for i in range(count)]
+        return await asyncio.gather(*tasks)
+    return asyncio.run(run())
+
+
+def _status(host: str, port: int) -> dict:
+    with urllib.request.urlopen(f"http://{host}:{port}/status", timeout=2) as response:
+        return json.loads(response.read())
+
+
+def _percentile(values, pct):
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * pct / 100.0))]
+
+
+def run_step(args, clients: int) -> dict:
+    """Measure one concurrency level."""
+    before = _status(args.host, args.port)
+    clients += args.slow  # Stalled clients come on top of the measured ones
+    procs = max(1, min(args.procs, clients))
+    per_proc = [clients // procs + (1 if i < clients % procs else 0) for i in range(procs)]
+    slow_left = args.slow
+    jobs = []
+    with ProcessPoolExecutor(procs) as pool:
+        for n in per_proc:
+            slow = min(slow_left, n)
+            slow_left -= slow
+            jobs.append(pool.submit(_run_clients, args.host, args.port, args.query,
+                                    args.duration, n, slow))
+        results = [r for job in jobs for r in job.result()]
+    after = _status(args.host, args.port)
+    
+    normal = [r for r in results if not r["slow"] and not r["error"]]
+    latencies = [lat for r in normal for lat in r["latencies"]]
+    engine_before = before.get("engine", {})
+    engine_after = after.get("engine", {})
+    # A frame goes out per batch, but only when the engine has published something
+    interval_ms = max(after.get("batch_ms", 50), engine_after.get("block_ms", 0))
+    expected = args.duration * 1000.0 / interval_ms
+    step = {
+        "clients": clients - args.slow,
+        "slow_clients": args.slow,
+        "errors": sum(1 for r in results if r["error"]),
+        "frames_per_client": round(statistics.mean(r["frames"] for r in normal), 1) if normal else 0,
+        "expected_frames": round(expected, 1),
+        "min_frames": min((r["frames"] for r in normal), default=0),
+        "mbit_s_total": round(sum(r["bytes"] for r in normal) * 8 / args.duration / 1e6, 3),
+        "latency_p50_ms": round(_percentile(latencies, 50), 2),
+        "latency_p99_ms": round(_percentile(latencies, 99), 2),
+        "server_encode_ms": after.get("encode_ms"),
+        "engine_overruns": engine_after.get("overruns", 0) - engine_before.get("overruns", 0),
+        "engine_max_late_ms": round(engine_after.get("max_late_ms", 0.0), 2),
+    }
+    step["ok"] = (step["errors"] == 0 and step["min_frames"] >= 0.95 * expected
+                  and step["latency_p99_ms"] <= args.max_latency_ms)
+    return step
+
+
+def serve_mock(args):
+    """Run mock acquisition + stream server until killed."""
+    from acquisition.bus import SampleBus
+    from acquisition.engine import AcquisitionEngine
+    from api.websocket_server import StreamServer
+    from mock.mock_hardware import MockHardware
+    
+    hardware = MockHardware()
+    bus = SampleBus()
+    engine = AcquisitionEngine(hardware, bus, rate_hz=args.rate)
+    server = StreamServer(bus, host=args.host, port=args.port, engine=engine)
+    engine.start()
+    server.start()
+    try:
+        while True:
+            time.sleep(1)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.stop()
+        engine.stop()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="WebSocket streaming load generator")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8765)
+    parser.add_argument("--clients", default="1,2,5,10,25,50",
+                        help="Comma-separated concurrency levels")
+    parser.add_argument("--duration", type=float, default=5.0, help="Seconds per level")
+    parser.add_argument("--query", default="", help="Stream options, e.g. 'rate=100&events=0'")
+    parser.add_argument("--slow", type=int, default=0,
+                        help="Extra stalled clients added at every level")
+    parser.add_argument("--procs", type=int, default=os.cpu_count() or 1,
+                        help="Client processes (keeps the generator off the server's core)")
+    parser.add_argument("--max-latency-ms", type=float, default=250.0,
+                        help="p99 latency budget for a level to count as OK")
+    parser.add_argument("--spawn-mock", action="store_true",
+                        help="Start a mock acquisition + server subprocess")
+    parser.add_argument("--rate", type=float, default=1000.0,
+                        help="Mock sample rate per channel (with --spawn-mock)")
+    parser.add_argument("--serve-mock", action="store_true", help=argparse.SUPPRESS)
+    parser.add_argument("--json", action="store_true", help="Print results as JSON")
+    args = parser.parse_args()
+    
+    if args.serve_mock:
+        serve_mock(args)
+        return
+    
+    server = None
+    if args.spawn_mock:
+        server = subprocess.Popen([sys.executable, "-m", "benchmarks.ws_load", "--serve-mock",
+                                   "--host", args.host, "--port", str(args.port),
+                                   "--rate", str(args.rate)],
+                                  cwd=os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+        for _ in range(50):
+            try:
+                _status(args.host, args.port)
+                break
+            except OSError:
+                time.sleep(0.1)
+    
+    try:
+        steps = []
+        for clients in (int(c) for c in args.clients.split(",") if c):
+            step = run_step(args, clients)
+            steps.append(step)
+            if not args.json:
+                print(f"{clients:5d} clients: {step['frames_per_client']:7.1f}/{step['expected_frames']:.0f} frames"
+                      f"  p50 {step['latency_p50_ms']:6.2f} ms  p99 {step['latency_p99_ms']:7.2f} ms"
+                      f"  {step['mbit_s_total']:7.2f} Mbit/s  overruns {step['engine_overruns']}"
+                      f"  {'OK' if step['ok'] else 'FAIL'}")
+        capacity = max((s["clients"] for s in steps if s["ok"]), default=0)
+        if args.json:
+            print(json.dumps({"steps": steps, "max_clients_ok": capacity}, indent=2))
+        else:
+            print(f"Max clients within budget: {capacity}")
+    finally:
+        if server is not None:
+            server.terminate()
+            server.wait()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,206 @@
+"""Configuration for the background acquisition engine."""
+
+from config.memory_config import LOW_MEMORY
+
+# Enable/disable background acquisition (feeds the sample bus)
+ENABLE_ACQUISITION = True
+
+# ADC channels sampled by the engine
+ADC_CHANNELS = [0, 1, 2, 3]
+
+# Target sample rate per ADC channel (Hz)
+ADC_SAMPLE_RATE_HZ = 50
+
+# Samples are collected into blocks and published every BLOCK_MS
+BLOCK_MS = 100
+
+# Period of the I2C presence scan that reports devices appearing/vanishing (seconds)
+I2C_PRESENCE_PERIOD_S = 5.0
+
+# Replay a capture file (see device_cli.py stream) instead of sampling hardware.
+# None = live acquisition
+REPLAY_FILE = None
+
+# Replay speed: 1.0 = real time, 4.0 = 4x, 0 = as fast as possible
+REPLAY_SPEED = 1.0
+
+# Restart the capture at its end
+REPLAY_LOOP = True
+
+# Extra boards on additional I2C adapters, merged onto the bus as board 1, 2, ...
+# Specs: "20" (ADS1115 on /dev/i2c-20), "20:0x49", "mock" or "synthetic"
+EXTRA_BOARDS = []
+
+# "process" runs each extra board in its own process (uses all cores), "thread" in-process
+MULTI_BOARD_MODE = "process"
+
+# Per-channel running statistics (mean/std/RMS, windowed min/max, percentiles)
+ENABLE_STATS = True
+
+# Sliding window for min/max (seconds)
+STATS_WINDOW_S = 10.0
+
+# Streaming percentiles (P-squared estimators)
+STATS_PERCENTILES = [50, 95, 99]
+
+# Spectrum analyzer (Welch-averaged FFT + waterfall of one channel). In low-memory
+# mode it (and NumPy) only loads when started from the GUI.
+ENABLE_SPECTRUM = True
+SPECTRUM_NFFT = 256
+SPECTRUM_OVERLAP = 0.5
+SPECTRUM_WINDOW = "hann"  # "hann" or "blackman"
+SPECTRUM_AVERAGES = 8
+SPECTRUM_UPDATE_HZ = 4.0
+SPECTRUM_WATERFALL_ROWS = 60 if LOW_MEMORY else 120
+
+# Derived channels: name -> expression over adc0..adc3 (ch0..ch3 also work) and
+# earlier derived channels, or (expression, unit). Evaluated block-wise and
+# published on the bus like physical channels; grammar in acquisition/derived.py.
+# e.g. {"diff01": ("(adc0 - adc1) * 2.5", "V"), "temp": ("ntc(adc2)", "°C")}
+ENABLE_DERIVED = True
+DERIVED_CHANNELS = {}
+
+# Named curves for table(x, "name"): [(x, y), ...] with x strictly increasing
+DERIVED_TABLES = {}
+
+# Local rules evaluated in the acquisition thread (see acquisition/rules.py), e.g.
+# {"name": "overvoltage", "when": "adc2 > 3.1", "for_ms": 20, "hysteresis": 0.1,
+#  "then": ["led3:blink", "power:off"], "clear": ["led3:off"]}
+ENABLE_RULES = True
+RULES = []
+
+# Warn when a rule's sample-to-action latency exceeds this (ms)
+RULE_LATENCY_BUDGET_MS = 5.0
+
+# Blink frequency for ledN:blink actions (Hz)
+RULE_BLINK_HZ = 4.0
+
+# Closed-loop PID control on the J11 GPIO bank (see acquisition/control.py), e.g.
+# {"name": "heater", "input": "temp", "output": "pwm:12", "rate_hz": 20,
+#  "setpoint": 45.0, "kp": 0.08, "ki": 0.01, "kd": 0.0, "out_min": 0.0, "out_max": 1.0}
+# Inputs are adcN or derived channels; outputs "pwm:<bcm>" or "gpio:<bcm>".
+ENABLE_CONTROL = True
+CONTROL_LOOPS = []
+
+# Default PWM frequency (Hz)
+CONTROL_PWM_HZ = 1000
+
+# Trace points kept per loop (served on /control)
+CONTROL_TRACE_LEN = 500 if LOW_MEMORY else 2000
+
+# Busy-wait before each deadline (µs): lower jitter for more CPU, 0 = sleep only
+CONTROL_SPIN_US = 0
+
+# A control input older than this many input periods (the ADC sample period, or
+# BLOCK_MS for derived and replayed channels) is stale: the tick counts under
+# input_missing and the output is driven to out_min. Per loop: "max_age_s".
+CONTROL_INPUT_MAX_AGE = 5
+
+# Real-time settings for the acquisition and control threads (see acquisition/realtime.py).
+# SCHED_FIFO needs CAP_SYS_NICE or an rtprio entry in /etc/security/limits.conf,
+# mlockall a large enough memlock limit; the startup check reports what took effect.
+RT_ENABLE = False
+
+# SCHED_FIFO priority per thread role (kept below the kernel's IRQ threads at 50)
+RT_PRIORITIES = {"acquisition": 45, "control": 40}
+
+# CPUs for RT threads: [2, 3], "isolated" (cores from isolcpus=) or None
+RT_CPUS = "isolated"
+
+# Lock all current and future memory in RAM
+RT_MLOCKALL = True
+
+# Heap touched at startup so the first blocks don't page-fault (MB)
+RT_PREFAULT_MB = 8
+
+# Garbage collector: "normal", "freeze", "defer" (no automatic collection, young
+# generations collected every RT_GC_PERIOD_S on the housekeeping thread, all of
+# them every RT_GC_FULL_PERIOD_S so cycles that reach the oldest one are freed)
+# or "off" (cyclic garbage is never freed)
+RT_GC = "defer"
+RT_GC_PERIOD_S = 1.0
+RT_GC_FULL_PERIOD_S = 600.0
+
+# GIL switch interval (s): how long an RT thread can wait for the interpreter
+RT_SWITCH_INTERVAL_S = 0.001
+
+# Conversion-time stamping (see acquisition/timing.py): the ADC is read on its own
+# thread and every sample is stamped at the middle of its conversion, with the
+# ADS1x15 oscillator drift estimated against the host clock. Needs ADC_TIMED_BUS
+# (register-level access); one channel runs in continuous mode.
+ADC_TIMED = False
+ADC_TIMED_BUS = 1
+
+# Data rate for timed sampling (SPS); None = the chip's fastest (860 ADS1115, 3300 ADS1015)
+ADC_DATA_RATE = None
+
+# BCM pin wired to the ADS1x15 ALERT/RDY output (e.g. 6 = J11 pin 2), timestamped by
+# the kernel; None = derive conversion times from the data rate
+ADC_RDY_PIN = None
+
+# Time constant of the drift estimate (s)
+ADC_DRIFT_TAU_S = 30.0
+
+# MPU6050/MPU6500 IMUs streamed through their on-chip FIFO (see acquisition/imu.py), e.g.
+# {"bus": 1, "address": 0x68, "rate_hz": 1000, "int_pin": 13, "name": "imu"}
+# Every key but "bus" is optional. Channels <name>_ax/_ay/_az (g) and _gx/_gy/_gz
+# (deg/s) are published on the bus; "temperature": True adds <name>_temp (degC).
+ENABLE_IMU = True
+IMU_STREAMS = []
+
+# Output data rate (Hz, up to 1000 with the DLPF on) and full-scale ranges
+IMU_RATE_HZ = 1000
+IMU_ACCEL_RANGE_G = 4        # 2, 4, 8 or 16
+IMU_GYRO_RANGE_DPS = 500     # 250, 500, 1000 or 2000
+
+# Digital low-pass bandwidth (Hz); None = widest setting below the Nyquist frequency
+IMU_DLPF_HZ = None
+
+# FIFO drain interval (ms). The FIFO holds 85 packets (MPU6050) or 42 (MPU6500) of
+# accel + gyro, i.e. 85/42 ms at 1 kHz; with an INT pin the drain waits for this
+# many ms worth of data-ready edges instead of polling.
+IMU_BATCH_MS = 10
+
+# BMP280/BME280 pressure sensors polled on the engine's task thread (see
+# acquisition/pressure.py), e.g. [{"bus": 1, "address": 0x76},
+# {"bus": 3, "address": 0x77, "name": "outside"}]. Channels <name>_p (hPa),
+# <name>_t (degC) and, on a BME280, <name>_rh (%).
+ENABLE_PRESSURE = True
+PRESSURE_SENSORS = []
+
+# Poll rate (Hz); oversampling is the highest that fits the period (up to ~80 Hz)
+PRESSURE_RATE_HZ = 1.0
+
+# "forced": one measurement per poll, the sensor sleeps in between (least power and
+# self-heating); "normal": the sensor free-runs and polls read the newest result
+PRESSURE_MODE = "forced"
+
+# IIR filter coefficient (0 = off, 2, 4, 8, 16); damps door slams and wind gusts
+PRESSURE_IIR = 0
+
+# MCP9808 temperature sensors (see acquisition/temperature.py). Polled at
+# TEMPERATURE_RATE_HZ: {"bus": 1, "address": 0x18, "name": "case"}. Event mode, with
+# ALERT wired to a J11 GPIO and the bus idle until the temperature leaves the window:
+# {"bus": 1, "address": 0x19, "alert_pin": 12, "lower": 5, "upper": 40, "critical": 60}
+# Channel <name> (degC); event mode also publishes "alert" events.
+ENABLE_TEMPERATURE = True
+TEMPERATURE_SENSORS = []
+
+# Poll rate (Hz); resolution is the finest whose conversion fits (0.0625 degC up to 4 Hz)
+TEMPERATURE_RATE_HZ = 1.0
+
+# ALERT hysteresis (degC): 0, 1.5, 3 or 6
+TEMPERATURE_HYSTERESIS = 1.5
+
+# DS3231 RTC disciplining the acquisition timestamps (see acquisition/clock.py):
+# its 1 Hz SQW output wired to a J11 GPIO (e.g. 5) with a pull-up. None = off;
+# wall-clock conversions then use the system clock.
+RTC_SQW_PIN = None
+RTC_BUS = 1
+RTC_ADDRESS = 0x68
+
+# Drift estimator time constant (s); longer averages more edge jitter away
+RTC_TAU_S = 3600.0
+
+# Interval of the clock_offset channel (Unix minus monotonic seconds)
+RTC_PUBLISH_S = 10.0
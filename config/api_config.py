@@ -0,0 +1,44 @@
+"""Configuration for the local streaming API."""
+
+# Enable/disable the embedded HTTP/WebSocket server
+ENABLE_STREAM_SERVER = True
+
+# Listen address - loopback only by default; use "0.0.0.0" to expose on the LAN
+STREAM_HOST = "127.0.0.1"
+STREAM_PORT = 8765
+
+# Frames are batched and sent to each client every STREAM_BATCH_MS
+STREAM_BATCH_MS = 50
+
+# Depth (bus items) of the server's one bus subscription, shared by all clients,
+# before the oldest are dropped
+STREAM_QUEUE_LEN = 512
+
+# Per-client socket buffer (bytes) above which frames are skipped, not queued
+STREAM_MAX_BUFFERED = 256 * 1024
+
+# Largest frame a client may send (option updates are a few hundred bytes);
+# a longer one closes the connection with 1009 (message too big)
+STREAM_MAX_MESSAGE = 64 * 1024
+
+# MQTT publisher (plant historian uplink)
+ENABLE_MQTT = False
+MQTT_HOST = "localhost"
+MQTT_PORT = 1883
+MQTT_CLIENT_ID = None  # None = "device-panel-<hostname>"
+MQTT_TOPIC_PREFIX = None  # None = "sensor-shield/<hostname>"
+MQTT_QOS = 1
+
+# Payload format: "cbor" (self-describing) or "binary" (api.frames layout)
+MQTT_FORMAT = "cbor"
+
+# Samples are coalesced into one message per MQTT_BATCH_MS, or sooner once
+# the pending payload reaches MQTT_MAX_PAYLOAD bytes
+MQTT_BATCH_MS = 1000
+MQTT_MAX_PAYLOAD = 32 * 1024
+
+# Offline spool (used while the broker is unreachable)
+MQTT_SPOOL_DIR = "~/.cache/device-panel/mqtt-spool"
+MQTT_SPOOL_MAX_BYTES = 64 * 1024 * 1024
+MQTT_REPLAY_RATE = 50  # Spooled messages per second during replay
+MQTT_RECONNECT_S = 5.0
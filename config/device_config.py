@@ -1,5 +1,7 @@
 """Configuration for device management system."""
 
+from config.memory_config import LOW_MEMORY
+
 # Enable/disable device system
 ENABLE_DEVICE_SYSTEM = True
 
@@ -9,3 +11,28 @@ PLUGIN_DIR = "devices"
 # User plugin directory (for custom plugins)
 USER_PLUGIN_DIR = "devices/user"
 
+# Plugin instances kept per (bus, address, plugin) by the loader
+DEVICE_CACHE_SIZE = 8 if LOW_MEMORY else 32
+
+# Device tabs kept built (with their plugin pages) after being closed
+DEVICE_TAB_CACHE_SIZE = 2 if LOW_MEMORY else 8
+
+# Sample-image thumbnails decoded once per file (pixels per side)
+THUMBNAIL_SIZE = 64
+
+# Decoded thumbnails kept (least recently used are dropped)
+THUMBNAIL_CACHE_SIZE = 16 if LOW_MEMORY else 128
+
+# 24Cxx EEPROM part at 0x50 (size, page size, address width; see hardware/eeprom.py).
+# The Pi HAT specification uses a 24C32.
+EEPROM_PART = "24c32"
+
+# Longest write cycle to wait for while ACK polling (datasheet tWR max is 5-10 ms)
+EEPROM_WRITE_TIMEOUT_MS = 20
+
+# OLED controller at 0x3C/0x3D for the CLI and kiosk text output (see hardware/display/):
+# "ssd1306", "ssd1309" or "sh1106" (1.3" modules are usually SH1106)
+OLED_CONTROLLER = "ssd1306"
+
+# OLED panel height (64 or 32; 32 is SSD1306 only)
+OLED_HEIGHT = 64
@@ -0,0 +1,33 @@
+"""Configuration for the GUI display backend (X11 desktop or kiosk without X)."""
+
+# Qt platform plugin for device_panel.py:
+#   None       Qt's default - xcb under the X11 desktop (or whatever QT_QPA_PLATFORM says)
+#   "eglfs"    fullscreen straight on DRM/KMS through EGL/GLES (vc4/v3d), no X server
+#   "linuxfb"  software-rendered into the framebuffer device, no X server and no GPU
+# The DEVICE_PANEL_PLATFORM environment variable overrides this
+# (pi-image-build/config/device-panel-kiosk.service sets it).
+KIOSK_PLATFORM = None
+
+# eglfs: DRM device; None = Qt picks one. On Bookworm card0 can be the render-only
+# v3d node, so the display controller may have to be named (e.g. "/dev/dri/card1").
+KIOSK_DRM_DEVICE = None
+
+# linuxfb: framebuffer device
+KIOSK_FB = "/dev/fb0"
+
+# Screen rotation in degrees (0, 90, 180, 270); touch input is rotated to match
+KIOSK_ROTATION = 0
+
+# Hide the mouse cursor (touch-only kiosks)
+KIOSK_HIDE_CURSOR = True
+
+# Below this screen height the sections are put in a touch-scrollable area
+# (the official 7" display is 800x480; the window wants 900x700 under X11)
+KIOSK_SCROLL_BELOW_HEIGHT = 700
+
+# Startup report (boot-to-first-frame, RSS), written once the first frame is on
+# screen and updated after STARTUP_SETTLE_S. None = $RUNTIME_DIRECTORY/startup.json
+# under systemd (RuntimeDirectory=device-panel), else /tmp/device-panel-startup.json.
+# The DEVICE_PANEL_STARTUP_REPORT environment variable overrides this.
+STARTUP_REPORT = None
+STARTUP_SETTLE_S = 10.0
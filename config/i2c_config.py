@@ -0,0 +1,37 @@
+"""Configuration for the I2C adapter timeout, message size and bus recovery."""
+
+# Bus clock (Hz) the adapter runs at - dtparam=i2c_arm_baudrate in
+# config.txt; the image sets 100 kHz (pi-image-build/config/boot-config.txt)
+I2C_CLOCK_HZ = 100000
+
+# Largest single I2C message the drivers send or request (bytes). Bulk
+# transfers - display frames, EEPROM dumps - are split at this size so every
+# message finishes well inside the adapter timeout
+I2C_MAX_MESSAGE_BYTES = 512
+
+# Adapter timeout (ms), set with the I2C_TIMEOUT ioctl. It is adapter-wide -
+# it bounds every message on the bus, from every process - so it has to cover
+# the longest message at I2C_CLOCK_HZ. Kernel drivers default to about a
+# second, which stalls the acquisition loop every time a sensor stops
+# responding. None = computed from I2C_CLOCK_HZ and I2C_MAX_MESSAGE_BYTES
+# (twice the transfer time plus 20 ms, 120 ms at 100 kHz); 0 = leave the
+# driver default
+I2C_TIMEOUT_MS = None
+
+# Retries the adapter makes on arbitration loss (I2C_RETRIES ioctl)
+I2C_RETRIES = 1
+
+# Consecutive bus faults (timeouts, arbitration loss, I/O errors - not NACKs)
+# before the bus is considered hung and recovered
+I2C_ERROR_THRESHOLD = 3
+
+# Recover a hung bus automatically: 9 SCL pulses + STOP through GPIO, then
+# rebind the adapter driver (needs root for the sysfs bind/unbind)
+I2C_RECOVERY_ENABLED = True
+
+# Minimum time between two recoveries of the same bus (seconds)
+I2C_RECOVERY_INTERVAL_S = 2.0
+
+# An address that faults I2C_ERROR_THRESHOLD times in a row is skipped (calls
+# fail immediately) for this long, so one bad sensor can't stall its neighbours
+I2C_QUARANTINE_S = 5.0
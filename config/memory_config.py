@@ -0,0 +1,15 @@
+"""Configuration for the low-memory mode (Pi Zero-class boards with 512 MB)."""
+
+import os
+
+# Low-memory mode:
+# - NumPy-backed views load when first opened (the spectrum analyzer starts
+#   from a button instead of at launch)
+# - the ADC talks through the shared smbus2 bus layer (hardware/i2c_bus.py)
+#   instead of loading Blinka and the Adafruit driver (the OLEDs always do)
+# - smaller caches and in-memory histories (see the *_config.py sizes)
+# DEVICE_PANEL_LOW_MEMORY=1 (or 0) in the environment overrides this.
+LOW_MEMORY = False
+
+if "DEVICE_PANEL_LOW_MEMORY" in os.environ:
+    LOW_MEMORY = os.environ["DEVICE_PANEL_LOW_MEMORY"] not in ("", "0", "false", "no")
@@ -13,6 +13,14 @@ BTN2 = 24  # BCM24
 # Sensor power control
 SENSOR_POWER = 26  # BCM26
 
+# GPIO bank (J11): connector pin -> BCM pin
+GPIO_BANK = {1: 5, 2: 6, 3: 12, 4: 13}
+
+# Hardware PWM on the GPIO bank: BCM pin -> (pwmchip, channel) under /sys/class/pwm.
+# Needs e.g. dtoverlay=pwm-2chan,pin=12,func=4,pin2=13,func2=4 in config.txt;
+# without it (and on BCM5/BCM6) PWM is software-timed through gpiozero.
+PWM_SYSFS_CHANNELS = {12: (0, 0), 13: (0, 1)}
+
 # I2C bus
 # Set to None to auto-detect, or specify bus number
 # - Bus 1: I2C1 (GPIO2/GPIO3, pins 3/5) - Default, used by ADC and J12/J13
@@ -27,4 +35,10 @@ I2C3_BUS = 3  # I2C3 bus number
 # ADC I2C address
 ADC_ADDRESS = 0x48  # ADS1115 default address
 
+# ADC chip: "ADS1115" (16-bit, up to 860 SPS), "ADS1015" (12-bit, up to 3300 SPS)
+# or None to tell them apart by conversion time when first used
+ADC_MODEL = None
 
+# I2C pins used for bus recovery: bus -> (SDA, SCL) as BCM pins.
+# Buses not listed (USB adapters, Pi 5 native buses) are only reset by rebinding the adapter.
+I2C_RECOVERY_PINS = {1: (2, 3), 3: (4, 5)}
@@ -0,0 +1,1096 @@
+#!/usr/bin/env python3
+"""Device CLI - headless entry point for scripting, SSH sessions and benchmarks.
+
+Uses the same hardware managers as the GUI but never imports PySide6, and
+imports each manager only when a subcommand needs it, so startup stays well
+under a second on a Pi. Every subcommand accepts --json (before or after its
+name) for machine-readable output on stdout; diagnostics go to stderr. Exit
+status is 0 on success, 1 on hardware/test failure and 2 on usage errors.
+
+Usage:
+    python3 device_cli.py scan [--bus N] [--all] [--health] [--recover]
+    python3 device_cli.py read [--channels 0,1] [--count N] [--interval S]
+    python3 device_cli.py stream --out FILE [--duration S] [--rate HZ] [--format capture|csv|jsonl]
+    python3 device_cli.py oled text "Hello" | oled image PATH  [--controller sh1106]
+    python3 device_cli.py eeprom info | read [--out FILE] | write FILE | wpcheck  [--part 24c32]
+    python3 device_cli.py imu [--address 0x69] [--rate HZ] [--duration S] [--int-pin BCM]
+    python3 device_cli.py pressure [--sensor 1:0x76 ...] [--rate HZ] [--mode forced|normal]
+    python3 device_cli.py temperature [--address 0x18] [--alert-pin BCM --lower C --upper C]
+    python3 device_cli.py rtc read | set | discipline [--sqw-pin BCM] [--duration S]
+    python3 device_cli.py spi [--pattern HEX | --size N] [--speed HZ] [--repeat N]
+    python3 device_cli.py bench adc|engine
+    python3 device_cli.py replay FILE [--speed X] [--loop] [--serve]
+    python3 device_cli.py rtcheck [--duration S]   (apply RT settings and report what took effect)
+    python3 device_cli.py --rt bench|control ...   (SCHED_FIFO, affinity, mlockall, GC deferral)
+    python3 device_cli.py --mock ...   (simulated hardware, works on any PC)
+    python3 device_cli.py --synthetic ...   (NumPy block signals for load tests)
+    python3 device_cli.py --virtual ...   (virtual ADS1115 or ADS1015 per ADC_MODEL / MPU6050 /
+                                           MCP9808 / DS3231 / OLED, realistic I2C timing)
+"""
+
+import argparse
+import json
+import sys
+import time
+
+
+class _Hardware:
+    """Lazy hardware container - managers are created on first access."""
+    
+    _FACTORIES = {
+        "adc": ("hardware.adc_manager", "ADCManager", "MockADC"),
+        "gpio": ("hardware.gpio_manager", "GPIOManager", "MockGPIO"),
+        "spi": ("hardware.spi_tester", "SPITester", "MockSPI"),
+        "power": ("hardware.power_manager", "PowerManager", "MockPower"),
+    }
+    
+    def __init__(self, mock: bool = False, i2c_bus=None):
+        self.mock = mock
+        self.i2c_bus = i2c_bus
+    
+    def __getattr__(self, name):
+        import importlib
+        if name == "i2c":
+            if self.mock:
+                from mock.mock_hardware import MockI2C
+                manager = MockI2C()
+            else:
+                from hardware.i2c_scanner import I2CScanner
+                from config.pins import I2C_BUS
+                manager = I2CScanner(bus=self.i2c_bus if self.i2c_bus is not None else I2C_BUS)
+        elif name in self._FACTORIES:
+            module, real, fake = self._FACTORIES[name]
+            if self.mock:
+                manager = getattr(importlib.import_module("mock.mock_hardware"), fake)()
+            else:
+                manager = getattr(importlib.import_module(module), real)()
+        else:
+            raise AttributeError(name)
+        setattr(self, name, manager)
+        return manager
+
+
+def _engine_view(hw, events: bool):
+    """Only the managers the engine should touch (it probes gpio/i2c with getattr)."""
+    from types import SimpleNamespace
+    if events:
+        return SimpleNamespace(adc=hw.adc, gpio=hw.gpio, i2c=hw.i2c)
+    return SimpleNamespace(adc=hw.adc)
+
+
+def _parse_channels(text: str):
+    return [int(ch) for ch in text.split(",") if ch.strip()]
+
+
+def _emit(args, result: dict, text: str):
+    if args.json:
+        print(json.dumps(result))
+    else:
+        print(text)
+
+
+def cmd_scan(args, hw) -> int:
+    """Scan I2C bus(es) and name what was found."""
+    from devices.registry import get_registry
+    registry = get_registry()
+    
+    if args.recover and not args.mock:
+        outcome = hw.i2c.recover()
+        state = "ok" if outcome["ok"] else f"FAILED ({outcome['error']})"
+        print(f"recover: {state} in {outcome['duration_ms']:.1f} ms, SDA stuck: "
+              f"{outcome['sda_stuck']}, {outcome['pulses']} SCL pulses", file=sys.stderr)
+    
+    if args.all and not args.mock:
+        from hardware.i2c_scanner import I2CScanner
+        buses = I2CScanner.scan_all_buses()
+    else:
+        try:
+            buses = {getattr(hw.i2c, 'bus', args.bus or 1): hw.i2c.scan()}
+        except RuntimeError as e:
+            print(f"scan: {e}", file=sys.stderr)
+            return 1
+    
+    result = {"buses": {}}
+    lines = []
+    for bus, addresses in sorted(buses.items()):
+        devices = []
+        for addr in addresses:
+            names = [name for name, _ in registry.lookup(addr)]
+            devices.append({"address": addr, "candidates": names})
+            lines.append(f"bus {bus}  0x{addr:02X}  {' / '.join(names)}")
+        result["buses"][str(bus)] = devices
+    if not lines:
+        lines.append("No devices found")
+    if args.health and not args.mock:
+        from hardware.i2c_bus import get_health
+        result["health"] = {}
+        for bus in sorted(buses):
+            health = get_health(bus).get_stats()
+            result["health"][str(bus)] = health
+            lines.append(f"bus {bus}  {'healthy' if health['healthy'] else 'FAULT'}: "
+                         f"{health['transactions']} transactions, {health['faults']} faults "
+                         f"({health['timeouts']} timeouts), {health['recoveries']} recoveries "
+                         f"(max {health['recovery_ms_max']:.1f} ms), timeout {health['timeout_ms']} ms")
+            if health["last_error"]:
+                lines.append(f"bus {bus}  last error: {health['last_error']}")
+    _emit(args, result, "\n".join(lines))
+    return 0
+
+
+def cmd_read(args, hw) -> int:
+    """Read ADC channels one or more times."""
+    channels = _parse_channels(args.channels)
+    rows = []
+    for i in range(args.count):
+        if i:
+            time.sleep(args.interval)
+        t = time.time()
+        values = {ch: hw.adc.read_channel(ch) for ch in channels}
+        rows.append({"t": t, "values": {str(ch): v for ch, v in values.items()}})
+        if not args.json:
+            print("  ".join(f"A{ch}={v:.4f}V" if v is not None else f"A{ch}=--"
+                            for ch, v in values.items()))
+    if args.json:
+        print(json.dumps({"channels": channels, "readings": rows}))
+    return 0
+
+
+class _TextSink:
+    """CSV / JSON-lines writer for the stream command."""
+    
+    def __init__(self, path: str, fmt: str, offset: float):
+        self.file = open(path, "w")
+        self.fmt = fmt
+        self.offset = offset  # monotonic -> Unix seconds
+        self.samples = 0
+        self.events = 0
+        if fmt == "csv":
+            self.file.write("time,board,channel,value\n")
+    
+    def write(self, item):
+        from acquisition.bus import Event
+        if isinstance(item, Event):
+            self.events += 1
+            if self.fmt == "jsonl":
+                self.file.write(json.dumps({"t": item.timestamp + self.offset, "event": item.kind,
+                                            "source": item.source, "value": item.value,
+                                            "board": item.board}) + "\n")
+            return
+        write = self.file.write
+        if self.fmt == "csv":
+            for t, v in zip(item.timestamps, item.values):
+                write(f"{t + self.offset:.6f},{item.board},{item.channel},{v:.6g}\n")
+        else:
+            write(json.dumps({"t": [t + self.offset for t in item.timestamps],
+                              "channel": item.channel, "board": item.board,
+                              "values": list(item.values)}) + "\n")
+        self.samples += len(item.values)
+    
+    def close(self):
+        self.file.close()
+
+
+def cmd_stream(args, hw) -> int:
+    """Run the acquisition engine and record the sample bus to a file."""
+    from acquisition.bus import SampleBus
+    from acquisition.engine import AcquisitionEngine
+    
+    bus = SampleBus()
+    sub = bus.subscribe(maxlen=4096)
+    channels = _parse_channels(args.channels)
+    view = _engine_view(hw, args.events)
+    timed = None
+    if args.timed:
+        # Conversion-time stamps: the ADC is read on its own thread, the engine collects blocks
+        from acquisition.timing import TimedADC
+        adc = hw.adc
+        if not hasattr(adc, "configure"):
+            if args.mock:
+                print("stream: --timed needs a register-level ADC (use --virtual)", file=sys.stderr)
+                return 2
+            from config.acquisition_config import ADC_TIMED_BUS
+            from hardware.adc_manager import ADCManager
+            adc = ADCManager(bus=ADC_TIMED_BUS)
+        ready = adc.ready_line() if args.rdy_pin is not None and hasattr(adc, "ready_line") else None
+        try:
+            timed = TimedADC(adc, channels, data_rate=args.data_rate, ready=ready,
+                             ready_pin=args.rdy_pin)
+        except (ImportError, OSError, ValueError) as e:
+            print(f"stream: {e}", file=sys.stderr)
+            return 1
+        view.adc = timed
+    engine = AcquisitionEngine(view, bus, rate_hz=args.rate, channels=channels)
+    
+    derived = None
+    if args.derived:
+        from acquisition.derived import DerivedChannels
+        definitions = {}
+        for spec in args.derived:
+            name, sep, expression = spec.partition("=")
+            if not sep:
+                print(f"stream: --derived expects NAME=EXPR, got {spec!r}", file=sys.stderr)
+                return 2
+            definitions[name.strip()] = expression.strip()
+        try:
+            derived = DerivedChannels(bus, definitions)
+        except ValueError as e:
+            print(f"stream: {e}", file=sys.stderr)
+            return 2
+    
+    fmt = args.format or ("csv" if args.out.endswith(".csv") else
+                          "jsonl" if args.out.endswith(".jsonl") else "capture")
+    if fmt == "capture":
+        from acquisition.capture import CaptureWriter
+        metadata = {"rate_hz": args.rate, "channels": channels,
+                    "source": "mock" if args.mock else "adc"}
+        if timed:
+            metadata.update({"timestamps": timed.mode, "data_rate": args.data_rate})
+        if derived:
+            metadata["derived"] = {name: expr.source for name, expr in derived.channels}
+        sink = CaptureWriter(args.out, metadata)
+    else:
+        from acquisition.timing import unix_offset
+        sink = _TextSink(args.out, fmt, unix_offset())
+    
+    boards = None
+    if args.boards:
+        from acquisition.multiboard import MultiBoardAcquisition
+        boards = MultiBoardAcquisition(args.boards.split(","), bus, rate_hz=args.rate,
+                                       channels=channels)
+        boards.start()
+    if derived:
+        derived.start()
+    if timed:
+        timed.start()
+    engine.start()
+    start = time.monotonic()
+    try:
+        while args.duration <= 0 or time.monotonic() - start < args.duration:
+            sub.wait(0.2)
+            for item in sub.drain():
+                sink.write(item)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if boards:
+            boards.stop()
+        engine.stop()
+        if timed:
+            timed.stop()
+        if derived:
+            derived.stop()
+        for item in sub.drain():
+            sink.write(item)
+        sink.close()
+    
+    elapsed = time.monotonic() - start
+    stats = engine.get_stats()
+    result = {"out": args.out, "format": fmt, "duration_s": elapsed,
+              "samples": sink.samples, "events": sink.events,
+              "overruns": stats["overruns"], "read_errors": stats["read_errors"],
+              "max_late_ms": stats["max_late_ms"], "bus_dropped": sub.dropped}
+    text = (f"Wrote {sink.samples} samples, {sink.events} events to {args.out} "
+            f"in {elapsed:.1f}s ({stats['overruns']} overruns, {sub.dropped} dropped)")
+    if timed:
+        timing = result["adc_timing"] = timed.get_stats()
+        if timing["ppm"] is None:
+            text += (f"\nADC {timing['mode']}: no drift fit, conversion "
+                     f"{timing['conversion_us']:.0f} us ({timing['conversion_source']})")
+        else:
+            text += (f"\nADC {timing['mode']}: clock {timing['ppm']:+.0f} ppm vs host, "
+                     f"fit residual {timing['residual_us']:.1f} us, {timing['missed']} missed")
+    _emit(args, result, text)
+    return 0 if not sub.dropped else 1
+
+
+def cmd_oled(args, hw) -> int:
+    """Push text or an image to the OLED (--mock only renders)."""
+    from config.device_config import OLED_CONTROLLER
+    from hardware import oled
+    address = int(args.address, 0)
+    controller = args.controller or OLED_CONTROLLER
+    try:
+        if args.virtual:
+            from hardware.display import open_display
+            from mock.virtual_oled import VirtualOLED
+            display = open_display(address, controller,
+                                   device=VirtualOLED(hw.i2c, address, controller))
+            image = (oled.render_text(args.value) if args.kind == "text"
+                     else oled.render_image(args.value)[0])
+            display.image(image)
+            display.show()
+        elif args.mock:
+            if args.kind == "text":
+                oled.render_text(args.value)
+            else:
+                oled.render_image(args.value)
+            _emit(args, {"ok": True, "mock": True}, "Rendered (mock - nothing sent)")
+            return 0
+        elif args.kind == "text":
+            display = oled.show_text(args.value, address, controller, args.bus)
+        else:
+            display = oled.show_image(args.value, address, controller, args.bus)[0]
+    except ImportError as e:
+        print(f"oled: {e} (pip3 install smbus2 pillow)", file=sys.stderr)
+        return 1
+    except ValueError as e:
+        print(f"oled: {e}", file=sys.stderr)
+        return 2
+    except Exception as e:
+        print(f"oled: {e}", file=sys.stderr)
+        return 1
+    stats = display.get_stats()
+    _emit(args, {"ok": True, "address": address, "width": display.width,
+                 "height": display.height, "controller": display.name,
+                 "bytes": stats["last_bytes"], "ms": stats["last_ms"]},
+          f"Displayed on {display.name} at 0x{address:02X} ({display.width}x{display.height}), "
+          f"{stats['last_bytes']} bytes in {stats['last_ms']:.1f} ms")
+    return 0
+
+
+def cmd_eeprom(args, hw) -> int:
+    """Read, flash or inspect a 24Cxx EEPROM (HAT EEPROM at 0x50 by default)."""
+    from config.device_config import EEPROM_PART
+    from config.pins import I2C_BUS
+    from hardware.eeprom import EEPROM, EEPROMError, WriteProtectedError, parse_hat
+    if args.mock:
+        print("eeprom: needs real hardware", file=sys.stderr)
+        return 2
+    try:
+        eeprom = EEPROM(args.bus if args.bus is not None else I2C_BUS, int(args.address, 0),
+                        args.part or EEPROM_PART)
+    except (ImportError, OSError, ValueError) as e:
+        print(f"eeprom: {e}", file=sys.stderr)
+        return 2 if isinstance(e, ValueError) else 1
+    try:
+        with eeprom:
+            if args.action == "info":
+                hat = parse_hat(eeprom.read())
+                result = {"part": eeprom.part_name, "size": eeprom.part.size,
+                          "page": eeprom.part.page, "hat": hat, **eeprom.stats}
+                text = (f"{eeprom.part_name.upper()} at 0x{eeprom.address:02X}: "
+                        f"{eeprom.part.size} bytes, {eeprom.part.page}-byte pages\n"
+                        + (f"HAT v{hat['version']}: {hat.get('vendor', '?')} "
+                           f"{hat.get('product', '?')} uuid {hat.get('uuid', '?')}"
+                           if hat else "No HAT header"))
+            elif args.action == "read":
+                data = eeprom.read(args.offset, args.length)
+                result = dict(eeprom.stats, out=args.out)
+                text = (f"Read {len(data)} bytes in {eeprom.stats['read_s'] * 1000:.1f} ms "
+                        f"({eeprom.stats['read_bytes_per_s'] / 1024:.1f} KB/s, "
+                        f"{eeprom.stats['read_transactions']} transactions)")
+                if not args.out:
+                    # Raw bytes on stdout, the summary on stderr
+                    sys.stdout.buffer.write(data)
+                    print(text, file=sys.stderr)
+                    return 0
+                with open(args.out, "wb") as f:
+                    f.write(data)
+            elif args.action == "write":
+                if not args.file:
+                    print("eeprom write: image file required", file=sys.stderr)
+                    return 2
+                with open(args.file, "rb") as f:
+                    image = f.read()
+                result = eeprom.write(args.offset, image, verify=not args.no_verify,
+                                      skip_unchanged=not args.force)
+                text = (f"Wrote {result['bytes']} bytes in {result['total_s']:.3f} s "
+                        f"({result['bytes_per_s'] / 1024:.1f} KB/s): "
+                        f"{result['pages_written']} pages written, "
+                        f"{result['pages_skipped']} unchanged, write cycle "
+                        f"{result['write_cycle_ms_mean']:.2f} ms mean / "
+                        f"{result['write_cycle_ms_max']:.2f} ms max"
+                        + (", verified" if result["verified"] else ""))
+            else:
+                protected = eeprom.probe_write_protect()
+                result = {"write_protected": protected}
+                text = "Write protected (WP active)" if protected else "Writable"
+    except WriteProtectedError as e:
+        _emit(args, {"ok": False, "write_protected": True, "error": str(e)}, f"eeprom: {e}")
+        return 1
+    except (EEPROMError, OSError, ValueError) as e:
+        print(f"eeprom: {e}", file=sys.stderr)
+        return 1
+    _emit(args, result, text)
+    return 0
+
+
+def cmd_imu(args, hw) -> int:
+    """Stream an MPU6050/MPU6500 through its FIFO and report the rate it sustains."""
+    from acquisition.bus import SampleBus
+    from acquisition.imu import IMUStream
+    from config.pins import I2C_BUS
+    from hardware.imu import MPU6050
+    address = int(args.address, 0)
+    ready = None
+    try:
+        if args.virtual:
+            from mock.virtual_mpu6050 import VirtualMPU6050
+            device = VirtualMPU6050(hw.i2c, address)
+            imu = MPU6050(None, address, device=device)
+            ready = device.ready_line() if args.int_pin is not None else None
+        elif args.mock:
+            print("imu: needs real hardware or --virtual", file=sys.stderr)
+            return 2
+        else:
+            imu = MPU6050(args.bus if args.bus is not None else I2C_BUS, address)
+        bus = SampleBus()
+        sub = bus.subscribe(maxlen=4096, events=False)
+        stream = IMUStream(bus, imu, rate_hz=args.rate, temperature=args.temperature,
+                           ready=ready, int_pin=None if args.virtual else args.int_pin,
+                           batch_ms=args.batch_ms)
+        settings = stream.start()
+    except (ImportError, OSError, ValueError) as e:
+        print(f"imu: {e}", file=sys.stderr)
+        return 2 if isinstance(e, ValueError) else 1
+    samples = 0
+    start = time.monotonic()
+    try:
+        while time.monotonic() - start < args.duration:
+            sub.wait(0.2)
+            samples += sum(len(block.values) for block in sub.drain())
+    except KeyboardInterrupt:
+        pass
+    stream.stop()
+    imu.close()
+    samples += sum(len(block.values) for block in sub.drain())
+    result = stream.get_stats()
+    result["published_samples"] = samples
+    if args.virtual:
+        result["bus_busy"] = hw.i2c.busy_s / (time.monotonic() - start)
+    ok = result["overflows"] == 0 and result["achieved_hz"] >= 0.95 * result["rate_hz"]
+    _emit(args, result,
+          f"{settings['model']} at 0x{address:02X}: {result['achieved_hz']:.1f} Hz of "
+          f"{result['rate_hz']:g} (DLPF {settings['dlpf_hz']} Hz), {result['packets']} packets "
+          f"in {result['drains']} drains, {result['mean_read_ms']:.2f} ms / "
+          f"{result['max_read_ms']:.2f} ms max per drain, "
+          f"{result['bytes_per_s'] / 1000:.1f} kB/s, FIFO peak {result['max_fill'] * 100:.0f} %, "
+          f"{result['overflows']} overflows, clock {result['clock_ppm']:+.0f} ppm"
+          + (f", bus {result['bus_busy'] * 100:.0f} % busy" if args.virtual else ""))
+    return 0 if ok else 1
+
+
+def cmd_pressure(args, hw) -> int:
+    """Poll BMP280/BME280 sensors together and report readings and poll cost."""
+    from acquisition.bus import SampleBus
+    from acquisition.pressure import PressurePoller
+    from config.pins import I2C_BUS
+    if args.mock or args.virtual:
+        print("pressure: needs real hardware", file=sys.stderr)
+        return 2
+    specs = []
+    for text in args.sensor or [f"{1 if I2C_BUS is None else I2C_BUS}:0x76"]:
+        bus, _, address = text.partition(":")
+        try:
+            specs.append({"bus": int(bus), "address": int(address or "0x76", 0),
+                          "name": f"p{bus}_{int(address or '0x76', 0):02x}"})
+        except ValueError:
+            print(f"pressure: bad sensor {text!r} (BUS:ADDRESS)", file=sys.stderr)
+            return 2
+    try:
+        poller = PressurePoller.from_specs(specs, SampleBus(), rate_hz=args.rate,
+                                           mode=args.mode, iir=args.iir)
+        if not poller.sensors:
+            return 1
+        poller.start()
+    except (ImportError, OSError, ValueError) as e:
+        print(f"pressure: {e}", file=sys.stderr)
+        return 2 if isinstance(e, ValueError) else 1
+    period = 1.0 / args.rate
+    next_poll = time.monotonic() + period
+    try:
+        for _ in range(args.count):
+            time.sleep(max(0.0, next_poll - time.monotonic()))
+            next_poll += period
+            poller.poll()
+    except KeyboardInterrupt:
+        pass
+    poller.stop()
+    for _, sensor in poller.sensors:
+        sensor.close()
+    result = poller.get_stats()
+    result["latest"] = poller.latest
+    lines = []
+    for sensor in result["sensors"]:
+        name = sensor["name"]
+        reading = f"{poller.latest.get(name + '_p', float('nan')):.2f} hPa, " \
+                  f"{poller.latest.get(name + '_t', float('nan')):.2f} °C"
+        if name + "_rh" in poller.latest:
+            reading += f", {poller.latest[name + '_rh']:.1f} %RH"
+        lines.append(f"{name} {sensor['model']}: {reading} (p×{sensor['osrs_p']} "
+                     f"t×{sensor['osrs_t']}, {sensor['measurement_ms']:.1f} ms)")
+    lines.append(f"{result['polls']} polls of {len(poller.sensors)} sensors in {args.mode} mode, "
+                 f"{result['mean_poll_ms']:.2f} ms / {result['max_poll_ms']:.2f} ms max per poll, "
+                 f"{result['read_errors']} read errors")
+    _emit(args, result, "\n".join(lines))
+    return 0 if result["read_errors"] == 0 else 1
+
+
+def cmd_temperature(args, hw) -> int:
+    """Poll an MCP9808, or wait on its ALERT window, and report samples and alerts."""
+    from acquisition.bus import Event, SampleBus
+    from acquisition.temperature import TemperatureMonitor
+    from config.pins import I2C_BUS
+    from hardware.mcp9808 import MCP9808
+    address = int(args.address, 0)
+    window = None
+    if args.alert_pin is not None:
+        if args.lower is None or args.upper is None:
+            print("temperature: --alert-pin needs --lower and --upper", file=sys.stderr)
+            return 2
+        window = {"pin": args.alert_pin, "lower": args.lower, "upper": args.upper,
+                  "critical": args.critical}
+    lines = {}
+    try:
+        if args.virtual:
+            from mock.virtual_mcp9808 import VirtualMCP9808
+            device = VirtualMCP9808(hw.i2c, address)
+            sensor = MCP9808(None, address, device=device)
+            if window is not None:
+                lines[args.alert_pin] = device.alert_line()
+        elif args.mock:
+            print("temperature: needs real hardware or --virtual", file=sys.stderr)
+            return 2
+        else:
+            sensor = MCP9808(args.bus if args.bus is not None else I2C_BUS, address)
+        bus = SampleBus()
+        sub = bus.subscribe(maxlen=4096)
+        monitor = TemperatureMonitor(bus, [("temp", sensor, window)], rate_hz=args.rate,
+                                     hysteresis=args.hysteresis, lines=lines)
+        monitor.start()
+    except (ImportError, OSError, ValueError) as e:
+        print(f"temperature: {e}", file=sys.stderr)
+        return 2 if isinstance(e, ValueError) else 1
+    transfers = hw.i2c.transfers if args.virtual else None
+    samples, alerts = 0, []
+    start = time.monotonic()
+    next_poll = start
+    try:
+        while time.monotonic() - start < args.duration:
+            if window is None:
+                time.sleep(max(0.0, next_poll - time.monotonic()))
+                next_poll += 1.0 / args.rate
+                monitor.poll()
+            else:
+                sub.wait(0.2)
+            for item in sub.drain():
+                if isinstance(item, Event):
+                    alerts.append(item)
+                    if not args.json:
+                        print(f"{item.timestamp - start:8.3f} s  alert {item.value:+d}  "
+                              f"{monitor.latest.get('temp', float('nan')):.3f} °C")
+                else:
+                    samples += len(item.values)
+    except KeyboardInterrupt:
+        pass
+    monitor.stop()
+    elapsed = time.monotonic() - start
+    samples += sum(len(item.values) for item in sub.drain() if not isinstance(item, Event))
+    sensor.close()
+    result = monitor.get_stats()
+    result.update(samples=samples,
+                  alert_events=[(e.timestamp - start, e.value) for e in alerts],
+                  latest=monitor.latest.get("temp"))
+    if args.virtual:
+        result["bus_transfers_per_s"] = (hw.i2c.transfers - transfers) / elapsed
+    _emit(args, result,
+          f"MCP9808 at 0x{address:02X}, {'ALERT window' if window else 'polled'}: "
+          f"{samples} samples, {len(alerts)} alerts in {elapsed:.1f} s, latest "
+          f"{result['latest'] if result['latest'] is not None else float('nan'):.3f} °C, "
+          f"{result['read_errors']} read errors"
+          + (f", {result['bus_transfers_per_s']:.1f} bus transfers/s" if args.virtual else ""))
+    return 0 if result["read_errors"] == 0 else 1
+
+
+def cmd_rtc(args, hw) -> int:
+    """Read or set a DS3231, or discipline against its 1 Hz SQW and report offset and drift."""
+    from config.acquisition_config import RTC_ADDRESS, RTC_BUS, RTC_SQW_PIN
+    from hardware.ds3231 import DS3231
+    address = int(args.address, 0) if args.address else RTC_ADDRESS
+    sqw = None
+    try:
+        if args.virtual:
+            from mock.virtual_ds3231 import VirtualDS3231
+            device = VirtualDS3231(hw.i2c, address, ppm=args.ppm)
+            rtc = DS3231(None, address, device=device)
+            sqw = device.sqw_line()
+        elif args.mock:
+            print("rtc: needs real hardware or --virtual", file=sys.stderr)
+            return 2
+        else:
+            rtc = DS3231(args.bus if args.bus is not None else RTC_BUS, address)
+    except (ImportError, OSError) as e:
+        print(f"rtc: {e}", file=sys.stderr)
+        return 1
+    with rtc:
+        try:
+            if args.action == "set":
+                rtc.set_time()
+            if args.action in ("read", "set"):
+                now = rtc.read_time()
+                result = {"rtc_time": now.isoformat(), "offset_s": time.time() - now.timestamp(),
+                          "oscillator_stopped": rtc.oscillator_stopped,
+                          "temperature": rtc.temperature(), "aging": rtc.aging}
+                _emit(args, result,
+                      f"DS3231 at 0x{address:02X}: {now:%Y-%m-%d %H:%M:%S} UTC "
+                      f"(system clock {result['offset_s']:+.1f} s), "
+                      f"{result['temperature']:.2f} °C, aging {result['aging']:+d}"
+                      + ("\nOscillator stopped: time not valid until set" if
+                         result["oscillator_stopped"] else ""))
+                return 0
+            return _rtc_discipline(args, rtc, sqw)
+        except OSError as e:
+            print(f"rtc: {e}", file=sys.stderr)
+            return 1
+
+
+def _rtc_discipline(args, rtc, sqw) -> int:
+    from acquisition.clock import RTCDiscipline
+    pin = args.sqw_pin
+    if pin is None and sqw is None:
+        from config.acquisition_config import RTC_SQW_PIN
+        pin = RTC_SQW_PIN
+        if pin is None:
+            print("rtc: discipline needs --sqw-pin (or RTC_SQW_PIN)", file=sys.stderr)
+            return 2
+    discipline = RTCDiscipline(rtc, sqw=sqw, sqw_pin=pin)
+    try:
+        discipline.start()
+    except (ImportError, OSError) as e:
+        print(f"rtc: {e}", file=sys.stderr)
+        return 1
+    start = time.monotonic()
+    try:
+        while time.monotonic() - start < args.duration:
+            time.sleep(min(10.0, args.duration))
+            stats = discipline.get_stats()
+            if not args.json and stats["locked"]:
+                print(f"{time.monotonic() - start:7.0f} s  drift {stats['drift_ppm']:+8.2f} ppm  "
+                      f"system clock {stats['offset_s']:+.4f} s  "
+                      f"residual {stats['residual_us']:.0f} us", file=sys.stderr)
+    except KeyboardInterrupt:
+        pass
+    discipline.stop()
+    result = discipline.get_stats()
+    result["duration_s"] = time.monotonic() - start
+    if not result["locked"]:
+        _emit(args, result, f"Not locked after {result['edges']} SQW edges "
+              f"({result['timeouts']} timeouts): check the INT/SQW wiring and pull-up")
+        return 1
+    _emit(args, result,
+          f"{result['edges']} SQW edges ({result['missed']} missed): host clock "
+          f"{result['drift_ppm']:+.2f} ppm vs the RTC, system clock {result['offset_s']:+.4f} s "
+          f"from RTC time, {result['residual_us']:.0f} us edge residual")
+    return 0
+
+
+def cmd_spi(args, hw) -> int:
+    """SPI loopback test (jumper MOSI to MISO)."""
+    if args.pattern:
+        pattern = bytes.fromhex(args.pattern)
+    else:
+        pattern = bytes(i & 0xFF for i in range(args.size))
+    try:
+        result = hw.spi.loopback(pattern, args.speed, args.repeat)
+    except Exception as e:
+        print(f"spi: {e}", file=sys.stderr)
+        return 1
+    if result["status"] == "NOT_AVAILABLE":
+        _emit(args, result, f"NOT_AVAILABLE: {result['error']}")
+        return 1
+    _emit(args, result, f"{result['status']}: {result['bytes']} bytes, {result['errors']} errors, "
+                        f"{result['throughput_Bps'] / 1000:.1f} kB/s at {args.speed} Hz"
+                        + (" (mock loopback)" if result.get("mock") else ""))
+    return 0 if result["status"] == "OK" else 1
+
+
+def cmd_bench(args, hw) -> int:
+    """Measure raw ADC read latency or sustained engine throughput."""
+    channels = _parse_channels(args.channels)
+    if args.target == "adc":
+        latencies = []
+        for i in range(args.count):
+            ch = channels[i % len(channels)]
+            t0 = time.perf_counter()
+            hw.adc.read_channel(ch)
+            latencies.append((time.perf_counter() - t0) * 1000.0)
+        latencies.sort()
+        n = len(latencies)
+        result = {"target": "adc", "reads": n,
+                  "mean_ms": sum(latencies) / n,
+                  "p50_ms": latencies[n // 2],
+                  "p99_ms": latencies[min(n - 1, int(n * 0.99))],
+                  "max_ms": latencies[-1],
+                  "reads_per_s": n / (sum(latencies) / 1000.0) if sum(latencies) else 0.0}
+        _emit(args, result, f"ADC: {n} reads, mean {result['mean_ms']:.3f} ms, "
+                            f"p99 {result['p99_ms']:.3f} ms, max {result['max_ms']:.3f} ms "
+                            f"({result['reads_per_s']:.0f} reads/s)")
+        return 0
+    
+    from acquisition.bus import SampleBus
+    from acquisition.engine import AcquisitionEngine
+    bus = SampleBus()
+    sub = bus.subscribe(maxlen=4096, events=False)
+    engine = AcquisitionEngine(_engine_view(hw, False), bus, rate_hz=args.rate,
+                               channels=channels, realtime=args.rt)
+    engine.start()
+    _rt_report(args, ["acquisition"])
+    start = time.monotonic()
+    samples = 0
+    while time.monotonic() - start < args.duration:
+        sub.wait(0.2)
+        samples += sum(len(block.values) for block in sub.drain())
+    engine.stop()
+    samples += sum(len(block.values) for block in sub.drain())
+    elapsed = time.monotonic() - start
+    stats = engine.get_stats()
+    achieved = samples / elapsed / max(1, len(channels))
+    result = {"target": "engine", "requested_hz": args.rate, "achieved_hz": achieved,
+              "samples": samples, "overruns": stats["overruns"],
+              "max_late_ms": stats["max_late_ms"], "read_errors": stats["read_errors"]}
+    _emit(args, result, f"Engine: {achieved:.1f} Hz/channel of {args.rate:g} requested, "
+                        f"{stats['overruns']} overruns, max late {stats['max_late_ms']:.2f} ms")
+    return 0
+
+
+def cmd_control(args, hw) -> int:
+    """Run one PID loop from an ADC channel to a J11 output and report its timing."""
+    from acquisition.bus import SampleBus
+    from acquisition.control import PID, ControlError, ControlLoop, latest_reader, make_output
+    from acquisition.engine import AcquisitionEngine
+    from config.acquisition_config import CONTROL_INPUT_MAX_AGE
+    
+    channel = _parse_channels(args.input)[0]
+    try:
+        pid = PID(args.kp, args.ki, args.kd, args.setpoint, args.out_min, args.out_max,
+                  args.ff_gain, args.ff_offset, reverse=args.reverse)
+        writer, device = make_output(args.output, args.pwm_hz, args.out_min, args.out_max)
+    except ControlError as e:
+        print(f"control: {e}", file=sys.stderr)
+        return 2
+    
+    bus = SampleBus()
+    # Sample at least twice as fast as the loop runs
+    engine = AcquisitionEngine(_engine_view(hw, False), bus,
+                               rate_hz=args.sample_rate or 2 * args.rate, channels=[channel],
+                               realtime=args.rt)
+    loop = ControlLoop("cli", pid, latest_reader(engine.latest, engine.latest_t, channel),
+                       writer, args.rate, trace_len=max(1, int(args.rate * args.duration) + 1),
+                       spin_us=args.spin_us, realtime=args.rt,
+                       max_age_s=CONTROL_INPUT_MAX_AGE / engine.rate_hz)
+    engine.start()
+    loop.start()
+    _rt_report(args, ["acquisition", "control:cli"])
+    try:
+        time.sleep(args.duration)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        loop.stop()
+        engine.stop()
+        device.close()
+    
+    if args.trace:
+        trace = loop.get_trace()
+        with open(args.trace, "w") as f:
+            f.write(",".join(trace) + "\n")
+            for row in zip(*trace.values()):
+                f.write(",".join(f"{v:.6f}" for v in row) + "\n")
+    stats = loop.get_stats()
+    _emit(args, stats, f"{stats['ticks']} ticks at {args.rate:g} Hz: jitter σ "
+                       f"{stats['jitter_ms_std']:.3f} ms (max {stats['jitter_ms_max']:.3f}), "
+                       f"wake p99 {stats['wake_ms_p99'] or 0:.3f} ms, {stats['overruns']} overruns, "
+                       f"last output {stats['output']:.3f}")
+    return 0 if not stats["overruns"] else 1
+
+
+def _rt_report(args, threads) -> bool:
+    """With --rt, wait for the RT threads to configure themselves and report to stderr."""
+    if not args.rt:
+        return True
+    from acquisition import realtime
+    realtime.wait_for(threads)
+    ok, text = realtime.format_report()
+    print(text, file=sys.stderr)
+    return ok
+
+
+def cmd_rtcheck(args, hw) -> int:
+    """Apply the RT settings to a short engine run and report whether they took effect."""
+    from acquisition import realtime
+    from acquisition.bus import SampleBus
+    from acquisition.engine import AcquisitionEngine
+    
+    if not args.rt:
+        realtime.setup_process()
+    engine = AcquisitionEngine(_engine_view(hw, False), SampleBus(), rate_hz=args.rate,
+                               channels=_parse_channels(args.channels), realtime=True)
+    engine.start()
+    realtime.wait_for(["acquisition"])
+    time.sleep(args.duration)
+    engine.stop()
+    
+    result = realtime.report()
+    ok, text = realtime.format_report(result)
+    stats = engine.get_stats()
+    result.update({"ok": ok, "overruns": stats["overruns"], "max_late_ms": stats["max_late_ms"]})
+    _emit(args, result, f"{text}\nEngine: {stats['overruns']} overruns, "
+                        f"max late {stats['max_late_ms']:.2f} ms over {args.duration:g}s")
+    return 0 if ok else 1
+
+
+def cmd_replay(args, hw) -> int:
+    """Play a capture file onto a bus; report throughput or serve it over WebSocket."""
+    from acquisition.bus import SampleBus
+    from acquisition.replay import CaptureReplayer
+    
+    bus = SampleBus()
+    sub = bus.subscribe(maxlen=65536)
+    try:
+        replayer = CaptureReplayer(args.file, bus, speed=args.speed,
+                                   rebase=not args.preserve_timestamps, loop=args.loop)
+    except (OSError, ValueError) as e:
+        print(f"replay: {e}", file=sys.stderr)
+        return 1
+    server = None
+    if args.serve:
+        from api.websocket_server import StreamServer
+        server = StreamServer(bus, engine=replayer)
+        server.start()
+    
+    replayer.start()
+    start = time.monotonic()
+    received = 0
+    try:
+        while replayer.running:
+            if args.duration > 0 and time.monotonic() - start >= args.duration:
+                break
+            sub.wait(0.1)
+            received += sum(len(item.values) for item in sub.drain()
+                            if not hasattr(item, "kind"))
+    except KeyboardInterrupt:
+        pass
+    replayer.stop()
+    received += sum(len(item.values) for item in sub.drain() if not hasattr(item, "kind"))
+    if server:
+        server.stop()
+    
+    result = replayer.get_stats()
+    result.update({"received": received, "bus_dropped": sub.dropped})
+    _emit(args, result, f"Replayed {result['samples']} samples in {result['elapsed_s']:.2f}s "
+                        f"({result['samples_per_s']:.0f} samples/s, {result['passes']} passes, "
+                        f"max lag {result['max_lag_ms']:.1f} ms, {sub.dropped} dropped)")
+    return 0
+
+
+def build_parser() -> argparse.ArgumentParser:
+    parser = argparse.ArgumentParser(prog="device_cli", description="Headless device panel CLI")
+    parser.add_argument("--mock", action="store_true", help="Use simulated hardware")
+    parser.add_argument("--json", action="store_true", help="Machine-readable output")
+    parser.add_argument("--synthetic", action="store_true",
+                        help="Synthetic block-rate signals (implies --mock, needs NumPy)")
+    parser.add_argument("--seed", type=int, default=0, help="Seed for --synthetic")
+    parser.add_argument("--edge-rate", type=float, default=1.0,
+                        help="Button edges per second with --synthetic")
+    parser.add_argument("--virtual", action="store_true",
+                        help="Virtual ADS1115 (ADS1015 with ADC_MODEL) with modelled I2C and "
+                             "conversion timing (implies --mock)")
+    parser.add_argument("--rt", action="store_true",
+                        help="Real-time threads (SCHED_FIFO, affinity, mlockall; see RT_* config)")
+    # --json also after the subcommand (scan --json); SUPPRESS keeps a global --json
+    common = argparse.ArgumentParser(add_help=False)
+    common.add_argument("--json", action="store_true", default=argparse.SUPPRESS,
+                        help="Machine-readable output")
+    sub = parser.add_subparsers(dest="command", required=True)
+    
+    p = sub.add_parser("scan", help="Scan I2C bus for devices", parents=[common])
+    p.add_argument("--bus", type=int, default=None, help="I2C bus (default: auto-detect)")
+    p.add_argument("--all", action="store_true", help="Scan every /dev/i2c-* bus")
+    p.add_argument("--health", action="store_true",
+                   help="Report transaction/fault/recovery counters of the scanned bus(es)")
+    p.add_argument("--recover", action="store_true",
+                   help="Recover the bus first (9 SCL pulses, STOP, adapter rebind; needs root)")
+    p.set_defaults(func=cmd_scan)
+    
+    p = sub.add_parser("read", help="Read ADC channels", parents=[common])
+    p.add_argument("--channels", default="0,1,2,3")
+    p.add_argument("--count", type=int, default=1)
+    p.add_argument("--interval", type=float, default=1.0, help="Seconds between readings")
+    p.set_defaults(func=cmd_read)
+    
+    p = sub.add_parser("stream", help="Record acquisition to a file", parents=[common])
+    p.add_argument("--out", required=True)
+    p.add_argument("--format", choices=["capture", "csv", "jsonl"], default=None,
+                   help="Default: from file extension, else capture")
+    p.add_argument("--duration", type=float, default=10.0, help="Seconds (0 = until Ctrl+C)")
+    p.add_argument("--rate", type=float, default=None, help="Sample rate per channel (Hz)")
+    p.add_argument("--channels", default="0,1,2,3")
+    p.add_argument("--events", action="store_true", help="Also record button/I2C events")
+    p.add_argument("--boards", default="",
+                   help="Extra boards as board 1, 2, ... e.g. '20,21:0x49' or 'mock,mock'")
+    p.add_argument("--derived", action="append", default=[], metavar="NAME=EXPR",
+                   help="Also record a derived channel, e.g. 'diff=(adc0-adc1)*2.5' (repeatable)")
+    p.add_argument("--timed", action="store_true",
+                   help="Stamp samples at conversion time with drift correction (one channel = "
+                        "continuous mode)")
+    p.add_argument("--data-rate", type=int, default=None,
+                   help="ADC data rate with --timed (SPS; default: the chip's fastest, 860 on "
+                        "an ADS1115, 3300 on an ADS1015)")
+    p.add_argument("--rdy-pin", type=int, default=None,
+                   help="BCM pin wired to ALERT/RDY (kernel edge timestamps) with --timed")
+    p.set_defaults(func=cmd_stream)
+    
+    p = sub.add_parser("oled", help="Push text or an image to the OLED", parents=[common])
+    p.add_argument("kind", choices=["text", "image"])
+    p.add_argument("value", help="Text to show or image path")
+    p.add_argument("--address", default="0x3C")
+    p.add_argument("--controller", default=None, choices=["ssd1306", "ssd1309", "sh1106"],
+                   help="Display controller (default: OLED_CONTROLLER)")
+    p.add_argument("--bus", type=int, default=None, help="I2C bus (default: I2C_BUS)")
+    p.set_defaults(func=cmd_oled)
+    
+    p = sub.add_parser("eeprom", help="Read, flash or inspect a 24Cxx EEPROM", parents=[common])
+    p.add_argument("action", choices=["info", "read", "write", "wpcheck"])
+    p.add_argument("file", nargs="?", help="Image to write (write)")
+    p.add_argument("--bus", type=int, default=None, help="I2C bus (default: I2C_BUS)")
+    p.add_argument("--address", default="0x50")
+    p.add_argument("--part", default=None, help="24c01 ... 24c512 (default: EEPROM_PART)")
+    p.add_argument("--offset", type=int, default=0)
+    p.add_argument("--length", type=int, default=None, help="Bytes to read (default: to the end)")
+    p.add_argument("--out", help="Write the data read to this file (default: stdout)")
+    p.add_argument("--no-verify", action="store_true", help="Skip the read-back (write)")
+    p.add_argument("--force", action="store_true", help="Rewrite pages that already match (write)")
+    p.set_defaults(func=cmd_eeprom)
+    
+    p = sub.add_parser("imu", help="Stream an MPU6050/MPU6500 through its FIFO", parents=[common])
+    p.add_argument("--bus", type=int, default=None, help="I2C bus (default: I2C_BUS)")
+    p.add_argument("--address", default="0x68")
+    p.add_argument("--rate", type=float, default=1000.0, help="Output data rate (Hz, max 1000)")
+    p.add_argument("--duration", type=float, default=5.0)
+    p.add_argument("--int-pin", type=int, default=None,
+                   help="BCM pin wired to INT (drain on data-ready edges)")
+    p.add_argument("--batch-ms", type=float, default=10.0, help="FIFO drain interval")
+    p.add_argument("--temperature", action="store_true", help="Also stream the temperature")
+    p.set_defaults(func=cmd_imu)
+    
+    p = sub.add_parser("pressure", help="Poll BMP280/BME280 pressure sensors", parents=[common])
+    p.add_argument("--sensor", action="append",
+                   help="BUS:ADDRESS, repeatable (default: I2C_BUS:0x76)")
+    p.add_argument("--rate", type=float, default=1.0, help="Poll rate (Hz)")
+    p.add_argument("--mode", choices=("forced", "normal"), default="forced")
+    p.add_argument("--iir", type=int, default=0, help="IIR filter coefficient (0, 2 ... 16)")
+    p.add_argument("--count", type=int, default=5, help="Number of polls")
+    p.set_defaults(func=cmd_pressure)
+    
+    p = sub.add_parser("temperature", help="Poll an MCP9808 or watch its ALERT window",
+                       parents=[common])
+    p.add_argument("--bus", type=int, default=None, help="I2C bus (default: I2C_BUS)")
+    p.add_argument("--address", default="0x18")
+    p.add_argument("--rate", type=float, default=4.0, help="Poll rate (Hz) without --alert-pin")
+    p.add_argument("--duration", type=float, default=10.0)
+    p.add_argument("--alert-pin", type=int, default=None,
+                   help="BCM pin wired to ALERT (event mode: no polling)")
+    p.add_argument("--lower", type=float, default=None, help="Window lower limit (degC)")
+    p.add_argument("--upper", type=float, default=None, help="Window upper limit (degC)")
+    p.add_argument("--critical", type=float, default=None, help="Critical limit (default: 125)")
+    p.add_argument("--hysteresis", type=float, default=1.5, help="0, 1.5, 3 or 6 degC")
+    p.set_defaults(func=cmd_temperature)
+    
+    p = sub.add_parser("rtc", help="Read/set a DS3231 or discipline against its 1 Hz SQW",
+                       parents=[common])
+    p.add_argument("action", choices=["read", "set", "discipline"])
+    p.add_argument("--bus", type=int, default=None, help="I2C bus (default: RTC_BUS)")
+    p.add_argument("--address", default=None, help="Default: RTC_ADDRESS (0x68)")
+    p.add_argument("--sqw-pin", type=int, default=None,
+                   help="BCM pin wired to INT/SQW (default: RTC_SQW_PIN)")
+    p.add_argument("--duration", type=float, default=60.0, help="Seconds (discipline)")
+    p.add_argument("--ppm", type=float, default=20.0,
+                   help="Oscillator error of the --virtual RTC vs the host")
+    p.set_defaults(func=cmd_rtc)
+    
+    p = sub.add_parser("spi", help="SPI loopback test (MOSI jumpered to MISO)", parents=[common])
+    p.add_argument("--pattern", help="Hex bytes to send, e.g. A55A00FF")
+    p.add_argument("--size", type=int, default=256, help="Ramp pattern length if no --pattern")
+    p.add_argument("--speed", type=int, default=1000000, help="Clock in Hz")
+    p.add_argument("--repeat", type=int, default=10)
+    p.set_defaults(func=cmd_spi)
+    
+    p = sub.add_parser("bench", help="Benchmark ADC reads or the acquisition engine",
+                       parents=[common])
+    p.add_argument("target", choices=["adc", "engine"])
+    p.add_argument("--channels", default="0,1,2,3")
+    p.add_argument("--count", type=int, default=200, help="ADC reads (adc)")
+    p.add_argument("--duration", type=float, default=5.0, help="Seconds (engine)")
+    p.add_argument("--rate", type=float, default=None, help="Requested rate in Hz (engine)")
+    p.set_defaults(func=cmd_bench)
+    
+    p = sub.add_parser("control", help="Run a PID loop from an ADC channel to a J11 output",
+                       parents=[common])
+    p.add_argument("--input", default="0", help="ADC channel")
+    p.add_argument("--output", required=True, help="pwm:<bcm> or gpio:<bcm> (BCM5/6/12/13)")
+    p.add_argument("--setpoint", type=float, required=True)
+    p.add_argument("--kp", type=float, default=1.0)
+    p.add_argument("--ki", type=float, default=0.0)
+    p.add_argument("--kd", type=float, default=0.0)
+    p.add_argument("--ff-gain", type=float, default=0.0)
+    p.add_argument("--ff-offset", type=float, default=0.0)
+    p.add_argument("--out-min", type=float, default=0.0)
+    p.add_argument("--out-max", type=float, default=1.0)
+    p.add_argument("--reverse", action="store_true", help="Cooling loop (output up when above setpoint)")
+    p.add_argument("--rate", type=float, default=50.0, help="Loop rate (Hz)")
+    p.add_argument("--sample-rate", type=float, default=None, help="ADC sample rate (Hz)")
+    p.add_argument("--pwm-hz", type=float, default=1000.0)
+    p.add_argument("--spin-us", type=float, default=0.0, help="Busy-wait before each deadline")
+    p.add_argument("--duration", type=float, default=10.0)
+    p.add_argument("--trace", help="Write the loop trace to this CSV file")
+    p.set_defaults(func=cmd_control)
+    
+    p = sub.add_parser("replay", help="Replay a capture file through the sample bus",
+                       parents=[common])
+    p.add_argument("file")
+    p.add_argument("--speed", type=float, default=1.0, help="1 = real time, 0 = as fast as possible")
+    p.add_argument("--preserve-timestamps", action="store_true",
+                   help="Keep recorded timestamps instead of rebasing to now")
+    p.add_argument("--loop", action="store_true")
+    p.add_argument("--duration", type=float, default=0.0, help="Stop after seconds (0 = at end)")
+    p.add_argument("--serve", action="store_true", help="Also run the WebSocket stream server")
+    p.set_defaults(func=cmd_replay)
+    
+    p = sub.add_parser("rtcheck", help="Check that real-time thread settings take effect",
+                       parents=[common])
+    p.add_argument("--channels", default="0,1,2,3")
+    p.add_argument("--rate", type=float, default=None, help="Sample rate per channel (Hz)")
+    p.add_argument("--duration", type=float, default=2.0, help="Seconds of sampling")
+    p.set_defaults(func=cmd_rtcheck)
+    return parser
+
+
+def main(argv=None) -> int:
+    args = build_parser().parse_args(argv)
+    if getattr(args, "rate", "unset") is None:
+        from config.acquisition_config import ADC_SAMPLE_RATE_HZ
+        args.rate = ADC_SAMPLE_RATE_HZ
+    if args.synthetic:
+        from config.acquisition_config import ADC_SAMPLE_RATE_HZ
+        from mock.signal_generator import SyntheticHardware
+        args.mock = True
+        rate = getattr(args, "rate", None) or ADC_SAMPLE_RATE_HZ
+        hw = SyntheticHardware(rate, edge_rates={1: args.edge_rate, 2: args.edge_rate / 2},
+                               seed=args.seed)
+    elif args.virtual:
+        from config.pins import ADC_MODEL
+        from mock.virtual_ads1x15 import VirtualHardware
+        args.mock = True
+        hw = _Hardware(mock=True)
+        virtual = VirtualHardware(resolution=12 if ADC_MODEL == "ADS1015" else 16)
+        hw.adc, hw.i2c = virtual.adc, virtual.i2c
+    else:
+        hw = _Hardware(mock=args.mock, i2c_bus=getattr(args, "bus", None))
+    if args.rt:
+        from acquisition import realtime
+        realtime.setup_process()
+    return args.func(args, hw)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
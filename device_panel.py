@@ -15,6 +15,17 @@ from hardware.i2c_scanner import I2CScanner
 from hardware.spi_tester import SPITester
 from hardware.power_manager import PowerManager
 from config.pins import I2C_BUS
+from config.acquisition_config import (ADC_CHANNELS, ADC_TIMED, ADC_TIMED_BUS, CONTROL_LOOPS,
+                                       DERIVED_CHANNELS, ENABLE_ACQUISITION, ENABLE_CONTROL,
+                                       ENABLE_DERIVED, ENABLE_IMU, ENABLE_PRESSURE, ENABLE_RULES,
+                                       ENABLE_SPECTRUM, ENABLE_STATS, ENABLE_TEMPERATURE,
+                                       EXTRA_BOARDS, IMU_STREAMS, MULTI_BOARD_MODE,
+                                       PRESSURE_SENSORS, REPLAY_FILE, REPLAY_LOOP, REPLAY_SPEED,
+                                       RT_ENABLE, RTC_SQW_PIN, RULES, TEMPERATURE_SENSORS)
+from config.api_config import ENABLE_STREAM_SERVER, ENABLE_MQTT
+from config.memory_config import LOW_MEMORY
+from acquisition.bus import SampleBus
+from acquisition.engine import AcquisitionEngine
 
 
 class Hardware:
@@ -26,11 +37,43 @@ class Hardware:
         self.i2c = I2CScanner(bus=I2C_BUS)
         self.spi = SPITester()
         self.power = PowerManager()
+        self.bus = SampleBus()
+        self.engine = None
+        self.replay = None
+        self.boards = None  # Extra boards on other I2C adapters (MultiBoardAcquisition)
+        self.stats = None
+        self.spectrum = None
+        self.derived = None
+        self.rules = None  # Threshold rules acting on LEDs/power (RuleEngine)
+        self.control = None  # PID loops driving the J11 GPIO bank (ControlSystem)
+        self.imus = []  # FIFO-streamed MPU6050/MPU6500s (IMUStream)
+        self.pressure = None  # BMP280/BME280 poller (PressurePoller)
+        self.temperature = None  # MCP9808s, polled or on ALERT (TemperatureMonitor)
+        self.rtc = None  # DS3231 SQW disciplining the wall-clock mapping (RTCDiscipline)
+    
+    def start_spectrum(self):
+        """Create and start the spectrum analyzer (loads NumPy) unless running.
+        
+        Returns:
+            The analyzer, or None when NumPy is missing
+        """
+        if self.spectrum is None:
+            try:
+                from acquisition.spectrum import SpectrumAnalyzer
+                self.spectrum = SpectrumAnalyzer(self.bus)
+                self.spectrum.start()
+            except ImportError as e:
+                print(f"Spectrum view disabled: {e}", file=sys.stderr)
+        return self.spectrum
 
 
 def main():
     """Main application entry point."""
     try:
+        # Kiosk mode (eglfs/linuxfb, no X11) selects its Qt platform before the app exists
+        from ui import kiosk
+        kiosk_platform = kiosk.configure_platform()
+        
         # Create Qt application
         app = QApplication(sys.argv)
         app.setApplicationName("Device Panel")
@@ -38,12 +81,190 @@ def main():
         # Create hardware managers
         hardware = Hardware()
         
-        # Create and show main window
+        # Real-time process settings (mlockall, prefault, GC) before any sampling starts
+        if RT_ENABLE:
+            from acquisition import realtime
+            realtime.setup_process()
+        
+        # Threshold rules; with live acquisition they run in the acquisition thread
+        if ENABLE_RULES and RULES:
+            from acquisition.rules import RuleEngine
+            try:
+                hardware.rules = RuleEngine(RULES, hardware.gpio, hardware.power, hardware.bus,
+                                            via_bus=bool(REPLAY_FILE))
+                hardware.rules.start()
+            except ValueError as e:
+                print(f"Rules disabled: {e}", file=sys.stderr)
+        
+        # Start background acquisition (feeds the sample bus), or replay a capture
+        timed = None
+        if REPLAY_FILE:
+            from acquisition.replay import CaptureReplayer, ReplayADC
+            hardware.replay = CaptureReplayer(REPLAY_FILE, hardware.bus, speed=REPLAY_SPEED,
+                                              loop=REPLAY_LOOP)
+            hardware.adc = ReplayADC(hardware.replay)
+            hardware.replay.start()
+        elif ENABLE_ACQUISITION:
+            if ADC_TIMED:
+                # Conversion-time stamps; the engine then collects blocks instead of reading
+                from acquisition.timing import TimedADC
+                from hardware.adc_manager import ADCManager
+                try:
+                    timed = TimedADC(ADCManager(bus=ADC_TIMED_BUS), ADC_CHANNELS)
+                    timed.start()
+                    hardware.adc = timed
+                except (ImportError, OSError, ValueError) as e:
+                    print(f"Timed ADC sampling disabled: {e}", file=sys.stderr)
+            hardware.engine = AcquisitionEngine(hardware, hardware.bus, rules=hardware.rules,
+                                                realtime=RT_ENABLE)
+            hardware.engine.start()
+            if EXTRA_BOARDS:
+                from acquisition.multiboard import MultiBoardAcquisition
+                hardware.boards = MultiBoardAcquisition(EXTRA_BOARDS, hardware.bus,
+                                                        mode=MULTI_BOARD_MODE)
+                hardware.boards.start()
+            
+            # IMUs stream through their FIFOs on their own threads
+            if ENABLE_IMU and IMU_STREAMS:
+                from acquisition.imu import IMUStream
+                for index, spec in enumerate(IMU_STREAMS):
+                    try:
+                        stream = IMUStream.from_spec(spec, hardware.bus, index)
+                        stream.start()
+                        hardware.imus.append(stream)
+                    except (ImportError, OSError, ValueError) as e:
+                        print(f"IMU {spec.get('address', 0x68):#04x} disabled: {e}",
+                              file=sys.stderr)
+            
+            # Pressure sensors are polled by an engine task
+            if ENABLE_PRESSURE and PRESSURE_SENSORS:
+                from acquisition.pressure import PressurePoller
+                try:
+                    hardware.pressure = PressurePoller.from_specs(PRESSURE_SENSORS, hardware.bus)
+                    hardware.pressure.start(hardware.engine)
+                except (ImportError, OSError, ValueError) as e:
+                    hardware.pressure = None
+                    print(f"Pressure sensors disabled: {e}", file=sys.stderr)
+            
+            # Temperature sensors: polled by an engine task or woken by their ALERT pin
+            if ENABLE_TEMPERATURE and TEMPERATURE_SENSORS:
+                from acquisition.temperature import TemperatureMonitor
+                try:
+                    hardware.temperature = TemperatureMonitor.from_specs(TEMPERATURE_SENSORS,
+                                                                         hardware.bus)
+                    hardware.temperature.start(hardware.engine)
+                except (ImportError, OSError, ValueError) as e:
+                    hardware.temperature = None
+                    print(f"Temperature sensors disabled: {e}", file=sys.stderr)
+            
+            # RTC: count the DS3231's 1 Hz edges for capture/MQTT wall-clock time
+            if RTC_SQW_PIN is not None:
+                from acquisition.clock import RTCDiscipline
+                try:
+                    hardware.rtc = RTCDiscipline.from_config(hardware.bus)
+                    hardware.rtc.start()
+                except (ImportError, OSError, ValueError) as e:
+                    hardware.rtc = None
+                    print(f"RTC clock discipline disabled: {e}", file=sys.stderr)
+        
+        # Derived channels (expressions over the ADC channels, published on the bus)
+        if ENABLE_DERIVED and DERIVED_CHANNELS:
+            try:
+                from acquisition.derived import DerivedChannels
+                hardware.derived = DerivedChannels(hardware.bus)
+                hardware.derived.start()
+            except (ImportError, ValueError) as e:
+                print(f"Derived channels disabled: {e}", file=sys.stderr)
+        
+        # Closed-loop control on the J11 GPIO bank
+        if ENABLE_CONTROL and CONTROL_LOOPS:
+            from acquisition.control import ControlSystem
+            try:
+                hardware.control = ControlSystem(CONTROL_LOOPS, hardware.bus, hardware.engine,
+                                                 hardware.derived, hardware.replay,
+                                                 realtime=RT_ENABLE)
+                hardware.control.start()
+            except ValueError as e:
+                print(f"Control loops disabled: {e}", file=sys.stderr)
+        
+        # Running per-channel statistics (UI and /stats)
+        if ENABLE_STATS:
+            from acquisition.stats import StatsTracker
+            hardware.stats = StatsTracker(hardware.bus)
+            hardware.stats.start()
+        
+        # Spectrum analyzer for the GUI's spectrum/waterfall view (needs NumPy);
+        # in low-memory mode the GUI starts it on request
+        if ENABLE_SPECTRUM and not LOW_MEMORY:
+            hardware.start_spectrum()
+        
+        # Startup check: report whether the RT settings actually took effect
+        if RT_ENABLE:
+            realtime.install_gc_task(hardware.engine)
+            threads = (["acquisition"] if hardware.engine else []) + \
+                      [f"control:{name}" for name in (hardware.control.loops if hardware.control else ())]
+            realtime.wait_for(threads)
+            ok, text = realtime.format_report()
+            print(text, file=sys.stdout if ok else sys.stderr)
+        
+        # Local streaming API (HTTP/WebSocket)
+        server = None
+        if ENABLE_STREAM_SERVER:
+            from api.websocket_server import StreamServer
+            server = StreamServer(hardware.bus, engine=hardware.engine or hardware.replay,
+                                  stats=hardware.stats, control=hardware.control)
+            server.start()
+        
+        # MQTT uplink to the plant historian (spools to disk while offline)
+        publisher = None
+        if ENABLE_MQTT:
+            from api.mqtt_publisher import MqttPublisher
+            publisher = MqttPublisher(hardware.bus)
+            publisher.start()
+        
+        # Create and show main window (fullscreen on kiosk platforms); the probe
+        # reports boot-to-first-frame and memory once it is on screen
         window = MainWindow(mock_hardware=hardware)
-        window.show()
+        kiosk.tune_window(window, kiosk_platform)
+        probe = kiosk.StartupProbe(window, kiosk_platform)
+        if kiosk_platform:
+            window.showFullScreen()
+        else:
+            window.show()
         
         # Run application
-        sys.exit(app.exec())
+        exit_code = app.exec()
+        if publisher:
+            publisher.stop()
+        if server:
+            server.stop()
+        if hardware.spectrum:
+            hardware.spectrum.stop()
+        if hardware.stats:
+            hardware.stats.stop()
+        if hardware.derived:
+            hardware.derived.stop()
+        if hardware.control:
+            hardware.control.stop()
+        if hardware.rules:
+            hardware.rules.stop()
+        if hardware.boards:
+            hardware.boards.stop()
+        for stream in hardware.imus:
+            stream.stop()
+        if hardware.pressure:
+            hardware.pressure.stop()
+        if hardware.temperature:
+            hardware.temperature.stop()
+        if hardware.rtc:
+            hardware.rtc.stop()
+        if hardware.engine:
+            hardware.engine.stop()
+        if timed:
+            timed.stop()
+        if hardware.replay:
+            hardware.replay.stop()
+        sys.exit(exit_code)
     except Exception as e:
         import traceback
         print(f"Error launching GUI: {e}", file=sys.stderr)
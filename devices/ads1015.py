@@ -0,0 +1,11 @@
+"""ADS1015 ADC plugin (12-bit, register compatible with the ADS1115)."""
+
+from .ads1115 import ADS1115Plugin
+
+
+class ADS1015Plugin(ADS1115Plugin):
+    """Plugin for ADS1015 ADC devices."""
+    
+    name = "ADS1015"
+    description = "12-bit ADC with 4 channels, up to 3300 SPS"
+    datasheet = "https://www.ti.com/product/ADS1015"
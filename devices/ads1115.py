@@ -1,24 +1,87 @@
 """ADS1115/ADS1015 ADC plugin."""
 
-from typing import Optional
+from typing import Dict, Optional, Tuple
 from PySide6.QtWidgets import QWidget, QVBoxLayout, QLabel, QPushButton
 from .base import DevicePlugin
 
+# (bus, address) -> model detected there; detection runs conversions, so it is done once
+_detected: Dict[Tuple[int, int], str] = {}
+
 
 class ADS1115Plugin(DevicePlugin):
-    """Plugin for ADS1115/ADS1015 ADC devices."""
+    """Plugin for ADS1115 ADC devices."""
     
     addresses = [0x48, 0x49, 0x4A, 0x4B]
     name = "ADS1115"
     manufacturer = "Texas Instruments"
-    description = "16-bit/12-bit ADC with 4 channels"
+    description = "16-bit ADC with 4 channels, up to 860 SPS"
+    datasheet = "https://www.ti.com/product/ADS1115"
+    
+    def _panel_adc(self):
+        """(ADCManager or None, in use) for the panel's own ADCs at this bus and address.
+
+        hardware.adc (bare or inside a TimedADC) may be this chip, and extra
+        boards may sample it in worker processes.
+        """
+        from config.pins import I2C_BUS
+        from hardware.adc_manager import ADCManager
+        
+        hardware = self.hardware
+        adc = getattr(hardware, "adc", None)
+        timed = adc is not None and hasattr(adc, "estimator")  # TimedADC wraps the manager
+        manager = adc.adc if timed else adc
+        if isinstance(manager, ADCManager) and manager.address == self.address and \
+                (manager.bus_num if manager.bus_num is not None else I2C_BUS or 1) == self.bus:
+            return manager, timed or getattr(hardware, "engine", None) is not None
+        boards = getattr(hardware, "boards", None)
+        if boards is not None:
+            from acquisition.multiboard import parse_board
+            if (self.bus, self.address) in [parse_board(spec) for spec in boards.specs]:
+                return None, True
+        return None, False
+    
+    def detected_model(self) -> Optional[str]:
+        """"ADS1115" or "ADS1015" if already known, else None (never touches the chip).
+
+        The model comes from the panel's ADC manager when it samples this chip,
+        or from identify(); detection runs conversions for up to a few hundred
+        milliseconds, far too long for the GUI thread building a tab.
+        """
+        key = (self.bus, self.address)
+        if key not in _detected:
+            manager, _ = self._panel_adc()
+            if manager is None or manager.known_model is None:
+                return None
+            _detected[key] = manager.known_model
+        return _detected[key]
+    
+    def identify(self) -> Optional[str]:
+        """Tell the models apart by conversion time (Test tab button).
+
+        An ADC the panel is sampling is never probed; None if it can't be told.
+        """
+        model = self.detected_model()
+        manager, in_use = self._panel_adc()
+        if model is not None or in_use:
+            return model
+        from hardware.adc_manager import ADCManager
+        adc = manager or ADCManager(bus=self.bus, address=self.address, model=None)
+        try:
+            model = _detected[(self.bus, self.address)] = adc.model
+        except OSError:
+            return None
+        finally:
+            if adc is not manager:
+                adc.close()
+        return model
     
     def detect(self) -> bool:
-        """Detect if ADS1115 is present."""
+        """Detect an ADC at the address (ACK only; the model is not checked here)."""
+        if self._panel_adc()[1]:
+            return True
         try:
-            import smbus2
-            bus = smbus2.SMBus(self.bus)
-            # Try to read from device (simple detection)
+            from hardware.i2c_bus import I2CBus
+            bus = I2CBus(self.bus)
             bus.write_quick(self.address)
             bus.close()
             return True
@@ -27,17 +90,25 @@ class ADS1115Plugin(DevicePlugin):
     
     def get_info(self) -> dict:
         """Get device information."""
+        from hardware.adc_manager import MODELS
+        resolution, rates = MODELS[self.name]
         info = super().get_info()
         info.update({
-            "resolution": "16-bit (ADS1115) or 12-bit (ADS1015)",
+            "resolution": f"{resolution}-bit",
+            "data_rates": f"{min(rates)}-{max(rates)} SPS",
             "channels": 4,
             "interface": "I2C",
-            "datasheet": "https://www.ti.com/product/ADS1115",
+            "datasheet": self.datasheet,
         })
+        detected = self.detected_model()
+        if detected is None:
+            detected = ("in use by acquisition (model not known yet)" if self._panel_adc()[1]
+                        else "not identified (Identify Model on the Test tab)")
+        info["detected"] = detected
         return info
     
     def get_test_ui(self) -> Optional[QWidget]:
-        """Get test interface for ADS1115."""
+        """Get test interface for the ADC."""
         from PySide6.QtWidgets import QWidget, QVBoxLayout, QHBoxLayout, QLabel, QPushButton, QGroupBox
         
         widget = QWidget()
@@ -46,7 +117,7 @@ class ADS1115Plugin(DevicePlugin):
         layout.setContentsMargins(20, 15, 20, 20)
         
         # Title
-        title = QLabel("ADS1115 ADC Test Interface")
+        title = QLabel(f"{self.name} ADC Test Interface")
         title.setStyleSheet("font-size: 22pt; font-weight: bold; padding: 15px;")
         layout.addWidget(title)
         
@@ -109,20 +180,40 @@ class ADS1115Plugin(DevicePlugin):
         test_button.clicked.connect(lambda checked=False: self._read_adc_channels(channel_labels))
         layout.addWidget(test_button)
         
+        # Model identification runs conversions, so only on request
+        model_label = QLabel(f"Model: {self.detected_model() or 'not identified'}")
+        model_label.setStyleSheet("font-size: 16pt; padding: 5px;")
+        identify_button = QPushButton("Identify Model")
+        identify_button.setMinimumHeight(50)
+        identify_button.clicked.connect(lambda checked=False: self._identify(model_label))
+        layout.addWidget(identify_button)
+        layout.addWidget(model_label)
+        
         layout.addStretch()
         widget.setLayout(layout)
         
         return widget
     
+    def _identify(self, model_label):
+        """Run identify() and show the result."""
+        model = self.identify()
+        if model is not None:
+            model_label.setText(f"Model: {model}" + ("" if model == self.name else
+                                                     f" (use the {model} plugin)"))
+        elif self._panel_adc()[1]:
+            model_label.setText("Model: not known yet (in use by acquisition, not probed)")
+        else:
+            model_label.setText("Model: not responding")
+    
     def _read_adc_channels(self, channel_labels):
         """Read all ADC channels and update display."""
         import sys
-        import smbus2
         import time
+        from hardware.i2c_bus import I2CBus
         
-        # Use smbus2 directly
+        # Use smbus2 directly (with timeouts and bus recovery)
         try:
-            bus = smbus2.SMBus(self.bus)
+            bus = I2CBus(self.bus)
             
             # Check if we can write to config register
             write_works = False
@@ -175,10 +266,10 @@ class ADS1115Plugin(DevicePlugin):
                 try:
                     result_data = bus.read_i2c_block_data(self.address, 0x00, 2)
                     raw_value = (result_data[0] << 8) | result_data[1]
-                    # Convert to signed 16-bit
+                    # Convert to signed 16-bit (the ADS1015 left-aligns its 12-bit result)
                     if raw_value & 0x8000:
                         raw_value = raw_value - 65536
-                    # Convert to voltage (±4.096V range for ADS1115)
+                    # Convert to voltage (±4.096V range)
                     voltage = (raw_value / 32767.0) * 4.096
                 except Exception as e:
                     print(f"DEBUG: Channel {ch} read failed: {e}", file=sys.stderr)
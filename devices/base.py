@@ -1,8 +1,10 @@
 """Base class for device plugins."""
 
 from abc import ABC, abstractmethod
-from typing import List, Dict, Optional, Any
-from PySide6.QtWidgets import QWidget
+from typing import List, Dict, Optional, Any, TYPE_CHECKING
+
+if TYPE_CHECKING:  # Qt is only needed by the GUI, not by headless users of plugins
+    from PySide6.QtWidgets import QWidget
 
 
 class DevicePlugin(ABC):
@@ -57,7 +59,7 @@ class DevicePlugin(ABC):
         }
     
     @abstractmethod
-    def get_test_ui(self) -> Optional[QWidget]:
+    def get_test_ui(self) -> Optional["QWidget"]:
         """Get test interface widget for this device.
         
         Returns:
@@ -77,4 +79,11 @@ class DevicePlugin(ABC):
             return "NOT_DETECTED"
         except Exception:
             return "ERROR"
+    
+    def close(self):
+        """Release bus handles and background work kept between uses (none by default).
+
+        Called when the loader drops the instance from its cache.
+        """
+        pass
 
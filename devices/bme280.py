@@ -0,0 +1,12 @@
+"""BME280 pressure/humidity sensor plugin (the BMP280 plugin plus humidity)."""
+
+from .bmp280 import BMP280Plugin
+
+
+class BME280Plugin(BMP280Plugin):
+    """Plugin for the Bosch BME280 pressure, temperature and humidity sensor."""
+    
+    name = "BME280"
+    description = "Barometric pressure + temperature + relative humidity sensor"
+    models = ("BME280",)
+    datasheet = "https://www.bosch-sensortec.com/media/boschsensortec/downloads/datasheets/bst-bme280-ds002.pdf"
@@ -0,0 +1,177 @@
+"""BMP280 pressure sensor plugin (burst reads, cached calibration)."""
+
+from typing import Optional
+from PySide6.QtCore import QTimer
+from PySide6.QtWidgets import (QWidget, QVBoxLayout, QHBoxLayout, QLabel, QPushButton,
+                               QGroupBox, QGridLayout)
+from .base import DevicePlugin
+
+QUANTITIES = (("p", "pressure", "Pressure", "hPa", "{:9.2f}"),
+              ("t", "temperature", "Temperature", "°C", "{:7.2f}"),
+              ("rh", "humidity", "Humidity", "%", "{:6.1f}"))
+
+# Live view update interval (ms)
+LIVE_MS = 500
+
+
+class BMP280Plugin(DevicePlugin):
+    """Plugin for the Bosch BMP280 barometric pressure sensor."""
+    
+    addresses = [0x76, 0x77]
+    name = "BMP280"
+    manufacturer = "Bosch Sensortec"
+    description = "Barometric pressure + temperature sensor"
+    models = ("BMP280",)
+    datasheet = "https://www.bosch-sensortec.com/media/boschsensortec/downloads/datasheets/bst-bmp280-ds001.pdf"
+    
+    def _open(self):
+        from hardware.bme280 import BME280
+        return BME280(self.bus, self.address)
+    
+    def _poller_name(self) -> Optional[str]:
+        """Channel prefix if the panel's PressurePoller owns this sensor."""
+        poller = getattr(self.hardware, "pressure", None)
+        if poller is None or not poller.running:
+            return None
+        for name, sensor in poller.sensors:
+            if sensor.address == self.address and sensor.bus_number == self.bus:
+                return name
+        return None
+    
+    def detect(self) -> bool:
+        """Detect the sensor by its chip ID."""
+        try:
+            with self._open() as sensor:
+                return sensor.model in self.models
+        except Exception:
+            return False
+    
+    def get_info(self) -> dict:
+        """Get device information."""
+        info = super().get_info()
+        info.update({
+            "sensors": "Pressure 300-1100 hPa (±0.12 hPa relative), temperature"
+                       + (", humidity (±3 %RH)" if "BME280" in self.models else ""),
+            "output_rate": "Up to ~80 Hz (oversampling traded against rate)",
+            "interface": "I2C (3.4 MHz max), SDO selects 0x76/0x77",
+            "datasheet": self.datasheet,
+        })
+        name = self._poller_name()
+        if name is not None:
+            info["polling"] = f"As {name}_* on the sample bus"
+            return info
+        try:
+            with self._open() as sensor:
+                info["model"] = f"{sensor.model} (chip ID 0x{sensor.chip_id:02X})"
+        except Exception as e:
+            info["model"] = f"Not readable: {e}"
+        return info
+    
+    def get_test_ui(self) -> Optional[QWidget]:
+        """Get test interface for the sensor."""
+        widget = QWidget()
+        layout = QVBoxLayout()
+        layout.setSpacing(15)
+        layout.setContentsMargins(20, 15, 20, 20)
+        
+        # Title
+        title = QLabel(f"{self.name} Test Interface")
+        title.setStyleSheet("font-size: 22pt; font-weight: bold; padding: 15px;")
+        layout.addWidget(title)
+        
+        info_label = QLabel(
+            "Read takes one forced measurement at the best oversampling for 1 Hz. "
+            "Live repeats it twice a second, or shows the panel's readings when the "
+            "sensor is in PRESSURE_SENSORS."
+        )
+        info_label.setWordWrap(True)
+        info_label.setStyleSheet("padding: 15px; color: #666; font-size: 16pt;")
+        layout.addWidget(info_label)
+        
+        # Readings
+        readings_group = QGroupBox("Readings")
+        readings_group.setStyleSheet("font-size: 18pt; font-weight: bold; padding-top: 20px;")
+        grid = QGridLayout()
+        value_labels = {}
+        quantities = QUANTITIES if "BME280" in self.models else QUANTITIES[:2]
+        for row, (suffix, key, label, unit, fmt) in enumerate(quantities):
+            name_label = QLabel(label)
+            name_label.setStyleSheet("font-size: 16pt;")
+            value_label = QLabel(f"--- {unit}")
+            value_label.setStyleSheet("font-size: 16pt; font-family: monospace;")
+            grid.addWidget(name_label, row, 0)
+            grid.addWidget(value_label, row, 1)
+            value_labels[suffix] = (key, value_label, unit, fmt)
+        readings_group.setLayout(grid)
+        layout.addWidget(readings_group)
+        
+        status_label = QLabel("")
+        status_label.setWordWrap(True)
+        status_label.setStyleSheet("padding: 10px; font-size: 16pt;")
+        layout.addWidget(status_label)
+        
+        button_style = """
+            QPushButton {
+                background: qlineargradient(x1:0, y1:0, x2:0, y2:1,
+                    stop:0 #007bff, stop:1 #0056b3);
+                color: white;
+                border: none;
+                border-radius: 6px;
+                padding: 15px;
+                font-size: 16pt;
+                font-weight: bold;
+            }
+            QPushButton:pressed {
+                background: #004085;
+            }
+            QPushButton:checked {
+                background: #28a745;
+            }
+        """
+        live_timer = QTimer(widget)
+        live_timer.setInterval(LIVE_MS)
+        live_timer.timeout.connect(lambda: self._read(value_labels, status_label, live_timer))
+        
+        buttons = QHBoxLayout()
+        read_button = QPushButton("Read")
+        read_button.clicked.connect(lambda: self._read(value_labels, status_label))
+        live_button = QPushButton("Live")
+        live_button.setCheckable(True)
+        live_button.toggled.connect(lambda on: live_timer.start() if on else live_timer.stop())
+        for button in (read_button, live_button):
+            button.setMinimumHeight(60)
+            button.setStyleSheet(button_style)
+            buttons.addWidget(button)
+        layout.addLayout(buttons)
+        
+        layout.addStretch()
+        widget.setLayout(layout)
+        return widget
+    
+    def _read(self, value_labels, status_label, timer=None):
+        name = self._poller_name()
+        try:
+            if name is not None:
+                # The poller owns the sensor; show what it published last
+                latest = self.hardware.pressure.latest
+                values = {key: latest.get(f"{name}_{suffix}")
+                          for suffix, (key, *_) in value_labels.items()}
+                status = f"Polled by the panel as {name}_*"
+            else:
+                with self._open() as sensor:
+                    values = sensor.read()
+                    settings = sensor.settings
+                status = (f"Oversampling p×{settings.osrs_p} t×{settings.osrs_t}"
+                          + (f" h×{settings.osrs_h}" if settings.osrs_h else "")
+                          + f", {settings.measurement_ms:.1f} ms per measurement")
+        except Exception as e:
+            if timer is not None:
+                timer.stop()
+            status_label.setText(f"✗ Read failed: {e}")
+            status_label.setStyleSheet("padding: 10px; font-size: 16pt; color: #dc3545;")
+            return
+        for key, label, unit, fmt in value_labels.values():
+            value = values.get(key)
+            label.setText(f"{fmt.format(value)} {unit}" if value is not None else f"--- {unit}")
+        status_label.setText(status)
+        status_label.setStyleSheet("padding: 10px; font-size: 16pt; color: #28a745;")
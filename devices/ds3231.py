@@ -0,0 +1,172 @@
+"""DS3231 real-time clock plugin (time, SQW clock discipline status)."""
+
+import time
+from typing import Optional
+from PySide6.QtWidgets import (QWidget, QVBoxLayout, QHBoxLayout, QLabel, QPushButton,
+                               QGroupBox, QGridLayout)
+from .base import DevicePlugin
+
+
+class DS3231Plugin(DevicePlugin):
+    """Plugin for the Analog Devices (Maxim) DS3231 TCXO real-time clock."""
+    
+    addresses = [0x68]
+    name = "DS3231"
+    manufacturer = "Analog Devices (Maxim)"
+    description = "±2 ppm TCXO real-time clock with 1 Hz square-wave output"
+    datasheet = "https://www.analog.com/media/en/technical-documentation/data-sheets/DS3231.pdf"
+    
+    def _open(self):
+        from hardware.ds3231 import DS3231
+        return DS3231(self.bus, self.address)
+    
+    def _discipline(self):
+        """The panel's RTCDiscipline if it is running on this RTC."""
+        discipline = getattr(self.hardware, "rtc", None)
+        if discipline is None or not discipline.running:
+            return None
+        rtc = discipline.rtc
+        if rtc.address == self.address and rtc.bus_number == self.bus:
+            return discipline
+        return None
+    
+    def detect(self) -> bool:
+        """Detect the RTC by its register layout (and that no IMU answers WHO_AM_I)."""
+        try:
+            with self._open():
+                return True
+        except Exception:
+            return False
+    
+    def get_info(self) -> dict:
+        """Get device information."""
+        info = super().get_info()
+        info.update({
+            "accuracy": "±2 ppm 0 to +40 °C (about 1 minute per year)",
+            "interface": "I2C (400 kHz), INT/SQW open-drain output (1 Hz to 8.192 kHz)",
+            "datasheet": self.datasheet,
+        })
+        try:
+            with self._open() as rtc:
+                now = rtc.read_time()
+                info["time"] = f"{now:%Y-%m-%d %H:%M:%S} UTC"
+                if rtc.oscillator_stopped:
+                    info["time"] += " (oscillator stopped: not valid)"
+                info["temperature"] = f"{rtc.temperature():.2f} °C"
+                info["aging"] = f"{rtc.aging:+d}"
+        except Exception as e:
+            info["time"] = f"Not readable: {e}"
+        discipline = self._discipline()
+        if discipline is not None:
+            stats = discipline.get_stats()
+            if stats["locked"]:
+                info["discipline"] = (f"SQW on BCM{discipline.sqw_pin}: host clock "
+                                      f"{stats['drift_ppm']:+.2f} ppm, system clock "
+                                      f"{stats['offset_s']:+.3f} s from RTC")
+            else:
+                info["discipline"] = f"SQW on BCM{discipline.sqw_pin}: locking"
+        return info
+    
+    def get_test_ui(self) -> Optional[QWidget]:
+        """Get test interface for the RTC."""
+        widget = QWidget()
+        layout = QVBoxLayout()
+        layout.setSpacing(15)
+        layout.setContentsMargins(20, 15, 20, 20)
+        
+        # Title
+        title = QLabel("DS3231 Test Interface")
+        title.setStyleSheet("font-size: 22pt; font-weight: bold; padding: 15px;")
+        layout.addWidget(title)
+        
+        info_label = QLabel(
+            "Read shows the RTC time (one burst read) next to the system clock. "
+            "Set from system clock writes the system time at the start of its next "
+            "second and clears the oscillator-stopped flag."
+        )
+        info_label.setWordWrap(True)
+        info_label.setStyleSheet("padding: 15px; color: #666; font-size: 16pt;")
+        layout.addWidget(info_label)
+        
+        # Readings
+        readings_group = QGroupBox("Readings")
+        readings_group.setStyleSheet("font-size: 18pt; font-weight: bold; padding-top: 20px;")
+        grid = QGridLayout()
+        labels = {}
+        for row, (key, text) in enumerate((("time", "RTC time"), ("offset", "System clock"),
+                                           ("temperature", "Temperature"),
+                                           ("discipline", "Discipline"))):
+            name_label = QLabel(text)
+            name_label.setStyleSheet("font-size: 16pt;")
+            value_label = QLabel("---")
+            value_label.setStyleSheet("font-size: 16pt; font-family: monospace;")
+            grid.addWidget(name_label, row, 0)
+            grid.addWidget(value_label, row, 1)
+            labels[key] = value_label
+        readings_group.setLayout(grid)
+        layout.addWidget(readings_group)
+        
+        status_label = QLabel("")
+        status_label.setWordWrap(True)
+        status_label.setStyleSheet("padding: 10px; font-size: 16pt;")
+        layout.addWidget(status_label)
+        
+        button_style = """
+            QPushButton {
+                background: qlineargradient(x1:0, y1:0, x2:0, y2:1,
+                    stop:0 #007bff, stop:1 #0056b3);
+                color: white;
+                border: none;
+                border-radius: 6px;
+                padding: 15px;
+                font-size: 16pt;
+                font-weight: bold;
+            }
+            QPushButton:pressed {
+                background: #004085;
+            }
+        """
+        buttons = QHBoxLayout()
+        read_button = QPushButton("Read")
+        read_button.clicked.connect(lambda: self._read(labels, status_label))
+        set_button = QPushButton("Set from system clock")
+        set_button.clicked.connect(lambda: self._read(labels, status_label, set_time=True))
+        for button in (read_button, set_button):
+            button.setMinimumHeight(60)
+            button.setStyleSheet(button_style)
+            buttons.addWidget(button)
+        layout.addLayout(buttons)
+        
+        layout.addStretch()
+        widget.setLayout(layout)
+        return widget
+    
+    def _read(self, labels, status_label, set_time=False):
+        try:
+            with self._open() as rtc:
+                if set_time:
+                    rtc.set_time()
+                now = rtc.read_time()
+                system = time.time()
+                stopped = rtc.oscillator_stopped
+                celsius = rtc.temperature()
+        except Exception as e:
+            status_label.setText(f"✗ {'Set' if set_time else 'Read'} failed: {e}")
+            status_label.setStyleSheet("padding: 10px; font-size: 16pt; color: #dc3545;")
+            return
+        labels["time"].setText(f"{now:%Y-%m-%d %H:%M:%S} UTC")
+        labels["offset"].setText(f"{system - now.timestamp():+.1f} s")
+        labels["temperature"].setText(f"{celsius:.2f} °C")
+        discipline = self._discipline()
+        if discipline is None:
+            labels["discipline"].setText("Off (RTC_SQW_PIN)")
+        else:
+            stats = discipline.get_stats()
+            labels["discipline"].setText(f"{stats['drift_ppm']:+.2f} ppm" if stats["locked"]
+                                         else "Locking")
+        if stopped:
+            status_label.setText("Oscillator stopped: time not valid until set")
+            status_label.setStyleSheet("padding: 10px; font-size: 16pt; color: #dc3545;")
+        else:
+            status_label.setText("✓ Time set" if set_time else "")
+            status_label.setStyleSheet("padding: 10px; font-size: 16pt; color: #28a745;")
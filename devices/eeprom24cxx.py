@@ -0,0 +1,223 @@
+"""24Cxx EEPROM plugin (HAT EEPROM, board serials and calibration data)."""
+
+import sys
+from typing import Optional
+from PySide6.QtWidgets import (QWidget, QVBoxLayout, QHBoxLayout, QLabel, QPushButton,
+                               QTextEdit, QGroupBox, QFileDialog, QMessageBox)
+from PySide6.QtGui import QFont
+from .base import DevicePlugin
+from config.device_config import EEPROM_PART
+
+
+def _hexdump(data: bytes, offset: int = 0) -> str:
+    lines = []
+    for i in range(0, len(data), 16):
+        row = data[i:i + 16]
+        text = "".join(chr(b) if 32 <= b < 127 else "." for b in row)
+        lines.append(f"{offset + i:04X}  {row.hex(' '):<47}  {text}")
+    return "\n".join(lines)
+
+
+class EEPROM24CxxPlugin(DevicePlugin):
+    """Plugin for 24Cxx-class I2C EEPROMs."""
+    
+    addresses = [0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57]
+    name = "24Cxx EEPROM"
+    manufacturer = "Microchip / Atmel / ST (24Cxx compatible)"
+    description = "I2C serial EEPROM (HAT ID, board serial, calibration)"
+    
+    def __init__(self, bus: int, address: int):
+        super().__init__(bus, address)
+        self.part = EEPROM_PART
+    
+    def _open(self):
+        from hardware.eeprom import EEPROM
+        return EEPROM(self.bus, self.address, self.part)
+    
+    def detect(self) -> bool:
+        """Detect if the EEPROM answers its address."""
+        try:
+            with self._open() as eeprom:
+                return eeprom.is_present()
+        except Exception:
+            return False
+    
+    def get_info(self) -> dict:
+        """Get device information (and the HAT header if the EEPROM holds one).
+
+        Only the HAT header and vendor atom are read; the Read button dumps it all.
+        """
+        from hardware.eeprom import PARTS
+        
+        info = super().get_info()
+        part = PARTS[self.part]
+        info.update({
+            "part": f"{self.part.upper()} ({part.size} bytes, {part.page}-byte pages)",
+            "interface": "I2C",
+            "datasheet": "https://ww1.microchip.com/downloads/en/DeviceDoc/24AA32A-24LC32A-Data-Sheet-20001713N.pdf",
+        })
+        try:
+            with self._open() as eeprom:
+                hat = eeprom.read_hat()
+                info["read_throughput"] = (f"{eeprom.stats['read_bytes']} B in "
+                                           f"{eeprom.stats['read_s'] * 1000:.1f} ms "
+                                           f"({eeprom.stats['read_transactions']} transactions)")
+        except Exception as e:
+            info["contents"] = f"Not readable: {e}"
+            return info
+        if hat is None:
+            info["contents"] = "No HAT header (raw data)"
+        else:
+            info["contents"] = (f"HAT EEPROM v{hat['version']}, {len(hat['atoms'])} atoms: "
+                                + ", ".join(atom["type"] for atom in hat["atoms"]))
+            for key in ("vendor", "product", "product_id", "uuid"):
+                if key in hat:
+                    info[key] = hat[key]
+        return info
+    
+    def get_test_ui(self) -> Optional[QWidget]:
+        """Get test interface for the EEPROM."""
+        widget = QWidget()
+        layout = QVBoxLayout()
+        layout.setSpacing(15)
+        layout.setContentsMargins(20, 15, 20, 20)
+        
+        # Title
+        title = QLabel(f"{self.part.upper()} EEPROM Test Interface")
+        title.setStyleSheet("font-size: 22pt; font-weight: bold; padding: 15px;")
+        layout.addWidget(title)
+        
+        info_label = QLabel(
+            "Read dumps the whole EEPROM in bulk transactions. Flash writes an image "
+            "page by page (only pages that differ), waits for each write cycle by ACK "
+            "polling and verifies by reading back."
+        )
+        info_label.setWordWrap(True)
+        info_label.setStyleSheet("padding: 15px; color: #666; font-size: 16pt;")
+        layout.addWidget(info_label)
+        
+        # Contents
+        dump_group = QGroupBox("Contents")
+        dump_group.setStyleSheet("font-size: 18pt; font-weight: bold; padding-top: 20px;")
+        dump_layout = QVBoxLayout()
+        dump_view = QTextEdit()
+        dump_view.setReadOnly(True)
+        dump_view.setFont(QFont("monospace", 11))
+        dump_view.setMinimumHeight(300)
+        dump_layout.addWidget(dump_view)
+        dump_group.setLayout(dump_layout)
+        layout.addWidget(dump_group)
+        
+        status_label = QLabel("")
+        status_label.setWordWrap(True)
+        status_label.setStyleSheet("padding: 10px; font-size: 16pt;")
+        layout.addWidget(status_label)
+        
+        button_style = """
+            QPushButton {
+                background: qlineargradient(x1:0, y1:0, x2:0, y2:1,
+                    stop:0 #007bff, stop:1 #0056b3);
+                color: white;
+                border: none;
+                border-radius: 6px;
+                padding: 15px;
+                font-size: 16pt;
+                font-weight: bold;
+            }
+            QPushButton:pressed {
+                background: #004085;
+            }
+        """
+        buttons = QHBoxLayout()
+        for text, handler in (("Read", self._read),
+                              ("Save Dump...", self._save),
+                              ("Flash Image...", self._flash),
+                              ("Check Write Protect", self._check_wp)):
+            button = QPushButton(text)
+            button.setMinimumHeight(60)
+            button.setStyleSheet(button_style)
+            button.clicked.connect(
+                lambda checked=False, h=handler: h(widget, dump_view, status_label))
+            buttons.addWidget(button)
+        layout.addLayout(buttons)
+        
+        layout.addStretch()
+        widget.setLayout(layout)
+        return widget
+    
+    @staticmethod
+    def _show(status_label, text: str, ok: bool = True):
+        status_label.setText(text)
+        status_label.setStyleSheet(f"padding: 10px; font-size: 16pt; "
+                                   f"color: {'#28a745' if ok else '#dc3545'};")
+    
+    def _read(self, widget, dump_view, status_label):
+        try:
+            with self._open() as eeprom:
+                data = eeprom.read()
+                stats = eeprom.stats
+        except Exception as e:
+            self._show(status_label, f"✗ Read failed: {e}", ok=False)
+            return None
+        dump_view.setPlainText(_hexdump(data))
+        self._show(status_label, f"✓ Read {len(data)} bytes in {stats['read_s'] * 1000:.1f} ms "
+                                 f"({stats['read_bytes_per_s'] / 1024:.1f} KB/s, "
+                                 f"{stats['read_transactions']} transactions)")
+        return data
+    
+    def _save(self, widget, dump_view, status_label):
+        data = self._read(widget, dump_view, status_label)
+        if data is None:
+            return
+        path, _ = QFileDialog.getSaveFileName(widget, "Save EEPROM Dump",
+                                              f"eeprom-0x{self.address:02X}.bin",
+                                              "Binary (*.bin *.eep);;All Files (*)")
+        if path:
+            with open(path, "wb") as f:
+                f.write(data)
+            self._show(status_label, f"✓ Saved {len(data)} bytes to {path}")
+    
+    def _flash(self, widget, dump_view, status_label):
+        from hardware.eeprom import EEPROMError, WriteProtectedError
+        
+        path, _ = QFileDialog.getOpenFileName(widget, "Flash EEPROM Image", "",
+                                              "Binary (*.bin *.eep);;All Files (*)")
+        if not path:
+            return
+        with open(path, "rb") as f:
+            image = f.read()
+        answer = QMessageBox.question(
+            widget, "Flash EEPROM",
+            f"Write {len(image)} bytes from {path} to the EEPROM at 0x{self.address:02X}?")
+        if answer != QMessageBox.Yes:
+            return
+        try:
+            with self._open() as eeprom:
+                stats = eeprom.write(0, image)
+        except WriteProtectedError as e:
+            self._show(status_label, f"✗ Write protected: {e}", ok=False)
+            return
+        except (EEPROMError, OSError, ValueError) as e:
+            self._show(status_label, f"✗ Flash failed: {e}", ok=False)
+            print(f"EEPROM flash failed: {e}", file=sys.stderr)
+            return
+        dump_view.setPlainText(_hexdump(image))
+        self._show(status_label,
+                   f"✓ Flashed and verified {stats['bytes']} bytes in {stats['total_s']:.2f} s "
+                   f"({stats['bytes_per_s'] / 1024:.1f} KB/s): {stats['pages_written']} pages "
+                   f"written, {stats['pages_skipped']} unchanged, write cycle "
+                   f"{stats['write_cycle_ms_mean']:.2f} ms mean / "
+                   f"{stats['write_cycle_ms_max']:.2f} ms max")
+    
+    def _check_wp(self, widget, dump_view, status_label):
+        try:
+            with self._open() as eeprom:
+                protected = eeprom.probe_write_protect()
+        except Exception as e:
+            self._show(status_label, f"✗ Check failed: {e}", ok=False)
+            return
+        if protected:
+            self._show(status_label, "Write protect is ACTIVE (WP pin high) - writes are ignored",
+                       ok=False)
+        else:
+            self._show(status_label, "✓ Writable (last byte flipped and restored)")
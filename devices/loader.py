@@ -2,9 +2,11 @@
 
 import importlib
 import os
-from typing import Optional, List, Dict, Any
+from collections import OrderedDict
+from typing import Optional, List, Dict, Any, Tuple
 from .base import DevicePlugin
 from .registry import get_registry
+from config.device_config import DEVICE_CACHE_SIZE
 
 
 class DeviceLoader:
@@ -14,6 +16,8 @@ class DeviceLoader:
         self.registry = get_registry()
         self.loaded_plugins: Dict[str, type] = {}
         self.failed_plugins: List[str] = []
+        # (bus, address, plugin) -> instance, least recently used first
+        self.devices: "OrderedDict[Tuple[int, int, str], DevicePlugin]" = OrderedDict()
     
     def load_plugin(self, plugin_name: str) -> Optional[type]:
         """Load a device plugin by name.
@@ -39,15 +43,18 @@ class DeviceLoader:
             # Try to import plugin module
             module = importlib.import_module(f"devices.{plugin_name}")
             
-            # Find DevicePlugin subclass
+            # Find DevicePlugin subclass; one defined in the module itself wins over
+            # an imported base plugin (mpu6500 builds on mpu6050's)
             plugin_class = None
             for attr_name in dir(module):
                 attr = getattr(module, attr_name)
-                if (isinstance(attr, type) and 
-                    issubclass(attr, DevicePlugin) and 
+                if (isinstance(attr, type) and
+                    issubclass(attr, DevicePlugin) and
                     attr != DevicePlugin):
-                    plugin_class = attr
-                    break
+                    if attr.__module__ == module.__name__:
+                        plugin_class = attr
+                        break
+                    plugin_class = plugin_class or attr
             
             if plugin_class is None:
                 raise ValueError(f"No DevicePlugin subclass found in devices.{plugin_name}")
@@ -104,6 +111,29 @@ class DeviceLoader:
             print(f"Warning: Failed to create device {plugin_name} at 0x{address:02X}: {e}")
             return None
     
+    def get_device(self, bus: int, address: int, plugin_name: str) -> Optional[DevicePlugin]:
+        """Cached create_device(): one instance per (bus, address, plugin).
+        
+        Plugins keep state between uses (selected image, open bus handles), so
+        reopening a device returns the same instance. At most DEVICE_CACHE_SIZE
+        instances are kept (the least recently used one is closed and dropped);
+        failures are not cached.
+        """
+        key = (bus, address, plugin_name)
+        device = self.devices.pop(key, None)
+        if device is None:
+            device = self.create_device(bus, address, plugin_name)
+            if device is None:
+                return None
+        self.devices[key] = device
+        while len(self.devices) > DEVICE_CACHE_SIZE:
+            (_, _, evicted_name), evicted = self.devices.popitem(last=False)
+            try:
+                evicted.close()
+            except Exception as e:
+                print(f"Warning: Failed to close device {evicted_name}: {e}")
+        return device
+    
     def get_available_plugins(self) -> List[str]:
         """Get list of available plugin names.
         
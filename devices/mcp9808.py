@@ -0,0 +1,179 @@
+"""MCP9808 temperature sensor plugin (polled or ALERT window)."""
+
+from typing import Optional
+from PySide6.QtCore import QTimer
+from PySide6.QtWidgets import (QWidget, QVBoxLayout, QHBoxLayout, QLabel, QPushButton,
+                               QGroupBox, QGridLayout)
+from .base import DevicePlugin
+
+STATES = {0: "Inside window", 1: "Above T_UPPER", 2: "At/above T_CRIT", -1: "Below T_LOWER"}
+
+# Live view update interval (ms); one 0.0625 degC conversion takes 250 ms
+LIVE_MS = 500
+
+
+class MCP9808Plugin(DevicePlugin):
+    """Plugin for the Microchip MCP9808 digital temperature sensor."""
+    
+    addresses = [0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F]
+    name = "MCP9808"
+    manufacturer = "Microchip"
+    description = "±0.25 °C digital temperature sensor with window ALERT output"
+    datasheet = "https://ww1.microchip.com/downloads/en/DeviceDoc/25095A.pdf"
+    
+    def _open(self):
+        from hardware.mcp9808 import MCP9808
+        return MCP9808(self.bus, self.address)
+    
+    def _monitored(self):
+        """(channel name, window) if the panel's TemperatureMonitor owns this sensor."""
+        monitor = getattr(self.hardware, "temperature", None)
+        if monitor is None or not monitor.running:
+            return None
+        for name, sensor, window in monitor.sensors:
+            if sensor.address == self.address and sensor.bus_number == self.bus:
+                return name, window
+        return None
+    
+    def detect(self) -> bool:
+        """Detect the sensor by its manufacturer and device IDs."""
+        try:
+            with self._open():
+                return True
+        except Exception:
+            return False
+    
+    def get_info(self) -> dict:
+        """Get device information."""
+        info = super().get_info()
+        info.update({
+            "range": "-40 to +125 °C (±0.25 °C typical)",
+            "resolution": "0.5 / 0.25 / 0.125 / 0.0625 °C (30 to 250 ms per conversion)",
+            "interface": "I2C (400 kHz), ALERT open-drain output, A2-A0 select 0x18-0x1F",
+            "datasheet": self.datasheet,
+        })
+        monitored = self._monitored()
+        if monitored is not None:
+            name, window = monitored
+            if window is None:
+                info["monitoring"] = f"Polled as {name}"
+            else:
+                info["monitoring"] = (f"ALERT on BCM{window['pin']} as {name}, window "
+                                      f"{window['lower']} to {window['upper']} °C")
+            return info
+        try:
+            with self._open() as sensor:
+                info["revision"] = str(sensor.revision)
+                window = sensor.get_window()
+                info["window"] = (f"{window['lower']:g} to {window['upper']:g} °C, critical "
+                                  f"{window['critical']:g} °C, ALERT "
+                                  f"{'on' if window['alert'] else 'off'}")
+        except Exception as e:
+            info["revision"] = f"Not readable: {e}"
+        return info
+    
+    def get_test_ui(self) -> Optional[QWidget]:
+        """Get test interface for the sensor."""
+        widget = QWidget()
+        layout = QVBoxLayout()
+        layout.setSpacing(15)
+        layout.setContentsMargins(20, 15, 20, 20)
+        
+        # Title
+        title = QLabel("MCP9808 Test Interface")
+        title.setStyleSheet("font-size: 22pt; font-weight: bold; padding: 15px;")
+        layout.addWidget(title)
+        
+        info_label = QLabel(
+            "Read shows the temperature and where it is relative to the programmed "
+            "window (the flag bits of the same 2-byte read). Live repeats it twice a "
+            "second, or shows the panel's readings when the sensor is in "
+            "TEMPERATURE_SENSORS."
+        )
+        info_label.setWordWrap(True)
+        info_label.setStyleSheet("padding: 15px; color: #666; font-size: 16pt;")
+        layout.addWidget(info_label)
+        
+        # Readings
+        readings_group = QGroupBox("Readings")
+        readings_group.setStyleSheet("font-size: 18pt; font-weight: bold; padding-top: 20px;")
+        grid = QGridLayout()
+        labels = {}
+        for row, (key, text, initial) in enumerate((("temperature", "Temperature", "--- °C"),
+                                                    ("state", "Window", "---"))):
+            name_label = QLabel(text)
+            name_label.setStyleSheet("font-size: 16pt;")
+            value_label = QLabel(initial)
+            value_label.setStyleSheet("font-size: 16pt; font-family: monospace;")
+            grid.addWidget(name_label, row, 0)
+            grid.addWidget(value_label, row, 1)
+            labels[key] = value_label
+        readings_group.setLayout(grid)
+        layout.addWidget(readings_group)
+        
+        status_label = QLabel("")
+        status_label.setWordWrap(True)
+        status_label.setStyleSheet("padding: 10px; font-size: 16pt;")
+        layout.addWidget(status_label)
+        
+        button_style = """
+            QPushButton {
+                background: qlineargradient(x1:0, y1:0, x2:0, y2:1,
+                    stop:0 #007bff, stop:1 #0056b3);
+                color: white;
+                border: none;
+                border-radius: 6px;
+                padding: 15px;
+                font-size: 16pt;
+                font-weight: bold;
+            }
+            QPushButton:pressed {
+                background: #004085;
+            }
+            QPushButton:checked {
+                background: #28a745;
+            }
+        """
+        live_timer = QTimer(widget)
+        live_timer.setInterval(LIVE_MS)
+        live_timer.timeout.connect(lambda: self._read(labels, status_label, live_timer))
+        
+        buttons = QHBoxLayout()
+        read_button = QPushButton("Read")
+        read_button.clicked.connect(lambda: self._read(labels, status_label))
+        live_button = QPushButton("Live")
+        live_button.setCheckable(True)
+        live_button.toggled.connect(lambda on: live_timer.start() if on else live_timer.stop())
+        for button in (read_button, live_button):
+            button.setMinimumHeight(60)
+            button.setStyleSheet(button_style)
+            buttons.addWidget(button)
+        layout.addLayout(buttons)
+        
+        layout.addStretch()
+        widget.setLayout(layout)
+        return widget
+    
+    def _read(self, labels, status_label, timer=None):
+        monitored = self._monitored()
+        try:
+            if monitored is not None:
+                # The monitor owns the sensor; show what it published last
+                name, _ = monitored
+                monitor = self.hardware.temperature
+                celsius, state = monitor.latest.get(name), monitor.states.get(name)
+                status = f"Monitored by the panel as {name}"
+            else:
+                with self._open() as sensor:
+                    celsius, state = sensor.read_state()
+                status = ""
+        except Exception as e:
+            if timer is not None:
+                timer.stop()
+            status_label.setText(f"✗ Read failed: {e}")
+            status_label.setStyleSheet("padding: 10px; font-size: 16pt; color: #dc3545;")
+            return
+        labels["temperature"].setText(f"{celsius:7.3f} °C" if celsius is not None else "--- °C")
+        labels["state"].setText(STATES.get(state, "---"))
+        status_label.setText(status)
+        status_label.setStyleSheet("padding: 10px; font-size: 16pt; color: #28a745;")
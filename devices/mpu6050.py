@@ -0,0 +1,222 @@
+"""MPU6050 IMU plugin (accelerometer + gyro, FIFO streaming)."""
+
+from typing import Optional
+from PySide6.QtCore import QTimer
+from PySide6.QtWidgets import (QWidget, QVBoxLayout, QHBoxLayout, QLabel, QPushButton,
+                               QGroupBox, QGridLayout)
+from .base import DevicePlugin
+
+AXES = (("ax", "Accel X", "g"), ("ay", "Accel Y", "g"), ("az", "Accel Z", "g"),
+        ("gx", "Gyro X", "°/s"), ("gy", "Gyro Y", "°/s"), ("gz", "Gyro Z", "°/s"),
+        ("temp", "Temperature", "°C"))
+
+# Length of the FIFO streaming test (ms)
+STREAM_TEST_MS = 2000
+
+
+class MPU6050Plugin(DevicePlugin):
+    """Plugin for the MPU6050 6-axis IMU."""
+    
+    addresses = [0x68, 0x69]
+    name = "MPU6050"
+    manufacturer = "InvenSense (TDK)"
+    description = "3-axis accelerometer + 3-axis gyroscope with 1 KB FIFO"
+    models = ("MPU6050",)
+    datasheet = "https://invensense.tdk.com/wp-content/uploads/2015/02/MPU-6000-Register-Map1.pdf"
+    
+    def __init__(self, bus: int, address: int):
+        super().__init__(bus, address)
+        self._stream = None
+    
+    def _open(self):
+        from hardware.imu import MPU6050
+        return MPU6050(self.bus, self.address)
+    
+    def _running_stream(self):
+        """The panel's IMUStream for this sensor, if it is streaming (it owns the FIFO)."""
+        for stream in getattr(self.hardware, "imus", None) or ():
+            if stream.imu.address == self.address and stream.running:
+                return stream
+        return None
+    
+    def detect(self) -> bool:
+        """Detect the IMU by its WHO_AM_I register."""
+        try:
+            with self._open() as imu:
+                return imu.model in self.models
+        except Exception:
+            return False
+    
+    def get_info(self) -> dict:
+        """Get device information."""
+        info = super().get_info()
+        info.update({
+            "sensors": "Accelerometer ±2/4/8/16 g, gyroscope ±250/500/1000/2000 °/s, temperature",
+            "output_rate": "Up to 1 kHz through the FIFO (DLPF on)",
+            "interface": "I2C (400 kHz), INT pin for data ready",
+            "datasheet": self.datasheet,
+        })
+        stream = self._running_stream()
+        if stream is not None:
+            stats = stream.get_stats()
+            info["streaming"] = (f"{stats['achieved_hz']:.0f} Hz as {stream.name}_*, "
+                                 f"{stats['overflows']} overflows")
+            return info
+        try:
+            with self._open() as imu:
+                info["model"] = imu.model
+                info["fifo"] = f"{imu.fifo_size} bytes"
+        except Exception as e:
+            info["model"] = f"Not readable: {e}"
+        return info
+    
+    def get_test_ui(self) -> Optional[QWidget]:
+        """Get test interface for the IMU."""
+        widget = QWidget()
+        layout = QVBoxLayout()
+        layout.setSpacing(15)
+        layout.setContentsMargins(20, 15, 20, 20)
+        
+        # Title
+        title = QLabel(f"{self.name} IMU Test Interface")
+        title.setStyleSheet("font-size: 22pt; font-weight: bold; padding: 15px;")
+        layout.addWidget(title)
+        
+        info_label = QLabel(
+            "Live shows the output registers five times a second. The stream test runs "
+            f"the FIFO at 1 kHz for {STREAM_TEST_MS / 1000:g} s and reports the rate "
+            "actually delivered, bus time per drain and overflows."
+        )
+        info_label.setWordWrap(True)
+        info_label.setStyleSheet("padding: 15px; color: #666; font-size: 16pt;")
+        layout.addWidget(info_label)
+        
+        # Readings
+        readings_group = QGroupBox("Readings")
+        readings_group.setStyleSheet("font-size: 18pt; font-weight: bold; padding-top: 20px;")
+        grid = QGridLayout()
+        value_labels = {}
+        for row, (key, label, unit) in enumerate(AXES):
+            name_label = QLabel(label)
+            name_label.setStyleSheet("font-size: 16pt;")
+            value_label = QLabel(f"--- {unit}")
+            value_label.setStyleSheet("font-size: 16pt; font-family: monospace;")
+            grid.addWidget(name_label, row, 0)
+            grid.addWidget(value_label, row, 1)
+            value_labels[key] = (value_label, unit)
+        readings_group.setLayout(grid)
+        layout.addWidget(readings_group)
+        
+        status_label = QLabel("")
+        status_label.setWordWrap(True)
+        status_label.setStyleSheet("padding: 10px; font-size: 16pt;")
+        layout.addWidget(status_label)
+        
+        button_style = """
+            QPushButton {
+                background: qlineargradient(x1:0, y1:0, x2:0, y2:1,
+                    stop:0 #007bff, stop:1 #0056b3);
+                color: white;
+                border: none;
+                border-radius: 6px;
+                padding: 15px;
+                font-size: 16pt;
+                font-weight: bold;
+            }
+            QPushButton:pressed {
+                background: #004085;
+            }
+            QPushButton:checked {
+                background: #28a745;
+            }
+        """
+        live_timer = QTimer(widget)
+        live_timer.setInterval(200)
+        live_timer.timeout.connect(lambda: self._read_live(value_labels, status_label,
+                                                           live_timer))
+        
+        buttons = QHBoxLayout()
+        live_button = QPushButton("Live")
+        live_button.setCheckable(True)
+        live_button.toggled.connect(lambda on: live_timer.start() if on else live_timer.stop())
+        stream_button = QPushButton("Run Stream Test")
+        stream_button.clicked.connect(lambda: self._stream_test(stream_button, status_label))
+        for button in (live_button, stream_button):
+            button.setMinimumHeight(60)
+            button.setStyleSheet(button_style)
+            buttons.addWidget(button)
+        layout.addLayout(buttons)
+        
+        layout.addStretch()
+        widget.setLayout(layout)
+        return widget
+    
+    @staticmethod
+    def _show(status_label, text: str, ok: bool = True):
+        status_label.setText(text)
+        status_label.setStyleSheet(f"padding: 10px; font-size: 16pt; "
+                                   f"color: {'#28a745' if ok else '#dc3545'};")
+    
+    def _read_live(self, value_labels, status_label, timer):
+        stream = self._running_stream()
+        try:
+            if stream is not None:
+                # The stream owns the sensor; show what it published last
+                values = {key: stream.latest.get(f"{stream.name}_{key}")
+                          for key in value_labels}
+            else:
+                with self._open() as imu:
+                    values = imu.read_sample()
+        except Exception as e:
+            timer.stop()
+            self._show(status_label, f"✗ Read failed: {e}", ok=False)
+            return
+        for key, (label, unit) in value_labels.items():
+            value = values.get(key)
+            label.setText(f"{value:+9.3f} {unit}" if value is not None else f"--- {unit}")
+    
+    def _stream_test(self, button, status_label):
+        """Stream through the FIFO on a private bus for STREAM_TEST_MS, then report."""
+        from acquisition.bus import SampleBus
+        from acquisition.imu import IMUStream
+        
+        if self._running_stream() is not None:
+            self._show(status_label, "The panel is streaming this IMU already (see Info)",
+                       ok=False)
+            return
+        try:
+            self._stream = IMUStream(SampleBus(), self._open(), name=self.name.lower())
+            settings = self._stream.start()
+        except Exception as e:
+            self._stream = None
+            self._show(status_label, f"✗ Could not start the FIFO: {e}", ok=False)
+            return
+        button.setEnabled(False)
+        self._show(status_label, f"Streaming {settings['model']} at {settings['rate_hz']:g} Hz "
+                                 f"(DLPF {settings['dlpf_hz']} Hz)...")
+        QTimer.singleShot(STREAM_TEST_MS, lambda: self._finish_stream_test(button, status_label))
+    
+    def close(self):
+        """Stop a running stream test and close its bus handle."""
+        stream, self._stream = self._stream, None
+        if stream is not None:
+            stream.stop()
+            stream.imu.close()
+    
+    def _finish_stream_test(self, button, status_label):
+        stream, self._stream = self._stream, None
+        button.setEnabled(True)
+        if stream is None:
+            return
+        stream.stop()
+        stream.imu.close()
+        stats = stream.get_stats()
+        ok = stats["overflows"] == 0 and stats["read_errors"] == 0 and \
+            stats["achieved_hz"] >= 0.95 * stats["rate_hz"]
+        self._show(status_label,
+                   f"{'✓' if ok else '✗'} {stats['packets']} packets, {stats['achieved_hz']:.0f} Hz "
+                   f"of {stats['rate_hz']:g}, {stats['drains']} drains at "
+                   f"{stats['mean_read_ms']:.2f} ms each, FIFO peak "
+                   f"{stats['max_fill'] * 100:.0f} %, {stats['overflows']} overflows, "
+                   f"{stats['read_errors']} read errors, clock {stats['clock_ppm']:+.0f} ppm",
+                   ok=ok)
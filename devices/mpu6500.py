@@ -0,0 +1,12 @@
+"""MPU6500 / MPU9250 IMU plugin (register compatible with the MPU6050 plugin)."""
+
+from .mpu6050 import MPU6050Plugin
+
+
+class MPU6500Plugin(MPU6050Plugin):
+    """Plugin for the MPU6500 family (MPU6500, MPU9250, MPU9255 accel/gyro)."""
+    
+    name = "MPU6500"
+    description = "3-axis accelerometer + 3-axis gyroscope with 512-byte FIFO"
+    models = ("MPU6500", "MPU9250", "MPU9255")
+    datasheet = "https://invensense.tdk.com/wp-content/uploads/2015/02/MPU-6500-Register-Map2.pdf"
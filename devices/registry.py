@@ -27,8 +27,15 @@ DEVICE_REGISTRY: Dict[int, List[Tuple[str, str]]] = {
     0x18: [("MCP9808", "mcp9808")],
     0x19: [("MCP9808", "mcp9808")],
     
-    # HAT EEPROM
-    0x50: [("HAT EEPROM", None)],  # Pi internal, no plugin needed
+    # EEPROMs (0x50 is the HAT ID EEPROM; RTC modules carry a 24C32 at 0x57)
+    0x50: [("HAT EEPROM", "eeprom24cxx")],
+    0x51: [("24Cxx EEPROM", "eeprom24cxx")],
+    0x52: [("24Cxx EEPROM", "eeprom24cxx")],
+    0x53: [("24Cxx EEPROM", "eeprom24cxx")],
+    0x54: [("24Cxx EEPROM", "eeprom24cxx")],
+    0x55: [("24Cxx EEPROM", "eeprom24cxx")],
+    0x56: [("24Cxx EEPROM", "eeprom24cxx")],
+    0x57: [("24Cxx EEPROM", "eeprom24cxx")],
 }
 
 
@@ -0,0 +1,14 @@
+"""SH1106 OLED display plugin (1.3" 128x64 panels)."""
+
+from .ssd1306 import SSD1306Plugin
+
+
+class SH1106Plugin(SSD1306Plugin):
+    """Plugin for SH1106 OLED displays (page addressing, 132-column RAM at offset 2)."""
+    
+    name = "SH1106"
+    manufacturer = "Sino Wealth"
+    description = "128x64 OLED display (1.3\", 132-column controller RAM)"
+    datasheet = "https://www.pololu.com/file/0J1813/SH1106.pdf"
+    controller = "sh1106"
+    resolution = "128x64 pixels"
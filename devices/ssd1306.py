@@ -1,28 +1,31 @@
-"""SSD1306 OLED display plugin."""
+"""SSD1306 OLED display plugin (base of the SSD1309 and SH1106 plugins)."""
 
 import os
 from typing import Optional
 from PySide6.QtWidgets import (QWidget, QVBoxLayout, QHBoxLayout, QLabel, 
                                QPushButton, QTextEdit, QGroupBox, QFileDialog,
                                QListWidget, QListWidgetItem, QTabWidget)
-from PySide6.QtCore import Qt
+from PySide6.QtCore import Qt, QSize
 from PySide6.QtGui import QPixmap
 from .base import DevicePlugin
 
 
 class SSD1306Plugin(DevicePlugin):
-    """Plugin for SSD1306/SSD1309/SH1106 OLED displays."""
+    """Plugin for SSD1306 OLED displays; subclasses change the controller backend."""
     
     addresses = [0x3C, 0x3D]
     name = "SSD1306"
     manufacturer = "Solomon Systech"
     description = "128x64 or 128x32 OLED display"
+    datasheet = "https://cdn-shop.adafruit.com/datasheets/SSD1306.pdf"
+    controller = "ssd1306"  # hardware/display backend
+    resolution = "128x64 or 128x32 pixels"
     
     def detect(self) -> bool:
-        """Detect if SSD1306 is present."""
+        """Detect if a display answers (the controllers have no ID register)."""
         try:
-            import smbus2
-            bus = smbus2.SMBus(self.bus)
+            from hardware.i2c_bus import I2CBus
+            bus = I2CBus(self.bus)
             # Try to read from device (simple detection)
             bus.write_quick(self.address)
             bus.close()
@@ -34,15 +37,21 @@ class SSD1306Plugin(DevicePlugin):
         """Get device information."""
         info = super().get_info()
         info.update({
-            "resolution": "128x64 or 128x32 pixels",
+            "resolution": self.resolution,
             "interface": "I2C",
             "color": "Monochrome (white/blue)",
-            "datasheet": "https://cdn-shop.adafruit.com/datasheets/SSD1306.pdf",
+            "datasheet": self.datasheet,
         })
+        from hardware.display import find_display
+        display = find_display(self.bus, self.address)
+        if display is not None and display.name == self.name:
+            stats = display.get_stats()
+            info["updates"] = (f"{stats['updates']} ({stats['bytes']} bytes, last "
+                               f"{stats['last_bytes']} bytes in {stats['last_ms']:.1f} ms)")
         return info
     
     def get_test_ui(self) -> Optional[QWidget]:
-        """Get test interface for SSD1306."""
+        """Get test interface for the display."""
         widget = QWidget()
         widget.setMinimumHeight(900)  # Make window taller
         layout = QVBoxLayout()
@@ -50,7 +59,7 @@ class SSD1306Plugin(DevicePlugin):
         layout.setContentsMargins(20, 15, 20, 20)
         
         # Title
-        title = QLabel("SSD1306 OLED Display Test")
+        title = QLabel(f"{self.name} OLED Display Test")
         title.setStyleSheet("font-size: 22pt; font-weight: bold; padding: 15px;")
         layout.addWidget(title)
         
@@ -165,91 +174,29 @@ class SSD1306Plugin(DevicePlugin):
                 return
             
             try:
-                # Import required libraries
-                import board
-                import adafruit_ssd1306
-                from PIL import Image, ImageDraw, ImageFont
+                from hardware.oled import show_text
+                display = show_text(text, self.address, self.controller, self.bus)
                 
-                # Create I2C bus
-                i2c = board.I2C()
-                
-                # Create SSD1306 display instance
-                # Try 128x64 first, fallback to 128x32
-                try:
-                    display = adafruit_ssd1306.SSD1306_I2C(128, 64, i2c, addr=self.address)
-                except:
-                    display = adafruit_ssd1306.SSD1306_I2C(128, 32, i2c, addr=self.address)
-                
-                # Clear display
-                display.fill(0)
-                display.show()
-                
-                # Create image and draw text
-                width = display.width
-                height = display.height
-                image = Image.new('1', (width, height))
-                draw = ImageDraw.Draw(image)
-                
-                # Try to load a font, fallback to default
-                try:
-                    font = ImageFont.truetype("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", 12)
-                except:
-                    font = ImageFont.load_default()
-                
-                # Split text into lines and draw
-                lines = text.split('\n')
-                y_offset = 0
-                line_height = 12
-                
-                for line in lines:
-                    if y_offset + line_height > height:
-                        break
-                    # Wrap long lines
-                    words = line.split(' ')
-                    current_line = ""
-                    for word in words:
-                        test_line = current_line + (" " if current_line else "") + word
-                        bbox = draw.textbbox((0, 0), test_line, font=font)
-                        if bbox[2] - bbox[0] <= width:
-                            current_line = test_line
-                        else:
-                            if current_line:
-                                draw.text((0, y_offset), current_line, font=font, fill=255)
-                                y_offset += line_height
-                                if y_offset + line_height > height:
-                                    break
-                            current_line = word
-                    if current_line and y_offset + line_height <= height:
-                        draw.text((0, y_offset), current_line, font=font, fill=255)
-                        y_offset += line_height
-                
-                # Display the image
-                display.image(image)
-                display.show()
-                
-                status_label.setText(f"✓ Text displayed successfully!")
+                status_label.setText(f"✓ Text displayed successfully! "
+                                     f"({display.stats['last_bytes']} bytes sent)")
                 status_label.setStyleSheet("padding: 10px; font-size: 14pt; color: #28a745; font-weight: bold;")
                 
             except ImportError as e:
                 # Library not available - provide detailed error
                 import sys
                 error_details = str(e)
-                missing_lib = "adafruit-ssd1306"
-                if "adafruit" in error_details.lower():
-                    missing_lib = "adafruit-circuitpython-ssd1306"
-                elif "PIL" in error_details or "Image" in error_details:
+                missing_lib = "smbus2"
+                if "PIL" in error_details or "Image" in error_details:
                     missing_lib = "pillow"
                 
                 error_msg = f"⚠ Library not found: {missing_lib}\n\n"
                 error_msg += f"Error: {error_details}\n\n"
                 error_msg += f"Install with:\n"
                 error_msg += f"pip3 install --break-system-packages {missing_lib}"
-                if missing_lib == "adafruit-circuitpython-ssd1306":
-                    error_msg += " pillow"
                 
                 status_label.setText(error_msg)
                 status_label.setStyleSheet("padding: 10px; font-size: 12pt; color: #ffc107; font-weight: bold;")
-                print(f"SSD1306 import error: {e}", file=sys.stderr)
+                print(f"{self.name} import error: {e}", file=sys.stderr)
                 import traceback
                 traceback.print_exc(file=sys.stderr)
             except Exception as e:
@@ -258,7 +205,7 @@ class SSD1306Plugin(DevicePlugin):
                 status_label.setText(f"✗ Error: {error_msg}")
                 status_label.setStyleSheet("padding: 10px; font-size: 14pt; color: #dc3545; font-weight: bold;")
                 import traceback
-                print(f"SSD1306 display error: {e}", file=__import__('sys').stderr)
+                print(f"{self.name} display error: {e}", file=__import__('sys').stderr)
                 traceback.print_exc()
         
         display_button.clicked.connect(display_text)
@@ -315,14 +262,38 @@ class SSD1306Plugin(DevicePlugin):
             }
         """)
         
-        # Load sample images from devices/ssd1306_samples directory
+        # Load sample images from devices/ssd1306_samples directory; names show
+        # right away, thumbnails are decoded once in the background and cached
+        from ui.thumbnails import get_thumbnails
+        thumbnails = get_thumbnails()
+        sample_list.setIconSize(QSize(thumbnails.size // 2, thumbnails.size // 2))
+        waiting = {}  # path -> item still without its thumbnail
         samples_dir = os.path.join(os.path.dirname(__file__), 'ssd1306_samples')
         if os.path.exists(samples_dir):
             for filename in sorted(os.listdir(samples_dir)):
                 if filename.lower().endswith(('.png', '.jpg', '.jpeg', '.bmp')):
                     item = QListWidgetItem(filename)
+                    path = os.path.join(samples_dir, filename)
+                    icon = thumbnails.request(path)
+                    if icon is not None:
+                        item.setIcon(icon)
+                    else:
+                        waiting[path] = item
                     sample_list.addItem(item)
         
+        def on_thumbnail(path, icon):
+            item = waiting.pop(path, None)
+            try:
+                if item is not None:
+                    item.setIcon(icon)
+            except RuntimeError:
+                waiting.clear()  # List already deleted
+            if not waiting:
+                thumbnails.ready.disconnect(on_thumbnail)
+        
+        if waiting:
+            thumbnails.ready.connect(on_thumbnail)
+        
         if sample_list.count() == 0:
             no_samples = QLabel("No sample images found.\nAdd images to devices/ssd1306_samples/")
             no_samples.setStyleSheet("padding: 10px; color: #666; font-size: 12pt;")
@@ -423,66 +394,30 @@ class SSD1306Plugin(DevicePlugin):
                 return
             
             try:
-                import board
-                import adafruit_ssd1306
-                from PIL import Image, ImageOps
-                
-                # Create I2C bus
-                i2c = board.I2C()
-                
-                # Create SSD1306 display instance
-                # Try 128x64 first, fallback to 128x32
-                try:
-                    display = adafruit_ssd1306.SSD1306_I2C(128, 64, i2c, addr=self.address)
-                    display_width, display_height = 128, 64
-                except:
-                    display = adafruit_ssd1306.SSD1306_I2C(128, 32, i2c, addr=self.address)
-                    display_width, display_height = 128, 32
-                
-                # Load and process image
-                img = Image.open(image_path)
-                original_size = f"{img.width}x{img.height}"
-                
-                # Convert to grayscale if needed
-                if img.mode != 'L':
-                    img = img.convert('L')
-                
-                # Resize to fit display (maintain aspect ratio, crop to fit)
-                img.thumbnail((display_width, display_height), Image.Resampling.LANCZOS)
-                resized_size = f"{img.width}x{img.height}"
-                
-                # Create a new image with exact display size
-                display_img = Image.new('1', (display_width, display_height), 0)
-                
-                # Calculate position to center the image
-                x_offset = (display_width - img.width) // 2
-                y_offset = (display_height - img.height) // 2
-                
-                # Paste the resized image onto the display image
-                # Convert to 1-bit using threshold (128)
-                img_1bit = img.point(lambda x: 255 if x > 128 else 0, mode='1')
-                display_img.paste(img_1bit, (x_offset, y_offset))
-                
-                # Display the image
-                display.image(display_img)
-                display.show()
+                from hardware.oled import show_image
+                display, original, resized = show_image(image_path, self.address,
+                                                        self.controller, self.bus)
+                original_size = f"{original[0]}x{original[1]}"
+                resized_size = f"{resized[0]}x{resized[1]}"
+                display_width, display_height = display.width, display.height
                 
                 filename = os.path.basename(image_path)
-                status_msg = f"✓ Image displayed successfully!\n"
+                status_msg = (f"✓ Image displayed successfully! "
+                              f"({display.stats['last_bytes']} bytes sent)\n")
                 status_msg += f"Original: {original_size} → Display: {resized_size} ({display_width}x{display_height})"
                 status_label.setText(status_msg)
                 status_label.setStyleSheet("padding: 10px; font-size: 12pt; color: #28a745; font-weight: bold;")
                 
             except ImportError as e:
-                missing_lib = str(e).split("'")[1] if "'" in str(e) else "adafruit-ssd1306"
-                status_label.setText(f"⚠ Library not installed: {missing_lib}\nInstall with: pip3 install adafruit-circuitpython-ssd1306 pillow")
+                missing_lib = str(e).split("'")[1] if "'" in str(e) else "smbus2"
+                status_label.setText(f"⚠ Library not installed: {missing_lib}\nInstall with: pip3 install smbus2 pillow")
                 status_label.setStyleSheet("padding: 10px; font-size: 12pt; color: #ffc107; font-weight: bold;")
             except Exception as e:
                 error_msg = str(e)[:50]
                 status_label.setText(f"✗ Error: {error_msg}")
                 status_label.setStyleSheet("padding: 10px; font-size: 14pt; color: #dc3545; font-weight: bold;")
                 import traceback
-                print(f"SSD1306 image display error: {e}", file=__import__('sys').stderr)
+                print(f"{self.name} image display error: {e}", file=__import__('sys').stderr)
                 traceback.print_exc()
         
         # Connect signals
@@ -0,0 +1,13 @@
+"""SSD1309 OLED display plugin (2.42" 128x64 panels)."""
+
+from .ssd1306 import SSD1306Plugin
+
+
+class SSD1309Plugin(SSD1306Plugin):
+    """Plugin for SSD1309 OLED displays (SSD1306 addressing, external-VCC panel setup)."""
+    
+    name = "SSD1309"
+    description = "128x64 OLED display (2.42\", external VCC)"
+    datasheet = "https://www.hpinfotech.ro/SSD1309.pdf"
+    controller = "ssd1309"
+    resolution = "128x64 pixels"
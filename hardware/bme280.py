@@ -0,0 +1,333 @@
+"""BMP280 / BME280 pressure (and humidity) sensors: settings, burst reads, compensation.
+
+No Qt and no threads here; acquisition/pressure.py polls any number of these
+and the bmp280/bme280 plugins use them directly.
+
+    calibration  the trimming block (0x88-0xA1, plus 0xE1-0xE7 on the BME280)
+                 is read once and cached per (bus, address, chip ID), so
+                 reopening a sensor - a device tab, a restarted poller -
+                 costs only the ID read
+    data         all measurement registers (0xF7-0xFC, up to 0xFE with
+                 humidity) in one burst; the datasheet requires a burst so the
+                 pressure/temperature/humidity bytes belong to one measurement
+    settings     choose_settings() picks the highest oversampling whose
+                 worst-case measurement time fits the requested period, and in
+                 normal mode the longest standby that still keeps up with it
+    compensate   Bosch's integer formulas (32-bit temperature and humidity,
+                 64-bit pressure) over NumPy int64 arrays, so a block of
+                 samples - or one sample of every sensor, with the
+                 calibrations stacked into arrays - is compensated in one pass
+"""
+
+import struct
+from typing import Dict, List, NamedTuple, Optional, Sequence, Tuple
+
+from hardware.i2c_bus import I2CDevice
+
+# Registers
+CALIB_00 = 0x88
+CALIB_26 = 0xE1
+CHIP_ID = 0xD0
+RESET = 0xE0
+CTRL_HUM = 0xF2
+STATUS = 0xF3
+CTRL_MEAS = 0xF4
+CONFIG = 0xF5
+DATA = 0xF7
+
+CHIP_IDS = {0x56: "BMP280", 0x57: "BMP280", 0x58: "BMP280", 0x60: "BME280"}
+
+MODE_SLEEP, MODE_FORCED, MODE_NORMAL = 0, 1, 3
+
+# Oversampling factors in register order (0 = measurement skipped)
+OVERSAMPLING = (0, 1, 2, 4, 8, 16)
+
+# Standby time (ms) in register order; the BME280 replaced the two longest ones
+STANDBY_MS = {"BMP280": (0.5, 62.5, 125, 250, 500, 1000, 2000, 4000),
+              "BME280": (0.5, 62.5, 125, 250, 500, 1000, 10, 20)}
+
+# IIR filter coefficients in register order
+FILTER = (0, 2, 4, 8, 16)
+
+# (pressure, temperature, humidity) oversampling, best first; the datasheet's
+# recommendations from indoor navigation down to the fastest setting
+PROFILES = ((16, 2, 1), (8, 1, 1), (4, 1, 1), (2, 1, 1), (1, 1, 1))
+
+# Share of the poll period a forced measurement may take (the rest is bus and
+# scheduling slack, so the measurement is always done when the next poll reads it)
+FORCED_MARGIN = 0.8
+
+# Raw value of a skipped measurement
+SKIPPED = 0x80000
+
+_CALIBRATION = struct.Struct("<HhhHhhhhhhhhBB")
+
+
+class SensorError(OSError):
+    """Not a BMP280/BME280."""
+
+
+class Calibration(NamedTuple):
+    """Trimming parameters; fields are ints, or arrays with one entry per sensor."""
+    T1: object
+    T2: object
+    T3: object
+    P1: object
+    P2: object
+    P3: object
+    P4: object
+    P5: object
+    P6: object
+    P7: object
+    P8: object
+    P9: object
+    H1: object = 0
+    H2: object = 0
+    H3: object = 0
+    H4: object = 0
+    H5: object = 0
+    H6: object = 0
+
+
+class Settings(NamedTuple):
+    mode: str              # "forced" or "normal"
+    osrs_p: int            # Oversampling factors (0 = skipped)
+    osrs_t: int
+    osrs_h: int
+    standby_ms: float      # Normal mode only
+    iir: int               # Filter coefficient (0 = off)
+    measurement_ms: float  # Worst case per measurement
+    output_hz: float       # Measurements per second the sensor makes
+
+
+def measurement_ms(osrs_p: int, osrs_t: int, osrs_h: int) -> float:
+    """Maximum measurement time (datasheet 9.1)."""
+    t = 1.25 + 2.3 * osrs_t
+    if osrs_p:
+        t += 2.3 * osrs_p + 0.575
+    if osrs_h:
+        t += 2.3 * osrs_h + 0.575
+    return t
+
+
+def choose_settings(model: str, rate_hz: float, mode: str = "forced", iir: int = 0) -> Settings:
+    """Best oversampling (and standby) for polling at rate_hz.
+
+    Raises:
+        ValueError: Unknown mode or filter coefficient
+    """
+    if mode not in ("forced", "normal"):
+        raise ValueError(f"Mode must be 'forced' or 'normal', not {mode!r}")
+    if iir not in FILTER:
+        raise ValueError(f"IIR coefficient must be one of {FILTER}")
+    period_ms = 1000.0 / rate_hz
+    humidity = model == "BME280"
+    for osrs_p, osrs_t, osrs_h in PROFILES:
+        osrs_h = osrs_h if humidity else 0
+        meas = measurement_ms(osrs_p, osrs_t, osrs_h)
+        if meas <= period_ms * FORCED_MARGIN:
+            break
+    if mode == "forced":
+        return Settings(mode, osrs_p, osrs_t, osrs_h, 0.5, iir, meas,
+                        min(rate_hz, 1000.0 / meas))
+    # Normal mode: the longest standby that still delivers a new value every period
+    standby = max((sb for sb in STANDBY_MS[model] if meas + sb <= period_ms), default=0.5)
+    return Settings(mode, osrs_p, osrs_t, osrs_h, standby, iir, meas,
+                    1000.0 / (meas + standby))
+
+
+def stack(calibrations: Sequence[Calibration]) -> Calibration:
+    """One Calibration of int64 arrays (one entry per sensor) for compensate()."""
+    import numpy as np
+    return Calibration(*(np.array(values, dtype=np.int64) for values in zip(*calibrations)))
+
+
+def decode(data):
+    """Burst bytes -> (adc_p, adc_t, adc_h) int64 arrays.
+
+    Args:
+        data: One burst (6 or 8 bytes) or an (n, 6|8) uint8 array of bursts
+    """
+    import numpy as np
+    if isinstance(data, (bytes, bytearray)):
+        data = np.frombuffer(data, dtype=np.uint8)
+    raw = np.asarray(data, dtype=np.uint8)
+    raw = raw.reshape(-1, raw.shape[-1]).astype(np.int64)
+    adc_p = (raw[:, 0] << 12) | (raw[:, 1] << 4) | (raw[:, 2] >> 4)
+    adc_t = (raw[:, 3] << 12) | (raw[:, 4] << 4) | (raw[:, 5] >> 4)
+    adc_h = (raw[:, 6] << 8) | raw[:, 7] if raw.shape[1] >= 8 else None
+    return adc_p, adc_t, adc_h
+
+
+def compensate(cal: Calibration, adc_p, adc_t, adc_h=None):
+    """Bosch integer compensation, vectorized (datasheet 4.2.3 / 8.2).
+
+    Calibration fields and raw values broadcast against each other: a block
+    of samples from one sensor, or one sample per sensor with a stack()ed
+    calibration.
+
+    Returns:
+        (temperature degC, pressure hPa, humidity % or None) float arrays
+    """
+    import numpy as np
+    adc_t = np.asarray(adc_t, dtype=np.int64)
+    adc_p = np.asarray(adc_p, dtype=np.int64)
+    
+    # Temperature (BME280_compensate_T_int32), t_fine feeds the other two
+    var1 = (((adc_t >> 3) - (cal.T1 << 1)) * cal.T2) >> 11
+    d = (adc_t >> 4) - cal.T1
+    var2 = (((d * d) >> 12) * cal.T3) >> 14
+    t_fine = var1 + var2
+    temperature = ((t_fine * 5 + 128) >> 8) / 100.0
+    
+    # Pressure (BME280_compensate_P_int64), Pa in Q24.8
+    var1 = t_fine - 128000
+    var2 = var1 * var1 * cal.P6
+    var2 = var2 + ((var1 * cal.P5) << 17)
+    var2 = var2 + (np.int64(cal.P4) << 35)
+    var1 = ((var1 * var1 * cal.P3) >> 8) + ((var1 * cal.P2) << 12)
+    var1 = (((np.int64(1) << 47) + var1) * cal.P1) >> 33
+    p = 1048576 - adc_p
+    valid = (var1 != 0) & (adc_p != SKIPPED)
+    divisor = np.where(var1 != 0, var1, 1)
+    p = (((p << 31) - var2) * 3125) // divisor  # var1 > 0 for any real calibration
+    var1 = (cal.P9 * (p >> 13) * (p >> 13)) >> 25
+    var2 = (cal.P8 * p) >> 19
+    p = ((p + var1 + var2) >> 8) + (np.int64(cal.P7) << 4)
+    pressure = np.where(valid, p / 25600.0, np.nan)
+    
+    if adc_h is None:
+        return temperature, pressure, None
+    # Humidity (bme280_compensate_H_int32), %RH in Q22.10
+    adc_h = np.asarray(adc_h, dtype=np.int64)
+    v = t_fine - 76800
+    v = ((((adc_h << 14) - (np.int64(cal.H4) << 20) - cal.H5 * v) + 16384) >> 15) * \
+        (((((((v * cal.H6) >> 10) * (((v * cal.H3) >> 11) + 32768)) >> 10) + 2097152) *
+         cal.H2 + 8192) >> 14)
+    v = v - (((((v >> 15) * (v >> 15)) >> 7) * cal.H1) >> 4)
+    v = np.clip(v, 0, 419430400)
+    humidity = np.where(adc_h != 0x8000, (v >> 12) / 1024.0, np.nan)
+    return temperature, pressure, humidity
+
+
+# (bus, address, chip ID) -> Calibration
+_calibration_cache: Dict[Tuple[object, int, int], Calibration] = {}
+
+
+class BME280:
+    """One BMP280 or BME280 (the BMP280 simply has no humidity)."""
+    
+    def __init__(self, bus, address: int = 0x76, device=None, reload: bool = False):
+        """Identify the sensor and load its calibration (cached).
+
+        Args:
+            bus: I2C bus number or shared I2CBus
+            address: 0x76, or 0x77 with SDO high
+            device: Register access object (default I2CDevice)
+            reload: Read the calibration even if cached (sensor swapped)
+
+        Raises:
+            SensorError: Chip ID is not a BMP280/BME280
+            ImportError: smbus2 not installed
+            OSError: Bus not accessible or nothing at the address
+        """
+        self.device = device if device is not None else I2CDevice(bus, address)
+        self.address = address
+        self.bus_number = getattr(bus, "bus", bus)
+        self.chip_id = self.device.read_register(CHIP_ID)
+        if self.chip_id not in CHIP_IDS:
+            raise SensorError(f"0x{address:02X} is not a BMP280/BME280 "
+                              f"(chip ID 0x{self.chip_id:02X})")
+        self.model = CHIP_IDS[self.chip_id]
+        self.humidity = self.model == "BME280"
+        self.burst = 8 if self.humidity else 6
+        self.settings: Optional[Settings] = None
+        key = (self.bus_number, address, self.chip_id)
+        calibration = None if reload else _calibration_cache.get(key)
+        if calibration is None:
+            calibration = _calibration_cache[key] = self._read_calibration()
+        self.calibration = calibration
+    
+    def _read_calibration(self) -> Calibration:
+        values = list(_CALIBRATION.unpack(self.device.read_registers(CALIB_00, 26)))
+        values.pop(12)  # 0xA0 is unused
+        if not self.humidity:
+            return Calibration(*values[:12])
+        h = self.device.read_registers(CALIB_26, 7)
+        signed = lambda b: b - 256 if b & 0x80 else b
+        h2 = struct.unpack("<h", h[0:2])[0]
+        h4 = (signed(h[3]) << 4) | (h[4] & 0x0F)
+        h5 = (signed(h[5]) << 4) | (h[4] >> 4)
+        return Calibration(*values[:12], values[12], h2, h[2], h4, h5, signed(h[6]))
+    
+    def close(self):
+        if hasattr(self.device, "close"):
+            self.device.close()
+    
+    def __enter__(self):
+        return self
+    
+    def __exit__(self, *exc):
+        self.close()
+    
+    def configure(self, settings: Settings):
+        """Apply settings; in forced mode the sensor sleeps until trigger()."""
+        dev = self.device
+        # CONFIG is only written reliably in sleep mode
+        dev.write_register(CTRL_MEAS, MODE_SLEEP)
+        dev.write_register(CONFIG, (STANDBY_MS[self.model].index(settings.standby_ms) << 5)
+                           | (FILTER.index(settings.iir) << 2))
+        if self.humidity:
+            # Takes effect with the next CTRL_MEAS write
+            dev.write_register(CTRL_HUM, OVERSAMPLING.index(settings.osrs_h))
+        self._ctrl_meas = (OVERSAMPLING.index(settings.osrs_t) << 5) | \
+                          (OVERSAMPLING.index(settings.osrs_p) << 2)
+        if settings.mode == "normal":
+            dev.write_register(CTRL_MEAS, self._ctrl_meas | MODE_NORMAL)
+        self.settings = settings
+    
+    def trigger(self):
+        """Start one forced-mode measurement (one byte write)."""
+        self.device.write_register(CTRL_MEAS, self._ctrl_meas | MODE_FORCED)
+    
+    def read_raw(self) -> bytes:
+        """All measurement registers in one burst."""
+        return self.device.read_registers(DATA, self.burst)
+    
+    def read(self) -> Dict[str, float]:
+        """One measurement now (forced mode unless running in normal mode)."""
+        import time
+        
+        if self.settings is None:
+            self.configure(choose_settings(self.model, 1.0))
+        if self.settings.mode == "forced":
+            self.trigger()
+            time.sleep(self.settings.measurement_ms / 1000.0)
+        temperature, pressure, humidity = compensate(self.calibration,
+                                                     *decode(self.read_raw()))
+        reading = {"temperature": float(temperature[0]), "pressure": float(pressure[0])}
+        if humidity is not None:
+            reading["humidity"] = float(humidity[0])
+        return reading
+
+
+def open_all(specs: List[dict]) -> List[Tuple[dict, BME280]]:
+    """Open sensors for a list of {"bus", "address"} specs, one I2CBus per bus number.
+
+    Sensors that are missing or not a BMP280/BME280 are reported and skipped.
+    """
+    import sys
+    from hardware.i2c_bus import I2CBus
+    
+    buses: Dict[int, I2CBus] = {}
+    sensors = []
+    for spec in specs:
+        address = spec.get("address", 0x76)
+        try:
+            if spec["bus"] not in buses:
+                buses[spec["bus"]] = I2CBus(spec["bus"])
+            sensors.append((spec, BME280(buses[spec["bus"]], address)))
+        except (ImportError, OSError) as e:
+            print(f"Pressure sensor {spec['bus']}:0x{address:02X} disabled: {e}",
+                  file=sys.stderr)
+    return sensors
@@ -0,0 +1,86 @@
+"""Monochrome OLED display engine: one framebuffer layer, controller-specific backends.
+
+    framebuffer.py  page-organized shadow framebuffer, dirty spans, glyph
+                    cache and blits (shared by every backend)
+    base.py         I2C framing, shadow of the panel RAM, partial updates
+    ssd1306.py      SSD1306: horizontal addressing, rectangles of pages
+    ssd1309.py      SSD1309: SSD1306 addressing, external-VCC panel setup
+    sh1106.py       SH1106: page addressing, 132-column RAM at offset 2
+
+No Qt here; PIL is only imported for text and images.
+"""
+
+from typing import Dict, Optional, Tuple
+
+from config.device_config import OLED_CONTROLLER, OLED_HEIGHT
+
+from .base import DisplayController
+from .framebuffer import Bitmap, Font, Framebuffer
+
+# Controller name -> (module, class)
+CONTROLLERS = {
+    "ssd1306": ("hardware.display.ssd1306", "SSD1306"),
+    "ssd1309": ("hardware.display.ssd1309", "SSD1309"),
+    "sh1106": ("hardware.display.sh1106", "SH1106"),
+}
+
+# Open displays by (bus, address); kept so the shadow of the panel RAM survives
+# between calls and repeated updates stay partial
+_displays: Dict[Tuple[int, int], DisplayController] = {}
+
+
+def controller_class(controller: str):
+    """Backend class for a controller name.
+
+    Raises:
+        ValueError: Unknown controller
+    """
+    import importlib
+    
+    try:
+        module, name = CONTROLLERS[controller.lower()]
+    except KeyError:
+        raise ValueError(f"Unknown OLED controller {controller!r} "
+                         f"(one of {', '.join(CONTROLLERS)})") from None
+    return getattr(importlib.import_module(module), name)
+
+
+def find_display(bus: int, address: int) -> Optional[DisplayController]:
+    """The display open_display() has open at (bus, address), if any."""
+    return _displays.get((bus, address))
+
+
+def open_display(address: int = 0x3C, controller: str = OLED_CONTROLLER,
+                 bus: Optional[int] = None, height: int = OLED_HEIGHT,
+                 device=None) -> DisplayController:
+    """Open (or reuse) the display at address.
+
+    A display already open with the same controller is returned as is; a
+    different controller reinitializes it.
+
+    Args:
+        address: I2C address (0x3C or 0x3D)
+        controller: "ssd1306", "ssd1309" or "sh1106"
+        bus: I2C bus number (default: I2C_BUS, or 1 when auto-detected)
+        height: Panel rows (64 or 32)
+        device: Object with write(bytes), e.g. a VirtualOLED (not cached)
+
+    Raises:
+        ValueError: Unknown controller
+        ImportError: smbus2 not installed
+        OSError: Bus not accessible
+    """
+    cls = controller_class(controller)
+    if device is not None:
+        return cls(128, height, address, bus, device=device)
+    if bus is None:
+        from config.pins import I2C_BUS
+        bus = 1 if I2C_BUS is None else I2C_BUS
+    key = (bus, address)
+    display = _displays.get(key)
+    if display is None or type(display) is not cls or display.height != height:
+        if display is not None:
+            display.close()
+        display = _displays[key] = cls(128, height, address, bus)
+    return display
+
@@ -0,0 +1,209 @@
+"""Controller backend base: I2C control-byte protocol, shadow of the panel RAM, update planning.
+
+Every supported controller takes the same I2C framing: a control byte
+0x00 before a command stream, 0x40 before display data, and 0x80 before
+a single command followed by another control byte. A region update is
+therefore one I2C write: its addressing commands, each as 0x80 + command,
+then 0x40 and the data. No write is longer than max_message (the bus's
+MAX_MESSAGE_BYTES), so a full frame never runs into the adapter timeout at
+100 kHz; SSD1306-style backends stop merging pages at that size.
+
+The backend keeps a shadow of what the panel RAM holds. show() takes the
+framebuffer's dirty spans, trims each against the shadow to the columns
+that really changed, and asks the controller how to cover them
+(plan_regions()); only those bytes go out. Until the first full update
+the RAM contents are unknown, so the first show() sends everything.
+"""
+
+import time
+from typing import List, Optional, Tuple
+
+from hardware.i2c_bus import MAX_MESSAGE_BYTES
+
+from .framebuffer import Framebuffer, changed_span
+
+CONTROL_COMMANDS = 0x00
+CONTROL_COMMAND = 0x80  # One command, another control byte follows
+CONTROL_DATA = 0x40
+
+# Fixed cost of a transaction in byte times (address byte + ioctl overhead at 400 kHz)
+TRANSACTION_BYTES = 3
+
+
+class I2CWriter:
+    """Plain I2C writes to one address (one message per call, no 32-byte SMBus limit)."""
+    
+    def __init__(self, bus, address: int):
+        """Open the bus (or share an open I2CBus).
+
+        Raises:
+            ImportError: smbus2 not installed
+            OSError: Device node missing or not accessible
+        """
+        from hardware.i2c_bus import I2CBus
+        
+        self._owned = not isinstance(bus, I2CBus)
+        self.bus = I2CBus(bus) if self._owned else bus
+        self.address = address
+    
+    def write(self, data: bytes):
+        from smbus2 import i2c_msg
+        
+        self.bus.i2c_rdwr(i2c_msg.write(self.address, data))
+    
+    def close(self):
+        if self._owned:
+            self.bus.close()
+
+
+class DisplayController:
+    """Page-organized monochrome OLED controller on I2C (subclasses give the commands)."""
+    
+    name = ""
+    ram_width = 128  # Columns of display RAM
+    column_offset = 0  # RAM column of the panel's first visible column
+    max_message = MAX_MESSAGE_BYTES  # Longest region write (control bytes included)
+    
+    def __init__(self, width: int = 128, height: int = 64, address: int = 0x3C, bus=1,
+                 device=None):
+        """Initialize the controller and clear nothing (the first show() is a full update).
+
+        Args:
+            width: Visible columns
+            height: Visible rows (32 or 64)
+            address: I2C address (0x3C or 0x3D)
+            bus: I2C bus number or shared I2CBus
+            device: Object with write(bytes) (default I2CWriter on bus/address)
+
+        Raises:
+            ImportError: smbus2 not installed
+            OSError: Bus not accessible or nothing at the address
+        """
+        self.width = width
+        self.height = height
+        self.address = address
+        self.bus_number = getattr(bus, "bus", bus)
+        self.framebuffer = Framebuffer(width, height)
+        self.device = device if device is not None else I2CWriter(bus, address)
+        self._shadow: Optional[bytearray] = None
+        self.stats = {"updates": 0, "regions": 0, "bytes": 0, "update_s": 0.0,
+                      "last_bytes": 0, "last_ms": 0.0, "max_write_bytes": 0}
+        self.command(*self.init_sequence())
+    
+    def init_sequence(self) -> Tuple[int, ...]:
+        raise NotImplementedError
+    
+    def region_commands(self, page0: int, page1: int, x0: int, x1: int) -> Tuple[int, ...]:
+        """Commands that point the RAM write at columns [x0, x1) of pages page0..page1."""
+        raise NotImplementedError
+    
+    def plan_regions(self, spans: List[Tuple[int, int, int]]) -> List[Tuple[int, int, int, int]]:
+        """(page0, page1, x0, x1) rectangles covering the changed spans.
+
+        Page addressing can only write within one page, so the default is one
+        region per span.
+        """
+        return [(page, page, x0, x1) for page, x0, x1 in spans]
+    
+    def region_bytes(self, page0: int, page1: int, x0: int, x1: int) -> int:
+        """Length of the I2C write for one region."""
+        commands = len(self.region_commands(page0, page1, x0, x1))
+        return 2 * commands + 1 + (page1 - page0 + 1) * (x1 - x0)
+    
+    def region_cost(self, page0: int, page1: int, x0: int, x1: int) -> int:
+        """Bus cost of one region update in byte times."""
+        return TRANSACTION_BYTES + self.region_bytes(page0, page1, x0, x1)
+    
+    # Transport -------------------------------------------------------------------
+    
+    def command(self, *commands: int):
+        """Send a command stream in one write."""
+        self.device.write(bytes((CONTROL_COMMANDS,) + commands))
+    
+    def _write_region(self, page0: int, page1: int, x0: int, x1: int) -> int:
+        buffer, width = self.framebuffer.buffer, self.width
+        message = bytearray()
+        for command in self.region_commands(page0, page1, x0, x1):
+            message += bytes((CONTROL_COMMAND, command))
+        message.append(CONTROL_DATA)
+        for page in range(page0, page1 + 1):
+            message += buffer[page * width + x0:page * width + x1]
+        self.device.write(bytes(message))
+        if len(message) > self.stats["max_write_bytes"]:
+            self.stats["max_write_bytes"] = len(message)
+        return len(message)
+    
+    # adafruit_ssd1306-compatible surface ---------------------------------------
+    
+    @property
+    def buffer(self) -> bytearray:
+        return self.framebuffer.buffer
+    
+    def fill(self, color: int):
+        self.framebuffer.fill(color)
+    
+    def image(self, image):
+        self.framebuffer.image(image)
+    
+    def show(self, full: bool = False) -> int:
+        """Send what changed since the last show() (everything with full); returns bytes sent."""
+        framebuffer = self.framebuffer
+        width = self.width
+        start = time.monotonic()
+        spans = framebuffer.take_dirty()
+        if full or self._shadow is None:
+            spans = [(page, 0, width) for page in range(framebuffer.pages)]
+            self._shadow = bytearray(len(framebuffer.buffer))
+            trimmed = spans
+        else:
+            trimmed = []
+            buffer, shadow = framebuffer.buffer, self._shadow
+            for page, x0, x1 in spans:
+                base = page * width
+                span = changed_span(buffer[base + x0:base + x1], shadow[base + x0:base + x1])
+                if span is not None:
+                    trimmed.append((page, x0 + span[0], x0 + span[1]))
+        sent = 0
+        regions = self.plan_regions(trimmed)
+        for page0, page1, x0, x1 in regions:
+            sent += self._write_region(page0, page1, x0, x1)
+            for page in range(page0, page1 + 1):
+                base = page * width
+                self._shadow[base + x0:base + x1] = framebuffer.buffer[base + x0:base + x1]
+        elapsed = time.monotonic() - start
+        stats = self.stats
+        stats["updates"] += 1
+        stats["regions"] += len(regions)
+        stats["bytes"] += sent
+        stats["update_s"] += elapsed
+        stats["last_bytes"] = sent
+        stats["last_ms"] = elapsed * 1000.0
+        return sent
+    
+    # Panel controls ------------------------------------------------------------
+    
+    def contrast(self, value: int):
+        self.command(0x81, value & 0xFF)
+    
+    def power(self, on: bool):
+        self.command(0xAF if on else 0xAE)
+    
+    def invert(self, on: bool):
+        self.command(0xA7 if on else 0xA6)
+    
+    def close(self):
+        if hasattr(self.device, "close"):
+            self.device.close()
+    
+    def __enter__(self):
+        return self
+    
+    def __exit__(self, *exc):
+        self.close()
+    
+    def get_stats(self) -> dict:
+        stats = dict(self.stats)
+        updates = max(1, stats["updates"])
+        stats["mean_ms"] = stats.pop("update_s") / updates * 1000.0
+        stats["controller"] = self.name
+        return stats
@@ -0,0 +1,229 @@
+"""Shadow framebuffer, dirty regions and the glyph/blit layer shared by all OLED backends.
+
+The buffer uses the layout of the controllers' display RAM: one byte per
+column per page of 8 rows, least significant bit at the top, pages in
+order. A controller backend can send any run of a page straight from it.
+
+Drawing marks what it touched as dirty, as one column span per page.
+take_dirty() hands the spans to the backend, which trims them further
+against what it last sent (changed_span()), so redrawing an unchanged
+line costs no bus time.
+
+Text is drawn from glyph bitmaps rendered once per (font, character) with
+PIL and kept as column bitmaps; drawing a glyph is then a blit of a few
+integers, not a PIL render.
+"""
+
+from typing import Dict, List, Optional, Tuple
+
+FONT_PATH = "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf"
+
+# Bit-reverse table: PIL packs the top pixel in the MSB, display RAM in the LSB
+_REVERSE = bytes(int(f"{i:08b}"[::-1], 2) for i in range(256))
+
+
+def changed_span(a: bytes, b: bytes) -> Optional[Tuple[int, int]]:
+    """First and past-last index where two equal-length byte strings differ (None if equal)."""
+    if a == b:
+        return None
+    diff = int.from_bytes(a, "little") ^ int.from_bytes(b, "little")
+    return ((diff & -diff).bit_length() - 1) >> 3, ((diff.bit_length() - 1) >> 3) + 1
+
+
+class Bitmap:
+    """1-bit image stored as one integer per column (bit i = row i)."""
+    
+    __slots__ = ("width", "height", "columns")
+    
+    def __init__(self, width: int, height: int, columns: List[int]):
+        self.width = width
+        self.height = height
+        self.columns = columns
+    
+    @classmethod
+    def from_image(cls, image) -> "Bitmap":
+        """From a PIL image (any mode; nonzero pixels are on)."""
+        image = image.convert("1")
+        width, height = image.size
+        pixels = image.load()
+        columns = []
+        for x in range(width):
+            column = 0
+            for y in range(height):
+                if pixels[x, y]:
+                    column |= 1 << y
+            columns.append(column)
+        return cls(width, height, columns)
+
+
+class Font:
+    """PIL font with a glyph cache (one Bitmap per character)."""
+    
+    def __init__(self, path: Optional[str] = FONT_PATH, size: int = 12):
+        """Load the font (PIL's built-in bitmap font if path is missing).
+
+        Raises:
+            ImportError: pillow not installed
+        """
+        from PIL import ImageFont
+        
+        try:
+            self._font = ImageFont.truetype(path, size)
+        except (OSError, TypeError):
+            self._font = ImageFont.load_default()
+        ascent, descent = self._font.getmetrics()
+        self.line_height = ascent + descent
+        self._glyphs: Dict[str, Bitmap] = {}
+    
+    def glyph(self, char: str) -> Bitmap:
+        glyph = self._glyphs.get(char)
+        if glyph is None:
+            from PIL import Image, ImageDraw
+            
+            advance = max(1, round(self._font.getlength(char)))
+            image = Image.new("1", (advance, self.line_height))
+            ImageDraw.Draw(image).text((0, 0), char, font=self._font, fill=1)
+            glyph = self._glyphs[char] = Bitmap.from_image(image)
+        return glyph
+    
+    def width(self, text: str) -> int:
+        return sum(self.glyph(char).width for char in text)
+
+
+_default_font: Optional[Font] = None
+
+
+def default_font() -> Font:
+    global _default_font
+    if _default_font is None:
+        _default_font = Font()
+    return _default_font
+
+
+class Framebuffer:
+    """Page-organized 1-bit framebuffer with per-page dirty column spans."""
+    
+    def __init__(self, width: int = 128, height: int = 64):
+        self.width = width
+        self.height = height
+        self.pages = (height + 7) // 8
+        self.buffer = bytearray(width * self.pages)
+        self._dirty: List[Optional[Tuple[int, int]]] = [None] * self.pages
+    
+    # Dirty regions -------------------------------------------------------------
+    
+    def mark_dirty(self, x0: int = 0, y0: int = 0, x1: Optional[int] = None,
+                   y1: Optional[int] = None):
+        """Mark the pixel rectangle [x0, x1) x [y0, y1) as changed (default: everything)."""
+        x0, y0 = max(0, x0), max(0, y0)
+        x1 = self.width if x1 is None else min(self.width, x1)
+        y1 = self.height if y1 is None else min(self.height, y1)
+        if x0 >= x1 or y0 >= y1:
+            return
+        for page in range(y0 >> 3, ((y1 - 1) >> 3) + 1):
+            span = self._dirty[page]
+            self._dirty[page] = (x0, x1) if span is None else (min(span[0], x0), max(span[1], x1))
+    
+    def invalidate(self):
+        """Everything changed (e.g. after writing buffer directly)."""
+        self.mark_dirty()
+    
+    def take_dirty(self) -> List[Tuple[int, int, int]]:
+        """(page, x0, x1) spans changed since the last call, in page order."""
+        spans = [(page, span[0], span[1]) for page, span in enumerate(self._dirty)
+                 if span is not None]
+        self._dirty = [None] * self.pages
+        return spans
+    
+    # Drawing -------------------------------------------------------------------
+    
+    def fill(self, color: int):
+        self.buffer[:] = (b"\xff" if color else b"\x00") * len(self.buffer)
+        self.invalidate()
+    
+    def pixel(self, x: int, y: int, color: int = 1):
+        if 0 <= x < self.width and 0 <= y < self.height:
+            index = (y >> 3) * self.width + x
+            if color:
+                self.buffer[index] |= 1 << (y & 7)
+            else:
+                self.buffer[index] &= ~(1 << (y & 7)) & 0xFF
+            self.mark_dirty(x, y, x + 1, y + 1)
+    
+    def fill_rect(self, x: int, y: int, width: int, height: int, color: int = 1):
+        x0, y0 = max(0, x), max(0, y)
+        x1, y1 = min(self.width, x + width), min(self.height, y + height)
+        if x0 >= x1 or y0 >= y1:
+            return
+        rows = ((1 << (y1 - y0)) - 1) << y0
+        for page in range(y0 >> 3, ((y1 - 1) >> 3) + 1):
+            mask = (rows >> (page * 8)) & 0xFF
+            start = page * self.width
+            run = self.buffer[start + x0:start + x1]
+            if color:
+                self.buffer[start + x0:start + x1] = bytes(b | mask for b in run)
+            else:
+                self.buffer[start + x0:start + x1] = bytes(b & ~mask & 0xFF for b in run)
+        self.mark_dirty(x0, y0, x1, y1)
+    
+    def blit(self, bitmap: Bitmap, x: int, y: int, opaque: bool = True, invert: bool = False):
+        """Copy a Bitmap with its top-left corner at (x, y), clipped to the buffer.
+
+        Args:
+            opaque: Clear the bitmap's off pixels (else only set its on pixels)
+            invert: Draw on pixels as off and vice versa
+        """
+        height = bitmap.height
+        if y >= self.height or y + height <= 0 or x >= self.width or x + bitmap.width <= 0:
+            return
+        full = (1 << height) - 1
+        first, last = max(0, -x), min(bitmap.width, self.width - x)
+        page0, page1 = max(0, y) >> 3, (min(self.height, y + height) - 1) >> 3
+        width = self.width
+        buffer = self.buffer
+        for i in range(first, last):
+            column = bitmap.columns[i] ^ full if invert else bitmap.columns[i]
+            if y >= 0:
+                bits, mask = column << y, full << y
+            else:
+                bits, mask = column >> -y, full >> -y
+            for page in range(page0, page1 + 1):
+                shift = page * 8
+                index = page * width + x + i
+                if opaque:
+                    keep = ~(mask >> shift) & 0xFF
+                    buffer[index] = (buffer[index] & keep) | ((bits >> shift) & 0xFF)
+                else:
+                    buffer[index] |= (bits >> shift) & 0xFF
+        self.mark_dirty(x + first, y, x + last, y + height)
+    
+    def text(self, x: int, y: int, text: str, font: Optional[Font] = None,
+             invert: bool = False) -> int:
+        """Draw one line of text from cached glyphs; returns the x after it."""
+        font = font or default_font()
+        for char in text:
+            if x >= self.width:
+                break
+            glyph = font.glyph(char)
+            self.blit(glyph, x, y, invert=invert)
+            x += glyph.width
+        return x
+    
+    def image(self, image):
+        """Replace the whole buffer with a 1-bit PIL image of the buffer's size.
+
+        The image is transposed so each column becomes a packed row (one byte
+        per page), then the bits are reversed and the pages gathered with
+        slicing, all in C.
+        """
+        from PIL import Image
+        
+        image = image.convert("1")
+        if image.size != (self.width, self.height):
+            canvas = Image.new("1", (self.width, self.height))
+            canvas.paste(image, (0, 0))
+            image = canvas
+        columns = image.transpose(Image.Transpose.TRANSPOSE).tobytes().translate(_REVERSE)
+        for page in range(self.pages):
+            self.buffer[page * self.width:(page + 1) * self.width] = columns[page::self.pages]
+        self.invalidate()
@@ -0,0 +1,45 @@
+"""SH1106 backend: page addressing in 132-column RAM with the panel at column 2.
+
+The SH1106 has no horizontal addressing mode and no column/page window
+commands; a write goes to one page from a start column and doesn't wrap.
+Its RAM is 132 columns wide and 128-column panels are wired to columns
+2-129, so every column address is shifted by column_offset. Driving it with
+SSD1306 commands (window commands ignored, frame streamed as if it
+wrapped) shifts the image by two columns and smears it across pages.
+
+Each changed page span is one write: page and column commands, then its
+data.
+"""
+
+from typing import Tuple
+
+from .base import DisplayController
+
+
+class SH1106(DisplayController):
+    """Sino Wealth SH1106 (132x64 RAM, 128x64 panel)."""
+    
+    name = "SH1106"
+    ram_width = 132
+    column_offset = 2
+    
+    def __init__(self, *args, column_offset: int = 2, **kwargs):
+        """See DisplayController; column_offset is 0 on the few modules wired from column 0."""
+        self.column_offset = column_offset
+        super().__init__(*args, **kwargs)
+    
+    def init_sequence(self) -> Tuple[int, ...]:
+        return (0xAE,                               # display off
+                0xD5, 0x80,                         # clock divide
+                0xA8, self.height - 1,              # multiplex
+                0xD3, 0x00, 0x40,                   # offset 0, start line 0
+                0xAD, 0x8B,                         # DC-DC converter on
+                0x32,                               # pump voltage 8.0 V
+                0xA1, 0xC8,                         # segment remap, COM scan down
+                0xDA, 0x12,
+                0x81, 0x80, 0xD9, 0x22, 0xDB, 0x35,
+                0xA4, 0xA6, 0xAF)                   # resume RAM, normal, display on
+    
+    def region_commands(self, page0: int, page1: int, x0: int, x1: int) -> Tuple[int, ...]:
+        column = x0 + self.column_offset
+        return (0xB0 | page0, 0x00 | (column & 0x0F), 0x10 | (column >> 4))
@@ -0,0 +1,48 @@
+"""SSD1306 backend: horizontal addressing, so one write can cover a rectangle of pages."""
+
+from typing import List, Tuple
+
+from .base import DisplayController
+
+
+class SSD1306(DisplayController):
+    """Solomon Systech SSD1306 (128x64 or 128x32, internal charge pump)."""
+    
+    name = "SSD1306"
+    
+    def init_sequence(self) -> Tuple[int, ...]:
+        return (0xAE,                               # display off
+                0xD5, 0x80,                         # clock divide
+                0xA8, self.height - 1,              # multiplex
+                0xD3, 0x00, 0x40,                   # offset 0, start line 0
+                0x8D, 0x14,                         # charge pump on
+                0x20, 0x00,                         # horizontal addressing
+                0xA1, 0xC8,                         # segment remap, COM scan down
+                0xDA, 0x12 if self.height == 64 else 0x02,
+                0x81, 0xCF, 0xD9, 0xF1, 0xDB, 0x40,
+                0xA4, 0xA6, 0xAF)                   # resume RAM, normal, display on
+    
+    def region_commands(self, page0: int, page1: int, x0: int, x1: int) -> Tuple[int, ...]:
+        column = x0 + self.column_offset
+        return (0x21, column, column + x1 - x0 - 1, 0x22, page0, page1)
+    
+    def plan_regions(self, spans: List[Tuple[int, int, int]]) -> List[Tuple[int, int, int, int]]:
+        """Merge spans of neighbouring pages into one rectangle when that costs less bus time.
+
+        A merged rectangle resends the unchanged columns inside it but saves
+        a transaction and its addressing commands; the merge is kept only
+        when the total comes out smaller and the write stays within
+        max_message (a full frame goes out as three writes of 2-3 pages).
+        """
+        regions: List[Tuple[int, int, int, int]] = []
+        for page, x0, x1 in spans:
+            if regions:
+                p0, p1, r0, r1 = regions[-1]
+                merged = (p0, page, min(r0, x0), max(r1, x1))
+                if (self.region_bytes(*merged) <= self.max_message
+                        and self.region_cost(*merged) <= (self.region_cost(p0, p1, r0, r1)
+                                                          + self.region_cost(page, page, x0, x1))):
+                    regions[-1] = merged
+                    continue
+            regions.append((page, page, x0, x1))
+        return regions
@@ -0,0 +1,27 @@
+"""SSD1309 backend: SSD1306 command set and addressing, different panel setup.
+
+The SSD1309 drives larger (2.42") panels from an external VCC: it has no
+charge pump command, and wants its own clock, precharge and VCOMH values.
+"""
+
+from typing import Tuple
+
+from .ssd1306 import SSD1306
+
+
+class SSD1309(SSD1306):
+    """Solomon Systech SSD1309 (128x64, external VCC)."""
+    
+    name = "SSD1309"
+    
+    def init_sequence(self) -> Tuple[int, ...]:
+        return (0xFD, 0x12,                         # unlock the command interface
+                0xAE,                               # display off
+                0xD5, 0xA0,                         # clock divide, oscillator
+                0xA8, self.height - 1,              # multiplex
+                0xD3, 0x00, 0x40,                   # offset 0, start line 0
+                0x20, 0x00,                         # horizontal addressing
+                0xA1, 0xC8,                         # segment remap, COM scan down
+                0xDA, 0x12,
+                0x81, 0xDF, 0xD9, 0x82, 0xDB, 0x34,  # contrast, precharge, VCOMH
+                0xA4, 0xA6, 0xAF)                   # resume RAM, normal, display on
@@ -0,0 +1,202 @@
+"""DS3231 real-time clock: burst time read/set, SQW output, temperature and aging.
+
+No Qt and no threads here; acquisition/clock.py disciplines the timestamp
+clock with it and the ds3231 plugin uses it directly.
+
+The time registers (0x00-0x06, BCD) are read and written in one transaction
+each, so a read can't straddle a seconds rollover and a write restarts the
+chip's countdown chain exactly once. The 1 Hz square wave on INT/SQW falls
+when the seconds register advances.
+
+The DS3231 shares 0x68 with the MPU6050/MPU6500. looks_like_ds3231() tells
+them apart from a single burst of 0x00-0x12: on a DS3231 those are BCD time
+and date fields, and control, status and temperature registers, and several
+bits are always zero. An IMU's self-test and trim registers rarely fit that
+pattern, and the IMU also answers WHO_AM_I (0x75) with a known ID.
+"""
+
+import time
+from datetime import datetime, timezone
+from typing import Optional
+
+from hardware.i2c_bus import I2CDevice
+
+# Registers
+SECONDS = 0x00
+ALARM1 = 0x07
+CONTROL = 0x0E
+STATUS = 0x0F
+AGING = 0x10
+TEMP_MSB = 0x11
+REGISTER_COUNT = 0x13
+
+# CONTROL bits
+CONTROL_EOSC = 0x80    # Oscillator off on battery (active low: 0 = running)
+CONTROL_BBSQW = 0x40   # Square wave on battery power
+CONTROL_CONV = 0x20
+CONTROL_RS = 0x18      # Square-wave rate
+CONTROL_INTCN = 0x04   # INT/SQW pin is the alarm interrupt instead of the square wave
+
+# STATUS bits
+STATUS_OSF = 0x80      # Oscillator stopped at some point: the time is not valid
+STATUS_EN32KHZ = 0x08
+STATUS_BSY = 0x04
+
+# Square-wave rates (Hz) -> RS2:RS1
+SQW_RATES = {1: 0x00, 1024: 0x08, 4096: 0x10, 8192: 0x18}
+
+# WHO_AM_I of the IMUs that share 0x68 (hardware/imu.py)
+IMU_WHO_AM_I = 0x75
+IMU_IDS = (0x68, 0x70, 0x71, 0x73)
+
+
+class RTCError(OSError):
+    """Not a DS3231."""
+
+
+def _from_bcd(value: int) -> int:
+    return (value >> 4) * 10 + (value & 0x0F)
+
+
+def _to_bcd(value: int) -> int:
+    return ((value // 10) << 4) | (value % 10)
+
+
+def _valid_bcd(value: int, low: int, high: int) -> bool:
+    return (value & 0x0F) <= 9 and low <= _from_bcd(value) <= high
+
+
+def looks_like_ds3231(regs: bytes) -> bool:
+    """Whether a dump of registers 0x00-0x12 has the DS3231 layout."""
+    if len(regs) < REGISTER_COUNT:
+        return False
+    seconds, minutes, hours, day, date, month, year = regs[:7]
+    if hours & 0x40:
+        hours_ok = _valid_bcd(hours & 0x1F, 1, 12)
+    else:
+        hours_ok = not hours & 0x80 and _valid_bcd(hours & 0x3F, 0, 23)
+    return (_valid_bcd(seconds, 0, 59) and _valid_bcd(minutes, 0, 59) and hours_ok
+            and 1 <= day <= 7 and _valid_bcd(date, 1, 31) and _valid_bcd(month & 0x1F, 1, 12)
+            and not month & 0x60 and _valid_bcd(year, 0, 99)
+            and not regs[STATUS] & 0x70 and not regs[TEMP_MSB + 1] & 0x3F)
+
+
+def _decode_time(regs: bytes) -> datetime:
+    seconds, minutes, hours, _, date, month, year = regs[:7]
+    if hours & 0x40:  # 12-hour mode (never written by set_time)
+        hour = _from_bcd(hours & 0x1F) % 12 + (12 if hours & 0x20 else 0)
+    else:
+        hour = _from_bcd(hours & 0x3F)
+    return datetime(2000 + _from_bcd(year) + (100 if month & 0x80 else 0), _from_bcd(month & 0x1F),
+                    _from_bcd(date), hour, _from_bcd(minutes), _from_bcd(seconds & 0x7F),
+                    tzinfo=timezone.utc)
+
+
+def _encode_time(when: datetime) -> bytes:
+    year = when.year - 2000
+    if not 0 <= year < 200:
+        raise ValueError(f"Year {when.year} outside 2000-2199")
+    return bytes([_to_bcd(when.second), _to_bcd(when.minute), _to_bcd(when.hour),
+                  when.isoweekday(), _to_bcd(when.day),
+                  _to_bcd(when.month) | (0x80 if year >= 100 else 0), _to_bcd(year % 100)])
+
+
+class DS3231:
+    """One DS3231 (or the register-compatible DS3232/DS3231M); times are UTC."""
+    
+    def __init__(self, bus, address: int = 0x68, device=None):
+        """Identify the chip.
+
+        Args:
+            bus: I2C bus number or shared I2CBus
+            address: 0x68 (fixed on the DS3231)
+            device: Register access object (default I2CDevice)
+
+        Raises:
+            RTCError: Register layout isn't a DS3231's, or an IMU answers WHO_AM_I
+            ImportError: smbus2 not installed
+            OSError: Bus not accessible or nothing at the address
+        """
+        self.device = device if device is not None else I2CDevice(bus, address)
+        self.address = address
+        self.bus_number = getattr(bus, "bus", bus)
+        if not looks_like_ds3231(self.device.read_registers(SECONDS, REGISTER_COUNT)):
+            raise RTCError(f"0x{address:02X} is not a DS3231 (register layout)")
+        if self.device.read_register(IMU_WHO_AM_I) in IMU_IDS:
+            raise RTCError(f"0x{address:02X} is an MPU6050/MPU6500 (WHO_AM_I)")
+    
+    def close(self):
+        if hasattr(self.device, "close"):
+            self.device.close()
+    
+    def __enter__(self):
+        return self
+    
+    def __exit__(self, *exc):
+        self.close()
+    
+    def read_time(self) -> datetime:
+        """Current time in one 7-byte burst."""
+        return _decode_time(self.device.read_registers(SECONDS, 7))
+    
+    def set_time(self, when: Optional[datetime] = None):
+        """Set the time in one 7-byte write and clear the oscillator-stopped flag.
+
+        Args:
+            when: Time to set (naive = UTC); None = the system clock, written
+                at the start of its next second so the RTC's seconds line up
+                with it to within the I2C transfer time
+        """
+        if when is None:
+            now = time.time()
+            time.sleep(1.0 - now % 1.0)
+            when = datetime.fromtimestamp(round(time.time()), tz=timezone.utc)
+        elif when.tzinfo is not None:
+            when = when.astimezone(timezone.utc)
+        self.device.write_registers(SECONDS, _encode_time(when))
+        status = self.device.read_register(STATUS)
+        self.device.write_register(STATUS, status & ~STATUS_OSF)
+    
+    @property
+    def oscillator_stopped(self) -> bool:
+        """The oscillator stopped since the time was last set (battery flat or removed)."""
+        return bool(self.device.read_register(STATUS) & STATUS_OSF)
+    
+    def enable_sqw(self, hz: int = 1, battery: bool = False):
+        """Square wave on INT/SQW (open drain; needs a pull-up).
+
+        Raises:
+            ValueError: Rate not in SQW_RATES
+        """
+        if hz not in SQW_RATES:
+            raise ValueError(f"SQW rate must be one of {sorted(SQW_RATES)} Hz")
+        control = self.device.read_register(CONTROL)
+        control &= ~(CONTROL_INTCN | CONTROL_RS | CONTROL_BBSQW | CONTROL_EOSC)
+        control |= SQW_RATES[hz] | (CONTROL_BBSQW if battery else 0)
+        self.device.write_register(CONTROL, control)
+    
+    def disable_sqw(self):
+        """INT/SQW back to the (disabled) alarm interrupt, pin released."""
+        control = self.device.read_register(CONTROL)
+        self.device.write_register(CONTROL, control | CONTROL_INTCN)
+    
+    def temperature(self) -> float:
+        """Die temperature (degC, 0.25 steps, updated every 64 s)."""
+        msb, lsb = self.device.read_registers(TEMP_MSB, 2)
+        return ((msb - 256 if msb & 0x80 else msb) * 4 + (lsb >> 6)) / 4.0
+    
+    @property
+    def aging(self) -> int:
+        """Aging offset (LSB ~0.1 ppm at 25 degC; positive slows the clock)."""
+        value = self.device.read_register(AGING)
+        return value - 256 if value & 0x80 else value
+    
+    def set_aging(self, value: int):
+        """Trim the oscillator (-128 ... 127), e.g. from a measured drift.
+
+        Raises:
+            ValueError: Out of range
+        """
+        if not -128 <= value <= 127:
+            raise ValueError("Aging offset must be -128 ... 127")
+        self.device.write_register(AGING, value & 0xFF)
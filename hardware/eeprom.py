@@ -0,0 +1,312 @@
+"""24Cxx-class I2C EEPROM access (board serials, calibration, Pi HAT EEPROM).
+
+No Qt here; shared by the eeprom24cxx plugin and device_cli.py eeprom.
+
+Reads are sequential: one combined transaction (word address write +
+repeated-start read) per 256-byte block on parts with 1-byte word addresses
+(24C01-24C16 put the upper address bits into the device address) and per
+MAX_MESSAGE_BYTES (512 by default) on parts with 2-byte word addresses. A
+single 4 KB read would take about 370 ms at 100 kHz, far past the adapter
+timeout; in 512-byte pieces the 4 KB of a HAT EEPROM is 8 transactions of
+about 47 ms each. The count is in stats["read_transactions"].
+
+Writes go page by page, never crossing a page boundary (the part would wrap
+inside the page). After each page the write cycle is awaited by ACK polling
+- the part does not acknowledge its address until the cycle is done - so a
+page costs the part's actual tWR (typically 1.5-3.5 ms) instead of a fixed
+5-10 ms sleep. write() reads the range first and only rewrites pages whose
+content differs, then verifies everything with one bulk read-back.
+
+Write protection (WP pin high) shows up as a write whose data is NACKed
+while the part still answers, or as a page that was accepted without any
+write cycle (the first poll ACKs) and did not change; either raises
+WriteProtectedError.
+"""
+
+import struct
+import time
+import uuid
+from typing import Dict, NamedTuple, Optional, Tuple
+
+from config.device_config import EEPROM_PART, EEPROM_WRITE_TIMEOUT_MS
+from hardware.i2c_bus import I2CBus, I2CBusError, MAX_MESSAGE_BYTES, NACK_ERRNOS
+
+
+class Part(NamedTuple):
+    size: int        # Bytes
+    page: int        # Page (write buffer) size in bytes
+    addr_bytes: int  # Word address width
+
+
+PARTS: Dict[str, Part] = {
+    "24c01": Part(128, 8, 1), "24c02": Part(256, 8, 1), "24c04": Part(512, 16, 1),
+    "24c08": Part(1024, 16, 1), "24c16": Part(2048, 16, 1), "24c32": Part(4096, 32, 2),
+    "24c64": Part(8192, 32, 2), "24c128": Part(16384, 64, 2), "24c256": Part(32768, 64, 2),
+    "24c512": Part(65536, 128, 2),
+}
+
+# Raspberry Pi HAT EEPROM layout (github.com/raspberrypi/hats, eeprom-format.md)
+HAT_SIGNATURE = b"R-Pi"
+_HAT_HEADER = struct.Struct("<4sBBHI")
+_HAT_ATOM = struct.Struct("<HHI")
+HAT_ATOM_TYPES = {0x0001: "vendor_info", 0x0002: "gpio_map", 0x0003: "device_tree",
+                  0x0004: "custom", 0x0005: "gpio_map_bank1"}
+
+
+class EEPROMError(OSError):
+    """Write cycle timeout or read-back mismatch."""
+
+
+class WriteProtectedError(EEPROMError):
+    """The part answers but does not program (WP pin high)."""
+
+
+class EEPROM:
+    """One 24Cxx part: bulk reads, page-aligned writes with ACK polling."""
+    
+    def __init__(self, bus: int, address: int = 0x50, part: str = EEPROM_PART,
+                 write_timeout_ms: float = EEPROM_WRITE_TIMEOUT_MS):
+        """Open the bus.
+
+        Args:
+            bus: I2C bus number
+            address: Device address (A2..A0 pins; 0x50 for the HAT EEPROM)
+            part: Key of PARTS (size, page size and address width)
+            write_timeout_ms: Give up waiting for a write cycle after this long
+
+        Raises:
+            ValueError: Unknown part
+            ImportError: smbus2 not installed
+        """
+        if part.lower() not in PARTS:
+            raise ValueError(f"Unknown part {part!r}, one of {', '.join(PARTS)}")
+        self.part_name = part.lower()
+        self.part = PARTS[self.part_name]
+        self.address = address
+        self.write_timeout_s = write_timeout_ms / 1000.0
+        self._bus = I2CBus(bus)
+        self.stats: Dict[str, float] = {}
+    
+    def close(self):
+        self._bus.close()
+    
+    def __enter__(self):
+        return self
+    
+    def __exit__(self, *exc):
+        self.close()
+    
+    def _locate(self, offset: int) -> Tuple[int, list]:
+        """Device address and word address bytes for a memory offset."""
+        if self.part.addr_bytes == 1:
+            return self.address | (offset >> 8), [offset & 0xFF]
+        return self.address, [offset >> 8, offset & 0xFF]
+    
+    def _check_range(self, offset: int, length: int):
+        if offset < 0 or length < 0 or offset + length > self.part.size:
+            raise ValueError(f"Range {offset}+{length} outside the {self.part.size}-byte "
+                             f"{self.part_name}")
+    
+    def read(self, offset: int = 0, length: Optional[int] = None) -> bytes:
+        """Sequential read in as few transactions as the part and the adapter timeout allow."""
+        from smbus2 import i2c_msg
+        
+        if length is None:
+            length = self.part.size - offset
+        self._check_range(offset, length)
+        start = time.perf_counter()
+        data = bytearray()
+        transactions = 0
+        while len(data) < length:
+            position = offset + len(data)
+            if self.part.addr_bytes == 1:
+                # The block select bits are in the address
+                span = min(256 - (position & 0xFF), MAX_MESSAGE_BYTES)
+            else:
+                span = MAX_MESSAGE_BYTES
+            count = min(length - len(data), span)
+            address, word = self._locate(position)
+            read = i2c_msg.read(address, count)
+            self._bus.i2c_rdwr(i2c_msg.write(address, word), read)
+            data += bytes(read)
+            transactions += 1
+        elapsed = time.perf_counter() - start
+        self.stats.update(read_bytes=length, read_s=elapsed, read_transactions=transactions,
+                          read_bytes_per_s=length / elapsed if elapsed > 0 else 0.0)
+        return bytes(data)
+    
+    def read_hat(self) -> Optional[dict]:
+        """parse_hat() of the HAT header, reading only what it reports.
+
+        The 12-byte header, each atom header and the vendor info atom are read;
+        other atom bodies are skipped (a few hundred bytes instead of the whole
+        part). stats hold the totals of all the reads.
+        """
+        start = time.perf_counter()
+        read_bytes = transactions = 0
+        
+        def read(offset: int, length: int) -> bytes:
+            nonlocal read_bytes, transactions
+            data = self.read(offset, length)
+            read_bytes += length
+            transactions += self.stats["read_transactions"]
+            return data
+        
+        data = bytearray(read(0, _HAT_HEADER.size))
+        if data[:4] != HAT_SIGNATURE:
+            hat = None
+        else:
+            numatoms = _HAT_HEADER.unpack_from(data)[3]
+            for _ in range(numatoms):
+                if len(data) + _HAT_ATOM.size > self.part.size:
+                    break
+                header = read(len(data), _HAT_ATOM.size)
+                kind, _, dlen = _HAT_ATOM.unpack(header)
+                dlen = min(dlen, self.part.size - len(data) - _HAT_ATOM.size)
+                data += header
+                # Only the vendor info body is parsed; the rest just needs its length
+                data += read(len(data), dlen) if kind == 0x0001 and dlen else bytes(dlen)
+            hat = parse_hat(bytes(data))
+        elapsed = time.perf_counter() - start
+        self.stats.update(read_bytes=read_bytes, read_s=elapsed, read_transactions=transactions,
+                          read_bytes_per_s=read_bytes / elapsed if elapsed > 0 else 0.0)
+        return hat
+    
+    def _wait_ready(self, address: int) -> Tuple[float, int]:
+        """ACK-poll until the write cycle is over.
+
+        Returns:
+            (seconds waited, polls the part NACKed while busy)
+        """
+        start = time.perf_counter()
+        busy = 0
+        while True:
+            try:
+                self._bus.write_quick(address)
+                return time.perf_counter() - start, busy
+            except I2CBusError:
+                raise
+            except OSError as e:
+                if e.errno not in NACK_ERRNOS:
+                    raise
+            busy += 1
+            if time.perf_counter() - start > self.write_timeout_s:
+                raise EEPROMError(f"Write cycle at 0x{address:02X} did not finish within "
+                                  f"{self.write_timeout_s * 1000:.0f} ms")
+    
+    def _write_page(self, offset: int, chunk: bytes) -> Tuple[float, int]:
+        from smbus2 import i2c_msg
+        
+        address, word = self._locate(offset)
+        try:
+            self._bus.i2c_rdwr(i2c_msg.write(address, word + list(chunk)))
+        except I2CBusError:
+            raise
+        except OSError as e:
+            # Data NACKed by a part that still answers its address: WP is high
+            if e.errno in NACK_ERRNOS and self.is_present():
+                raise WriteProtectedError(f"0x{self.address:02X} rejected the write at "
+                                          f"{offset} - write protect (WP) active?") from e
+            raise
+        return self._wait_ready(address)
+    
+    def write(self, offset: int, data: bytes, verify: bool = True,
+              skip_unchanged: bool = True) -> dict:
+        """Program data page by page, skipping pages that already hold it.
+
+        Returns:
+            Throughput and write-cycle statistics (also kept in self.stats)
+
+        Raises:
+            WriteProtectedError: The part does not program
+            EEPROMError: Write cycle timeout or read-back mismatch
+        """
+        self._check_range(offset, len(data))
+        start = time.perf_counter()
+        current = self.read(offset, len(data)) if skip_unchanged else None
+        page = self.part.page
+        written = skipped = 0
+        cycles = []
+        position = offset
+        while position < offset + len(data):
+            end = min(offset + len(data), (position // page + 1) * page)
+            chunk = data[position - offset:end - offset]
+            if current is not None and current[position - offset:end - offset] == chunk:
+                skipped += 1
+            else:
+                cycle_s, busy = self._write_page(position, chunk)
+                cycles.append(cycle_s)
+                written += 1
+                # No busy poll at all: nothing was programmed, or tWR was shorter than
+                # one poll - the read-back tells which
+                if busy == 0 and written == 1 and self.read(position, len(chunk)) != chunk:
+                    raise WriteProtectedError(f"0x{self.address:02X} accepted the write at "
+                                              f"{position} but did not program it - "
+                                              f"write protect (WP) active?")
+            position = end
+        write_s = time.perf_counter() - start
+        
+        verified = None
+        if verify:
+            readback = self.read(offset, len(data))
+            verified = readback == bytes(data)
+            if not verified:
+                bad = next(i for i, (a, b) in enumerate(zip(readback, data)) if a != b)
+                raise EEPROMError(f"Read-back mismatch at offset {offset + bad}")
+        elapsed = time.perf_counter() - start
+        self.stats.update({
+            "bytes": len(data), "pages_written": written, "pages_skipped": skipped,
+            "write_s": write_s, "total_s": elapsed, "verified": verified,
+            "bytes_per_s": len(data) / elapsed if elapsed > 0 else 0.0,
+            "write_cycle_ms_mean": 1000.0 * sum(cycles) / len(cycles) if cycles else 0.0,
+            "write_cycle_ms_max": 1000.0 * max(cycles) if cycles else 0.0,
+        })
+        return dict(self.stats)
+    
+    def is_present(self) -> bool:
+        try:
+            self._bus.write_quick(self.address)
+            return True
+        except OSError:
+            return False
+    
+    def probe_write_protect(self) -> bool:
+        """Try to flip the last byte and put it back; True if the part does not program."""
+        last = self.part.size - 1
+        original = self.read(last, 1)
+        try:
+            self.write(last, bytes([original[0] ^ 0xFF]), verify=False, skip_unchanged=False)
+        except WriteProtectedError:
+            return True
+        changed = self.read(last, 1) != original
+        if changed:
+            self.write(last, original, skip_unchanged=False)
+        return not changed
+
+
+def parse_hat(data: bytes) -> Optional[dict]:
+    """Header, atom list and vendor info of a Pi HAT EEPROM image (None if not one)."""
+    if len(data) < _HAT_HEADER.size or data[:4] != HAT_SIGNATURE:
+        return None
+    _, version, _, numatoms, eeplen = _HAT_HEADER.unpack_from(data)
+    hat = {"version": version, "atoms": [], "length": eeplen}
+    position = _HAT_HEADER.size
+    for _ in range(numatoms):
+        if position + _HAT_ATOM.size > len(data):
+            hat["truncated"] = True
+            break
+        kind, count, dlen = _HAT_ATOM.unpack_from(data, position)
+        body = data[position + _HAT_ATOM.size:position + _HAT_ATOM.size + dlen - 2]
+        hat["atoms"].append({"type": HAT_ATOM_TYPES.get(kind, f"0x{kind:04X}"),
+                             "count": count, "length": len(body)})
+        if kind == 0x0001 and len(body) >= 22:
+            pid, pver, vslen, pslen = struct.unpack_from("<HHBB", body, 16)
+            hat.update({
+                # Four little-endian u32, least significant first
+                "uuid": str(uuid.UUID(bytes=bytes(reversed(body[:16])))),
+                "product_id": f"0x{pid:04X}", "product_version": pver,
+                "vendor": body[22:22 + vslen].decode(errors="replace"),
+                "product": body[22 + vslen:22 + vslen + pslen].decode(errors="replace"),
+            })
+        position += _HAT_ATOM.size + dlen
+    return hat
@@ -0,0 +1,163 @@
+"""Outputs on the J11 GPIO bank (BCM5, BCM6, BCM12, BCM13)."""
+
+import os
+import sys
+
+from hardware.platform import is_raspberry_pi
+from config.pins import PWM_SYSFS_CHANNELS
+
+
+class PWMOutput:
+    """PWM output - hardware PWM via sysfs where available, else gpiozero, mock on PC."""
+    
+    def __init__(self, pin: int, frequency: float = 1000.0):
+        """Initialize PWM output.
+
+        Args:
+            pin: BCM pin number
+            frequency: PWM frequency in Hz
+        """
+        self.is_pi = is_raspberry_pi()
+        self.pin = pin
+        self.frequency = frequency
+        self.duty = 0.0
+        self.backend = "mock"
+        self._device = None
+        self._duty_fd = None
+        self._period_ns = int(1e9 / frequency)
+        
+        if self.is_pi:
+            self._init_pi()
+    
+    def _init_pi(self):
+        """Initialize on Raspberry Pi."""
+        channel = PWM_SYSFS_CHANNELS.get(self.pin)
+        if channel is not None:
+            chip = f"/sys/class/pwm/pwmchip{channel[0]}"
+            path = f"{chip}/pwm{channel[1]}"
+            try:
+                if not os.path.isdir(path):
+                    with open(f"{chip}/export", "w") as f:
+                        f.write(str(channel[1]))
+                with open(f"{path}/duty_cycle", "w") as f:
+                    f.write("0")
+                with open(f"{path}/period", "w") as f:
+                    f.write(str(self._period_ns))
+                with open(f"{path}/enable", "w") as f:
+                    f.write("1")
+                # Kept open: one write() per update instead of open/close
+                self._duty_fd = os.open(f"{path}/duty_cycle", os.O_WRONLY)
+                self.backend = "sysfs"
+                return
+            except OSError:
+                pass  # Overlay not loaded - fall back to software PWM
+        try:
+            from gpiozero import PWMOutputDevice
+            self._device = PWMOutputDevice(self.pin, frequency=self.frequency)
+            self.backend = "gpiozero"
+        except Exception as e:
+            print(f"PWM on BCM{self.pin} unavailable: {e}", file=sys.stderr)
+    
+    def set_duty(self, duty: float):
+        """Set duty cycle (0.0 - 1.0, clamped)."""
+        duty = min(1.0, max(0.0, duty))
+        self.duty = duty
+        if self._duty_fd is not None:
+            os.pwrite(self._duty_fd, str(int(duty * self._period_ns)).encode(), 0)
+        elif self._device is not None:
+            self._device.value = duty
+    
+    def close(self):
+        """Switch the output off and release it."""
+        self.set_duty(0.0)
+        if self._duty_fd is not None:
+            os.close(self._duty_fd)
+            self._duty_fd = None
+        if self._device is not None:
+            self._device.close()
+            self._device = None
+
+
+class DigitalOutput:
+    """On/off output - real on Pi, mock on PC."""
+    
+    def __init__(self, pin: int):
+        self.is_pi = is_raspberry_pi()
+        self.pin = pin
+        self.state = False
+        self._device = None
+        
+        if self.is_pi:
+            try:
+                from gpiozero import OutputDevice
+                self._device = OutputDevice(pin)
+            except Exception as e:
+                print(f"GPIO output on BCM{pin} unavailable: {e}", file=sys.stderr)
+    
+    def set_state(self, state: bool):
+        """Set output state."""
+        self.state = state
+        if self._device is not None:
+            if state:
+                self._device.on()
+            else:
+                self._device.off()
+    
+    def close(self):
+        """Switch the output off and release it."""
+        self.set_state(False)
+        if self._device is not None:
+            self._device.close()
+            self._device = None
+
+
+def _find_gpiochip(gpiod) -> str:
+    """Path of the chip carrying the 40-pin header lines (Pi 4: bcm2711, Pi 5: rp1)."""
+    import glob
+    for path in sorted(glob.glob("/dev/gpiochip*")):
+        try:
+            with gpiod.Chip(path) as chip:
+                if chip.get_info().label.startswith(("pinctrl-bcm", "pinctrl-rp1")):
+                    return path
+        except OSError:
+            continue
+    return "/dev/gpiochip0"
+
+
+class EdgeInput:
+    """Input whose edges are timestamped by the kernel (libgpiod v2 edge events)."""
+    
+    def __init__(self, pin: int, falling: bool = True, pull_up: bool = True, both: bool = False):
+        """Request the line with edge detection.
+
+        Args:
+            pin: BCM pin number
+            falling: Watch falling edges (else rising)
+            pull_up: Enable the internal pull-up (open-drain sources like ALERT/RDY)
+            both: Watch both edges (falling is then ignored)
+
+        Raises:
+            ImportError: python3-libgpiod (v2) not installed
+            OSError: Line busy or not available
+        """
+        import gpiod
+        from gpiod.line import Bias, Clock, Edge
+        
+        self.pin = pin
+        edge = Edge.BOTH if both else Edge.FALLING if falling else Edge.RISING
+        settings = gpiod.LineSettings(edge_detection=edge,
+                                      bias=Bias.PULL_UP if pull_up else Bias.AS_IS,
+                                      event_clock=Clock.MONOTONIC)
+        self._request = gpiod.request_lines(_find_gpiochip(gpiod), consumer="device-panel",
+                                            config={pin: settings})
+    
+    def read(self, timeout: float) -> list:
+        """Edges that arrived, as time.monotonic() seconds; waits up to timeout for one."""
+        if not self._request.wait_edge_events(timeout):
+            return []
+        return [event.timestamp_ns / 1e9 for event in self._request.read_edge_events()]
+    
+    def close(self):
+        if self._request is not None:
+            self._request.release()
+            self._request = None
@@ -1,15 +1,16 @@
 """GPIO manager for LEDs and buttons."""
 
 from hardware.platform import is_raspberry_pi
-from PySide6.QtCore import Signal, QObject
 from config.pins import LED1, LED2, LED3, LED4, BTN1, BTN2
 
 
-class GPIOManager(QObject):
-    """Simple GPIO manager - real on Pi, mock on PC."""
+class GPIOManager:
+    """Simple GPIO manager - real on Pi, mock on PC.
+    
+    Deliberately Qt-free so the headless CLI can use it without PySide6.
+    """
     
     def __init__(self):
-        super().__init__()  # Initialize QObject
         self.is_pi = is_raspberry_pi()
         self.led_states = {1: False, 2: False, 3: False, 4: False}
         self.button_states = {1: False, 2: False}
@@ -0,0 +1,510 @@
+"""I2C bus access with an adapter timeout, health tracking and recovery.
+
+A sensor that hangs SDA low (typically reset or brown-out in the middle of a
+read, with the slave still driving a 0 bit) blocks every device on the bus:
+each transaction waits for the adapter timeout, about a second by default,
+and then fails. Everything that talks to the bus - I2CScanner, ADCManager's
+direct path and the device plugins - goes through I2CBus instead of a bare
+smbus2.SMBus, which adds:
+
+    timeout     TIMEOUT_MS on the adapter (I2C_TIMEOUT ioctl), so a hung
+                transaction costs about a tenth of a second, not a second.
+                The ioctl is adapter-wide, so the value is sized to the
+                longest message at the bus clock: drivers split bulk
+                transfers at MAX_MESSAGE_BYTES, which always fits in half
+                of it
+    health      per-bus BusHealth: bus faults (timeouts, arbitration loss,
+                I/O errors) are counted; NACKs are not faults, they only mean
+                nobody is at that address
+    quarantine  an address that faults I2C_ERROR_THRESHOLD times in a row is
+                refused (I2CBusError) for I2C_QUARANTINE_S without touching
+                the bus, so one bad sensor can't stall its neighbours
+    recovery    after I2C_ERROR_THRESHOLD consecutive faults on the bus, a
+                background thread waits for transactions in flight, closes
+                every I2CBus handle on the bus (an open /dev/i2c-N can block
+                the unbind indefinitely), unbinds the adapter driver, takes
+                SDA/SCL as GPIOs (I2C_RECOVERY_PINS), senses SDA, clocks out
+                up to 9 SCL pulses until the slave lets go, issues a STOP and
+                rebinds the driver (which restores the pin function).
+                Transactions during the recovery fail immediately; I2CBus
+                reopens the device node afterwards. Another process holding
+                the node open still delays the unbind.
+
+Counts, recovery durations and the last errors are in get_health(bus).get_stats().
+"""
+
+import errno
+import math
+import os
+import sys
+import threading
+import time
+import weakref
+from collections import deque
+from typing import Dict, Optional
+
+from config.i2c_config import (I2C_CLOCK_HZ, I2C_ERROR_THRESHOLD, I2C_MAX_MESSAGE_BYTES,
+                               I2C_QUARANTINE_S, I2C_RECOVERY_ENABLED, I2C_RECOVERY_INTERVAL_S,
+                               I2C_RETRIES, I2C_TIMEOUT_MS)
+from config.pins import I2C_RECOVERY_PINS
+
+# linux/i2c-dev.h
+I2C_RETRIES_IOCTL = 0x0701
+I2C_TIMEOUT_IOCTL = 0x0702  # Argument in units of 10 ms
+
+# No ACK: nobody at the address (or the device is busy) - the bus itself is fine
+NACK_ERRNOS = (errno.ENXIO, errno.EREMOTEIO)
+
+# smbus2.SMBus methods whose first argument is the device address
+_TRANSACTIONS = frozenset((
+    "write_quick", "read_byte", "write_byte", "read_byte_data", "write_byte_data",
+    "read_word_data", "write_word_data", "process_call", "read_block_data",
+    "write_block_data", "block_process_call", "read_i2c_block_data", "write_i2c_block_data",
+))
+
+
+def message_ms(length: int, clock_hz: float = I2C_CLOCK_HZ) -> float:
+    """Wire time of an I2C message of length bytes (9 clocks per byte with the ACK)."""
+    return length * 9 * 1000.0 / clock_hz
+
+
+# Adapter timeout actually set (None = driver default): twice the longest
+# message plus 20 ms of scheduling slack, in the ioctl's 10 ms units
+if I2C_TIMEOUT_MS is None:
+    TIMEOUT_MS = int(math.ceil((2 * message_ms(I2C_MAX_MESSAGE_BYTES) + 20) / 10)) * 10
+else:
+    TIMEOUT_MS = I2C_TIMEOUT_MS or None
+
+# Largest message a driver may put on the wire in one go: I2C_MAX_MESSAGE_BYTES,
+# or less if a hand-set I2C_TIMEOUT_MS is too short for it at I2C_CLOCK_HZ
+MAX_MESSAGE_BYTES = I2C_MAX_MESSAGE_BYTES
+if TIMEOUT_MS is not None:
+    MAX_MESSAGE_BYTES = max(32, min(MAX_MESSAGE_BYTES, int(TIMEOUT_MS / 2 / message_ms(1))))
+
+# SCL half period while clocking out a stuck slave (100 kHz or slower)
+_HALF_PERIOD_S = 5e-6
+
+
+class I2CBusError(OSError):
+    """Transaction refused without touching the bus (recovering or address quarantined)."""
+
+
+class BusHealth:
+    """Fault counters and recovery for one I2C bus (shared by all I2CBus handles)."""
+    
+    def __init__(self, bus: int):
+        self.bus = bus
+        # Incremented by every recovery; handles reopen the device node when it changes
+        self.generation = 0
+        self.recovering = False
+        self.consecutive = 0
+        self._address_faults: Dict[int, int] = {}
+        self._quarantine: Dict[int, float] = {}
+        self._last_recovery = -float("inf")
+        self._lock = threading.Lock()
+        self._recover_lock = threading.Lock()
+        # Open I2CBus handles and transactions in flight; recovery closes the
+        # former after the latter drain
+        self._handles = weakref.WeakSet()
+        self._active = 0
+        self._idle = threading.Condition(threading.Lock())
+        self.recoveries = deque(maxlen=8)
+        self.stats = {
+            "transactions": 0,
+            "nacks": 0,
+            "faults": 0,
+            "timeouts": 0,
+            "refused": 0,
+            "quarantines": 0,
+            "recoveries": 0,
+            "recovery_failures": 0,
+            "sda_stuck": 0,
+            "recovery_ms_total": 0.0,
+            "recovery_ms_max": 0.0,
+            "max_transaction_ms": 0.0,
+            "last_error": None,
+            "timeout_ms": None,
+        }
+    
+    @property
+    def healthy(self) -> bool:
+        return not self.recovering and self.consecutive < I2C_ERROR_THRESHOLD
+    
+    def check(self, address: Optional[int]):
+        """Raise I2CBusError if a transaction to address must not go out now."""
+        if self.recovering:
+            self.stats["refused"] += 1
+            raise I2CBusError(errno.EBUSY, f"I2C bus {self.bus} is being recovered")
+        until = self._quarantine.get(address)
+        if until is not None:
+            if time.monotonic() < until:
+                self.stats["refused"] += 1
+                raise I2CBusError(errno.EIO, f"I2C 0x{address:02X} on bus {self.bus} quarantined "
+                                             f"after repeated faults")
+            with self._lock:
+                self._quarantine.pop(address, None)
+                self._address_faults.pop(address, None)
+    
+    def register(self, handle):
+        """Track an open I2CBus, so recovery can close it before unbinding."""
+        with self._idle:
+            self._handles.add(handle)
+    
+    def begin(self, address: Optional[int]):
+        """check() and count a transaction in flight until end()."""
+        self.check(address)
+        with self._idle:
+            if self.recovering:
+                self.stats["refused"] += 1
+                raise I2CBusError(errno.EBUSY, f"I2C bus {self.bus} is being recovered")
+            self._active += 1
+    
+    def end(self):
+        with self._idle:
+            self._active -= 1
+            if self._active == 0:
+                self._idle.notify_all()
+    
+    def _close_handles(self):
+        """Wait for transactions in flight, then close every handle's device node."""
+        # A transaction that started lasts at most the adapter timeout
+        wait_s = 2.0 if TIMEOUT_MS is None else 3 * TIMEOUT_MS / 1000.0
+        with self._idle:
+            if not self._idle.wait_for(lambda: self._active == 0, timeout=wait_s):
+                raise OSError(errno.EBUSY, f"{self._active} transactions on bus {self.bus} "
+                                           f"did not finish - not unbinding")
+            handles = list(self._handles)
+        for handle in handles:
+            handle.close()
+    
+    def record_ok(self, address: Optional[int], duration: float, nack: bool = False):
+        """A transaction completed (an ACK or a NACK - either way the bus works)."""
+        with self._lock:
+            self.stats["transactions"] += 1
+            if nack:
+                self.stats["nacks"] += 1
+            ms = duration * 1000.0
+            if ms > self.stats["max_transaction_ms"]:
+                self.stats["max_transaction_ms"] = ms
+            self.consecutive = 0
+            if not nack:
+                self._address_faults.pop(address, None)
+    
+    def record_fault(self, address: Optional[int], error: Exception, duration: float = 0.0):
+        """A transaction failed with a bus fault; may quarantine the address or start recovery."""
+        now = time.monotonic()
+        with self._lock:
+            self.stats["transactions"] += 1
+            self.stats["faults"] += 1
+            if getattr(error, "errno", None) == errno.ETIMEDOUT:
+                self.stats["timeouts"] += 1
+            target = "bus" if address is None else f"0x{address:02X}"
+            self.stats["last_error"] = f"{target}: {error}"
+            ms = duration * 1000.0
+            if ms > self.stats["max_transaction_ms"]:
+                self.stats["max_transaction_ms"] = ms
+            self.consecutive += 1
+            if address is not None:
+                faults = self._address_faults.get(address, 0) + 1
+                self._address_faults[address] = faults
+                if faults >= I2C_ERROR_THRESHOLD and address not in self._quarantine:
+                    self._quarantine[address] = now + I2C_QUARANTINE_S
+                    self.stats["quarantines"] += 1
+            trigger = self.consecutive >= I2C_ERROR_THRESHOLD
+        if trigger:
+            self.request_recovery(f"{self.consecutive} consecutive faults, last {target}: {error}")
+    
+    def request_recovery(self, reason: str) -> bool:
+        """Start a background recovery unless disabled, running, or one ran recently."""
+        if not I2C_RECOVERY_ENABLED:
+            return False
+        with self._lock:
+            if self.recovering or time.monotonic() - self._last_recovery < I2C_RECOVERY_INTERVAL_S:
+                return False
+            self.recovering = True
+        threading.Thread(target=self.recover, args=(reason,), name=f"i2c{self.bus}-recovery",
+                         daemon=True).start()
+        return True
+    
+    def recover(self, reason: str = "manual") -> dict:
+        """Unbind the adapter, clock the bus free, issue STOP and rebind (blocking).
+
+        Returns:
+            Result dict: reason, ok, duration_ms, sda_stuck, pulses, sda_released,
+            rebound and error (what failed, if anything)
+        """
+        with self._recover_lock:
+            with self._idle:
+                self.recovering = True
+            start = time.monotonic()
+            result = {"reason": reason, "ok": False, "sda_stuck": None, "pulses": 0,
+                      "sda_released": None, "rebound": False, "error": None}
+            try:
+                self._recover(result)
+            except Exception as e:
+                result["error"] = str(e)
+            duration_ms = (time.monotonic() - start) * 1000.0
+            result["duration_ms"] = round(duration_ms, 2)
+            with self._lock:
+                result["ok"] = result["error"] is None and result["sda_released"] is not False
+                self.stats["recoveries"] += 1
+                if not result["ok"]:
+                    self.stats["recovery_failures"] += 1
+                if result["sda_stuck"]:
+                    self.stats["sda_stuck"] += 1
+                self.stats["recovery_ms_total"] += duration_ms
+                self.stats["recovery_ms_max"] = max(self.stats["recovery_ms_max"], duration_ms)
+                self.recoveries.append(result)
+                self.consecutive = 0
+                self.generation += 1
+                self._last_recovery = time.monotonic()
+                self.recovering = False
+            state = "recovered" if result["ok"] else f"recovery failed ({result['error']})"
+            print(f"I2C bus {self.bus}: {state} in {duration_ms:.0f} ms - {reason}", file=sys.stderr)
+            return result
+    
+    def _recover(self, result: dict):
+        adapter = _adapter_driver(self.bus)
+        if adapter is None:
+            raise OSError(errno.ENODEV, f"no adapter for /dev/i2c-{self.bus} in sysfs")
+        driver, device = adapter
+        # The unbind waits for every open file of /dev/i2c-N to be released;
+        # handles reopen the node on their next transaction (generation changes)
+        self._close_handles()
+        with open(os.path.join(driver, "unbind"), "w") as f:
+            f.write(device)
+        try:
+            # Only touch the pins with the driver detached: requesting them as
+            # GPIOs switches their function away from I2C, and binding again
+            # restores it
+            pins = I2C_RECOVERY_PINS.get(self.bus)
+            if pins is not None:
+                result.update(_clock_out(*pins))
+        finally:
+            with open(os.path.join(driver, "bind"), "w") as f:
+                f.write(device)
+            deadline = time.monotonic() + 2.0
+            while not os.path.exists(f"/dev/i2c-{self.bus}"):
+                if time.monotonic() > deadline:
+                    raise OSError(errno.ENODEV, f"/dev/i2c-{self.bus} did not come back")
+                time.sleep(0.005)
+            result["rebound"] = True
+    
+    def get_stats(self) -> dict:
+        """Snapshot of counters, quarantined addresses and recent recoveries."""
+        with self._lock:
+            stats = dict(self.stats)
+            now = time.monotonic()
+            stats["bus"] = self.bus
+            stats["healthy"] = self.healthy
+            stats["consecutive_faults"] = self.consecutive
+            stats["quarantined"] = [f"0x{addr:02X}" for addr, until in self._quarantine.items()
+                                    if until > now]
+            stats["recent_recoveries"] = list(self.recoveries)
+        return stats
+
+
+def _adapter_driver(bus: int):
+    """(driver sysfs dir, device name) of the controller behind /dev/i2c-<bus>, or None."""
+    adapter = os.path.realpath(f"/sys/bus/i2c/devices/i2c-{bus}")
+    parent = os.path.dirname(adapter)
+    driver = os.path.join(parent, "driver")
+    if not os.path.isdir(adapter) or not os.path.exists(driver):
+        return None
+    return os.path.realpath(driver), os.path.basename(parent)
+
+
+def _clock_out(sda: int, scl: int) -> dict:
+    """Sense SDA, clock SCL until a stuck slave releases it (at most 9 pulses), then STOP."""
+    import gpiod
+    from gpiod.line import Bias, Direction, Drive, Value
+    from hardware.gpio_bank import _find_gpiochip
+    
+    settings = gpiod.LineSettings(direction=Direction.OUTPUT, drive=Drive.OPEN_DRAIN,
+                                  bias=Bias.PULL_UP, output_value=Value.ACTIVE)
+    request = gpiod.request_lines(_find_gpiochip(gpiod), consumer="device-panel-i2c-recovery",
+                                  config={(sda, scl): settings})
+    try:
+        time.sleep(_HALF_PERIOD_S)
+        if request.get_value(scl) == Value.INACTIVE:
+            raise OSError(errno.EIO, f"SCL (BCM{scl}) held low - a device is stretching the clock")
+        stuck = request.get_value(sda) == Value.INACTIVE
+        pulses = 0
+        # A slave in the middle of a read shifts out one bit per clock; 9 clocks
+        # finish any byte plus its ACK, after which it releases SDA
+        while pulses < 9 and request.get_value(sda) == Value.INACTIVE:
+            request.set_value(scl, Value.INACTIVE)
+            time.sleep(_HALF_PERIOD_S)
+            request.set_value(scl, Value.ACTIVE)
+            time.sleep(_HALF_PERIOD_S)
+            pulses += 1
+        # STOP: SDA low -> high while SCL is high
+        request.set_value(scl, Value.INACTIVE)
+        time.sleep(_HALF_PERIOD_S)
+        request.set_value(sda, Value.INACTIVE)
+        time.sleep(_HALF_PERIOD_S)
+        request.set_value(scl, Value.ACTIVE)
+        time.sleep(_HALF_PERIOD_S)
+        request.set_value(sda, Value.ACTIVE)
+        time.sleep(_HALF_PERIOD_S)
+        released = request.get_value(sda) == Value.ACTIVE
+    finally:
+        request.release()
+    return {"sda_stuck": stuck, "pulses": pulses, "sda_released": released}
+
+
+_health: Dict[int, BusHealth] = {}
+_health_lock = threading.Lock()
+
+
+def get_health(bus: int) -> BusHealth:
+    """The shared BusHealth of a bus number."""
+    with _health_lock:
+        health = _health.get(bus)
+        if health is None:
+            health = _health[bus] = BusHealth(bus)
+        return health
+
+
+class I2CBus:
+    """smbus2.SMBus drop-in with timeouts, fault accounting and reopen after recovery.
+
+    Transaction methods (write_quick, read_i2c_block_data, ...) take the same
+    arguments as smbus2's; I2CBusError is raised instead of a transaction when
+    the bus is being recovered or the address is quarantined.
+    """
+    
+    def __init__(self, bus: int, timeout_ms: Optional[int] = TIMEOUT_MS,
+                 retries: Optional[int] = I2C_RETRIES):
+        """Open /dev/i2c-<bus>.
+
+        Raises:
+            ImportError: smbus2 not installed
+            OSError: Device node missing or not accessible
+        """
+        self.bus = bus
+        self.timeout_ms = timeout_ms
+        self.retries = retries
+        self.health = get_health(bus)
+        self._smbus = None
+        self._generation = -1
+        self._open()
+        self.health.register(self)
+    
+    def _open(self):
+        import fcntl
+        import smbus2
+        
+        if self._smbus is not None:
+            self._smbus.close()
+            self._smbus = None
+        self._generation = self.health.generation
+        self._smbus = smbus2.SMBus(self.bus)
+        try:
+            if self.timeout_ms is not None:
+                fcntl.ioctl(self._smbus.fd, I2C_TIMEOUT_IOCTL, max(1, round(self.timeout_ms / 10)))
+                self.health.stats["timeout_ms"] = max(1, round(self.timeout_ms / 10)) * 10
+            if self.retries is not None:
+                fcntl.ioctl(self._smbus.fd, I2C_RETRIES_IOCTL, self.retries)
+        except OSError:
+            pass  # Adapter without timeout support (some USB bridges) - keep its default
+    
+    def _transaction(self, address: Optional[int], call):
+        health = self.health
+        health.begin(address)
+        try:
+            if self._smbus is None or self._generation != health.generation:
+                self._open()
+            start = time.monotonic()
+            try:
+                result = call(self._smbus)
+            except OSError as e:
+                duration = time.monotonic() - start
+                if e.errno in NACK_ERRNOS:
+                    health.record_ok(address, duration, nack=True)
+                else:
+                    health.record_fault(address, e, duration)
+                raise
+        finally:
+            health.end()
+        health.record_ok(address, time.monotonic() - start)
+        return result
+    
+    def i2c_rdwr(self, *msgs):
+        """Combined transaction (accounted to the address of the first message)."""
+        address = msgs[0].addr if msgs else None
+        return self._transaction(address, lambda smbus: smbus.i2c_rdwr(*msgs))
+    
+    def __getattr__(self, name):
+        if name not in _TRANSACTIONS:
+            raise AttributeError(f"I2CBus has no attribute {name!r}")
+        
+        def transaction(address: int, *args, **kwargs):
+            return self._transaction(address, lambda smbus: getattr(smbus, name)(address, *args,
+                                                                                 **kwargs))
+        return transaction
+    
+    def close(self):
+        if self._smbus is not None:
+            self._smbus.close()
+            self._smbus = None
+    
+    def __enter__(self):
+        return self
+    
+    def __exit__(self, *exc):
+        self.close()
+
+
+class I2CDevice:
+    """Register access to one device on an I2CBus.
+
+    read_registers() returns any number of consecutive registers in one
+    combined transaction (register write + repeated-start read); smbus2's
+    read_i2c_block_data stops at 32 bytes, which would split a FIFO drain
+    or a burst of measurement registers into several transactions.
+    """
+    
+    def __init__(self, bus, address: int):
+        """Open the bus (or share an open I2CBus).
+
+        Args:
+            bus: I2C bus number, or an I2CBus to share
+            address: Device address
+
+        Raises:
+            ImportError: smbus2 not installed
+            OSError: Device node missing or not accessible
+        """
+        self._owned = not isinstance(bus, I2CBus)
+        self.bus = I2CBus(bus) if self._owned else bus
+        self.address = address
+    
+    def read_registers(self, register: int, length: int) -> bytes:
+        from smbus2 import i2c_msg
+        
+        read = i2c_msg.read(self.address, length)
+        self.bus.i2c_rdwr(i2c_msg.write(self.address, [register]), read)
+        return bytes(read)
+    
+    def read_register(self, register: int) -> int:
+        return self.bus.read_byte_data(self.address, register)
+    
+    def write_register(self, register: int, value: int):
+        self.bus.write_byte_data(self.address, register, value & 0xFF)
+    
+    def write_registers(self, register: int, data: bytes):
+        """Consecutive registers in one write (auto-increment)."""
+        from smbus2 import i2c_msg
+        
+        self.bus.i2c_rdwr(i2c_msg.write(self.address, [register] + list(data)))
+    
+    def close(self):
+        if self._owned:
+            self.bus.close()
+    
+    def __enter__(self):
+        return self
+    
+    def __exit__(self, *exc):
+        self.close()
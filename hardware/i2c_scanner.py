@@ -1,8 +1,14 @@
 """I2C bus scanner - works on both PC and Raspberry Pi."""
 
+import errno
 import os
 from typing import List, Optional
 
+from hardware.i2c_bus import I2CBus, I2CBusError, get_health
+
+# Addresses probed by scan(); 0x00-0x07 and 0x78-0x7F are reserved
+SCAN_ADDRESSES = range(0x08, 0x78)
+
 
 class I2CScanner:
     """I2C bus scanner using standard Linux I2C interface."""
@@ -34,8 +40,7 @@ class I2CScanner:
             if os.path.exists(f"/dev/i2c-{bus_num}"):
                 # Quick check if this bus is functional (raises exceptions for invalid addresses)
                 try:
-                    import smbus2
-                    test_bus = smbus2.SMBus(bus_num)
+                    test_bus = I2CBus(bus_num)
                     # Test that bus properly raises exceptions for invalid addresses
                     # If it doesn't raise exceptions, it's not a real functional I2C bus
                     try:
@@ -71,8 +76,7 @@ class I2CScanner:
             if os.path.exists(f"/dev/i2c-{bus_num}"):
                 # Verify bus is functional before returning it
                 try:
-                    import smbus2
-                    test_bus = smbus2.SMBus(bus_num)
+                    test_bus = I2CBus(bus_num)
                     try:
                         test_bus.write_quick(0x08)
                         # Doesn't raise exception - skip this bus
@@ -106,36 +110,41 @@ class I2CScanner:
         if not os.path.exists(self.device_path):
             return devices
         
+        health = get_health(self.bus)
+        probed = 0
         try:
-            import smbus2
             import time
             
             # Open fresh bus connection for each scan
-            bus = smbus2.SMBus(self.bus)
+            bus = I2CBus(self.bus)
             
             # Small delay to let bus settle (helps with capacitance issues)
             time.sleep(0.01)
             
-            # Scan addresses 0x08 to 0x77 (valid I2C addresses)
-            # Note: Addresses 0x00-0x07 and 0x78-0x7F are reserved
-            for addr in range(0x08, 0x78):
-                try:
-                    # Use write_quick() - same method as i2cdetect
-                    # This sends a write command and checks for ACK
-                    # More reliable than read_byte() which can give false positives
-                    bus.write_quick(addr)
-                    devices.append(addr)
-                    # Small delay between addresses to avoid bus congestion
-                    time.sleep(0.001)
-                except (IOError, OSError):
-                    # Device not present at this address - this is normal
-                    pass
-                except Exception as e:
-                    # Other errors (permission, bus error, etc.)
-                    # Continue scanning other addresses
-                    pass
-            
-            bus.close()
+            try:
+                for addr in SCAN_ADDRESSES:
+                    try:
+                        # Use write_quick() - same method as i2cdetect
+                        # This sends a write command and checks for ACK
+                        # More reliable than read_byte() which can give false positives
+                        probed += 1
+                        bus.write_quick(addr)
+                        devices.append(addr)
+                        # Small delay between addresses to avoid bus congestion
+                        time.sleep(0.001)
+                    except I2CBusError as e:
+                        probed -= 1
+                        if e.errno == errno.EBUSY:
+                            raise  # Bus is being recovered - give up on this scan
+                        # Quarantined address - left out, as if it had vanished
+                    except OSError as e:
+                        if e.errno in (errno.ENXIO, errno.EREMOTEIO):
+                            continue  # Device not present at this address - this is normal
+                        if not health.healthy:
+                            # Hung bus: every further probe would only wait for the timeout
+                            raise
+            finally:
+                bus.close()
             # Small delay after closing to ensure bus is ready for next scan
             time.sleep(0.01)
         except ImportError:
@@ -151,13 +160,28 @@ class I2CScanner:
             # Other bus errors
             raise RuntimeError(f"I2C bus error: {e}")
         
+        if probed > 8 and len(devices) == probed:
+            # With SDA held low every address reads as acknowledged
+            health.request_recovery("every address acknowledged - SDA stuck low?")
+            raise RuntimeError(f"I2C bus {self.bus}: every address acknowledged - SDA stuck low")
         return devices
     
     def get_status(self) -> str:
         """Get I2C bus status."""
-        if os.path.exists(self.device_path):
-            return "OK"
-        return "NOT_AVAILABLE"
+        if not os.path.exists(self.device_path):
+            return "NOT_AVAILABLE"
+        health = get_health(self.bus)
+        if health.recovering:
+            return "RECOVERING"
+        return "OK" if health.healthy else "FAULT"
+    
+    def get_stats(self) -> dict:
+        """Transaction, fault and recovery counters of this bus (hardware/i2c_bus.py)."""
+        return get_health(self.bus).get_stats()
+    
+    def recover(self) -> dict:
+        """Recover the bus now (9 SCL pulses, STOP, adapter rebind); blocks until done."""
+        return get_health(self.bus).recover("requested")
     
     @staticmethod
     def scan_all_buses() -> dict:
@@ -0,0 +1,261 @@
+"""MPU6050 / MPU6500 register access and FIFO draining.
+
+No Qt and no threads here; acquisition/imu.py streams from it, the mpu6050
+and mpu6500 plugins and device_cli.py imu use it directly.
+
+The sensor samples into its on-chip FIFO (1024 bytes on the MPU6050, 512 on
+the MPU6500 family) at the rate set by SMPLRT_DIV, so the host only has to
+empty the FIFO every few milliseconds instead of reading every sample:
+
+    rate        with the DLPF on, the gyro output runs at 1 kHz and
+                SMPLRT_DIV divides it: rate = 1000 / (1 + SMPLRT_DIV)
+    DLPF        the widest bandwidth below rate / 2, so what lands in the
+                FIFO is not aliased (the MPU6050 accelerometer shares the
+                gyro setting, the MPU6500 gets the same index in ACCEL_CONFIG2)
+    drain       FIFO_COUNT (one 2-byte read), then every whole packet in
+                combined transactions of up to MAX_MESSAGE_BYTES - one for a
+                normal drain (smbus2's 32-byte block reads would split a
+                10 ms drain at 1 kHz into four), two for a late one that finds
+                up to 1020 bytes in the MPU6050's FIFO
+    decode      one np.frombuffer('>i2') over the burst, reshaped to
+                (packets, words) and scaled per column
+    overflow    a full FIFO keeps accepting data over its oldest bytes, so
+                packet boundaries are lost; a count at the FIFO size counts
+                an overflow and resets the FIFO instead of decoding
+                misaligned data
+
+A packet of accel + gyro is 12 bytes, 12 kB/s at 1 kHz; draining every 10 ms
+puts about 130 bytes per drain on the wire, roughly 30 % of a 400 kHz bus.
+"""
+
+import time
+from typing import Dict, List, Optional, Tuple
+
+from hardware.i2c_bus import MAX_MESSAGE_BYTES, I2CDevice
+
+# Registers
+SMPLRT_DIV = 0x19
+CONFIG = 0x1A
+GYRO_CONFIG = 0x1B
+ACCEL_CONFIG = 0x1C
+ACCEL_CONFIG2 = 0x1D  # MPU6500 family only
+FIFO_EN = 0x23
+INT_PIN_CFG = 0x37
+INT_ENABLE = 0x38
+INT_STATUS = 0x3A
+ACCEL_XOUT_H = 0x3B
+USER_CTRL = 0x6A
+PWR_MGMT_1 = 0x6B
+FIFO_COUNTH = 0x72
+FIFO_R_W = 0x74
+WHO_AM_I = 0x75
+
+# FIFO_EN bits
+FIFO_TEMP = 0x80
+FIFO_GYRO = 0x70  # XG, YG, ZG
+FIFO_ACCEL = 0x08
+
+# USER_CTRL bits
+USER_FIFO_EN = 0x40
+USER_FIFO_RESET = 0x04
+
+# INT_PIN_CFG: active low, open drain, 50 us pulse (same wiring as the ADS1x15 ALERT/RDY)
+INT_ACTIVE_LOW_OPEN_DRAIN = 0xC0
+INT_DATA_RDY = 0x01
+
+# WHO_AM_I -> model
+MODELS = {0x68: "MPU6050", 0x70: "MPU6500", 0x71: "MPU9250", 0x73: "MPU9255"}
+
+ACCEL_RANGES_G = (2, 4, 8, 16)
+GYRO_RANGES_DPS = (250, 500, 1000, 2000)
+
+# Gyro bandwidth (Hz) for DLPF_CFG 1..6; all of them give a 1 kHz gyro output rate
+DLPF_HZ = {"MPU6050": (188, 98, 42, 20, 10, 5)}
+DLPF_HZ_6500 = (184, 92, 41, 20, 10, 5)
+
+# Temperature: degC = raw / scale + offset
+TEMPERATURE = {"MPU6050": (340.0, 36.53)}
+TEMPERATURE_6500 = (333.87, 21.0)
+
+INTERNAL_RATE_HZ = 1000.0
+
+
+class IMUError(OSError):
+    """Not an MPU6050/MPU6500, or it does not respond as one."""
+
+
+class MPU6050:
+    """One MPU6050 or MPU6500-family IMU (the two share the FIFO interface)."""
+    
+    def __init__(self, bus, address: int = 0x68, device=None):
+        """Open the device and identify it.
+
+        Args:
+            bus: I2C bus number or I2CBus (ignored when device is given)
+            address: 0x68, or 0x69 with AD0 high
+            device: Register access object (read_registers / read_register /
+                write_register), e.g. a VirtualMPU6050; default I2CDevice
+
+        Raises:
+            IMUError: WHO_AM_I is not an MPU6050/MPU6500-family ID
+            ImportError: smbus2 not installed
+            OSError: Bus not accessible or nothing at the address
+        """
+        self.device = device if device is not None else I2CDevice(bus, address)
+        self.address = address
+        who = self.device.read_register(WHO_AM_I)
+        if who not in MODELS:
+            raise IMUError(f"0x{address:02X} is not an MPU6050/MPU6500 (WHO_AM_I 0x{who:02X})")
+        self.model = MODELS[who]
+        self.fifo_size = 1024 if self.model == "MPU6050" else 512
+        self.rate_hz = INTERNAL_RATE_HZ
+        self.dlpf_hz = self.bandwidths[0]
+        self.accel_range_g = 2
+        self.gyro_range_dps = 250
+        self.temperature = False
+        self.columns: List[str] = []
+        self.packet = 0
+        self._scale = self._offset = None
+    
+    @property
+    def bandwidths(self) -> Tuple[int, ...]:
+        return DLPF_HZ.get(self.model, DLPF_HZ_6500)
+    
+    def close(self):
+        if hasattr(self.device, "close"):
+            self.device.close()
+    
+    def __enter__(self):
+        return self
+    
+    def __exit__(self, *exc):
+        self.close()
+    
+    def configure(self, rate_hz: float = INTERNAL_RATE_HZ, accel_range_g: int = 4,
+                  gyro_range_dps: int = 500, dlpf_hz: Optional[float] = None,
+                  temperature: bool = False, data_ready: bool = False) -> dict:
+        """Reset the device, set rate, ranges and DLPF, and start the FIFO.
+
+        Args:
+            rate_hz: Output data rate; rounded to 1000 / (1 + SMPLRT_DIV)
+            accel_range_g: Accelerometer full scale (2, 4, 8, 16)
+            gyro_range_dps: Gyro full scale (250, 500, 1000, 2000)
+            dlpf_hz: Low-pass bandwidth (closest setting); None = widest below rate / 2
+            temperature: Also put the temperature into the FIFO
+            data_ready: Pulse INT (active low, open drain) for every sample
+
+        Returns:
+            The settings actually applied
+        """
+        if accel_range_g not in ACCEL_RANGES_G:
+            raise ValueError(f"Accelerometer range must be one of {ACCEL_RANGES_G} g")
+        if gyro_range_dps not in GYRO_RANGES_DPS:
+            raise ValueError(f"Gyro range must be one of {GYRO_RANGES_DPS} deg/s")
+        if not 0 < rate_hz <= INTERNAL_RATE_HZ:
+            raise ValueError(f"Rate must be above 0 and at most {INTERNAL_RATE_HZ:g} Hz")
+        divider = max(0, min(255, round(INTERNAL_RATE_HZ / rate_hz) - 1))
+        bandwidths = self.bandwidths
+        if dlpf_hz is None:
+            nyquist = INTERNAL_RATE_HZ / (1 + divider) / 2
+            index = next((i for i, bw in enumerate(bandwidths) if bw < nyquist),
+                         len(bandwidths) - 1)
+        else:
+            index = min(range(len(bandwidths)), key=lambda i: abs(bandwidths[i] - dlpf_hz))
+        
+        dev = self.device
+        dev.write_register(PWR_MGMT_1, 0x80)  # Device reset
+        time.sleep(0.1)
+        dev.write_register(PWR_MGMT_1, 0x01)  # Wake, PLL on the X gyro (better than the RC clock)
+        dev.write_register(USER_CTRL, 0x00)
+        dev.write_register(FIFO_EN, 0x00)
+        dev.write_register(SMPLRT_DIV, divider)
+        dev.write_register(CONFIG, index + 1)
+        dev.write_register(GYRO_CONFIG, GYRO_RANGES_DPS.index(gyro_range_dps) << 3)
+        dev.write_register(ACCEL_CONFIG, ACCEL_RANGES_G.index(accel_range_g) << 3)
+        if self.model != "MPU6050":
+            dev.write_register(ACCEL_CONFIG2, index + 1)
+        dev.write_register(INT_PIN_CFG, INT_ACTIVE_LOW_OPEN_DRAIN)
+        dev.write_register(INT_ENABLE, INT_DATA_RDY if data_ready else 0x00)
+        dev.write_register(FIFO_EN, FIFO_ACCEL | FIFO_GYRO | (FIFO_TEMP if temperature else 0))
+        
+        self.rate_hz = INTERNAL_RATE_HZ / (1 + divider)
+        self.dlpf_hz = bandwidths[index]
+        self.accel_range_g = accel_range_g
+        self.gyro_range_dps = gyro_range_dps
+        self.temperature = temperature
+        self._set_layout()
+        self.reset_fifo()
+        return {"model": self.model, "rate_hz": self.rate_hz, "dlpf_hz": self.dlpf_hz,
+                "accel_range_g": accel_range_g, "gyro_range_dps": gyro_range_dps,
+                "packet_bytes": self.packet, "fifo_bytes": self.fifo_size,
+                "fifo_ms": 1000.0 * (self.fifo_size // self.packet) / self.rate_hz}
+    
+    def _set_layout(self):
+        """Columns and per-column scale/offset of a FIFO packet (register order)."""
+        import numpy as np
+        
+        temp_scale, temp_offset = TEMPERATURE.get(self.model, TEMPERATURE_6500)
+        accel = self.accel_range_g / 32768.0
+        gyro = self.gyro_range_dps / 32768.0
+        self.columns = ["ax", "ay", "az"] + (["temp"] if self.temperature else []) + \
+                       ["gx", "gy", "gz"]
+        self.packet = 2 * len(self.columns)
+        self._scale = np.array([accel] * 3 + ([1.0 / temp_scale] if self.temperature else [])
+                               + [gyro] * 3)
+        self._offset = np.array([0.0] * 3 + ([temp_offset] if self.temperature else [])
+                                + [0.0] * 3)
+    
+    def reset_fifo(self):
+        """Empty the FIFO and restart it (FIFO_RESET only takes effect with the FIFO off)."""
+        self.device.write_register(USER_CTRL, USER_FIFO_RESET)
+        self.device.write_register(USER_CTRL, USER_FIFO_EN)
+    
+    def fifo_count(self) -> int:
+        high, low = self.device.read_registers(FIFO_COUNTH, 2)
+        return ((high << 8) | low) & 0x1FFF
+    
+    def drain(self, max_packets: Optional[int] = None) -> Tuple[bytes, int, bool]:
+        """Read every whole packet in the FIFO (up to max_packets).
+
+        Each transaction carries at most MAX_MESSAGE_BYTES, whole packets only.
+
+        Returns:
+            (packet bytes, FIFO count before the read, True if the FIFO had
+            overflowed - it was reset and the data discarded)
+        """
+        count = self.fifo_count()
+        if count >= self.fifo_size:
+            self.reset_fifo()
+            return b"", count, True
+        packets = count // self.packet
+        if max_packets is not None:
+            packets = min(packets, max_packets)
+        if not packets:
+            return b"", count, False
+        per_message = max(1, MAX_MESSAGE_BYTES // self.packet)
+        data = b""
+        while packets > 0:
+            chunk = min(packets, per_message)
+            data += self.device.read_registers(FIFO_R_W, chunk * self.packet)
+            packets -= chunk
+        return data, count, False
+    
+    def decode(self, data: bytes):
+        """FIFO bytes -> (packets, columns) float array in g, deg/s (and degC)."""
+        import numpy as np
+        
+        words = np.frombuffer(data, dtype=">i2").reshape(-1, len(self.columns))
+        return words * self._scale + self._offset
+    
+    def read_sample(self) -> Dict[str, float]:
+        """Current output registers (one 14-byte burst), bypassing the FIFO."""
+        import numpy as np
+        
+        temp_scale, temp_offset = TEMPERATURE.get(self.model, TEMPERATURE_6500)
+        words = np.frombuffer(self.device.read_registers(ACCEL_XOUT_H, 14), dtype=">i2")
+        accel = self.accel_range_g / 32768.0
+        gyro = self.gyro_range_dps / 32768.0
+        values = [float(w) * accel for w in words[:3]] + \
+                 [float(words[3]) / temp_scale + temp_offset] + \
+                 [float(w) * gyro for w in words[4:]]
+        return dict(zip(("ax", "ay", "az", "temp", "gx", "gy", "gz"), values))
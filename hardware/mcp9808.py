@@ -0,0 +1,201 @@
+"""MCP9808 digital temperature sensor: reads, resolution and the ALERT window.
+
+No Qt and no threads here; acquisition/temperature.py polls these or waits
+on their ALERT line, and the mcp9808 plugin uses them directly.
+
+Every register is a big-endian 16-bit word. T_A carries the temperature and,
+in its top three bits, how it compares with the window (T_CRIT, T_UPPER,
+T_LOWER), so one 2-byte read after an ALERT edge says both what the
+temperature is and which limit was crossed.
+"""
+
+from typing import Dict, Optional, Tuple
+
+from hardware.i2c_bus import I2CDevice
+
+# Registers
+CONFIG = 0x01
+T_UPPER = 0x02
+T_LOWER = 0x03
+T_CRIT = 0x04
+T_A = 0x05
+MANUFACTURER_ID = 0x06
+DEVICE_ID = 0x07
+RESOLUTION = 0x08
+
+MANUFACTURER = 0x0054
+DEVICE = 0x04  # Upper byte of DEVICE_ID; the lower one is the revision
+
+# CONFIG bits
+CONFIG_SHDN = 0x0100
+CONFIG_CRIT_LOCK = 0x0080
+CONFIG_WIN_LOCK = 0x0040
+CONFIG_INT_CLEAR = 0x0020
+CONFIG_ALERT_STAT = 0x0010
+CONFIG_ALERT_CNT = 0x0008
+CONFIG_ALERT_SEL = 0x0004   # ALERT on T_CRIT only
+CONFIG_ALERT_POL = 0x0002   # Active high (default active low, open drain)
+CONFIG_ALERT_MOD = 0x0001   # Interrupt instead of comparator output
+
+# Hysteresis (degC) in register order (CONFIG bits 10:9)
+HYSTERESIS = (0.0, 1.5, 3.0, 6.0)
+
+# T_A flag bits
+FLAG_CRIT = 0x8000
+FLAG_UPPER = 0x4000
+FLAG_LOWER = 0x2000
+
+# Resolution (degC) and typical conversion time (ms) in register order
+RESOLUTIONS = ((0.5, 30.0), (0.25, 65.0), (0.125, 130.0), (0.0625, 250.0))
+
+# T_CRIT when no critical limit is given: the top of the rated range, so only the
+# window drives ALERT
+CRITICAL_DEFAULT = 125.0
+
+# Window states, as reported by read_state() and in "alert" events
+INSIDE, ABOVE, CRITICAL, BELOW = 0, 1, 2, -1
+
+
+class SensorError(OSError):
+    """Not an MCP9808."""
+
+
+def decode(word: int) -> Tuple[float, int]:
+    """T_A word -> (degC, window state)."""
+    value = word & 0x0FFF
+    temperature = (value - 0x1000 if word & 0x1000 else value) / 16.0
+    if word & FLAG_CRIT:
+        state = CRITICAL
+    elif word & FLAG_UPPER:
+        state = ABOVE
+    elif word & FLAG_LOWER:
+        state = BELOW
+    else:
+        state = INSIDE
+    return temperature, state
+
+
+def encode_limit(celsius: float) -> int:
+    """degC -> limit register word (0.25 degC steps in bits 12:2, two's complement)."""
+    quarters = int(round(celsius * 4))
+    if not -1024 <= quarters < 1024:
+        raise ValueError(f"Limit {celsius} degC out of range")
+    return (quarters & 0x7FF) << 2
+
+
+def resolution_for(rate_hz: float) -> int:
+    """Finest resolution (register value) whose conversion fits the poll period."""
+    period_ms = 1000.0 / rate_hz
+    for index in range(len(RESOLUTIONS) - 1, 0, -1):
+        if RESOLUTIONS[index][1] <= period_ms:
+            return index
+    return 0
+
+
+class MCP9808:
+    """One MCP9808 (also JC42.4 compatible parts with the same IDs)."""
+    
+    def __init__(self, bus, address: int = 0x18, device=None):
+        """Identify the sensor.
+
+        Args:
+            bus: I2C bus number or shared I2CBus
+            address: 0x18-0x1F (A2-A0)
+            device: Register access object (default I2CDevice)
+
+        Raises:
+            SensorError: Manufacturer/device ID don't match
+            ImportError: smbus2 not installed
+            OSError: Bus not accessible or nothing at the address
+        """
+        self.device = device if device is not None else I2CDevice(bus, address)
+        self.address = address
+        self.bus_number = getattr(bus, "bus", bus)
+        manufacturer = self._read_word(MANUFACTURER_ID)
+        device_id = self._read_word(DEVICE_ID)
+        if manufacturer != MANUFACTURER or device_id >> 8 != DEVICE:
+            raise SensorError(f"0x{address:02X} is not an MCP9808 (IDs 0x{manufacturer:04X}/"
+                              f"0x{device_id:04X})")
+        self.revision = device_id & 0xFF
+        self.resolution = RESOLUTIONS[3][0]
+        self._config = self._read_word(CONFIG)
+    
+    def close(self):
+        if hasattr(self.device, "close"):
+            self.device.close()
+    
+    def __enter__(self):
+        return self
+    
+    def __exit__(self, *exc):
+        self.close()
+    
+    def _read_word(self, register: int) -> int:
+        data = self.device.read_registers(register, 2)
+        return (data[0] << 8) | data[1]
+    
+    def _write_word(self, register: int, value: int):
+        self.device.write_registers(register, bytes((value >> 8, value & 0xFF)))
+    
+    def read_state(self) -> Tuple[float, int]:
+        """Temperature (degC) and window state in one 2-byte read."""
+        return decode(self._read_word(T_A))
+    
+    def read(self) -> float:
+        """Temperature (degC)."""
+        return self.read_state()[0]
+    
+    def set_resolution(self, index: int):
+        """Resolution by register value (0 = 0.5 degC / 30 ms ... 3 = 0.0625 degC / 250 ms)."""
+        self.device.write_register(RESOLUTION, index)
+        self.resolution = RESOLUTIONS[index][0]
+    
+    def set_alert(self, lower: float, upper: float, critical: Optional[float] = None,
+                  hysteresis: float = 1.5):
+        """Program the window and drive ALERT (active low) while outside it.
+
+        Args:
+            lower: T_LOWER (degC)
+            upper: T_UPPER (degC)
+            critical: T_CRIT (degC); None = CRITICAL_DEFAULT
+            hysteresis: Release hysteresis (degC), one of HYSTERESIS
+
+        Comparator mode: ALERT follows the temperature, so it asserts when the
+        temperature leaves [lower, upper] (or reaches critical) and releases
+        once it is back inside by the hysteresis - one edge each way, no
+        register access needed to re-arm.
+
+        Raises:
+            ValueError: Limits out of order or out of range, unknown hysteresis
+        """
+        if critical is None:
+            critical = max(upper, CRITICAL_DEFAULT)
+        if not lower < upper <= critical:
+            raise ValueError("Limits must satisfy lower < upper <= critical")
+        if hysteresis not in HYSTERESIS:
+            raise ValueError(f"Hysteresis must be one of {HYSTERESIS}")
+        if self._config & (CONFIG_CRIT_LOCK | CONFIG_WIN_LOCK):
+            raise ValueError("Limits are locked until the next power cycle")
+        # Limits and hysteresis are only writable with the alert output off
+        self._write_word(CONFIG, self._config & ~CONFIG_ALERT_CNT)
+        self._write_word(T_UPPER, encode_limit(upper))
+        self._write_word(T_LOWER, encode_limit(lower))
+        self._write_word(T_CRIT, encode_limit(critical))
+        config = (self._config & CONFIG_SHDN) | (HYSTERESIS.index(hysteresis) << 9)
+        self._write_word(CONFIG, config)
+        self._config = config | CONFIG_ALERT_CNT
+        self._write_word(CONFIG, self._config)
+    
+    def disable_alert(self):
+        self._config &= ~CONFIG_ALERT_CNT
+        self._write_word(CONFIG, self._config)
+    
+    def get_window(self) -> Dict[str, float]:
+        """Programmed limits (degC)."""
+        limits = {}
+        for name, register in (("lower", T_LOWER), ("upper", T_UPPER), ("critical", T_CRIT)):
+            word = (self._read_word(register) >> 2) & 0x7FF
+            limits[name] = (word - 0x800 if word & 0x400 else word) / 4.0
+        limits["hysteresis"] = HYSTERESIS[(self._config >> 9) & 0x03]
+        limits["alert"] = bool(self._config & CONFIG_ALERT_CNT)
+        return limits
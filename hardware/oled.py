@@ -0,0 +1,109 @@
+"""OLED helpers shared by the GUI plugins and the headless CLI.
+
+No Qt here: text and images are rendered with PIL (imported lazily) and
+pushed through the display engine in hardware/display/, which drives the
+SSD1306, SSD1309 and SH1106 over the panel's own smbus2 bus layer (Blinka
+and the Adafruit driver never load). Displays stay open between calls, so
+showing new text only sends the columns that changed.
+"""
+
+from typing import Optional, Tuple
+
+from config.device_config import OLED_CONTROLLER
+from hardware.display.framebuffer import FONT_PATH
+
+LINE_HEIGHT = 12
+
+
+def open_display(address: int = 0x3C, controller: str = OLED_CONTROLLER,
+                 bus: Optional[int] = None):
+    """Open the display (or reuse it if already open); see hardware.display.open_display.
+
+    Raises:
+        ValueError: Unknown controller
+        ImportError: smbus2 not installed
+        OSError: Bus not accessible
+    """
+    from hardware.display import open_display as open_controller
+    
+    return open_controller(address, controller, bus)
+
+
+def render_text(text: str, size: Tuple[int, int] = (128, 64)):
+    """Render word-wrapped text into a 1-bit PIL image of the given size."""
+    from PIL import Image, ImageDraw, ImageFont
+    
+    width, height = size
+    image = Image.new('1', (width, height))
+    draw = ImageDraw.Draw(image)
+    try:
+        font = ImageFont.truetype(FONT_PATH, 12)
+    except Exception:
+        font = ImageFont.load_default()
+    
+    y_offset = 0
+    for line in text.split('\n'):
+        if y_offset + LINE_HEIGHT > height:
+            break
+        # Wrap long lines
+        current_line = ""
+        for word in line.split(' '):
+            test_line = current_line + (" " if current_line else "") + word
+            bbox = draw.textbbox((0, 0), test_line, font=font)
+            if bbox[2] - bbox[0] <= width:
+                current_line = test_line
+            else:
+                if current_line:
+                    draw.text((0, y_offset), current_line, font=font, fill=255)
+                    y_offset += LINE_HEIGHT
+                    if y_offset + LINE_HEIGHT > height:
+                        break
+                current_line = word
+        if current_line and y_offset + LINE_HEIGHT <= height:
+            draw.text((0, y_offset), current_line, font=font, fill=255)
+            y_offset += LINE_HEIGHT
+    return image
+
+
+def render_image(path: str, size: Tuple[int, int] = (128, 64)):
+    """Load an image file, fit it into size (centered) and threshold to 1-bit.
+
+    Returns:
+        (image, original_size, resized_size)
+    """
+    from PIL import Image
+    
+    width, height = size
+    img = Image.open(path)
+    original_size = (img.width, img.height)
+    if img.mode != 'L':
+        img = img.convert('L')
+    img.thumbnail((width, height), Image.Resampling.LANCZOS)
+    
+    display_img = Image.new('1', (width, height), 0)
+    img_1bit = img.point(lambda x: 255 if x > 128 else 0, mode='1')
+    display_img.paste(img_1bit, ((width - img.width) // 2, (height - img.height) // 2))
+    return display_img, original_size, (img.width, img.height)
+
+
+def show_text(text: str, address: int = 0x3C, controller: str = OLED_CONTROLLER,
+              bus: Optional[int] = None):
+    """Render text and push what changed to the display."""
+    display = open_display(address, controller, bus)
+    display.image(render_text(text, (display.width, display.height)))
+    display.show()
+    return display
+
+
+def show_image(path: str, address: int = 0x3C, controller: str = OLED_CONTROLLER,
+               bus: Optional[int] = None):
+    """Render an image file and push what changed to the display.
+
+    Returns:
+        (display, original_size, resized_size)
+    """
+    display = open_display(address, controller, bus)
+    image, original_size, resized_size = render_image(path, (display.width, display.height))
+    display.image(image)
+    display.show()
+    return display, original_size, resized_size
@@ -2,6 +2,7 @@
 
 from hardware.platform import is_raspberry_pi
 import os
+import time
 
 
 class SPITester:
@@ -42,5 +43,54 @@ class SPITester:
             "miso": "MISO response detected" if self._test_count % 2 == 0 else "MISO response not detected",
             "status": "OK" if self._test_count % 2 == 0 else "NOT VERIFIED"
         }
-
-
+    
+    def loopback(self, pattern: bytes, speed_hz: int = 1000000, repeat: int = 1) -> dict:
+        """Send pattern and compare what comes back (needs MOSI jumpered to MISO).
+        
+        Args:
+            pattern: Bytes to send (spidev limits one transfer to 4096 bytes)
+            speed_hz: SPI clock
+            repeat: Number of transfers
+            
+        Returns:
+            Dictionary with bytes sent, mismatching bytes, elapsed time, status
+            ("OK", "MISMATCH", or "NOT_AVAILABLE" on a Pi without spidev0.0)
+            and mock (True off the Pi, where the loopback is simulated)
+        """
+        data = list(pattern)
+        if self.is_pi and not os.path.exists(self.spi_device):
+            return {
+                "bytes": 0,
+                "errors": None,
+                "speed_hz": speed_hz,
+                "elapsed_s": 0.0,
+                "throughput_Bps": 0.0,
+                "status": "NOT_AVAILABLE",
+                "mock": False,
+                "error": f"{self.spi_device} missing - enable SPI (dtparam=spi=on)",
+            }
+        errors = 0
+        start = time.perf_counter()
+        if self.is_pi:
+            import spidev
+            spi = spidev.SpiDev()
+            spi.open(0, 0)
+            try:
+                spi.max_speed_hz = speed_hz
+                for _ in range(repeat):
+                    received = spi.xfer2(data)
+                    errors += sum(1 for a, b in zip(data, received) if a != b)
+            finally:
+                spi.close()
+        # Not on a Pi: a perfect loopback, flagged as mock
+        elapsed = time.perf_counter() - start
+        sent = len(data) * repeat
+        return {
+            "bytes": sent,
+            "errors": errors,
+            "speed_hz": speed_hz,
+            "elapsed_s": elapsed,
+            "throughput_Bps": sent / elapsed if elapsed > 0 else 0.0,
+            "status": "OK" if errors == 0 else "MISMATCH",
+            "mock": not self.is_pi,
+        }
@@ -104,6 +104,20 @@ class MockSPI:
             "miso": "MISO response detected" if self._test_count % 2 == 0 else "MISO response not detected",
             "status": "OK" if self._test_count % 2 == 0 else "NOT VERIFIED"
         }
+    
+    def loopback(self, pattern: bytes, speed_hz: int = 1000000, repeat: int = 1) -> Dict:
+        """Simulate a perfect MOSI->MISO loopback at the requested clock."""
+        sent = len(pattern) * repeat
+        elapsed = sent * 8 / speed_hz
+        return {
+            "bytes": sent,
+            "errors": 0,
+            "speed_hz": speed_hz,
+            "elapsed_s": elapsed,
+            "throughput_Bps": sent / elapsed if elapsed > 0 else 0.0,
+            "status": "OK",
+            "mock": True,
+        }
 
 
 class MockPower:
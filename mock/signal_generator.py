@@ -0,0 +1,191 @@
+"""Synthetic signal backend for load testing.
+
+Unlike MockHardware (one random value per call), this generates whole
+blocks of samples with NumPy at a fixed rate, so the acquisition pipeline
+can be driven at thousands of samples per second on a laptop. Output is
+deterministic for a given seed and does not depend on how the stream is
+split into blocks.
+
+Profiles (per channel, all accept "offset", "amp" and "noise" = sigma):
+    sine    freq
+    chirp   f0, f1, period      linear sweep f0 -> f1, repeating every period
+    step    at                  offset before t=at, offset + amp after
+    square  freq, duty
+    noise                       Gaussian, sigma = amp
+    burst   freq, on, period    sine for `on` seconds every `period` seconds
+"""
+
+import time
+from typing import Dict, List, Optional, Tuple
+
+import numpy as np
+
+from .mock_hardware import MockGPIO, MockI2C, MockPower, MockSPI
+
+DEFAULT_PROFILES = {
+    0: {"type": "sine", "freq": 5.0, "amp": 1.0, "offset": 1.65, "noise": 0.005},
+    1: {"type": "chirp", "f0": 1.0, "f1": 50.0, "period": 10.0, "amp": 1.0, "offset": 1.65},
+    2: {"type": "square", "freq": 2.0, "duty": 0.5, "amp": 1.5, "offset": 1.65},
+    3: {"type": "burst", "freq": 40.0, "on": 0.2, "period": 2.0, "amp": 1.0, "offset": 1.65,
+        "noise": 0.02},
+}
+
+
+def _render(spec: dict, t: np.ndarray, rng: np.random.Generator) -> np.ndarray:
+    """Evaluate one channel profile at times t (seconds since start)."""
+    kind = spec.get("type", "sine")
+    amp = spec.get("amp", 1.0)
+    sigma = spec.get("noise", 0.0)
+    # The normals are drawn per sample (the noise profile's and the noise sigma's
+    # side by side), so the stream doesn't depend on how it is split into blocks
+    columns = (kind == "noise") + bool(sigma)
+    draws = rng.standard_normal((len(t), columns)) if columns else None
+    if kind == "sine":
+        wave = amp * np.sin(2 * np.pi * spec.get("freq", 1.0) * t + spec.get("phase", 0.0))
+    elif kind == "chirp":
+        f0, f1 = spec.get("f0", 1.0), spec.get("f1", 10.0)
+        period = spec.get("period", 10.0)
+        tau = np.mod(t, period)
+        wave = amp * np.sin(2 * np.pi * (f0 * tau + (f1 - f0) * tau * tau / (2 * period)))
+    elif kind == "step":
+        wave = np.where(t >= spec.get("at", 1.0), amp, 0.0)
+    elif kind == "square":
+        cycle = np.mod(t * spec.get("freq", 1.0), 1.0)
+        wave = np.where(cycle < spec.get("duty", 0.5), amp, -amp)
+    elif kind == "noise":
+        wave = amp * draws[:, 0]
+    elif kind == "burst":
+        active = np.mod(t, spec.get("period", 1.0)) < spec.get("on", 0.1)
+        wave = np.where(active, amp * np.sin(2 * np.pi * spec.get("freq", 10.0) * t), 0.0)
+    else:
+        raise ValueError(f"Unknown signal profile '{kind}'")
+    wave = wave + spec.get("offset", 0.0)
+    if sigma:
+        wave = wave + sigma * draws[:, -1]
+    return wave
+
+
+class SignalGenerator:
+    """Block-wise multi-channel signal source."""
+    
+    def __init__(self, rate_hz: float, profiles: Optional[Dict[int, dict]] = None,
+                 seed: int = 0):
+        """Initialize generator.
+
+        Args:
+            rate_hz: Sample rate per channel
+            profiles: Channel -> profile dict (default: DEFAULT_PROFILES)
+            seed: RNG seed; each channel gets its own stream derived from it
+        """
+        self.rate_hz = rate_hz
+        self.profiles = dict(DEFAULT_PROFILES if profiles is None else profiles)
+        self.seed = seed
+        self.position = 0  # Index of the next sample
+        self._rngs = {ch: np.random.default_rng([seed, ch]) for ch in self.profiles}
+    
+    def generate(self, count: int) -> Tuple[np.ndarray, Dict[int, np.ndarray]]:
+        """Produce the next count samples of every channel.
+
+        Returns:
+            (t, values) - t is seconds since the first sample, values maps
+            channel -> float64 array
+        """
+        t = (self.position + np.arange(count)) / self.rate_hz
+        self.position += count
+        return t, {ch: _render(spec, t, self._rngs[ch]) for ch, spec in self.profiles.items()}
+
+
+class SyntheticADC:
+    """ADC manager backed by a SignalGenerator.
+
+    read_block() returns every sample that fell due since the previous call,
+    which the acquisition engine uses instead of per-sample read_channel().
+    """
+    
+    def __init__(self, generator: SignalGenerator):
+        self.generator = generator
+        self.is_pi = False
+        self._t_start: Optional[float] = None
+        self._probe_rng = np.random.default_rng([generator.seed, 0xFFFF])
+        self.latest: Dict[int, float] = {}
+    
+    def read_block(self, now: Optional[float] = None) -> Tuple[np.ndarray, Dict[int, np.ndarray]]:
+        """Samples due up to now (monotonic seconds), with monotonic timestamps."""
+        if now is None:
+            now = time.monotonic()
+        if self._t_start is None:
+            self._t_start = now
+        due = int((now - self._t_start) * self.generator.rate_hz) + 1 - self.generator.position
+        t, values = self.generator.generate(max(0, due))
+        if len(t):
+            self.latest = {ch: float(v[-1]) for ch, v in values.items()}
+        return t + self._t_start, values
+    
+    def read_channel(self, channel: int) -> Optional[float]:
+        """Instantaneous value (the latest block value once streaming)."""
+        if channel in self.latest:
+            return self.latest[channel]
+        spec = self.generator.profiles.get(channel)
+        if spec is None:
+            return None
+        return float(_render(spec, np.zeros(1), self._probe_rng)[0])
+    
+    def read_all_channels(self) -> Dict[int, Optional[float]]:
+        return {i: self.read_channel(i) for i in range(4)}
+
+
+class SyntheticGPIO(MockGPIO):
+    """Mock GPIO whose buttons produce edge trains at fixed rates.
+
+    Each button toggles at its configured rate (edges per second), with
+    optional deterministic jitter as a fraction of the edge interval.
+    """
+    
+    def __init__(self, edge_rates: Optional[Dict[int, float]] = None, jitter: float = 0.0,
+                 seed: int = 0):
+        super().__init__()
+        self.edge_rates = dict({1: 1.0, 2: 0.5} if edge_rates is None else edge_rates)
+        self.jitter = jitter
+        self._rngs = {b: np.random.default_rng([seed, 0xB077, b]) for b in self.edge_rates}
+        self._t_start: Optional[float] = None
+        self._next_edge: Dict[int, float] = {}
+    
+    def read_edges(self, now: Optional[float] = None) -> List[Tuple[float, int, bool]]:
+        """All edges up to now as (monotonic time, button_id, pressed), in time order."""
+        if now is None:
+            now = time.monotonic()
+        if self._t_start is None:
+            self._t_start = now
+            self._next_edge = {b: now + self._interval(b)
+                               for b, rate in self.edge_rates.items() if rate > 0}
+        edges = []
+        for button_id, due in self._next_edge.items():
+            while due <= now:
+                self.button_states[button_id] = not self.button_states[button_id]
+                edges.append((due, button_id, self.button_states[button_id]))
+                due += self._interval(button_id)
+            self._next_edge[button_id] = due
+        edges.sort()
+        return edges
+    
+    def _interval(self, button_id: int) -> float:
+        interval = 1.0 / self.edge_rates[button_id]
+        if self.jitter:
+            interval *= 1.0 + self.jitter * (self._rngs[button_id].random() * 2.0 - 1.0)
+        return interval
+    
+    def get_button(self, button_id: int) -> bool:
+        self.read_edges()
+        return self.button_states.get(button_id, False)
+
+
+class SyntheticHardware:
+    """Hardware container with synthetic ADC/GPIO and the usual mocks."""
+    
+    def __init__(self, rate_hz: float, profiles: Optional[Dict[int, dict]] = None,
+                 edge_rates: Optional[Dict[int, float]] = None, seed: int = 0):
+        self.adc = SyntheticADC(SignalGenerator(rate_hz, profiles, seed))
+        self.gpio = SyntheticGPIO(edge_rates, seed=seed)
+        self.i2c = MockI2C()
+        self.spi = MockSPI()
+        self.power = MockPower()
@@ -0,0 +1,294 @@
+"""Virtual ADS1115/ADS1015 on a virtual I2C bus, with realistic timing.
+
+Unlike MockADC, which returns instantly, this models where the time goes
+on real hardware so the acquisition loop can be benchmarked without a
+board:
+    I2C transfers   9 bit times per byte at the bus clock plus a fixed
+                    per-transfer (ioctl) overhead, serialized on a bus lock,
+                    so I2C scans or OLED frames on the same bus delay reads
+    conversions     1 / data rate, scaled by the internal oscillator error
+                    (clock_ppm; the datasheet allows up to +-10 %)
+    registers       config (OS, MUX, PGA, MODE, DR) and conversion, with
+                    single-shot and continuous mode
+    ALERT/RDY       conversion-complete times in continuous mode (ready_edges)
+
+read_channel() follows ADCManager's direct path: write config, sleep a
+conversion plus margin, read the conversion register.
+"""
+
+import math
+import random
+import threading
+import time
+from typing import Callable, Dict, List, Optional, Tuple
+
+CONVERSION_REG = 0x00
+CONFIG_REG = 0x01
+
+DATA_RATES = {
+    16: (8, 16, 32, 64, 128, 250, 475, 860),          # ADS1115
+    12: (128, 250, 490, 920, 1600, 2400, 3300, 3300),  # ADS1015
+}
+PGA_FULL_SCALE = (6.144, 4.096, 2.048, 1.024, 0.512, 0.256, 0.256, 0.256)
+
+# Same wait as ADCManager's direct read (in conversion times)
+CONVERSION_MARGIN = 1.3
+
+
+class VirtualI2CBus:
+    """Serialized I2C bus with byte-accurate transfer times."""
+    
+    def __init__(self, clock_khz: float = 400.0, overhead_us: float = 40.0):
+        self.clock_hz = clock_khz * 1000.0
+        self.overhead_s = overhead_us / 1e6
+        self.devices: Dict[int, object] = {}
+        self.transfers = 0
+        self.busy_s = 0.0
+        self._lock = threading.Lock()
+    
+    def transfer(self, nbytes: int):
+        """Occupy the bus for one transfer of nbytes (address byte included)."""
+        duration = self.overhead_s + nbytes * 9 / self.clock_hz
+        with self._lock:
+            time.sleep(duration)
+            self.transfers += 1
+            self.busy_s += duration
+    
+    def scan(self) -> List[int]:
+        """Probe 0x03..0x77 like i2cdetect (one quick write per address)."""
+        for _ in range(0x03, 0x78):
+            self.transfer(1)
+        return sorted(self.devices)
+    
+    def get_status(self) -> str:
+        return "OK"
+
+
+def _default_signal(channel: int) -> Callable[[float], float]:
+    base = (1.234, 3.301, 0.012, 3.9)[channel % 4]
+    freq = 0.5 + channel
+    return lambda t: base + 0.05 * math.sin(2 * math.pi * freq * t)
+
+
+class VirtualADS1x15:
+    """Register-level ADS1115 (resolution=16) or ADS1015 (resolution=12)."""
+    
+    def __init__(self, bus: Optional[VirtualI2CBus] = None, address: int = 0x48,
+                 resolution: int = 16, clock_ppm: float = 0.0,
+                 signals: Optional[Dict[int, Callable[[float], float]]] = None,
+                 noise_v: float = 0.0005, seed: int = 0):
+        """Create a virtual converter and attach it to the bus.
+
+        Args:
+            bus: Shared bus (default: a private 400 kHz bus)
+            address: I2C address (0x48..0x4B)
+            resolution: 16 for ADS1115, 12 for ADS1015
+            clock_ppm: Internal oscillator error; positive = conversions run fast
+            signals: channel -> f(t) in volts (t = time.monotonic())
+            noise_v: Gaussian input noise (V rms)
+            seed: Noise seed
+        """
+        self.bus = bus or VirtualI2CBus()
+        self.bus.devices[address] = self
+        self.address = address
+        self.resolution = resolution
+        self.clock_scale = 1.0 + clock_ppm / 1e6
+        self.signals = {ch: _default_signal(ch) for ch in range(4)}
+        self.signals.update(signals or {})
+        self.noise_v = noise_v
+        self._random = random.Random(seed)
+        # Power-on default: single-shot, AIN0/AIN1, +-2.048 V, 128 SPS (1600 on ADS1015)
+        self.config = 0x8583
+        self._conversion = 0
+        self._started: Optional[float] = None  # Start of the running conversion
+        self._done = 0  # Conversions completed since _started (continuous mode)
+        self._lock = threading.Lock()
+    
+    # Timing --------------------------------------------------------------------
+    
+    @property
+    def model(self) -> str:
+        return "ADS1015" if self.resolution == 12 else "ADS1115"
+    
+    @property
+    def data_rates(self) -> Tuple[int, ...]:
+        """Selectable data rates (samples/s), ascending."""
+        return tuple(sorted(set(DATA_RATES[self.resolution])))
+    
+    @property
+    def data_rate(self) -> int:
+        return DATA_RATES[self.resolution][(self.config >> 5) & 0x7]
+    
+    @property
+    def conversion_s(self) -> float:
+        return 1.0 / (self.data_rate * self.clock_scale)
+    
+    @property
+    def continuous(self) -> bool:
+        return not self.config & 0x0100
+    
+    def ready_edges(self, since: float, until: Optional[float] = None) -> List[float]:
+        """ALERT/RDY conversion-complete times in (since, until] (continuous mode)."""
+        if not self.continuous or self._started is None:
+            return []
+        until = time.monotonic() if until is None else until
+        period = self.conversion_s
+        first = max(1, math.floor((since - self._started) / period) + 1)
+        last = math.floor((until - self._started) / period)
+        return [self._started + k * period for k in range(first, last + 1)]
+    
+    # Registers -----------------------------------------------------------------
+    
+    def _sample(self, t: float) -> int:
+        """Code for the input at t (the end of a conversion)."""
+        mux = (self.config >> 12) & 0x7
+        channel = mux - 4 if mux >= 4 else 0
+        volts = self.signals[channel](t) + self._random.gauss(0.0, self.noise_v)
+        full_scale = PGA_FULL_SCALE[(self.config >> 9) & 0x7]
+        top = (1 << (self.resolution - 1)) - 1
+        code = max(-top - 1, min(top, round(volts / full_scale * (top + 1))))
+        # ADS1015 left-aligns its 12-bit result in the 16-bit register
+        return (code << (16 - self.resolution)) & 0xFFFF
+    
+    def _update(self, now: float):
+        """Complete conversions that finished by now."""
+        if self._started is None:
+            return
+        elapsed = now - self._started
+        period = self.conversion_s
+        if elapsed < period:
+            return
+        if self.continuous:
+            done = math.floor(elapsed / period)
+            if done != self._done:
+                self._done = done
+                self._conversion = self._sample(self._started + done * period)
+        else:
+            self._conversion = self._sample(self._started + period)
+            self._started = None
+            self.config |= 0x8000
+    
+    def write_register(self, register: int, value: int):
+        self.bus.transfer(4)  # address, pointer, two data bytes
+        now = time.monotonic()
+        with self._lock:
+            self._update(now)
+            if register != CONFIG_REG:
+                return
+            was_continuous = self.continuous and self._started is not None
+            if was_continuous:
+                running = self._started + self._done * self.conversion_s
+            self.config = value & 0x7FFF
+            if self.continuous or (value & 0x8000 and not was_continuous):
+                self._started = now
+                self._done = 0
+            elif was_continuous:
+                # Leaving continuous mode: the running conversion completes first
+                # (a start written meanwhile is ignored)
+                self._started = running
+            elif self._started is None:
+                self.config |= 0x8000
+    
+    def read_register(self, register: int) -> int:
+        self.bus.transfer(5)  # address + pointer, repeated start, address, two data bytes
+        with self._lock:
+            self._update(time.monotonic())
+            if register == CONFIG_REG:
+                return self.config
+            return self._conversion
+    
+    # ADCManager interface ------------------------------------------------------
+    
+    def configure(self, channel: int, data_rate: Optional[int] = None, continuous: bool = False,
+                  ready: bool = False) -> Tuple[float, float]:
+        """Same contract as ADCManager.configure (period, raw-clock time of the write)."""
+        rates = DATA_RATES[self.resolution]
+        data_rate = data_rate or rates[-1]
+        if data_rate not in rates:
+            raise ValueError(f"Data rate must be one of {rates}")
+        config = ((4 + channel) << 12) | 0x0200 | (rates.index(data_rate) << 5)
+        config |= 0x0000 if ready else 0x0003
+        config |= 0x0000 if continuous else 0x8100
+        self.write_register(CONFIG_REG, config)
+        return 1.0 / data_rate, time.clock_gettime(time.CLOCK_MONOTONIC_RAW)
+    
+    def power_down(self):
+        """Same as ADCManager.power_down: single-shot without a start."""
+        self.write_register(CONFIG_REG, 0x0200 | 0x0100 | 0x0003)
+    
+    def read_raw(self) -> int:
+        raw = self.read_register(CONVERSION_REG)
+        raw = raw - (1 << 16) if raw & 0x8000 else raw
+        return raw >> (16 - self.resolution)
+    
+    def code_to_volts(self, code: int) -> float:
+        return code * 4.096 / (1 << (self.resolution - 1))
+    
+    def ready_line(self) -> "VirtualReadyLine":
+        """ALERT/RDY as an EdgeInput-like object with exact edge times."""
+        return VirtualReadyLine(self)
+    
+    def read_channel(self, channel: int) -> float:
+        """Single-shot read at the highest data rate, +-4.096 V."""
+        if not 0 <= channel <= 3:
+            raise ValueError(f"Invalid ADC channel {channel}")
+        config = 0x8000 | ((4 + channel) << 12) | 0x0200 | 0x0100 | 0x00E0 | 0x0003
+        self.write_register(CONFIG_REG, config)
+        time.sleep(self.conversion_s * CONVERSION_MARGIN)
+        raw = self.read_register(CONVERSION_REG)
+        if raw & 0x8000:
+            raw -= 1 << 16
+        return raw / 32768.0 * 4.096
+    
+    def read_all_channels(self) -> Dict[int, float]:
+        return {ch: self.read_channel(ch) for ch in range(4)}
+
+
+class VirtualReadyLine:
+    """Conversion-ready edges of a VirtualADS1x15 (time.monotonic() seconds)."""
+    
+    def __init__(self, adc: VirtualADS1x15):
+        self.adc = adc
+        self._last = time.monotonic()
+    
+    def _pending(self) -> Optional[float]:
+        """Time of the next edge after the last one returned, if a conversion is running."""
+        adc = self.adc
+        with adc._lock:
+            if adc._started is None:
+                return None
+            period = adc.conversion_s
+            if adc.continuous:
+                k = max(1, math.floor((self._last - adc._started) / period + 0.5) + 1)
+                return adc._started + k * period
+            edge = adc._started + period
+            return edge if edge > self._last else None
+    
+    def read(self, timeout: float) -> list:
+        """Edges since the last call; waits up to timeout for the next one."""
+        edge = self._pending()
+        delay = timeout if edge is None else edge - time.monotonic()
+        if delay >= timeout:
+            time.sleep(timeout)
+            return []
+        if delay > 0:
+            time.sleep(delay)
+        edges = [edge]
+        if self.adc.continuous:
+            # Edges that queued up while nobody was reading
+            edges = self.adc.ready_edges(self._last + 1e-9, time.monotonic()) or edges
+        self._last = edges[-1]
+        return edges
+    
+    def close(self):
+        pass
+
+
+class VirtualHardware:
+    """Minimal hardware container: a virtual ADS1115 (or ADS1015) and the bus it sits on."""
+    
+    def __init__(self, clock_khz: float = 400.0, resolution: int = 16,
+                 clock_ppm: float = 0.0, seed: int = 0):
+        self.i2c = VirtualI2CBus(clock_khz)
+        self.adc = VirtualADS1x15(self.i2c, resolution=resolution, clock_ppm=clock_ppm,
+                                  seed=seed)
@@ -0,0 +1,130 @@
+"""Virtual DS3231 on a VirtualI2CBus, with a 1 Hz SQW line off a drifting oscillator.
+
+Register-level like VirtualMCP9808, so hardware/ds3231.py and the clock
+discipline run unchanged on it (pass it as DS3231(device=...)):
+    I2C transfers   bus time of every burst read/write on the shared bus
+    time            BCD registers 0x00-0x06 counting from the last write,
+                    one RTC second every 1 / (1 + ppm * 1e-6) host seconds
+    SQW             sqw_line() gives the falling edges (start of each RTC
+                    second) while CONTROL selects the 1 Hz square wave,
+                    with jitter_us of Gaussian timestamp noise
+    temperature     a constant 25.25 degC; aging and control read back
+
+Writing the seconds register restarts the countdown chain, as on the chip.
+"""
+
+import random
+import threading
+import time
+from datetime import datetime, timezone
+from typing import Optional
+
+from hardware.ds3231 import (AGING, CONTROL, CONTROL_INTCN, CONTROL_RS, REGISTER_COUNT, SECONDS,
+                             STATUS, STATUS_OSF, TEMP_MSB, _decode_time,
+                             _encode_time)
+from .virtual_ads1x15 import VirtualI2CBus
+
+
+class VirtualDS3231:
+    """Register-level DS3231 real-time clock."""
+    
+    def __init__(self, bus: Optional[VirtualI2CBus] = None, address: int = 0x68,
+                 ppm: float = 0.0, start: Optional[float] = None, jitter_us: float = 20.0):
+        """Create a virtual RTC and attach it to the bus.
+
+        Args:
+            bus: Shared bus (default: a private 400 kHz bus)
+            address: I2C address
+            ppm: Oscillator error vs the host clock; positive = RTC runs fast
+            start: Unix time it holds now (default: the system clock)
+            jitter_us: RMS noise on the SQW edge timestamps
+        """
+        self.bus = bus or VirtualI2CBus()
+        self.bus.devices[address] = self
+        self.address = address
+        self.period = 1.0 / (1.0 + ppm * 1e-6)
+        self.jitter_us = jitter_us
+        self._lock = threading.Lock()
+        # Power-on defaults: INTCN set (no square wave), OSF set (time not valid)
+        self.registers = bytearray(REGISTER_COUNT)
+        self.registers[CONTROL] = 0x1C
+        self.registers[STATUS] = STATUS_OSF
+        self.registers[TEMP_MSB] = 25
+        self.registers[TEMP_MSB + 1] = 0x40
+        self._set(time.time() if start is None else start)
+    
+    def _set(self, unix: float):
+        """Hold Unix time unix now; the next second starts one period later."""
+        self._base = int(unix)
+        now = time.monotonic()
+        self._origin = now - (unix - int(unix)) * self.period
+        self._edges_to = now
+    
+    def _seconds(self, now: float) -> int:
+        return self._base + int((now - self._origin) // self.period)
+    
+    # Registers -----------------------------------------------------------------
+    
+    def read_registers(self, register: int, length: int) -> bytes:
+        self.bus.transfer(3 + length)  # address + register, repeated start, address, data
+        with self._lock:
+            registers = bytearray(self.registers)
+            when = datetime.fromtimestamp(self._seconds(time.monotonic()), tz=timezone.utc)
+            registers[SECONDS:SECONDS + 7] = _encode_time(when)
+            return bytes(registers[register:register + length]) + bytes(
+                max(0, register + length - REGISTER_COUNT))
+    
+    def read_register(self, register: int) -> int:
+        return self.read_registers(register, 1)[0]
+    
+    def write_registers(self, register: int, data: bytes):
+        self.bus.transfer(2 + len(data))  # address, register, data
+        with self._lock:
+            if register == SECONDS and len(data) >= 7:
+                self._set(_decode_time(bytes(data[:7])).timestamp())
+                data, register = data[7:], register + 7
+            for offset, value in enumerate(data):
+                if register + offset in (CONTROL, STATUS, AGING):
+                    self.registers[register + offset] = value
+    
+    def write_register(self, register: int, value: int):
+        self.write_registers(register, bytes([value]))
+    
+    def close(self):
+        pass
+    
+    def sqw_line(self) -> "VirtualSQW":
+        """INT/SQW as an EdgeInput-like object (falling edges)."""
+        return VirtualSQW(self)
+    
+    def _edges(self, now: float) -> list:
+        """Falling edges since the last call (only while the 1 Hz square wave is on)."""
+        with self._lock:
+            start, self._edges_to = self._edges_to, now
+            control = self.registers[CONTROL]
+            if control & (CONTROL_INTCN | CONTROL_RS):
+                return []
+            first = int((start - self._origin) // self.period) + 1
+            last = int((now - self._origin) // self.period)
+            return [self._origin + k * self.period + random.gauss(0.0, self.jitter_us * 1e-6)
+                    for k in range(max(first, last - 1000), last + 1)]
+
+
+class VirtualSQW:
+    """SQW output of a VirtualDS3231 (time.monotonic() seconds)."""
+    
+    def __init__(self, rtc: VirtualDS3231):
+        self.rtc = rtc
+    
+    def read(self, timeout: float) -> list:
+        """Edges since the last call; waits up to timeout for the next one."""
+        deadline = time.monotonic() + timeout
+        while True:
+            now = time.monotonic()
+            edges = self.rtc._edges(now)
+            if edges or now >= deadline:
+                return edges
+            time.sleep(min(0.005, deadline - now))
+    
+    def close(self):
+        pass
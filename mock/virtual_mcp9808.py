@@ -0,0 +1,162 @@
+"""Virtual MCP9808 on a VirtualI2CBus, converting in real time with a comparator ALERT.
+
+Register-level like VirtualMPU6050, so hardware/mcp9808.py runs unchanged on
+it (pass it as MCP9808(device=...)) and the temperature monitor's polled and
+event modes can be exercised without a board:
+    I2C transfers   bus time of every word read/write on the shared bus
+    conversions     one per 30/65/130/250 ms depending on RESOLUTION; T_A
+                    holds the latest, with the T_CRIT/T_UPPER/T_LOWER flags
+    ALERT           comparator output with hysteresis, asserted while the
+                    temperature is outside the window; alert_line() gives its
+                    edges (both directions) at the conversion that caused them
+
+The temperature follows signal(t); by default a slow swing of +-8 degC
+around 25 degC, so a 20-30 degC window is left and re-entered every few
+seconds.
+"""
+
+import math
+import threading
+import time
+from typing import Callable, List, Optional
+
+from hardware.mcp9808 import (CONFIG, CONFIG_ALERT_CNT, DEVICE, DEVICE_ID, FLAG_CRIT,
+                              FLAG_LOWER, FLAG_UPPER, HYSTERESIS, MANUFACTURER,
+                              MANUFACTURER_ID, RESOLUTION, RESOLUTIONS, T_A, T_CRIT, T_LOWER,
+                              T_UPPER)
+from .virtual_ads1x15 import VirtualI2CBus
+
+
+def _default_signal(t: float) -> float:
+    return 25.0 + 8.0 * math.sin(2 * math.pi * t / 20.0)
+
+
+class VirtualMCP9808:
+    """Register-level MCP9808 temperature sensor."""
+    
+    def __init__(self, bus: Optional[VirtualI2CBus] = None, address: int = 0x18,
+                 signal: Optional[Callable[[float], float]] = None):
+        """Create a virtual sensor and attach it to the bus.
+
+        Args:
+            bus: Shared bus (default: a private 400 kHz bus)
+            address: I2C address (0x18-0x1F)
+            signal: Temperature (degC) as a function of time.monotonic()
+        """
+        self.bus = bus or VirtualI2CBus()
+        self.bus.devices[address] = self
+        self.address = address
+        self.signal = signal or _default_signal
+        self._lock = threading.Lock()
+        self.registers = {CONFIG: 0, T_UPPER: 0, T_LOWER: 0, T_CRIT: 0, T_A: 0,
+                          MANUFACTURER_ID: MANUFACTURER, DEVICE_ID: DEVICE << 8, RESOLUTION: 3}
+        self.asserted = False
+        self.edges: List[float] = []
+        self._origin = time.monotonic()
+        self._converted = 0
+        self._update(self._origin + self.period)
+    
+    @property
+    def period(self) -> float:
+        return RESOLUTIONS[self.registers[RESOLUTION] & 3][1] / 1000.0
+    
+    @staticmethod
+    def _limit(word: int) -> float:
+        word = (word >> 2) & 0x7FF
+        return (word - 0x800 if word & 0x400 else word) / 4.0
+    
+    def _update(self, now: float):
+        """Run the conversions finished by now: T_A, flags and the comparator."""
+        period = self.period
+        due = math.floor((now - self._origin) / period)
+        if due <= self._converted:
+            return
+        upper, lower = self._limit(self.registers[T_UPPER]), self._limit(self.registers[T_LOWER])
+        critical = self._limit(self.registers[T_CRIT])
+        config = self.registers[CONFIG]
+        hysteresis = HYSTERESIS[(config >> 9) & 3]
+        step = RESOLUTIONS[self.registers[RESOLUTION] & 3][0]
+        for k in range(max(self._converted + 1, due - 1000), due + 1):
+            t = self._origin + k * period
+            celsius = math.floor(self.signal(t) / step) * step
+            sixteenths = round(celsius * 16) & 0x1FFF
+            flags = (FLAG_CRIT if celsius >= critical else 0) | \
+                (FLAG_UPPER if celsius > upper else 0) | (FLAG_LOWER if celsius < lower else 0)
+            self.registers[T_A] = flags | sixteenths
+            if not config & CONFIG_ALERT_CNT:
+                continue
+            if self.asserted:
+                release = lower + hysteresis <= celsius <= upper - hysteresis and \
+                    celsius < critical - hysteresis
+                if release:
+                    self.asserted = False
+                    self.edges.append(t)
+            elif flags:
+                self.asserted = True
+                self.edges.append(t)
+        self._converted = due
+    
+    # Registers -----------------------------------------------------------------
+    
+    def read_registers(self, register: int, length: int) -> bytes:
+        self.bus.transfer(3 + length)  # address + register, repeated start, address, data
+        with self._lock:
+            self._update(time.monotonic())
+            if register == RESOLUTION:
+                return bytes([self.registers[RESOLUTION]])[:length]
+            word = self.registers.get(register, 0)
+            return bytes([word >> 8, word & 0xFF])[:length]
+    
+    def read_register(self, register: int) -> int:
+        return self.read_registers(register, 1)[0]
+    
+    def write_registers(self, register: int, data: bytes):
+        self.bus.transfer(2 + len(data))  # address, register, data
+        with self._lock:
+            self._update(time.monotonic())
+            if register in (CONFIG, T_UPPER, T_LOWER, T_CRIT):
+                self.registers[register] = (data[0] << 8) | data[1]
+                if register == CONFIG and not self.registers[CONFIG] & CONFIG_ALERT_CNT \
+                        and self.asserted:
+                    self.asserted = False
+                    self.edges.append(time.monotonic())
+            elif register == RESOLUTION:
+                self.registers[RESOLUTION] = data[0] & 3
+                self._origin, self._converted = time.monotonic(), 0
+    
+    def write_register(self, register: int, value: int):
+        self.write_registers(register, bytes([value]))
+    
+    def close(self):
+        pass
+    
+    def alert_line(self) -> "VirtualAlert":
+        """ALERT as an EdgeInput-like object (both edges, exact times)."""
+        return VirtualAlert([self])
+
+
+class VirtualAlert:
+    """Wired-OR ALERT line of one or more VirtualMCP9808s (time.monotonic() seconds)."""
+    
+    def __init__(self, sensors: List[VirtualMCP9808]):
+        self.sensors = sensors
+    
+    def read(self, timeout: float) -> list:
+        """Edges since the last call; waits up to timeout for the next one."""
+        deadline = time.monotonic() + timeout
+        while True:
+            now = time.monotonic()
+            edges = []
+            for sensor in self.sensors:
+                with sensor._lock:
+                    sensor._update(now)
+                    edges += sensor.edges
+                    sensor.edges = []
+            if edges:
+                return sorted(edges)
+            if now >= deadline:
+                return []
+            time.sleep(min(0.01, deadline - now))
+    
+    def close(self):
+        pass
@@ -0,0 +1,208 @@
+"""Virtual MPU6050/MPU6500 on a VirtualI2CBus, with a FIFO filled in real time.
+
+Register-level like VirtualADS1x15, so hardware/imu.py runs unchanged on it
+(pass it as MPU6050(device=...)) and IMU streaming can be benchmarked
+without a board:
+    I2C transfers   bus time of every register read/write, so a FIFO drain
+                    costs what it would on a 400 kHz bus
+    sampling        1 kHz / (1 + SMPLRT_DIV) (8 kHz with the DLPF off),
+                    scaled by the oscillator error (clock_ppm)
+    FIFO            accel/temp/gyro packets in register order per FIFO_EN,
+                    FIFO_COUNT, FIFO_R_W burst reads, FIFO_RESET; a full
+                    FIFO overwrites its oldest bytes like the real one
+    INT             DATA_RDY edges at the sample times (ready_line())
+
+The signal is 1 g on Z plus a vibration on every accel axis and a slow
+rotation on the gyro axes, with Gaussian noise.
+"""
+
+import math
+import random
+import threading
+import time
+from typing import List, Optional
+
+from hardware.imu import (ACCEL_CONFIG, CONFIG, FIFO_COUNTH, FIFO_EN, FIFO_R_W, GYRO_CONFIG,
+                          INT_ENABLE, INT_STATUS, PWR_MGMT_1, SMPLRT_DIV, USER_CTRL,
+                          USER_FIFO_EN, USER_FIFO_RESET, WHO_AM_I)
+from .virtual_ads1x15 import VirtualI2CBus
+
+WHO_AM_I_VALUES = {"MPU6050": 0x68, "MPU6500": 0x70}
+
+
+class VirtualMPU6050:
+    """Register-level MPU6050 (or MPU6500) IMU."""
+    
+    def __init__(self, bus: Optional[VirtualI2CBus] = None, address: int = 0x68,
+                 model: str = "MPU6050", clock_ppm: float = 0.0, vibration_hz: float = 120.0,
+                 noise_g: float = 0.002, seed: int = 0):
+        """Create a virtual IMU and attach it to the bus.
+
+        Args:
+            bus: Shared bus (default: a private 400 kHz bus)
+            address: I2C address (0x68/0x69)
+            model: "MPU6050" (1024-byte FIFO) or "MPU6500" (512 bytes)
+            clock_ppm: Sample clock error; positive = samples come fast
+            vibration_hz: Frequency of the simulated vibration
+            noise_g: Accelerometer noise (g rms)
+            seed: Noise seed
+        """
+        self.bus = bus or VirtualI2CBus()
+        self.bus.devices[address] = self
+        self.address = address
+        self.model = model
+        self.fifo_size = 1024 if model == "MPU6050" else 512
+        self.clock_scale = 1.0 + clock_ppm / 1e6
+        self.vibration_hz = vibration_hz
+        self.noise_g = noise_g
+        self._random = random.Random(seed)
+        self._lock = threading.Lock()
+        self.overflows = 0
+        self._reset()
+    
+    def _reset(self):
+        self.registers = bytearray(128)
+        self.registers[PWR_MGMT_1] = 0x40  # Sleep after power-on
+        self.registers[WHO_AM_I] = WHO_AM_I_VALUES.get(self.model, 0x70)
+        self.fifo = bytearray()
+        self._restart_grid(time.monotonic())
+    
+    # Timing --------------------------------------------------------------------
+    
+    @property
+    def period(self) -> float:
+        dlpf = self.registers[CONFIG] & 0x07
+        internal = 1000.0 if dlpf not in (0, 7) else 8000.0
+        return (1 + self.registers[SMPLRT_DIV]) / (internal * self.clock_scale)
+    
+    def _restart_grid(self, now: float):
+        self._origin = now
+        self._produced = 0
+    
+    def sample_times(self, since: float, until: float) -> List[float]:
+        """Sample (DATA_RDY) times in (since, until]."""
+        if self.registers[PWR_MGMT_1] & 0x40:
+            return []
+        period = self.period
+        # The epsilon keeps an edge returned last time (since == its time) from repeating
+        first = max(1, math.floor((since - self._origin) / period + 1e-6) + 1)
+        last = math.floor((until - self._origin) / period)
+        return [self._origin + k * period for k in range(first, last + 1)]
+    
+    def _packet(self, t: float) -> bytes:
+        fifo_en = self.registers[FIFO_EN]
+        accel_lsb = 32768.0 / (2 << ((self.registers[ACCEL_CONFIG] >> 3) & 3))
+        gyro_lsb = 32768.0 / (250 << ((self.registers[GYRO_CONFIG] >> 3) & 3))
+        vibration = 0.05 * math.sin(2 * math.pi * self.vibration_hz * t)
+        words = []
+        if fifo_en & 0x08:
+            for base in (0.0, 0.0, 1.0):
+                g = base + vibration + self._random.gauss(0.0, self.noise_g)
+                words.append(round(g * accel_lsb))
+        if fifo_en & 0x80:
+            words.append(round((25.0 - 36.53) * 340.0))
+        rotation = 10.0 * math.sin(2 * math.pi * 0.5 * t)
+        for axis, mask in enumerate((0x40, 0x20, 0x10)):
+            if fifo_en & mask:
+                words.append(round((rotation if axis == 2 else 0.1 * axis) * gyro_lsb))
+        data = bytearray()
+        for word in words:
+            data += max(-32768, min(32767, word)).to_bytes(2, "big", signed=True)
+        return bytes(data)
+    
+    def _update(self, now: float):
+        """Push the samples taken by now into the FIFO."""
+        if self.registers[PWR_MGMT_1] & 0x40:
+            return
+        period = self.period
+        due = math.floor((now - self._origin) / period)
+        if due <= self._produced:
+            return
+        enabled = self.registers[USER_CTRL] & USER_FIFO_EN and self.registers[FIFO_EN]
+        if enabled:
+            packet_len = len(self._packet(0.0))
+            # Only the newest FIFO's worth can survive; older samples are overwritten
+            keep = self.fifo_size // packet_len + 1
+            first = max(self._produced + 1, due - keep + 1)
+            if first > self._produced + 1:
+                self.fifo.clear()
+                self.registers[INT_STATUS] |= 0x10
+            for k in range(first, due + 1):
+                self.fifo += self._packet(self._origin + k * period)
+            if len(self.fifo) > self.fifo_size:
+                del self.fifo[:len(self.fifo) - self.fifo_size]
+                self.registers[INT_STATUS] |= 0x10
+                self.overflows += 1
+        self.registers[INT_STATUS] |= 0x01
+        self._produced = due
+    
+    # Registers -----------------------------------------------------------------
+    
+    def read_registers(self, register: int, length: int) -> bytes:
+        self.bus.transfer(3 + length)  # address + register, repeated start, address, data
+        with self._lock:
+            self._update(time.monotonic())
+            if register == FIFO_R_W:
+                data = bytes(self.fifo[:length]) + bytes(max(0, length - len(self.fifo)))
+                del self.fifo[:length]
+                return data
+            if register == FIFO_COUNTH:
+                count = len(self.fifo)
+                return bytes([count >> 8, count & 0xFF])[:length]
+            data = bytes(self.registers[register:register + length])
+            if register <= INT_STATUS < register + length:
+                self.registers[INT_STATUS] = 0  # Cleared on read
+            return data
+    
+    def read_register(self, register: int) -> int:
+        return self.read_registers(register, 1)[0]
+    
+    def write_register(self, register: int, value: int):
+        self.bus.transfer(3)  # address, register, value
+        now = time.monotonic()
+        with self._lock:
+            self._update(now)
+            if register == PWR_MGMT_1 and value & 0x80:
+                self._reset()
+                return
+            if register == USER_CTRL and value & USER_FIFO_RESET:
+                self.fifo.clear()
+                value &= ~USER_FIFO_RESET
+            self.registers[register] = value & 0xFF
+            if register in (SMPLRT_DIV, CONFIG, PWR_MGMT_1):
+                self._restart_grid(now)
+    
+    def close(self):
+        pass
+    
+    def ready_line(self) -> "VirtualDataReady":
+        """INT (DATA_RDY) as an EdgeInput-like object with exact edge times."""
+        return VirtualDataReady(self)
+
+
+class VirtualDataReady:
+    """DATA_RDY edges of a VirtualMPU6050 (time.monotonic() seconds)."""
+    
+    def __init__(self, imu: VirtualMPU6050):
+        self.imu = imu
+        self._last = time.monotonic()
+    
+    def read(self, timeout: float) -> list:
+        """Edges since the last call; waits up to timeout for the next one."""
+        imu = self.imu
+        deadline = time.monotonic() + timeout
+        while True:
+            now = time.monotonic()
+            with imu._lock:
+                enabled = imu.registers[INT_ENABLE] & 0x01
+                edges = imu.sample_times(self._last, now) if enabled else []
+                period = imu.period
+            if edges:
+                self._last = edges[-1]
+                return edges
+            if now >= deadline:
+                return []
+            time.sleep(min(period, deadline - now))
+    
+    def close(self):
+        pass
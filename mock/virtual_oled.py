@@ -0,0 +1,132 @@
+"""Virtual SSD1306/SSD1309/SH1106 on a VirtualI2CBus, with display RAM.
+
+Takes the same writes as the panel (pass it as device= to a
+hardware/display backend) and executes them, so both the bus time of an
+update and what it leaves on screen can be checked without a board:
+    I2C transfers   one per write, address byte included, on the shared bus
+    commands        control bytes 0x00 (stream) and 0x80 (single, Co bit);
+                    addressing commands as the controller implements them:
+                    SSD1306/SSD1309 horizontal/page modes with the 0x21/0x22
+                    window, SH1106 page addressing only (window commands are
+                    not understood), column auto-increment without wrap
+    RAM             ram_width columns per page (132 on the SH1106); visible()
+                    returns the panel's columns in framebuffer layout
+"""
+
+from typing import Optional
+
+from .virtual_ads1x15 import VirtualI2CBus
+
+# Commands followed by argument bytes (SSD1306/SSD1309; 0x21/0x22 are SH1106 pump voltages)
+_ARGUMENTS = {0x20: 1, 0x21: 2, 0x22: 2, 0x26: 6, 0x27: 6, 0x29: 5, 0x2A: 5, 0x81: 1,
+              0x8D: 1, 0xA3: 2, 0xA8: 1, 0xD3: 1, 0xD5: 1, 0xD9: 1, 0xDA: 1, 0xDB: 1, 0xFD: 1}
+_SH1106_ARGUMENTS = {0x81: 1, 0xA8: 1, 0xAD: 1, 0xD3: 1, 0xD5: 1, 0xD9: 1, 0xDA: 1, 0xDB: 1}
+
+
+class VirtualOLED:
+    """Register-level monochrome OLED controller ("ssd1306", "ssd1309" or "sh1106")."""
+    
+    def __init__(self, bus: Optional[VirtualI2CBus] = None, address: int = 0x3C,
+                 controller: str = "ssd1306", height: int = 64):
+        """Create a virtual display and attach it to the bus.
+
+        Args:
+            bus: Shared bus (default: a private 400 kHz bus)
+            address: I2C address
+            controller: Command set to emulate
+            height: Panel rows
+        """
+        self.bus = bus or VirtualI2CBus()
+        self.bus.devices[address] = self
+        self.address = address
+        self.controller = controller.lower()
+        self.sh1106 = self.controller == "sh1106"
+        self.ram_width = 132 if self.sh1106 else 128
+        self.panel_offset = 2 if self.sh1106 else 0
+        self.pages = height // 8
+        self.ram = bytearray(self.ram_width * self.pages)
+        self.on = False
+        self.horizontal = False  # SSD13xx addressing mode (page mode after reset)
+        self.window = (0, self.ram_width - 1, 0, self.pages - 1)
+        self.page = 0
+        self.column = 0
+        self.writes = 0
+        self.bytes = 0
+    
+    # Transport -----------------------------------------------------------------
+    
+    def write(self, data: bytes):
+        self.bus.transfer(1 + len(data))
+        self.writes += 1
+        self.bytes += len(data)
+        index = 0
+        while index < len(data):
+            control = data[index]
+            index += 1
+            if control & 0x40:
+                self._data(data[index:])
+                return
+            if control & 0x80:  # One command byte, then another control byte
+                index = self._command(data, index, single=True)
+            else:
+                while index < len(data):
+                    index = self._command(data, index)
+                return
+    
+    def _command(self, data: bytes, index: int, single: bool = False) -> int:
+        command = data[index]
+        arguments = (_SH1106_ARGUMENTS if self.sh1106 else _ARGUMENTS).get(command, 0)
+        if single and arguments:
+            # Arguments follow as further single commands (0x80 + byte each)
+            args = [data[index + 2 + 2 * i] for i in range(arguments)]
+            end = index + 1 + 2 * arguments
+        else:
+            args = list(data[index + 1:index + 1 + arguments])
+            end = index + 1 + arguments
+        self._execute(command, args)
+        return end
+    
+    def _execute(self, command: int, args: list):
+        if command in (0xAE, 0xAF):
+            self.on = command == 0xAF
+        elif 0xB0 <= command <= 0xB7:
+            self.page = command & 0x07
+        elif command <= 0x0F:
+            self.column = (self.column & 0xF0) | command
+        elif command <= 0x1F:
+            self.column = (self.column & 0x0F) | ((command & 0x0F) << 4)
+        elif self.sh1106:
+            pass  # No addressing mode or window commands
+        elif command == 0x20:
+            self.horizontal = (args[0] & 3) == 0
+        elif command == 0x21:
+            self.window = (args[0], args[1], self.window[2], self.window[3])
+            self.column = args[0]
+        elif command == 0x22:
+            self.window = (self.window[0], self.window[1], args[0], args[1])
+            self.page = args[0]
+    
+    def _data(self, data: bytes):
+        width = self.ram_width
+        for value in data:
+            if self.column < width:
+                self.ram[self.page * width + self.column] = value
+            if self.horizontal:
+                c0, c1, p0, p1 = self.window
+                if self.column >= c1:
+                    self.column = c0
+                    self.page = p0 if self.page >= p1 else self.page + 1
+                else:
+                    self.column += 1
+            elif self.column < width - 1:
+                self.column += 1  # Page mode stops at the last column
+    
+    def close(self):
+        pass
+    
+    def visible(self) -> bytes:
+        """What the panel shows, in framebuffer layout (128 columns per page)."""
+        width = self.ram_width
+        return b"".join(bytes(self.ram[page * width + self.panel_offset:
+                                       page * width + self.panel_offset + 128])
+                        for page in range(self.pages))
@@ -16,6 +16,9 @@ BASE_URL="https://downloads.raspberrypi.com/raspios_armhf/images"
 # Alternative: Use latest from raspberrypi.com
 # Check https://downloads.raspberrypi.com/raspios_armhf/images/ for latest
 OUTPUT_IMAGE="device-panel-v1.0.img"
+# Kiosk image: "eglfs" or "linuxfb" boots straight into the panel without X11
+# (device-panel-kiosk.service, see enable-kiosk.sh); empty = X11 desktop + autostart
+KIOSK_PLATFORM="${KIOSK_PLATFORM:-}"
 MOUNT_DIR="mnt"
 DOWNLOAD_DIR="downloads"
 
@@ -259,6 +262,11 @@ if [ -f "$DEVICE_PANEL_SOURCE/device_panel.py" ]; then
     cp -r "$DEVICE_PANEL_SOURCE"/hardware "$MOUNT_DIR/root/opt/device-panel/" 2>/dev/null || true
     cp -r "$DEVICE_PANEL_SOURCE"/config "$MOUNT_DIR/root/opt/device-panel/" 2>/dev/null || true
     cp -r "$DEVICE_PANEL_SOURCE"/mock "$MOUNT_DIR/root/opt/device-panel/" 2>/dev/null || true
+    cp -r "$DEVICE_PANEL_SOURCE"/acquisition "$MOUNT_DIR/root/opt/device-panel/" 2>/dev/null || true
+    cp -r "$DEVICE_PANEL_SOURCE"/api "$MOUNT_DIR/root/opt/device-panel/" 2>/dev/null || true
+    cp -r "$DEVICE_PANEL_SOURCE"/devices "$MOUNT_DIR/root/opt/device-panel/" 2>/dev/null || true
+    cp -r "$DEVICE_PANEL_SOURCE"/benchmarks "$MOUNT_DIR/root/opt/device-panel/" 2>/dev/null || true
+    cp -r "$DEVICE_PANEL_SOURCE"/device_cli.py "$MOUNT_DIR/root/opt/device-panel/" 2>/dev/null || true
     # Remove pi-image-build from the copy if it exists
     rm -rf "$MOUNT_DIR/root/opt/device-panel/pi-image-build" 2>/dev/null || true
     log_info "✓ Device Panel copied from local source"
@@ -273,14 +281,24 @@ CHROOT_EOF
     log_info "✓ Device Panel cloned from GitHub"
 fi
 
+# Stamp the image so benchmark reports can tell image versions apart
+PANEL_REVISION=$(git -C "$DEVICE_PANEL_SOURCE" describe --always --dirty 2>/dev/null || echo "unknown")
+echo "device-panel $PANEL_REVISION, base $(basename "$IMAGE_FILE"), built $(date -u +%Y-%m-%d)" \
+    > "$MOUNT_DIR/root/opt/device-panel/IMAGE_INFO"
+
 # Set permissions (use user ID 1000 which is typically the first user)
 chroot "$MOUNT_DIR/root" chown -R 1000:1000 /opt/device-panel 2>/dev/null || true
 
 # Step 8: Configure services and desktop
 log_info "Step 8: Configuring services and desktop..."
 
-# Copy systemd service (will use user ID 1000, not hardcoded "pi")
+# Copy systemd services (will use user ID 1000, not hardcoded "pi")
 cp config/device-panel.service "$MOUNT_DIR/root/etc/systemd/system/"
+cp config/device-panel-kiosk.service "$MOUNT_DIR/root/etc/systemd/system/"
+if [ -n "$KIOSK_PLATFORM" ]; then
+    sed -i "s/DEVICE_PANEL_PLATFORM=eglfs/DEVICE_PANEL_PLATFORM=$KIOSK_PLATFORM/" \
+        "$MOUNT_DIR/root/etc/systemd/system/device-panel-kiosk.service"
+fi
 
 # Update service file to use user ID 1000 instead of "pi"
 chroot "$MOUNT_DIR/root" /bin/bash << 'CHROOT_EOF'
@@ -290,6 +308,8 @@ USERNAME=$(id -nu 1000 2>/dev/null || echo "pi")
 sed -i "s/User=pi/User=$USERNAME/g" /etc/systemd/system/device-panel.service
 sed -i "s/Group=pi/Group=$USERNAME/g" /etc/systemd/system/device-panel.service
 sed -i "s|/home/pi|/home/$USERNAME|g" /etc/systemd/system/device-panel.service
+sed -i "s/User=pi/User=$USERNAME/g" /etc/systemd/system/device-panel-kiosk.service
+sed -i "s/Group=pi/Group=$USERNAME/g" /etc/systemd/system/device-panel-kiosk.service
 CHROOT_EOF
 
 # Create desktop launcher for all users
@@ -342,6 +362,20 @@ if id 1000 &>/dev/null; then
 fi
 CHROOT_EOF
 
+# Kiosk image: no display manager or desktop, the panel owns tty1 and the display
+if [ -n "$KIOSK_PLATFORM" ]; then
+    chroot "$MOUNT_DIR/root" /bin/bash << 'CHROOT_EOF'
+systemctl disable device-panel.service
+systemctl disable display-manager.service 2>/dev/null || true
+systemctl set-default multi-user.target
+systemctl enable device-panel-kiosk.service
+if id 1000 &>/dev/null; then
+    usermod -aG video,render,input,tty $(id -nu 1000) 2>/dev/null || true
+fi
+CHROOT_EOF
+    log_info "✓ Kiosk mode ($KIOSK_PLATFORM) enabled - no X11"
+fi
+
 log_info "✓ Services and desktop configured"
 
 # Step 9: Unmount
@@ -0,0 +1,57 @@
+#!/bin/bash
+# Switch Device Panel between the X11 desktop and kiosk mode (eglfs/linuxfb, no X11)
+# Run this ON THE PI:
+#   sudo ./enable-kiosk.sh eglfs     # GPU, fullscreen on DRM/KMS (default)
+#   sudo ./enable-kiosk.sh linuxfb   # software rendering into /dev/fb0
+#   sudo ./enable-kiosk.sh x11       # back to the desktop + device-panel.service
+# Reboot afterwards. The startup report of each boot is in /run/device-panel/startup.json
+# (kiosk) or /tmp/device-panel-startup.json (X11); compare setups with
+#   cd /opt/device-panel && python3 -m benchmarks.kiosk_startup --out <setup>.json   (after each reboot)
+#   python3 -m benchmarks.kiosk_startup --compare x11.json kiosk.json
+
+set -e
+
+MODE=${1:-eglfs}
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+USERNAME=$(id -nu 1000 2>/dev/null || echo "pi")
+UNIT=/etc/systemd/system/device-panel-kiosk.service
+
+if [ "$EUID" -ne 0 ]; then
+    echo "Run with sudo"
+    exit 1
+fi
+
+case "$MODE" in
+    eglfs|linuxfb)
+        echo "=== Enabling kiosk mode ($MODE) ==="
+        cp "$SCRIPT_DIR/config/device-panel-kiosk.service" "$UNIT"
+        sed -i "s/User=pi/User=$USERNAME/; s/Group=pi/Group=$USERNAME/" "$UNIT"
+        sed -i "s/DEVICE_PANEL_PLATFORM=eglfs/DEVICE_PANEL_PLATFORM=$MODE/" "$UNIT"
+        usermod -aG video,render,input,tty "$USERNAME" 2>/dev/null || true
+        
+        systemctl disable device-panel.service 2>/dev/null || true
+        systemctl disable display-manager.service 2>/dev/null || true
+        systemctl set-default multi-user.target
+        systemctl daemon-reload
+        systemctl enable device-panel-kiosk.service
+        echo "✓ Kiosk mode enabled - X11 and the desktop will not start"
+        ;;
+    x11)
+        echo "=== Restoring the X11 desktop ==="
+        systemctl disable device-panel-kiosk.service 2>/dev/null || true
+        rm -f "$UNIT"
+        # lightdm is the display manager on Raspberry Pi OS desktop images
+        systemctl enable lightdm.service 2>/dev/null || true
+        systemctl set-default graphical.target
+        systemctl daemon-reload
+        systemctl enable device-panel.service
+        echo "✓ X11 desktop and device-panel.service enabled"
+        ;;
+    *)
+        echo "Usage: $0 [eglfs|linuxfb|x11]"
+        exit 2
+        ;;
+esac
+
+echo ""
+echo "Reboot to apply: sudo reboot"
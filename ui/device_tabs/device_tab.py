@@ -1,17 +1,49 @@
 """Device tab for individual I2C devices."""
 
-from typing import Optional, List, Tuple
+from collections import OrderedDict
+from typing import Dict, Optional, List, Tuple
 from PySide6.QtWidgets import (QWidget, QVBoxLayout, QHBoxLayout, QLabel, 
                                QPushButton, QComboBox, QTabWidget, QTextEdit,
-                               QLineEdit, QGroupBox)
+                               QLineEdit, QGroupBox, QStackedWidget)
 from PySide6.QtCore import Qt
 from devices.base import DevicePlugin
 from devices.registry import get_registry
 from devices.loader import get_loader
+from config.device_config import DEVICE_TAB_CACHE_SIZE
 
 
 class DeviceTab(QWidget):
-    """Tab widget for a single I2C device."""
+    """Tab widget for a single I2C device.
+    
+    Everything is built on demand: the suggestions (and with them the first
+    plugin) when the tab is first shown, a plugin's info page when it is
+    selected, and its test UI when the Test tab is first opened. Pages are
+    kept per plugin, so switching back and forth in the combo box reuses
+    them, and for_device() keeps whole tabs for reopening.
+    """
+    
+    # (bus, address) -> tab, least recently opened first
+    _cache: "OrderedDict[Tuple[int, int], DeviceTab]" = OrderedDict()
+    
+    @classmethod
+    def for_device(cls, bus: int, address: int, hardware=None) -> "DeviceTab":
+        """The cached tab for a device, built (lazily) the first time.
+
+        Beyond DEVICE_TAB_CACHE_SIZE the least recently opened hidden tabs are
+        deleted; the returned tab and tabs still on screen are never evicted.
+        """
+        key = (bus, address)
+        tab = cls._cache.pop(key, None)
+        if tab is None:
+            tab = cls(bus, address, hardware)
+        cls._cache[key] = tab
+        for old_key, old_tab in list(cls._cache.items()):
+            if len(cls._cache) <= DEVICE_TAB_CACHE_SIZE:
+                break
+            if old_tab is not tab and not old_tab.isVisible():
+                del cls._cache[old_key]
+                old_tab.deleteLater()
+        return tab
     
     def __init__(self, bus: int, address: int, hardware=None, parent=None):
         super().__init__(parent)
@@ -22,13 +54,22 @@ class DeviceTab(QWidget):
         self.loader = get_loader()
         self.device: Optional[DevicePlugin] = None
         self.selected_plugin_name: Optional[str] = None
+        # Combo index -> (info page, test page once built)
+        self._pages: Dict[int, List[Optional[QWidget]]] = {}
+        self._suggestions_loaded = False
         
         self.setup_ui()
-        self.load_suggestions()
         
         # Set minimum size to make window taller (after UI is set up)
         self.setMinimumSize(1000, 1000)
     
+    def showEvent(self, event):
+        """Load suggestions (and the first plugin) the first time the tab is shown."""
+        super().showEvent(event)
+        if not self._suggestions_loaded:
+            self._suggestions_loaded = True
+            self.load_suggestions()
+    
     def setup_ui(self):
         """Set up the UI layout."""
         layout = QVBoxLayout()
@@ -97,17 +138,12 @@ class DeviceTab(QWidget):
             }
         """)
         
-        # Info tab
-        self.info_widget = QWidget()
-        self.info_layout = QVBoxLayout()
-        self.info_widget.setLayout(self.info_layout)
-        self.tabs.addTab(self.info_widget, "Info")
-        
-        # Test tab
-        self.test_widget = QWidget()
-        self.test_layout = QVBoxLayout()
-        self.test_widget.setLayout(self.test_layout)
-        self.tabs.addTab(self.test_widget, "Test")
+        # Info and Test tabs hold one page per selected plugin
+        self.info_stack = QStackedWidget()
+        self.tabs.addTab(self.info_stack, "Info")
+        self.test_stack = QStackedWidget()
+        self.tabs.addTab(self.test_stack, "Test")
+        self.tabs.currentChanged.connect(self.on_tab_changed)
         
         layout.addWidget(self.tabs)
         self.setLayout(layout)
@@ -129,45 +165,60 @@ class DeviceTab(QWidget):
             # on_device_selected will be called automatically via signal
     
     def on_device_selected(self, index: int):
-        """Handle device selection."""
+        """Handle device selection (reuses the pages built for an earlier selection)."""
         if index < 0:
             return
         plugin_name = self.device_combo.itemData(index)
         self.selected_plugin_name = plugin_name
-        
-        # Clear existing content
-        self.clear_tabs()
+        self.device = None
         
         if plugin_name:
-            # Try to load plugin
-            self.device = self.loader.create_device(self.bus, self.address, plugin_name)
+            # Instances are cached per (bus, address, plugin) by the loader
+            self.device = self.loader.get_device(self.bus, self.address, plugin_name)
             if self.device:
                 # Pass hardware manager to plugin if it supports it
                 if hasattr(self.device, 'set_hardware'):
                     self.device.set_hardware(self.hardware)
-                self.load_device_info()
-                self.load_device_test()
+        
+        pages = self._pages.get(index)
+        if pages is None:
+            info_page = QWidget()
+            info_layout = QVBoxLayout()
+            info_page.setLayout(info_layout)
+            if not plugin_name:
+                self.show_unknown_device(info_layout)
+            elif self.device:
+                self.load_device_info(info_layout)
             else:
-                self.show_no_plugin()
-        else:
-            self.show_unknown_device()
+                self.show_no_plugin(info_layout)
+            self.info_stack.addWidget(info_page)
+            pages = self._pages[index] = [info_page, None]
+        self.info_stack.setCurrentWidget(pages[0])
+        if pages[1] is not None:
+            self.test_stack.setCurrentWidget(pages[1])
+        self.on_tab_changed(self.tabs.currentIndex())
     
-    def clear_tabs(self):
-        """Clear tab content."""
-        # Clear info tab
-        while self.info_layout.count():
-            item = self.info_layout.takeAt(0)
-            if item.widget():
-                item.widget().deleteLater()
-        
-        # Clear test tab
-        while self.test_layout.count():
-            item = self.test_layout.takeAt(0)
-            if item.widget():
-                item.widget().deleteLater()
+    def on_tab_changed(self, index: int):
+        """Build the selected plugin's test UI the first time the Test tab is shown."""
+        if self.tabs.widget(index) is not self.test_stack:
+            return
+        pages = self._pages.get(self.device_combo.currentIndex())
+        if pages is None:
+            return
+        if pages[1] is None:
+            test_page = QWidget()
+            test_layout = QVBoxLayout()
+            test_page.setLayout(test_layout)
+            if self.device:
+                self.load_device_test(test_layout)
+            else:
+                self.show_no_test_interface(test_layout)
+            self.test_stack.addWidget(test_page)
+            pages[1] = test_page
+        self.test_stack.setCurrentWidget(pages[1])
     
-    def load_device_info(self):
-        """Load device information."""
+    def load_device_info(self, layout: QVBoxLayout):
+        """Load device information into layout."""
         if not self.device:
             return
         
@@ -198,33 +249,33 @@ class DeviceTab(QWidget):
             info_layout.addLayout(row)
         
         info_group.setLayout(info_layout)
-        self.info_layout.addWidget(info_group)
-        self.info_layout.addStretch()
+        layout.addWidget(info_group)
+        layout.addStretch()
     
-    def load_device_test(self):
-        """Load device test interface."""
+    def load_device_test(self, layout: QVBoxLayout):
+        """Load device test interface into layout."""
         if not self.device:
             return
         
         try:
             test_ui = self.device.get_test_ui()
             if test_ui:
-                self.test_layout.addWidget(test_ui)
+                layout.addWidget(test_ui)
             else:
-                self.show_no_test_interface()
+                self.show_no_test_interface(layout)
         except Exception as e:
             import traceback
             error_msg = f"Error loading test interface: {e}\n\n{traceback.format_exc()}"
             error_label = QLabel(error_msg)
             error_label.setStyleSheet("color: red; padding: 20px; font-size: 14pt;")
             error_label.setWordWrap(True)
-            self.test_layout.addWidget(error_label)
+            layout.addWidget(error_label)
             print(f"Error in load_device_test: {e}", file=__import__('sys').stderr)
             traceback.print_exc()
         
-        self.test_layout.addStretch()
+        layout.addStretch()
     
-    def show_no_plugin(self):
+    def show_no_plugin(self, layout: QVBoxLayout):
         """Show message when no plugin available."""
         label = QLabel(
             "No plugin available for this device.\n\n"
@@ -235,10 +286,10 @@ class DeviceTab(QWidget):
         )
         label.setWordWrap(True)
         label.setStyleSheet("padding: 20px; color: #666; font-size: 16pt;")
-        self.info_layout.addWidget(label)
-        self.info_layout.addStretch()
+        layout.addWidget(label)
+        layout.addStretch()
     
-    def show_unknown_device(self):
+    def show_unknown_device(self, layout: QVBoxLayout):
         """Show message for unknown device."""
         label = QLabel(
             f"Unknown device at address 0x{self.address:02X}.\n\n"
@@ -247,12 +298,12 @@ class DeviceTab(QWidget):
         )
         label.setWordWrap(True)
         label.setStyleSheet("padding: 20px; color: #666; font-size: 16pt;")
-        self.info_layout.addWidget(label)
-        self.info_layout.addStretch()
+        layout.addWidget(label)
+        layout.addStretch()
     
-    def show_no_test_interface(self):
+    def show_no_test_interface(self, layout: QVBoxLayout):
         """Show message when device has no test interface."""
         label = QLabel("This device does not provide a test interface.")
         label.setStyleSheet("padding: 20px; color: #666; font-size: 16pt;")
-        self.test_layout.addWidget(label)
+        layout.addWidget(label)
 
@@ -0,0 +1,242 @@
+"""Kiosk mode (Qt eglfs/linuxfb without X11) and the startup report.
+
+configure_platform() must run before the QApplication is created: it picks
+the Qt platform plugin and sets the plugin's environment (DRM device or
+framebuffer, rotation, cursor, touch rotation). tune_window() then adapts
+the main window to the backend: fullscreen, no X11-sized minimum, compact
+margins and a touch-scrollable area on small screens.
+
+StartupProbe records when the first frame reached the screen, relative to
+kernel boot and to process start, together with the panel's memory, the
+memory of any X11/Wayland display stack that is running, and system-wide
+memory in use. The report is written as JSON (see STARTUP_REPORT) and
+compared across setups with benchmarks/kiosk_startup.py.
+"""
+
+import json
+import os
+import sys
+import time
+from typing import Dict, Optional
+
+from PySide6.QtCore import QEvent, QObject, Qt, QTimer
+from PySide6.QtGui import QGuiApplication
+from PySide6.QtWidgets import QScrollArea, QScroller, QFrame
+
+from config.display_config import (KIOSK_DRM_DEVICE, KIOSK_FB, KIOSK_HIDE_CURSOR, KIOSK_PLATFORM,
+                                   KIOSK_ROTATION, KIOSK_SCROLL_BELOW_HEIGHT, STARTUP_REPORT,
+                                   STARTUP_SETTLE_S)
+
+KIOSK_PLATFORMS = ("eglfs", "linuxfb")
+
+# Processes that make up an X11/Wayland desktop session (for the memory comparison)
+DISPLAY_STACK = ("Xorg", "Xwayland", "lightdm", "wayfire", "labwc", "openbox", "lxsession",
+                 "lxpanel", "pcmanfm", "wf-panel-pi", "lxpolkit", "xcompmgr", "kanshi",
+                 "squeekboard", "wfrespawn", "lwrespawn")
+
+
+def requested_platform() -> Optional[str]:
+    """Platform plugin asked for by DEVICE_PANEL_PLATFORM or KIOSK_PLATFORM (None = default)."""
+    return os.environ.get("DEVICE_PANEL_PLATFORM") or KIOSK_PLATFORM
+
+
+def configure_platform() -> Optional[str]:
+    """Select the Qt platform plugin; call before creating the QApplication.
+
+    Returns:
+        "eglfs" or "linuxfb" when running as a kiosk, None otherwise
+    """
+    name = requested_platform()
+    if name not in KIOSK_PLATFORMS:
+        return None
+    env = os.environ
+    if name == "eglfs":
+        env.setdefault("QT_QPA_PLATFORM", "eglfs")
+        # KMS output, mode set even if the console already uses it, no hardware cursor plane
+        env.setdefault("QT_QPA_EGLFS_INTEGRATION", "eglfs_kms")
+        env.setdefault("QT_QPA_EGLFS_ALWAYS_SET_MODE", "1")
+        if KIOSK_DRM_DEVICE:
+            env.setdefault("QT_QPA_EGLFS_KMS_CONFIG", _kms_config(KIOSK_DRM_DEVICE))
+        if KIOSK_ROTATION:
+            env.setdefault("QT_QPA_EGLFS_ROTATION", str(KIOSK_ROTATION))
+        if KIOSK_HIDE_CURSOR:
+            env.setdefault("QT_QPA_EGLFS_HIDECURSOR", "1")
+    else:
+        spec = f"linuxfb:fb={KIOSK_FB}"
+        if KIOSK_ROTATION:
+            spec += f":rotation={KIOSK_ROTATION}"
+        env.setdefault("QT_QPA_PLATFORM", spec)
+        if KIOSK_HIDE_CURSOR:
+            env.setdefault("QT_QPA_FB_HIDECURSOR", "1")
+    if KIOSK_ROTATION:
+        env.setdefault("QT_QPA_EVDEV_TOUCHSCREEN_PARAMETERS", f"rotate={KIOSK_ROTATION}")
+    return name
+
+
+def _kms_config(device: str) -> str:
+    """eglfs_kms JSON config naming the DRM device (written next to the startup report)."""
+    path = os.path.join(os.path.dirname(report_path()), "eglfs-kms.json")
+    with open(path, "w") as f:
+        json.dump({"device": device, "hwcursor": False}, f)
+    return path
+
+
+def tune_window(window, kiosk: Optional[str]):
+    """Fit the main window to a kiosk screen (no-op under X11)."""
+    if kiosk is None:
+        return
+    screen = QGuiApplication.primaryScreen().availableGeometry()
+    window.setMinimumSize(0, 0)
+    window.setWindowFlag(Qt.FramelessWindowHint)
+    if KIOSK_HIDE_CURSOR:
+        QGuiApplication.setOverrideCursor(Qt.BlankCursor)
+    if screen.height() < KIOSK_SCROLL_BELOW_HEIGHT:
+        content = window.takeCentralWidget()
+        layout = content.layout()
+        layout.setSpacing(10)
+        layout.setContentsMargins(8, 6, 8, 8)
+        scroll = QScrollArea()
+        scroll.setFrameShape(QFrame.NoFrame)
+        scroll.setWidgetResizable(True)
+        scroll.setHorizontalScrollBarPolicy(Qt.ScrollBarAlwaysOff)
+        scroll.setWidget(content)
+        # Drag to scroll - a touchscreen has no wheel
+        QScroller.grabGesture(scroll.viewport(), QScroller.LeftMouseButtonGesture)
+        window.setCentralWidget(scroll)
+    window.setGeometry(screen)
+
+
+def report_path() -> str:
+    """Where the startup report goes (see STARTUP_REPORT)."""
+    path = os.environ.get("DEVICE_PANEL_STARTUP_REPORT") or STARTUP_REPORT
+    if path:
+        return path
+    runtime = os.environ.get("RUNTIME_DIRECTORY")
+    if runtime:
+        return os.path.join(runtime.split(":")[0], "startup.json")
+    return "/tmp/device-panel-startup.json"
+
+
+def _status_kb(pid: str, fields=("VmRSS", "VmHWM", "RssAnon", "RssFile")) -> Dict[str, int]:
+    values = {}
+    try:
+        with open(f"/proc/{pid}/status") as f:
+            for line in f:
+                key, _, rest = line.partition(":")
+                if key in fields:
+                    values[key] = int(rest.split()[0])
+    except (OSError, ValueError):
+        pass
+    return values
+
+
+def process_memory(pid: str = "self") -> Dict[str, int]:
+    """RSS (and PSS where readable) of a process, in kB."""
+    status = _status_kb(pid)
+    memory = {"rss_kb": status.get("VmRSS", 0), "peak_rss_kb": status.get("VmHWM", 0),
+              "anon_kb": status.get("RssAnon", 0), "file_kb": status.get("RssFile", 0)}
+    try:
+        with open(f"/proc/{pid}/smaps_rollup") as f:
+            for line in f:
+                if line.startswith("Pss:"):
+                    memory["pss_kb"] = int(line.split()[1])
+    except (OSError, ValueError):
+        pass
+    return memory
+
+
+def display_stack_memory() -> Dict[str, int]:
+    """Summed RSS (kB) of the running desktop-session processes, per name."""
+    stack: Dict[str, int] = {}
+    for pid in os.listdir("/proc"):
+        if not pid.isdigit():
+            continue
+        try:
+            with open(f"/proc/{pid}/comm") as f:
+                name = f.read().strip()
+        except OSError:
+            continue
+        if name in DISPLAY_STACK:
+            stack[name] = stack.get(name, 0) + _status_kb(pid, ("VmRSS",)).get("VmRSS", 0)
+    return stack
+
+
+def system_memory() -> Dict[str, int]:
+    """MemTotal/MemAvailable and what is in use, in kB."""
+    values = {}
+    with open("/proc/meminfo") as f:
+        for line in f:
+            key, _, rest = line.partition(":")
+            if key in ("MemTotal", "MemAvailable"):
+                values[key] = int(rest.split()[0])
+    return {"total_kb": values["MemTotal"], "available_kb": values["MemAvailable"],
+            "used_kb": values["MemTotal"] - values["MemAvailable"]}
+
+
+def _process_start_s() -> float:
+    """Process start time in seconds after boot (/proc/self/stat starttime)."""
+    with open("/proc/self/stat") as f:
+        fields = f.read().rsplit(")", 1)[1].split()
+    return int(fields[19]) / os.sysconf("SC_CLK_TCK")
+
+
+def _memory_snapshot() -> dict:
+    stack = display_stack_memory()
+    return {"panel": process_memory(), "display_stack_kb": sum(stack.values()),
+            "display_stack": stack, "system": system_memory()}
+
+
+class StartupProbe(QObject):
+    """Writes the startup report once the window's first frame has been painted."""
+    
+    def __init__(self, window, kiosk: Optional[str], path: Optional[str] = None):
+        super().__init__(window)
+        self.window = window
+        self.kiosk = kiosk
+        self.path = path or report_path()
+        self.report: Optional[dict] = None
+        window.installEventFilter(self)
+    
+    def eventFilter(self, obj, event):
+        if obj is self.window and event.type() == QEvent.Paint and self.report is None:
+            self.report = {}
+            self.window.removeEventFilter(self)
+            # The paint event renders the frame; it is flushed to the screen before
+            # the event loop runs zero-timeout timers
+            QTimer.singleShot(0, self._first_frame)
+        return False
+    
+    def _first_frame(self):
+        uptime = time.clock_gettime(time.CLOCK_BOOTTIME)
+        try:
+            started = _process_start_s()
+        except (OSError, ValueError, IndexError):
+            started = None
+        screen = QGuiApplication.primaryScreen().geometry()
+        self.report = {
+            "platform": QGuiApplication.platformName(),
+            "kiosk": self.kiosk is not None,
+            "screen": [screen.width(), screen.height()],
+            "boot_to_first_frame_s": round(uptime, 3),
+            "launch_to_first_frame_s": round(uptime - started, 3) if started is not None else None,
+            "first_frame": _memory_snapshot(),
+        }
+        self._write()
+        rss_mb = self.report["first_frame"]["panel"]["rss_kb"] / 1024
+        launch = self.report["launch_to_first_frame_s"]
+        print(f"First frame on {self.report['platform']}: {uptime:.2f} s after boot"
+              f"{f', {launch:.2f} s after launch' if launch is not None else ''}, "
+              f"RSS {rss_mb:.0f} MB (report: {self.path})")
+        QTimer.singleShot(int(STARTUP_SETTLE_S * 1000), self._settled)
+    
+    def _settled(self):
+        self.report["settled_after_s"] = STARTUP_SETTLE_S
+        self.report["settled"] = _memory_snapshot()
+        self._write()
+    
+    def _write(self):
+        try:
+            with open(self.path, "w") as f:
+                json.dump(self.report, f, indent=2)
+        except OSError as e:
+            print(f"Startup report not written: {e}", file=sys.stderr)
@@ -2,7 +2,7 @@
 
 import sys
 from PySide6.QtWidgets import (QMainWindow, QWidget, QVBoxLayout, QHBoxLayout,
-                               QApplication)
+                               QApplication, QPushButton)
 from PySide6.QtCore import QTimer, Qt
 
 from .status_bar import StatusBar
@@ -11,6 +11,10 @@ from .sections.led_section import LEDSection
 from .sections.button_section import ButtonSection
 from .sections.i2c_section import I2CSection
 from .sections.spi_section import SPISection
+from .sections.spectrum_section import SpectrumSection
+from .device_tabs import DeviceTab
+from config.acquisition_config import ENABLE_SPECTRUM
+from config.memory_config import LOW_MEMORY
 
 
 class MainWindow(QMainWindow):
@@ -54,6 +58,10 @@ class MainWindow(QMainWindow):
         self.update_timer = QTimer()
         self.update_timer.timeout.connect(self.update_all)
         
+        # Analog readings and statistics come from the acquisition pipeline (4Hz)
+        self.analog_timer = QTimer()
+        self.analog_timer.timeout.connect(self.update_analog)
+        
         # Ultra-fast button timer (1ms = 1000Hz) for instant response
         self.button_timer = QTimer()
         self.button_timer.timeout.connect(self.update_buttons_only)
@@ -64,6 +72,11 @@ class MainWindow(QMainWindow):
         # Start timer after a short delay to ensure window is ready
         QTimer.singleShot(200, lambda: self.update_timer.start(5))
         QTimer.singleShot(200, lambda: self.button_timer.start(1))  # 1ms = 1000Hz
+        QTimer.singleShot(200, lambda: self.analog_timer.start(250))
+        
+        # Spectrum redraw at the analyzer's fixed update rate
+        if self.spectrum_section is not None:
+            QTimer.singleShot(200, self.start_spectrum_timer)
     
     def setup_ui(self):
         """Set up the main UI layout."""
@@ -84,8 +97,23 @@ class MainWindow(QMainWindow):
         
         # Analog section (full width)
         self.analog_section = AnalogSection()
+        derived = getattr(self.mock_hardware, 'derived', None)
+        if derived is not None:
+            self.analog_section.set_derived_channels(derived.units)
         content_layout.addWidget(self.analog_section)
         
+        # Spectrum/waterfall (only when the pipeline runs an analyzer; in low-memory
+        # mode a button starts the analyzer, and loads NumPy, when first wanted)
+        self.spectrum_section = None
+        self.spectrum_button = None
+        if getattr(self.mock_hardware, 'spectrum', None) is not None:
+            self.add_spectrum_section(content_layout)
+        elif LOW_MEMORY and ENABLE_SPECTRUM and hasattr(self.mock_hardware, 'start_spectrum'):
+            self.spectrum_button = QPushButton("Show spectrum")
+            self.spectrum_button.clicked.connect(
+                lambda: self.on_show_spectrum(content_layout))
+            content_layout.addWidget(self.spectrum_button)
+        
         # Digital section row (LEDs and Buttons side by side)
         digital_row = QHBoxLayout()
         digital_row.setSpacing(15)
@@ -105,6 +133,7 @@ class MainWindow(QMainWindow):
         
         self.i2c_section = I2CSection()
         self.i2c_section.scan_requested.connect(self.on_i2c_scan)
+        self.i2c_section.device_clicked.connect(self.on_device_clicked)
         bus_row.addWidget(self.i2c_section)
         
         self.spi_section = SPISection()
@@ -118,6 +147,32 @@ class MainWindow(QMainWindow):
         main_layout.addLayout(content_layout)
         central_widget.setLayout(main_layout)
     
+    def add_spectrum_section(self, layout: QVBoxLayout, index: int = -1):
+        """Add the spectrum/waterfall view for the running analyzer."""
+        derived = getattr(self.mock_hardware, 'derived', None)
+        channels = [f"adc{ch}" for ch in range(4)] + (derived.names if derived else [])
+        self.spectrum_section = SpectrumSection(channels)
+        self.spectrum_section.channel_changed.connect(self.mock_hardware.spectrum.configure)
+        layout.insertWidget(index, self.spectrum_section)
+    
+    def start_spectrum_timer(self):
+        """Redraw the spectrum at the analyzer's fixed update rate."""
+        self.spectrum_timer = QTimer()
+        self.spectrum_timer.timeout.connect(self.update_spectrum)
+        self.spectrum_timer.start(int(1000 / self.mock_hardware.spectrum.update_hz))
+    
+    def on_show_spectrum(self, layout: QVBoxLayout):
+        """Start the analyzer on request (low-memory mode) and swap in its view."""
+        if self.mock_hardware.start_spectrum() is None:
+            self.spectrum_button.setText("Spectrum unavailable (NumPy missing)")
+            self.spectrum_button.setEnabled(False)
+            return
+        index = layout.indexOf(self.spectrum_button)
+        self.spectrum_button.deleteLater()
+        self.spectrum_button = None
+        self.add_spectrum_section(layout, index)
+        self.start_spectrum_timer()
+    
     def update_buttons_only(self):
         """Update only buttons - called at 1000Hz for instant response."""
         try:
@@ -138,15 +193,8 @@ class MainWindow(QMainWindow):
             if not self.mock_hardware:
                 return
             
-            # Update analog readings (skip if slow to avoid blocking buttons/LEDs)
-            # ADC can take 1+ seconds, so we skip it in the main update loop
-            # TODO: Move ADC to separate slower timer if needed
-            # if hasattr(self.mock_hardware, 'adc'):
-            #     try:
-            #         readings = self.mock_hardware.adc.read_all_channels()
-            #         self.analog_section.update_readings(readings)
-            #     except:
-            #         pass
+            # Analog readings are updated by update_analog() on a slower timer
+            # (ADC reads can take 1+ seconds, so they never happen here)
             
             # Update button states
             if hasattr(self.mock_hardware, 'gpio'):
@@ -178,6 +226,36 @@ class MainWindow(QMainWindow):
             print(f"Error in update_all: {e}", file=sys.stderr)
             traceback.print_exc()
     
+    def update_analog(self):
+        """Update analog readings and running statistics without touching the ADC."""
+        try:
+            hardware = self.mock_hardware
+            engine = getattr(hardware, 'engine', None)
+            if engine is not None:
+                self.analog_section.update_readings(
+                    {ch: engine.latest.get(ch) for ch in range(4)})
+            elif getattr(hardware, 'replay', None) is not None:
+                self.analog_section.update_readings(hardware.adc.read_all_channels())
+            
+            stats = getattr(hardware, 'stats', None)
+            if stats is not None:
+                self.analog_section.update_stats({ch: stats.get(f"adc{ch}") for ch in range(4)})
+            
+            derived = getattr(hardware, 'derived', None)
+            if derived is not None:
+                self.analog_section.update_derived(
+                    {name: derived.latest.get((0, name)) for name in derived.names},
+                    {name: stats.get(name) for name in derived.names} if stats else None)
+        except Exception as e:
+            print(f"Error in update_analog: {e}", file=sys.stderr)
+    
+    def update_spectrum(self):
+        """Redraw spectrum and waterfall from the analyzer's latest result."""
+        try:
+            self.spectrum_section.update_view(self.mock_hardware.spectrum.snapshot())
+        except Exception as e:
+            print(f"Error in update_spectrum: {e}", file=sys.stderr)
+    
     def on_led_changed(self, led_id: int, state: bool):
         """Handle LED state change from UI."""
         if self.mock_hardware and hasattr(self.mock_hardware, 'gpio'):
@@ -188,7 +266,8 @@ class MainWindow(QMainWindow):
         if self.mock_hardware and hasattr(self.mock_hardware, 'i2c'):
             devices = self.mock_hardware.i2c.scan()
             status = "OK" if devices else "NO_DEVICES"
-            self.i2c_section.update_results(devices, status)
+            self.i2c_section.update_results(devices, status,
+                                            getattr(self.mock_hardware.i2c, 'bus', None))
             
             # Update status bar
             if devices:
@@ -196,6 +275,14 @@ class MainWindow(QMainWindow):
             else:
                 self.status_bar.update_status("I²C", "NO DEVICES", "#ff9800")
     
+    def on_device_clicked(self, address: int, bus: int):
+        """Open the device's tab (reused if it was opened before)."""
+        tab = DeviceTab.for_device(bus, address, self.mock_hardware)
+        tab.setWindowTitle(f"I²C 0x{address:02X} (bus {bus})")
+        tab.show()
+        tab.raise_()
+        tab.activateWindow()
+    
     def on_spi_test(self):
         """Handle SPI test request."""
         if self.mock_hardware and hasattr(self.mock_hardware, 'spi'):
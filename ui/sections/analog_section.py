@@ -5,12 +5,26 @@ from PySide6.QtCore import Qt
 from typing import Dict, Optional
 
 
+def format_stats(snapshot: dict) -> str:
+    """One-line summary of a ChannelStats snapshot."""
+    text = (f"mean {snapshot['mean']:.3f}  σ {snapshot['std']:.4f}  "
+            f"RMS {snapshot['rms']:.3f}   "
+            f"min {snapshot['min']:.3f}  max {snapshot['max']:.3f}")
+    percentiles = [f"{key} {value:.3f}" for key, value in snapshot.items()
+                   if key.startswith("p") and value is not None]
+    if percentiles:
+        text += "   " + "  ".join(percentiles)
+    return text
+
+
 class AnalogSection(QGroupBox):
     """Section displaying 4 analog voltage channels."""
     
     def __init__(self, parent=None):
         super().__init__("Analog Voltages", parent)
         self.channel_labels = {}
+        self.stats_labels = {}
+        self.derived_labels = {}
         self.setup_ui()
     
     def setup_ui(self):
@@ -45,6 +59,13 @@ class AnalogSection(QGroupBox):
             
             self.channel_labels[channel] = label
             layout.addWidget(label)
+            
+            # Running statistics (filled from the acquisition pipeline)
+            stats_label = QLabel("")
+            stats_label.setStyleSheet("color: #6c757d; font-size: 10pt; padding: 0 16px;")
+            stats_label.setVisible(False)
+            self.stats_labels[channel] = stats_label
+            layout.addWidget(stats_label)
         
         layout.addStretch()
         self.setLayout(layout)
@@ -98,4 +119,70 @@ class AnalogSection(QGroupBox):
                         font-weight: bold;
                     }}
                 """)
-
+    
+    def update_stats(self, stats: Dict[int, Optional[dict]]):
+        """Update the running statistics line under each channel.
+        
+        Args:
+            stats: Dictionary mapping channel (0-3) to a ChannelStats snapshot or None
+        """
+        for channel, snapshot in stats.items():
+            label = self.stats_labels.get(channel)
+            if label is None:
+                continue
+            if not snapshot or not snapshot["count"]:
+                label.setVisible(False)
+                continue
+            label.setText(format_stats(snapshot))
+            label.setVisible(True)
+    
+    def set_derived_channels(self, units: Dict[str, str]):
+        """Add a readout per derived channel, below the ADC channels.
+        
+        Args:
+            units: Dictionary mapping derived channel name to its unit ("" if none)
+        """
+        layout = self.layout()
+        for name, unit in units.items():
+            label = QLabel(f"{name}: --")
+            label.setMinimumHeight(40)
+            label.setAlignment(Qt.AlignLeft | Qt.AlignVCenter)
+            label.setStyleSheet("""
+                QLabel {
+                    background-color: #f8f9fa;
+                    border: 2px dashed #ced4da;
+                    border-radius: 6px;
+                    padding: 8px 16px;
+                    color: #495057;
+                    font-size: 12pt;
+                    font-weight: bold;
+                }
+            """)
+            stats_label = QLabel("")
+            stats_label.setStyleSheet("color: #6c757d; font-size: 10pt; padding: 0 16px;")
+            stats_label.setVisible(False)
+            # Keep the trailing stretch last
+            layout.insertWidget(layout.count() - 1, label)
+            layout.insertWidget(layout.count() - 1, stats_label)
+            self.derived_labels[name] = (label, stats_label, unit)
+    
+    def update_derived(self, values: Dict[str, Optional[float]],
+                       stats: Optional[Dict[str, Optional[dict]]] = None):
+        """Update derived channel readouts.
+        
+        Args:
+            values: Dictionary mapping derived channel name to latest value or None
+            stats: Optional dictionary mapping name to a ChannelStats snapshot
+        """
+        for name, value in values.items():
+            if name not in self.derived_labels:
+                continue
+            label, stats_label, unit = self.derived_labels[name]
+            suffix = f" {unit}" if unit else ""
+            label.setText(f"{name}: --{suffix}" if value is None else f"{name}: {value:.3f}{suffix}")
+            snapshot = stats.get(name) if stats else None
+            if snapshot and snapshot["count"]:
+                stats_label.setText(format_stats(snapshot))
+                stats_label.setVisible(True)
+            else:
+                stats_label.setVisible(False)
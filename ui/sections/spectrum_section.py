@@ -0,0 +1,143 @@
+"""Spectrum and waterfall section for one ADC channel."""
+
+from typing import List, Optional
+
+from PySide6.QtWidgets import QGroupBox, QVBoxLayout, QHBoxLayout, QLabel, QComboBox, QWidget
+from PySide6.QtCore import Qt, Signal, QPointF
+from PySide6.QtGui import QPainter, QPen, QColor, QImage, QPolygonF
+
+
+def _colormap():
+    """256-entry dark-blue -> cyan -> yellow -> white color table."""
+    stops = [(0, (8, 16, 48)), (96, (0, 140, 200)), (176, (250, 220, 40)), (255, (255, 255, 255))]
+    table = []
+    for (i0, c0), (i1, c1) in zip(stops, stops[1:]):
+        for i in range(i0, i1):
+            f = (i - i0) / (i1 - i0)
+            r, g, b = (int(a + (b - a) * f) for a, b in zip(c0, c1))
+            table.append(0xFF000000 | (r << 16) | (g << 8) | b)
+    table.append(0xFFFFFFFF)
+    return table
+
+
+class SpectrumPlot(QWidget):
+    """PSD line plot in dB over frequency."""
+    
+    def __init__(self, parent=None):
+        super().__init__(parent)
+        self.setMinimumHeight(120)
+        self.freqs = None
+        self.db = None
+        self.floor = -120.0
+        self.ceiling = 0.0
+    
+    def set_data(self, freqs, db, floor: float, ceiling: float):
+        self.freqs, self.db = freqs, db
+        self.floor, self.ceiling = floor, ceiling
+        self.update()
+    
+    def paintEvent(self, event):
+        painter = QPainter(self)
+        painter.fillRect(self.rect(), QColor("#ffffff"))
+        painter.setPen(QPen(QColor("#e9ecef"), 1))
+        w, h = self.width(), self.height()
+        for i in range(1, 4):
+            painter.drawLine(0, h * i // 4, w, h * i // 4)
+        if self.db is None or len(self.db) < 2:
+            painter.setPen(QColor("#adb5bd"))
+            painter.drawText(self.rect(), Qt.AlignCenter, "Waiting for samples...")
+            return
+        span = max(self.ceiling - self.floor, 1e-9)
+        x_scale = (w - 1) / (len(self.db) - 1)
+        points = QPolygonF([QPointF(i * x_scale, (self.ceiling - v) / span * (h - 1))
+                            for i, v in enumerate(self.db.tolist())])
+        painter.setRenderHint(QPainter.Antialiasing)
+        painter.setPen(QPen(QColor("#007bff"), 1.5))
+        painter.drawPolyline(points)
+        painter.setPen(QColor("#6c757d"))
+        painter.drawText(4, 12, f"{self.ceiling:.0f} dB")
+        painter.drawText(4, h - 4, f"{self.floor:.0f} dB")
+        painter.drawText(w - 70, h - 4, f"{self.freqs[-1]:.1f} Hz")
+
+
+class WaterfallView(QWidget):
+    """Waterfall image: time runs downwards, newest row at the bottom."""
+    
+    def __init__(self, parent=None):
+        super().__init__(parent)
+        self.setMinimumHeight(100)
+        self._colors = _colormap()
+        self._image: Optional[QImage] = None
+        self._pixels = None  # Keeps the buffer alive while the image uses it
+    
+    def set_data(self, rows, floor: float, ceiling: float):
+        import numpy as np
+        if rows is None or not len(rows):
+            self._image = None
+        else:
+            scaled = (rows - floor) * (255.0 / max(ceiling - floor, 1e-9))
+            self._pixels = np.ascontiguousarray(np.clip(scaled, 0, 255).astype(np.uint8))
+            height, width = self._pixels.shape
+            self._image = QImage(self._pixels.data, width, height, width, QImage.Format_Indexed8)
+            self._image.setColorTable(self._colors)
+        self.update()
+    
+    def paintEvent(self, event):
+        painter = QPainter(self)
+        painter.fillRect(self.rect(), QColor("#081030"))
+        if self._image is not None:
+            painter.drawImage(self.rect(), self._image)
+
+
+class SpectrumSection(QGroupBox):
+    """Section showing a channel's spectrum and waterfall."""
+    
+    # Signal emitted when another channel is selected (channel name)
+    channel_changed = Signal(str)
+    
+    def __init__(self, channels: Optional[List[str]] = None, parent=None):
+        super().__init__("Spectrum", parent)
+        self.channels = channels or [f"adc{ch}" for ch in range(4)]
+        self.setup_ui()
+    
+    def setup_ui(self):
+        """Set up the UI layout."""
+        layout = QVBoxLayout()
+        layout.setSpacing(8)
+        layout.setContentsMargins(15, 10, 15, 15)
+        
+        header = QHBoxLayout()
+        self.channel_combo = QComboBox()
+        self.channel_combo.addItems(self.channels)
+        self.channel_combo.currentTextChanged.connect(self.channel_changed.emit)
+        header.addWidget(self.channel_combo)
+        
+        self.info_label = QLabel("")
+        self.info_label.setStyleSheet("color: #6c757d; font-size: 10pt;")
+        header.addWidget(self.info_label, 1)
+        layout.addLayout(header)
+        
+        self.plot = SpectrumPlot()
+        layout.addWidget(self.plot)
+        self.waterfall = WaterfallView()
+        layout.addWidget(self.waterfall)
+        
+        self.setLayout(layout)
+    
+    def update_view(self, snapshot: Optional[dict]):
+        """Redraw from a SpectrumAnalyzer snapshot (None = no data yet)."""
+        if snapshot is None:
+            self.plot.set_data(None, None, -120.0, 0.0)
+            self.waterfall.set_data(None, -120.0, 0.0)
+            return
+        db = snapshot["psd_db"][1:]  # Skip DC
+        ceiling = float(db.max()) + 5.0
+        floor = ceiling - 100.0
+        self.plot.set_data(snapshot["freqs"][1:], db, floor, ceiling)
+        self.waterfall.set_data(snapshot["waterfall"][:, 1:], floor, ceiling)
+        stats = snapshot["stats"]
+        resolution = snapshot["sample_rate"] / ((len(snapshot["freqs"]) - 1) * 2)
+        self.info_label.setText(
+            f"fs {snapshot['sample_rate']:.0f} Hz   Δf {resolution:.2f} Hz   "
+            f"{snapshot['averaged']} avg   CPU {stats['cpu_ms']:.2f} ms/update "
+            f"({stats['cpu_percent']:.2f}%)")
@@ -0,0 +1,87 @@
+"""Image thumbnails decoded once, off the GUI thread.
+
+Decoding a directory of PNGs when a list is built stalls the UI. request()
+returns a cached icon immediately when the file was decoded before (same
+path and modification time); otherwise a worker thread decodes and scales
+it into a QImage - which, unlike QPixmap, may be created outside the GUI
+thread - and the icon is delivered through the ready signal.
+"""
+
+import os
+import queue
+import threading
+from collections import OrderedDict
+from typing import Optional, Tuple
+
+from PySide6.QtCore import QObject, Qt, Signal
+from PySide6.QtGui import QIcon, QImage, QPixmap
+
+from config.device_config import THUMBNAIL_CACHE_SIZE, THUMBNAIL_SIZE
+
+
+class ThumbnailCache(QObject):
+    """Process-wide thumbnail cache with one background decoder thread."""
+    
+    # path, icon (emitted on the GUI thread)
+    ready = Signal(str, QIcon)
+    _decoded = Signal(str, float, QImage)
+    
+    def __init__(self, size: int = THUMBNAIL_SIZE, max_icons: int = THUMBNAIL_CACHE_SIZE):
+        super().__init__()
+        self.size = size
+        self.max_icons = max_icons
+        # (path, mtime) -> icon, least recently used first
+        self._icons: "OrderedDict[Tuple[str, float], QIcon]" = OrderedDict()
+        self._pending = set()
+        self._queue: "queue.Queue[Tuple[str, float]]" = queue.Queue()
+        self._thread: Optional[threading.Thread] = None
+        # Queued across threads: the QIcon is made where QPixmap is allowed
+        self._decoded.connect(self._on_decoded, Qt.QueuedConnection)
+    
+    def request(self, path: str) -> Optional[QIcon]:
+        """Cached icon for path, or None and a later ready(path, icon)."""
+        try:
+            key = (path, os.path.getmtime(path))
+        except OSError:
+            return None
+        icon = self._icons.get(key)
+        if icon is not None:
+            self._icons.move_to_end(key)
+            return icon
+        if key in self._pending:
+            return None
+        self._pending.add(key)
+        self._queue.put(key)
+        if self._thread is None:
+            self._thread = threading.Thread(target=self._run, name="thumbnails", daemon=True)
+            self._thread.start()
+        return None
+    
+    def _run(self):
+        while True:
+            path, mtime = self._queue.get()
+            image = QImage(path)
+            if not image.isNull():
+                image = image.scaled(self.size, self.size, Qt.KeepAspectRatio,
+                                     Qt.SmoothTransformation)
+            self._decoded.emit(path, mtime, image)
+    
+    def _on_decoded(self, path: str, mtime: float, image: QImage):
+        key = (path, mtime)
+        self._pending.discard(key)
+        icon = QIcon(QPixmap.fromImage(image)) if not image.isNull() else QIcon()
+        self._icons[key] = icon
+        while len(self._icons) > self.max_icons:
+            self._icons.popitem(last=False)
+        self.ready.emit(path, icon)
+
+
+_cache: Optional[ThumbnailCache] = None
+
+
+def get_thumbnails() -> ThumbnailCache:
+    """The shared thumbnail cache (create after the QApplication)."""
+    global _cache
+    if _cache is None:
+        _cache = ThumbnailCache()
+    return _cache